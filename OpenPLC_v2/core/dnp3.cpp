@@ -96,11 +96,12 @@ public:
             return_val = CommandStatus::SUCCESS;
 
             IEC_BOOL crob_val = (code == ControlCode::LATCH_ON);
-            pthread_mutex_lock(&bufferLock);
             if(bool_output[index/8][index%8] != NULL) {
-                *bool_output[index/8][index%8] = crob_val;
+                beginImageWrites();
+                stageImageWrite(bool_output[index/8][index%8], sizeof(IEC_BOOL), crob_val, IMAGE_WRITE_ALL);
+                if(!endImageWrites())
+                    return_val = CommandStatus::BLOCKED;
             }
-            pthread_mutex_unlock(&bufferLock);
         }
         else {
             return_val = CommandStatus::NOT_SUPPORTED;
@@ -115,18 +116,21 @@ public:
     }
     virtual CommandStatus Operate(const AnalogOutputInt16& command, uint16_t index, OperateType opType) {
         auto ao_val = command.value;
-        pthread_mutex_lock(&bufferLock);
+        if(index > MAX_16B_RANGE) {
+            return CommandStatus::OUT_OF_RANGE;
+        }
+
+        beginImageWrites();
         if(index < MIN_16B_RANGE && int_output[index] != NULL) {
-            *int_output[index] = ao_val;
+            stageImageWrite(int_output[index], sizeof(IEC_UINT), (IEC_UINT)ao_val, IMAGE_WRITE_ALL);
         }
-        else if(index < MAX_16B_RANGE && 
+        else if(index >= MIN_16B_RANGE && index < MAX_16B_RANGE && 
                 int_memory[index - MIN_16B_RANGE] != NULL) {
-            *int_memory[index - MIN_16B_RANGE] = ao_val;
+            stageImageWrite(int_memory[index - MIN_16B_RANGE], sizeof(IEC_UINT), (IEC_UINT)ao_val, IMAGE_WRITE_ALL);
         }
-        else if(index > MAX_16B_RANGE) {
-            return CommandStatus::OUT_OF_RANGE;
-        }
-        pthread_mutex_unlock(&bufferLock);
+        if(!endImageWrites())
+            return CommandStatus::BLOCKED;
+
         return CommandStatus::SUCCESS;
     }
 
@@ -137,14 +141,16 @@ public:
     virtual CommandStatus Operate(const AnalogOutputInt32& command, uint16_t index, OperateType opType) {
         auto ao_val = command.value;
 
-        if(index < MIN_32B_RANGE || index >= MAX_32B_RANGE)
+        if(index < MIN_32B_RANGE || index >= MAX_32B_RANGE ||
+           index - MIN_32B_RANGE >= BUFFER_SIZE)
             return CommandStatus::OUT_OF_RANGE;
         
-        pthread_mutex_lock(&bufferLock);
         if(dint_memory[index - MIN_32B_RANGE] != NULL) {
-            *dint_memory[index - MIN_32B_RANGE] = ao_val;
+            beginImageWrites();
+            stageImageWrite(dint_memory[index - MIN_32B_RANGE], sizeof(IEC_DINT), (IEC_DINT)ao_val, IMAGE_WRITE_ALL);
+            if(!endImageWrites())
+                return CommandStatus::BLOCKED;
         }
-        pthread_mutex_unlock(&bufferLock);
 
         return CommandStatus::SUCCESS;
     }
@@ -157,14 +163,16 @@ public:
     virtual CommandStatus Operate(const AnalogOutputFloat32& command, uint16_t index, OperateType opType) {
         auto ao_val = command.value;
 
-        if(index < MIN_32B_RANGE || index >= MAX_32B_RANGE)
+        if(index < MIN_32B_RANGE || index >= MAX_32B_RANGE ||
+           index - MIN_32B_RANGE >= BUFFER_SIZE)
             return CommandStatus::OUT_OF_RANGE;
         
-        pthread_mutex_lock(&bufferLock);
         if(dint_memory[index - MIN_32B_RANGE] != NULL) {
-            *dint_memory[index - MIN_32B_RANGE] = ao_val;
+            beginImageWrites();
+            stageImageWrite(dint_memory[index - MIN_32B_RANGE], sizeof(IEC_DINT), (IEC_DINT)ao_val, IMAGE_WRITE_ALL);
+            if(!endImageWrites())
+                return CommandStatus::BLOCKED;
         }
-        pthread_mutex_unlock(&bufferLock);
 
         return CommandStatus::SUCCESS;
     }
@@ -176,14 +184,16 @@ public:
     virtual CommandStatus Operate(const AnalogOutputDouble64& command, uint16_t index, OperateType opType) {
         auto ao_val = command.value;
 
-        if(index < MIN_64B_RANGE || index >= MAX_64B_RANGE)
+        if(index < MIN_64B_RANGE || index >= MAX_64B_RANGE ||
+           index - MIN_64B_RANGE >= BUFFER_SIZE)
             return CommandStatus::OUT_OF_RANGE;
         
-        pthread_mutex_lock(&bufferLock);
         if(lint_memory[index - MIN_64B_RANGE] != NULL) {
-            *lint_memory[index - MIN_64B_RANGE] = ao_val;
+            beginImageWrites();
+            stageImageWrite(lint_memory[index - MIN_64B_RANGE], sizeof(IEC_LINT), (IEC_LINT)ao_val, IMAGE_WRITE_ALL);
+            if(!endImageWrites())
+                return CommandStatus::BLOCKED;
         }
-        pthread_mutex_unlock(&bufferLock);
 
         return CommandStatus::SUCCESS;
     }
@@ -195,40 +205,42 @@ protected:
 //------------------------------------------------------------------
 // Function to update DNP3 values every time they may have changed
 //------------------------------------------------------------------
-void update_vals(std::shared_ptr<IOutstation> outstation){
+void update_vals(std::shared_ptr<IOutstation> outstation, const ProcessImage *image){
     UpdateBuilder builder;
     // Update Discrete input (Binary input)
     for(int i = 1; i < MAX_DISCRETE_INPUT; i++) {
-        builder.Update(Binary((bool)(*bool_input[i/8][i%8])), i);
+        builder.Update(Binary((bool)image->bool_input[i/8][i%8]), i);
 
     }
     // Update Coils (Binary Output)
     for(int i = 0; i < MAX_COILS; i++) {
-        builder.Update(BinaryOutputStatus((bool)(*bool_output[i/8][i%8])), i);
+        builder.Update(BinaryOutputStatus((bool)image->bool_output[i/8][i%8]), i);
 
     }    
     // Update Input Registers (Analog Input)
     for (int i = 0; i < MAX_INP_REGS; i++) {
-        builder.Update(Analog((int)(*int_input[i])), i);
+        builder.Update(Analog((int)image->int_input[i]), i);
 
     }
     // Update Holding Registers (Analog Output)
     for (int i = 0; i < MIN_16B_RANGE; i++) {
-        builder.Update(AnalogOutputStatus((int)(*int_output[i])), i);
+        builder.Update(AnalogOutputStatus((int)image->int_output[i]), i);
     }
     // Update Holding registers for memory
     for (int i = MIN_16B_RANGE; i < MAX_16B_RANGE; i++) {
         if(int_memory[i - MIN_16B_RANGE] != NULL)
             builder.Update(
-                    AnalogOutputStatus((int)(*int_memory[i - MIN_16B_RANGE])),
+                    AnalogOutputStatus((int)image->int_memory[i - MIN_16B_RANGE]),
                     i
             );
     } 
     // Update Holding registers for 32 b memory
-    for (int i = MIN_32B_RANGE; i < MAX_32B_RANGE; i++) {
+    for (int i = MIN_32B_RANGE; 
+         (i < MAX_32B_RANGE && i - MIN_32B_RANGE < BUFFER_SIZE); 
+         i++) {
         if(dint_memory[i - MIN_32B_RANGE] != NULL)
             builder.Update(
-                    AnalogOutputStatus((int)(*dint_memory[i - MIN_32B_RANGE])),
+                    AnalogOutputStatus((int)image->dint_memory[i - MIN_32B_RANGE]),
                     i
             );
     } 
@@ -239,7 +251,7 @@ void update_vals(std::shared_ptr<IOutstation> outstation){
          i++) {
         if(lint_memory[i - MIN_64B_RANGE] != NULL)
             builder.Update(
-                    AnalogOutputStatus((int)(*lint_memory[i - MIN_64B_RANGE])),
+                    AnalogOutputStatus((int)image->lint_memory[i - MIN_64B_RANGE]),
                     i
             );
     } 
@@ -402,10 +414,10 @@ void dnp3StartServer(int port) {
     struct timespec timer_start;
     clock_gettime(CLOCK_MONOTONIC, &timer_start);
     int i = 0;
+    static ProcessImage image;
     for(;;) {
-        pthread_mutex_lock(&bufferLock);
-        update_vals(outstation);
-        pthread_mutex_unlock(&bufferLock);
+        readProcessImage(&image);
+        update_vals(outstation, &image);
         sleep_until(&timer_start, OPLC_CYCLE);
     }
 }
@@ -73,6 +73,29 @@ extern IEC_LINT *lint_memory[BUFFER_SIZE];
 //lock for the buffer
 extern pthread_mutex_t bufferLock;
 
+//Snapshot of the located variables published by the scan cycle
+struct ProcessImage
+{
+	IEC_BOOL bool_input[BUFFER_SIZE][8];
+	IEC_BOOL bool_output[BUFFER_SIZE][8];
+	IEC_UINT int_input[BUFFER_SIZE];
+	IEC_UINT int_output[BUFFER_SIZE];
+	IEC_UINT int_memory[BUFFER_SIZE];
+	IEC_DINT dint_memory[BUFFER_SIZE];
+	IEC_LINT lint_memory[BUFFER_SIZE];
+};
+
+//Write of a protocol server, applied as *target = (*target & ~mask) | (value & mask)
+struct ImageWrite
+{
+	void *target;
+	uint64_t value;
+	uint64_t mask;
+	uint8_t size;
+};
+
+#define IMAGE_WRITE_ALL		0xffffffffffffffffULL
+
 //Common task timer
 extern unsigned long long common_ticktime__;
 
@@ -98,6 +121,7 @@ void updateBuffersOut();
 void sleep_thread(int milliseconds);
 void *modbusThread();
 void sleep_until(struct timespec *ts, int delay);
+void printScanStatistics();
 
 //server.cpp
 void startServer(int port);
@@ -109,6 +133,16 @@ void mapUnusedIO();
 //dnp3.cpp
 void dnp3StartServer(int port);
 
+//process_image.cpp
+void publishProcessImage();
+const ProcessImage *beginImageRead(unsigned int *generation);
+bool endImageRead(unsigned int generation);
+void readProcessImage(ProcessImage *copy);
+void beginImageWrites();
+void stageImageWrite(void *target, int size, uint64_t value, uint64_t mask);
+bool endImageWrites();
+void applyImageWrites();
+
 //persistent_storage.cpp
 void *persistentStorage(void *args);
 int readPersistentStorage();
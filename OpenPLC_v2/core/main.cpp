@@ -26,6 +26,7 @@
 #include <pthread.h>
 #include <time.h>
 #include <signal.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <sys/mman.h>
 
@@ -51,6 +52,22 @@ int dnp3_port = 20000;
 
 pthread_mutex_t bufferLock; //mutex for the internal buffers
 
+//scan cycle statistics. Histogram bucket n counts times in [2^(n-1), 2^n) us
+#define SCAN_HISTOGRAM_SIZE	24
+
+struct ScanStatistics
+{
+	unsigned long long cycles;
+	unsigned long long overruns;
+	unsigned long long maxJitter;
+	unsigned long long maxExecution;
+	unsigned long long jitterHistogram[SCAN_HISTOGRAM_SIZE];
+	unsigned long long executionHistogram[SCAN_HISTOGRAM_SIZE];
+};
+
+static ScanStatistics scanStats;
+static volatile sig_atomic_t scanStatisticsRequested = 0;
+
 //-----------------------------------------------------------------------------
 // Helper function - Makes the running thread sleep for the ammount of time
 // in milliseconds
@@ -71,7 +88,9 @@ void sleep_until(struct timespec *ts, int delay)
         ts->tv_nsec -= 1000*1000*1000;
         ts->tv_sec++;
     }
-    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, ts,  NULL);
+    //a signal (e.g. SIGUSR1 for the scan statistics) interrupts the sleep;
+    //the deadline is absolute, so just sleep again
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, ts,  NULL) == EINTR);
 }
 
 void *modbusThread(void *arg)
@@ -84,6 +103,77 @@ void *dnp3Thread(void *arg)
     dnp3StartServer(dnp3_port);
 }
 
+//-----------------------------------------------------------------------------
+// Helper functions for the scan cycle statistics. Times are in nanoseconds
+//-----------------------------------------------------------------------------
+long long timeDifference(struct timespec *end, struct timespec *start)
+{
+    return (long long)(end->tv_sec - start->tv_sec) * 1000000000LL + (end->tv_nsec - start->tv_nsec);
+}
+
+int histogramBucket(unsigned long long nanoseconds)
+{
+    unsigned long long microseconds = nanoseconds / 1000;
+    int bucket = 0;
+
+    while (microseconds > 0 && bucket < SCAN_HISTOGRAM_SIZE - 1)
+    {
+        microseconds >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+//-----------------------------------------------------------------------------
+// Accounts one scan cycle. deadline is the time the cycle was scheduled to
+// start, start and end are the times it actually started and finished
+//-----------------------------------------------------------------------------
+void recordScan(struct timespec *deadline, struct timespec *start, struct timespec *end)
+{
+    long long jitter = timeDifference(start, deadline);
+    long long execution = timeDifference(end, start);
+
+    if (jitter < 0) jitter = 0;
+    if (execution < 0) execution = 0;
+
+    scanStats.cycles++;
+    scanStats.jitterHistogram[histogramBucket(jitter)]++;
+    scanStats.executionHistogram[histogramBucket(execution)]++;
+    if ((unsigned long long)jitter > scanStats.maxJitter) scanStats.maxJitter = jitter;
+    if ((unsigned long long)execution > scanStats.maxExecution) scanStats.maxExecution = execution;
+
+    //the cycle finished after the next one should have started
+    if (timeDifference(end, deadline) > (long long)common_ticktime__) scanStats.overruns++;
+}
+
+void printScanStatistics()
+{
+    printf("Scan cycles: %llu, overruns: %llu\n", scanStats.cycles, scanStats.overruns);
+    printf("Max jitter: %llu us, max execution time: %llu us\n", scanStats.maxJitter / 1000, scanStats.maxExecution / 1000);
+    printf("%-16s %12s %12s\n", "time (us)", "jitter", "execution");
+
+    for (int i = 0; i < SCAN_HISTOGRAM_SIZE; i++)
+    {
+        if (scanStats.jitterHistogram[i] == 0 && scanStats.executionHistogram[i] == 0) continue;
+
+        char range[32];
+        if (i == 0)
+            sprintf(range, "< 1");
+        else if (i == SCAN_HISTOGRAM_SIZE - 1)
+            sprintf(range, ">= %llu", 1ULL << (i - 1));
+        else
+            sprintf(range, "%llu - %llu", 1ULL << (i - 1), (1ULL << i) - 1);
+
+        printf("%-16s %12llu %12llu\n", range, scanStats.jitterHistogram[i], scanStats.executionHistogram[i]);
+    }
+}
+
+void requestScanStatistics(int signum)
+{
+    scanStatisticsRequested = 1;
+}
+
 double measureTime(struct timespec *timer_start)
 {
     struct timespec timer_end;
@@ -166,6 +256,14 @@ int main(int argc,char **argv)
     initializeHardware();
     updateBuffersIn();
     updateBuffersOut();
+
+    pthread_mutex_lock(&bufferLock);
+    publishProcessImage();
+    pthread_mutex_unlock(&bufferLock);
+
+    //print the scan cycle statistics on SIGUSR1
+    signal(SIGUSR1, requestScanStatistics);
+
     pthread_t modbus_thread;
     pthread_t dnp3_thread;
 
@@ -214,6 +312,9 @@ int main(int argc,char **argv)
 	//======================================================
 	for(;;)
 	{
+		struct timespec cycle_start, cycle_end;
+		clock_gettime(CLOCK_MONOTONIC, &cycle_start);
+
 		//make sure the buffer pointers are correct and
 		//attached to the user variables
 		glueVars();
@@ -221,13 +322,27 @@ int main(int argc,char **argv)
 		updateBuffersIn(); //read input image
 
 		pthread_mutex_lock(&bufferLock); //lock mutex
+		applyImageWrites(); //writes received by the protocol servers
 		config_run__(tick++); // execute plc program logic
 		pthread_mutex_unlock(&bufferLock); //unlock mutex
 
 		updateBuffersOut(); //write output image
+
+		pthread_mutex_lock(&bufferLock);
+		publishProcessImage(); //image read by the protocol servers
+		pthread_mutex_unlock(&bufferLock);
 		
 		updateTime();
 
+		clock_gettime(CLOCK_MONOTONIC, &cycle_end);
+		recordScan(&timer_start, &cycle_start, &cycle_end);
+
+		if (scanStatisticsRequested)
+		{
+			scanStatisticsRequested = 0;
+			printScanStatistics();
+		}
+
 		sleep_until(&timer_start, common_ticktime__);
 	}
 }
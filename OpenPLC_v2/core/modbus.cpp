@@ -168,30 +168,34 @@ void ReadCoils(unsigned char *buffer, int bufferSize)
 	buffer[5] = lowByte(ByteDataLength + 3); //Number of bytes after this one
 	buffer[8] = ByteDataLength;     //Number of bytes of data
 
-	pthread_mutex_lock(&bufferLock);
-	for(int i = 0; i < ByteDataLength ; i++)
+	unsigned int generation;
+	const ProcessImage *image;
+	do
 	{
-		for(int j = 0; j < 8; j++)
+		image = beginImageRead(&generation);
+		for(int i = 0; i < ByteDataLength ; i++)
 		{
-			int position = Start + i * 8 + j;
-			if (position < MAX_COILS)
+			for(int j = 0; j < 8; j++)
 			{
-				if (bool_output[position/8][position%8] != NULL)
+				int position = Start + i * 8 + j;
+				if (position < MAX_COILS)
 				{
-					bitWrite(buffer[9 + i], j, *bool_output[position/8][position%8]);
+					if (bool_output[position/8][position%8] != NULL)
+					{
+						bitWrite(buffer[9 + i], j, image->bool_output[position/8][position%8]);
+					}
+					else
+					{
+						bitWrite(buffer[9 + i], j, 0);
+					}
 				}
-				else
+				else //invalid address
 				{
-					bitWrite(buffer[9 + i], j, 0);
+					mb_error = ERR_ILLEGAL_DATA_ADDRESS;
 				}
 			}
-			else //invalid address
-			{
-				mb_error = ERR_ILLEGAL_DATA_ADDRESS;
-			}
 		}
-	}
-	pthread_mutex_unlock(&bufferLock);
+	} while (!endImageRead(generation));
 
 	if (mb_error != ERR_NONE)
 	{
@@ -235,30 +239,34 @@ void ReadDiscreteInputs(unsigned char *buffer, int bufferSize)
 	buffer[5] = lowByte(ByteDataLength + 3); //Number of bytes after this one
 	buffer[8] = ByteDataLength;     //Number of bytes of data
 
-	pthread_mutex_lock(&bufferLock);
-	for(int i = 0; i < ByteDataLength ; i++)
+	unsigned int generation;
+	const ProcessImage *image;
+	do
 	{
-		for(int j = 0; j < 8; j++)
+		image = beginImageRead(&generation);
+		for(int i = 0; i < ByteDataLength ; i++)
 		{
-			int position = Start + i * 8 + j;
-			if (position < MAX_DISCRETE_INPUT)
+			for(int j = 0; j < 8; j++)
 			{
-				if (bool_input[position/8][position%8] != NULL)
+				int position = Start + i * 8 + j;
+				if (position < MAX_DISCRETE_INPUT)
 				{
-					bitWrite(buffer[9 + i], j, *bool_input[position/8][position%8]);
+					if (bool_input[position/8][position%8] != NULL)
+					{
+						bitWrite(buffer[9 + i], j, image->bool_input[position/8][position%8]);
+					}
+					else
+					{
+						bitWrite(buffer[9 + i], j, 0);
+					}
 				}
-				else
+				else //invalid address
 				{
-					bitWrite(buffer[9 + i], j, 0);
+					mb_error = ERR_ILLEGAL_DATA_ADDRESS;
 				}
 			}
-			else //invalid address
-			{
-				mb_error = ERR_ILLEGAL_DATA_ADDRESS;
-			}
 		}
-	}
-	pthread_mutex_unlock(&bufferLock);
+	} while (!endImageRead(generation));
 
 	if (mb_error != ERR_NONE)
 	{
@@ -301,105 +309,109 @@ void ReadHoldingRegisters(unsigned char *buffer, int bufferSize)
 	buffer[5] = lowByte(ByteDataLength + 3); //Number of bytes after this one
 	buffer[8] = ByteDataLength;     //Number of bytes of data
 
-	pthread_mutex_lock(&bufferLock);
-	for(int i = 0; i < WordDataLength; i++)
+	unsigned int generation;
+	const ProcessImage *image;
+	do
 	{
-		int position = Start + i;
-		if (position <= MIN_16B_RANGE)
-		{
-			if (int_output[position] != NULL)
-			{
-				buffer[ 9 + i * 2] = highByte(*int_output[position]);
-				buffer[10 + i * 2] = lowByte(*int_output[position]);
-			}
-			else
-			{
-				buffer[ 9 + i * 2] = 0;
-				buffer[10 + i * 2] = 0;
-			}
-		}
-		//accessing memory
-		//16-bit registers
-		else if (position >= MIN_16B_RANGE && position <= MAX_16B_RANGE)
-		{
-			if (int_memory[position - MIN_16B_RANGE] != NULL)
-			{
-				buffer[ 9 + i * 2] = highByte(*int_memory[position - MIN_16B_RANGE]);
-				buffer[10 + i * 2] = lowByte(*int_memory[position - MIN_16B_RANGE]);
-			}
-			else
-			{
-				buffer[ 9 + i * 2] = 0;
-				buffer[10 + i * 2] = 0;
-			}
-		}
-		//32-bit registers
-		else if (position >= MIN_32B_RANGE && position <= MAX_32B_RANGE)
+		image = beginImageRead(&generation);
+		for(int i = 0; i < WordDataLength; i++)
 		{
-			if (dint_memory[(position - MIN_32B_RANGE)/2] != NULL)
+			int position = Start + i;
+			if (position <= MIN_16B_RANGE)
 			{
-				if ((position - MIN_32B_RANGE) % 2 == 0) //first word
+				if (int_output[position] != NULL)
 				{
-					uint16_t tempValue = (uint16_t)(*dint_memory[(position - MIN_32B_RANGE)/2] >> 16);
-					buffer[ 9 + i * 2] = highByte(tempValue);
-					buffer[10 + i * 2] = lowByte(tempValue);
+					buffer[ 9 + i * 2] = highByte(image->int_output[position]);
+					buffer[10 + i * 2] = lowByte(image->int_output[position]);
 				}
-				else //second word
+				else
 				{
-					uint16_t tempValue = (uint16_t)(*dint_memory[(position - MIN_32B_RANGE)/2] & 0xffff);
-					buffer[ 9 + i * 2] = highByte(tempValue);
-					buffer[10 + i * 2] = lowByte(tempValue);
+					buffer[ 9 + i * 2] = 0;
+					buffer[10 + i * 2] = 0;
 				}
 			}
-			else
+			//accessing memory
+			//16-bit registers
+			else if (position >= MIN_16B_RANGE && position <= MAX_16B_RANGE)
 			{
-				buffer[ 9 + i * 2] = mb_holding_regs[position];
-				buffer[10 + i * 2] = mb_holding_regs[position];
+				if (int_memory[position - MIN_16B_RANGE] != NULL)
+				{
+					buffer[ 9 + i * 2] = highByte(image->int_memory[position - MIN_16B_RANGE]);
+					buffer[10 + i * 2] = lowByte(image->int_memory[position - MIN_16B_RANGE]);
+				}
+				else
+				{
+					buffer[ 9 + i * 2] = 0;
+					buffer[10 + i * 2] = 0;
+				}
 			}
-		}
-		//64-bit registers
-		else if (position >= MIN_64B_RANGE && position <= MAX_64B_RANGE)
-		{
-			if (lint_memory[(position - MIN_64B_RANGE)/4] != NULL)
+			//32-bit registers
+			else if (position >= MIN_32B_RANGE && position <= MAX_32B_RANGE)
 			{
-				if ((position - MIN_64B_RANGE) % 4 == 0) //first word
+				if (dint_memory[(position - MIN_32B_RANGE)/2] != NULL)
 				{
-					uint16_t tempValue = (uint16_t)(*lint_memory[(position - MIN_64B_RANGE)/4] >> 48);
-					buffer[ 9 + i * 2] = highByte(tempValue);
-					buffer[10 + i * 2] = lowByte(tempValue);
+					if ((position - MIN_32B_RANGE) % 2 == 0) //first word
+					{
+						uint16_t tempValue = (uint16_t)(image->dint_memory[(position - MIN_32B_RANGE)/2] >> 16);
+						buffer[ 9 + i * 2] = highByte(tempValue);
+						buffer[10 + i * 2] = lowByte(tempValue);
+					}
+					else //second word
+					{
+						uint16_t tempValue = (uint16_t)(image->dint_memory[(position - MIN_32B_RANGE)/2] & 0xffff);
+						buffer[ 9 + i * 2] = highByte(tempValue);
+						buffer[10 + i * 2] = lowByte(tempValue);
+					}
 				}
-				else if ((position - MIN_64B_RANGE) % 4 == 1)//second word
+				else
 				{
-					uint16_t tempValue = (uint16_t)((*lint_memory[(position - MIN_64B_RANGE)/4] >> 32) & 0xffff);
-					buffer[ 9 + i * 2] = highByte(tempValue);
-					buffer[10 + i * 2] = lowByte(tempValue);
+					buffer[ 9 + i * 2] = mb_holding_regs[position];
+					buffer[10 + i * 2] = mb_holding_regs[position];
 				}
-				else if ((position - MIN_64B_RANGE) % 4 == 2)//third word
+			}
+			//64-bit registers
+			else if (position >= MIN_64B_RANGE && position <= MAX_64B_RANGE)
+			{
+				if (lint_memory[(position - MIN_64B_RANGE)/4] != NULL)
 				{
-					uint16_t tempValue = (uint16_t)((*lint_memory[(position - MIN_64B_RANGE)/4] >> 16) & 0xffff);
-					buffer[ 9 + i * 2] = highByte(tempValue);
-					buffer[10 + i * 2] = lowByte(tempValue);
+					if ((position - MIN_64B_RANGE) % 4 == 0) //first word
+					{
+						uint16_t tempValue = (uint16_t)(image->lint_memory[(position - MIN_64B_RANGE)/4] >> 48);
+						buffer[ 9 + i * 2] = highByte(tempValue);
+						buffer[10 + i * 2] = lowByte(tempValue);
+					}
+					else if ((position - MIN_64B_RANGE) % 4 == 1)//second word
+					{
+						uint16_t tempValue = (uint16_t)((image->lint_memory[(position - MIN_64B_RANGE)/4] >> 32) & 0xffff);
+						buffer[ 9 + i * 2] = highByte(tempValue);
+						buffer[10 + i * 2] = lowByte(tempValue);
+					}
+					else if ((position - MIN_64B_RANGE) % 4 == 2)//third word
+					{
+						uint16_t tempValue = (uint16_t)((image->lint_memory[(position - MIN_64B_RANGE)/4] >> 16) & 0xffff);
+						buffer[ 9 + i * 2] = highByte(tempValue);
+						buffer[10 + i * 2] = lowByte(tempValue);
+					}
+					else if ((position - MIN_64B_RANGE) % 4 == 3)//fourth word
+					{
+						uint16_t tempValue = (uint16_t)(image->lint_memory[(position - MIN_64B_RANGE)/4] & 0xffff);
+						buffer[ 9 + i * 2] = highByte(tempValue);
+						buffer[10 + i * 2] = lowByte(tempValue);
+					}
 				}
-				else if ((position - MIN_64B_RANGE) % 4 == 3)//fourth word
+				else
 				{
-					uint16_t tempValue = (uint16_t)(*lint_memory[(position - MIN_64B_RANGE)/4] & 0xffff);
-					buffer[ 9 + i * 2] = highByte(tempValue);
-					buffer[10 + i * 2] = lowByte(tempValue);
+					buffer[ 9 + i * 2] = mb_holding_regs[position];
+					buffer[10 + i * 2] = mb_holding_regs[position];
 				}
 			}
+			//invalid address
 			else
 			{
-				buffer[ 9 + i * 2] = mb_holding_regs[position];
-				buffer[10 + i * 2] = mb_holding_regs[position];
+				mb_error = ERR_ILLEGAL_DATA_ADDRESS;
 			}
 		}
-		//invalid address
-		else
-		{
-			mb_error = ERR_ILLEGAL_DATA_ADDRESS;
-		}
-	}
-	pthread_mutex_unlock(&bufferLock);
+	} while (!endImageRead(generation));
 
 	if (mb_error != ERR_NONE)
 	{
@@ -442,29 +454,33 @@ void ReadInputRegisters(unsigned char *buffer, int bufferSize)
 	buffer[5] = lowByte(ByteDataLength + 3); //Number of bytes after this one
 	buffer[8] = ByteDataLength;     //Number of bytes of data
 
-	pthread_mutex_lock(&bufferLock);
-	for(int i = 0; i < WordDataLength; i++)
+	unsigned int generation;
+	const ProcessImage *image;
+	do
 	{
-		int position = Start + i;
-		if (position < MAX_INP_REGS)
+		image = beginImageRead(&generation);
+		for(int i = 0; i < WordDataLength; i++)
 		{
-			if (int_input[position] != NULL)
+			int position = Start + i;
+			if (position < MAX_INP_REGS)
 			{
-				buffer[ 9 + i * 2] = highByte(*int_input[position]);
-				buffer[10 + i * 2] = lowByte(*int_input[position]);
+				if (int_input[position] != NULL)
+				{
+					buffer[ 9 + i * 2] = highByte(image->int_input[position]);
+					buffer[10 + i * 2] = lowByte(image->int_input[position]);
+				}
+				else
+				{
+					buffer[ 9 + i * 2] = 0;
+					buffer[10 + i * 2] = 0;
+				}
 			}
-			else
+			else //invalid address
 			{
-				buffer[ 9 + i * 2] = 0;
-				buffer[10 + i * 2] = 0;
+				mb_error = ERR_ILLEGAL_DATA_ADDRESS;
 			}
 		}
-		else //invalid address
-		{
-			mb_error = ERR_ILLEGAL_DATA_ADDRESS;
-		}
-	}
-	pthread_mutex_unlock(&bufferLock);
+	} while (!endImageRead(generation));
 
 	if (mb_error != ERR_NONE)
 	{
@@ -505,12 +521,12 @@ void WriteCoil(unsigned char *buffer, int bufferSize)
 			value = 0;
 		}
 
-		pthread_mutex_lock(&bufferLock);
+		beginImageWrites();
 		if (bool_output[Start/8][Start%8] != NULL)
 		{
-			*bool_output[Start/8][Start%8] = value;
+			stageImageWrite(bool_output[Start/8][Start%8], sizeof(IEC_BOOL), value, IMAGE_WRITE_ALL);
 		}
-		pthread_mutex_unlock(&bufferLock);
+		if (!endImageWrites()) mb_error = ERR_SLAVE_DEVICE_BUSY;
 	}
 
 	else //invalid address
@@ -547,13 +563,13 @@ void WriteRegister(unsigned char *buffer, int bufferSize)
 
 	Start = word(buffer[8],buffer[9]);
 
-	pthread_mutex_lock(&bufferLock);
+	beginImageWrites();
 	//analog outputs
 	if (Start <= MIN_16B_RANGE)
 	{
 		if (int_output[Start] != NULL)
 		{
-			*int_output[Start] = word(buffer[10],buffer[11]);
+			stageImageWrite(int_output[Start], sizeof(IEC_UINT), word(buffer[10],buffer[11]), IMAGE_WRITE_ALL);
 		}
 	}
 	//accessing memory
@@ -562,7 +578,7 @@ void WriteRegister(unsigned char *buffer, int bufferSize)
 	{
 		if (int_memory[Start - MIN_16B_RANGE] != NULL)
 		{
-			*int_memory[Start - MIN_16B_RANGE] = word(buffer[10],buffer[11]);
+			stageImageWrite(int_memory[Start - MIN_16B_RANGE], sizeof(IEC_UINT), word(buffer[10],buffer[11]), IMAGE_WRITE_ALL);
 		}
 	}
 	//32-bit registers
@@ -574,13 +590,11 @@ void WriteRegister(unsigned char *buffer, int bufferSize)
 
 			if ((Start - MIN_32B_RANGE) % 2 == 0) //first word
 			{
-				*dint_memory[(Start - MIN_32B_RANGE) / 2] = *dint_memory[(Start - MIN_32B_RANGE) / 2] & 0x0000ffff;
-				*dint_memory[(Start - MIN_32B_RANGE) / 2] = *dint_memory[(Start - MIN_32B_RANGE) / 2] | (tempValue << 16);
+				stageImageWrite(dint_memory[(Start - MIN_32B_RANGE) / 2], sizeof(IEC_DINT), tempValue << 16, 0xffff0000);
 			}
 			else //second word
 			{
-				*dint_memory[(Start - MIN_32B_RANGE) / 2] = *dint_memory[(Start - MIN_32B_RANGE) / 2] & 0xffff0000;
-				*dint_memory[(Start - MIN_32B_RANGE) / 2] = *dint_memory[(Start - MIN_32B_RANGE) / 2] | tempValue;
+				stageImageWrite(dint_memory[(Start - MIN_32B_RANGE) / 2], sizeof(IEC_DINT), tempValue, 0x0000ffff);
 			}
 		}
 		else
@@ -597,23 +611,19 @@ void WriteRegister(unsigned char *buffer, int bufferSize)
 
 			if ((Start - MIN_64B_RANGE) % 4 == 0) //first word
 			{
-				*lint_memory[(Start - MIN_64B_RANGE) / 4] = *lint_memory[(Start - MIN_64B_RANGE) / 4] & 0x0000ffffffffffff;
-				*lint_memory[(Start - MIN_64B_RANGE) / 4] = *lint_memory[(Start - MIN_64B_RANGE) / 4] | (tempValue << 48);
+				stageImageWrite(lint_memory[(Start - MIN_64B_RANGE) / 4], sizeof(IEC_LINT), tempValue << 48, 0xffff000000000000);
 			}
 			else if ((Start - MIN_64B_RANGE) % 4 == 1) //second word
 			{
-				*lint_memory[(Start - MIN_64B_RANGE) / 4] = *lint_memory[(Start - MIN_64B_RANGE) / 4] & 0xffff0000ffffffff;
-				*lint_memory[(Start - MIN_64B_RANGE) / 4] = *lint_memory[(Start - MIN_64B_RANGE) / 4] | (tempValue << 32);
+				stageImageWrite(lint_memory[(Start - MIN_64B_RANGE) / 4], sizeof(IEC_LINT), tempValue << 32, 0x0000ffff00000000);
 			}
 			else if ((Start - MIN_64B_RANGE) % 4 == 2) //third word
 			{
-				*lint_memory[(Start - MIN_64B_RANGE) / 4] = *lint_memory[(Start - MIN_64B_RANGE) / 4] & 0xffffffff0000ffff;
-				*lint_memory[(Start - MIN_64B_RANGE) / 4] = *lint_memory[(Start - MIN_64B_RANGE) / 4] | (tempValue << 16);
+				stageImageWrite(lint_memory[(Start - MIN_64B_RANGE) / 4], sizeof(IEC_LINT), tempValue << 16, 0x00000000ffff0000);
 			}
 			else if ((Start - MIN_64B_RANGE) % 4 == 3) //fourth word
 			{
-				*lint_memory[(Start - MIN_64B_RANGE) / 4] = *lint_memory[(Start - MIN_64B_RANGE) / 4] & 0xffffffffffff0000;
-				*lint_memory[(Start - MIN_64B_RANGE) / 4] = *lint_memory[(Start - MIN_64B_RANGE) / 4] | tempValue;
+				stageImageWrite(lint_memory[(Start - MIN_64B_RANGE) / 4], sizeof(IEC_LINT), tempValue, 0x000000000000ffff);
 			}
 		}
 		else
@@ -625,7 +635,7 @@ void WriteRegister(unsigned char *buffer, int bufferSize)
 	{
 		mb_error = ERR_ILLEGAL_DATA_ADDRESS;
 	}
-	pthread_mutex_unlock(&bufferLock);
+	if (!endImageWrites()) mb_error = ERR_SLAVE_DEVICE_BUSY;
 
 	if (mb_error != ERR_NONE)
 	{
@@ -670,7 +680,7 @@ void WriteMultipleCoils(unsigned char *buffer, int bufferSize)
 	buffer[4] = 0;
 	buffer[5] = 6; //Number of bytes after this one.
 
-	pthread_mutex_lock(&bufferLock);
+	beginImageWrites();
 	for(int i = 0; i < ByteDataLength ; i++)
 	{
 		for(int j = 0; j < 8; j++)
@@ -678,7 +688,7 @@ void WriteMultipleCoils(unsigned char *buffer, int bufferSize)
 			int position = Start + i * 8 + j;
 			if (position < MAX_COILS)
 			{
-				if (bool_output[position/8][position%8] != NULL) *bool_output[position/8][position%8] = bitRead(buffer[13 + i], j);
+				if (bool_output[position/8][position%8] != NULL) stageImageWrite(bool_output[position/8][position%8], sizeof(IEC_BOOL), bitRead(buffer[13 + i], j), IMAGE_WRITE_ALL);
 			}
 			else //invalid address
 			{
@@ -686,7 +696,7 @@ void WriteMultipleCoils(unsigned char *buffer, int bufferSize)
 			}
 		}
 	}
-	pthread_mutex_unlock(&bufferLock);
+	if (!endImageWrites()) mb_error = ERR_SLAVE_DEVICE_BUSY;
 
 	if (mb_error != ERR_NONE)
 	{
@@ -728,20 +738,20 @@ void WriteMultipleRegisters(unsigned char *buffer, int bufferSize)
 	buffer[4] = 0;
 	buffer[5] = 6; //Number of bytes after this one.
 
-	pthread_mutex_lock(&bufferLock);
+	beginImageWrites();
 	for(int i = 0; i < WordDataLength; i++)
 	{
 		int position = Start + i;
 		//analog outputs
 		if (position <= MIN_16B_RANGE)
 		{
-			if (int_output[position] != NULL) *int_output[position] =  word(buffer[13 + i * 2], buffer[14 + i * 2]);
+			if (int_output[position] != NULL) stageImageWrite(int_output[position], sizeof(IEC_UINT), word(buffer[13 + i * 2], buffer[14 + i * 2]), IMAGE_WRITE_ALL);
 		}
 		//accessing memory
 		//16-bit registers
 		else if (position >= MIN_16B_RANGE && position <= MAX_16B_RANGE)
 		{
-			if (int_memory[position - MIN_16B_RANGE] != NULL) *int_memory[position - MIN_16B_RANGE] = word(buffer[13 + i * 2], buffer[14 + i * 2]);
+			if (int_memory[position - MIN_16B_RANGE] != NULL) stageImageWrite(int_memory[position - MIN_16B_RANGE], sizeof(IEC_UINT), word(buffer[13 + i * 2], buffer[14 + i * 2]), IMAGE_WRITE_ALL);
 		}
 		//32-bit registers
 		else if (position >= MIN_32B_RANGE && position <= MAX_32B_RANGE)
@@ -752,13 +762,11 @@ void WriteMultipleRegisters(unsigned char *buffer, int bufferSize)
 
 				if ((position - MIN_32B_RANGE) % 2 == 0) //first word
 				{
-					*dint_memory[(position - MIN_32B_RANGE) / 2] = *dint_memory[(position - MIN_32B_RANGE) / 2] & 0x0000ffff;
-					*dint_memory[(position - MIN_32B_RANGE) / 2] = *dint_memory[(position - MIN_32B_RANGE) / 2] | (tempValue << 16);
+					stageImageWrite(dint_memory[(position - MIN_32B_RANGE) / 2], sizeof(IEC_DINT), tempValue << 16, 0xffff0000);
 				}
 				else //second word
 				{
-					*dint_memory[(position - MIN_32B_RANGE) / 2] = *dint_memory[(position - MIN_32B_RANGE) / 2] & 0xffff0000;
-					*dint_memory[(position - MIN_32B_RANGE) / 2] = *dint_memory[(position - MIN_32B_RANGE) / 2] | tempValue;
+					stageImageWrite(dint_memory[(position - MIN_32B_RANGE) / 2], sizeof(IEC_DINT), tempValue, 0x0000ffff);
 				}
 			}
 			else
@@ -775,23 +783,19 @@ void WriteMultipleRegisters(unsigned char *buffer, int bufferSize)
 
 				if ((position - MIN_64B_RANGE) % 4 == 0) //first word
 				{
-					*lint_memory[(position - MIN_64B_RANGE) / 4] = *lint_memory[(position - MIN_64B_RANGE) / 4] & 0x0000ffffffffffff;
-					*lint_memory[(position - MIN_64B_RANGE) / 4] = *lint_memory[(position - MIN_64B_RANGE) / 4] | (tempValue << 48);
+					stageImageWrite(lint_memory[(position - MIN_64B_RANGE) / 4], sizeof(IEC_LINT), tempValue << 48, 0xffff000000000000);
 				}
 				else if ((Start - MIN_64B_RANGE) % 4 == 1) //second word
 				{
-					*lint_memory[(position - MIN_64B_RANGE) / 4] = *lint_memory[(position - MIN_64B_RANGE) / 4] & 0xffff0000ffffffff;
-					*lint_memory[(position - MIN_64B_RANGE) / 4] = *lint_memory[(position - MIN_64B_RANGE) / 4] | (tempValue << 32);
+					stageImageWrite(lint_memory[(position - MIN_64B_RANGE) / 4], sizeof(IEC_LINT), tempValue << 32, 0x0000ffff00000000);
 				}
 				else if ((Start - MIN_64B_RANGE) % 4 == 2) //third word
 				{
-					*lint_memory[(position - MIN_64B_RANGE) / 4] = *lint_memory[(position - MIN_64B_RANGE) / 4] & 0xffffffff0000ffff;
-					*lint_memory[(position - MIN_64B_RANGE) / 4] = *lint_memory[(position - MIN_64B_RANGE) / 4] | (tempValue << 16);
+					stageImageWrite(lint_memory[(position - MIN_64B_RANGE) / 4], sizeof(IEC_LINT), tempValue << 16, 0x00000000ffff0000);
 				}
 				else if ((Start - MIN_64B_RANGE) % 4 == 3) //fourth word
 				{
-					*lint_memory[(position - MIN_64B_RANGE) / 4] = *lint_memory[(position - MIN_64B_RANGE) / 4] & 0xffffffffffff0000;
-					*lint_memory[(position - MIN_64B_RANGE) / 4] = *lint_memory[(position - MIN_64B_RANGE) / 4] | tempValue;
+					stageImageWrite(lint_memory[(position - MIN_64B_RANGE) / 4], sizeof(IEC_LINT), tempValue, 0x000000000000ffff);
 				}
 			}
 			else
@@ -804,7 +808,7 @@ void WriteMultipleRegisters(unsigned char *buffer, int bufferSize)
 			mb_error = ERR_ILLEGAL_DATA_ADDRESS;
 		}
 	}
-	pthread_mutex_unlock(&bufferLock);
+	if (!endImageWrites()) mb_error = ERR_SLAVE_DEVICE_BUSY;
 
 	if (mb_error != ERR_NONE)
 	{
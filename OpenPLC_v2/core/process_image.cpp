@@ -0,0 +1,184 @@
+//-----------------------------------------------------------------------------
+// This file is part of the OpenPLC Software Stack.
+//
+// OpenPLC is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// OpenPLC is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with OpenPLC.  If not, see <http://www.gnu.org/licenses/>.
+//------
+//
+// Process image shared between the scan cycle and the protocol servers.
+// The scan cycle publishes a snapshot of the located variables at the end
+// of every cycle into one of two buffers, so the protocol servers can read
+// a consistent image without taking bufferLock. Writes from the protocol
+// servers are staged and applied by the scan cycle before the program runs.
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "ladder.h"
+
+#define IMAGE_WRITE_QUEUE_SIZE		4096
+
+//Snapshots. images[imageGeneration & 1] holds the last published one
+static ProcessImage images[2];
+static unsigned int imageGeneration = 0;
+static unsigned int imageWriting = 0;
+
+//Staged writes. Protocol servers append to writeQueue[activeQueue]
+static ImageWrite writeQueue[2][IMAGE_WRITE_QUEUE_SIZE];
+static int writeCount[2];
+static int activeQueue = 0;
+static int stagedStart;
+static bool stagedOverflow;
+static pthread_mutex_t writeQueueLock = PTHREAD_MUTEX_INITIALIZER;
+
+//-----------------------------------------------------------------------------
+// Copy the current value of all located variables into the next image
+// buffer and make it the current one. Must only be called by the scan cycle.
+//-----------------------------------------------------------------------------
+void publishProcessImage()
+{
+	unsigned int next = imageGeneration + 1;
+	ProcessImage *image = &images[next & 1];
+
+	//readers of the buffer we are about to overwrite must retry
+	__atomic_store_n(&imageWriting, next, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	for (int i = 0; i < BUFFER_SIZE; i++)
+	{
+		for (int j = 0; j < 8; j++)
+		{
+			image->bool_input[i][j] = (bool_input[i][j] != NULL) ? *bool_input[i][j] : 0;
+			image->bool_output[i][j] = (bool_output[i][j] != NULL) ? *bool_output[i][j] : 0;
+		}
+
+		image->int_input[i] = (int_input[i] != NULL) ? *int_input[i] : 0;
+		image->int_output[i] = (int_output[i] != NULL) ? *int_output[i] : 0;
+		image->int_memory[i] = (int_memory[i] != NULL) ? *int_memory[i] : 0;
+		image->dint_memory[i] = (dint_memory[i] != NULL) ? *dint_memory[i] : 0;
+		image->lint_memory[i] = (lint_memory[i] != NULL) ? *lint_memory[i] : 0;
+	}
+
+	__atomic_store_n(&imageGeneration, next, __ATOMIC_RELEASE);
+}
+
+//-----------------------------------------------------------------------------
+// Start reading the last published image. The values read are only valid if
+// endImageRead returns true for the same generation, otherwise the read has
+// to be repeated.
+//-----------------------------------------------------------------------------
+const ProcessImage *beginImageRead(unsigned int *generation)
+{
+	*generation = __atomic_load_n(&imageGeneration, __ATOMIC_ACQUIRE);
+
+	return &images[*generation & 1];
+}
+
+bool endImageRead(unsigned int generation)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	//the buffer is only overwritten again when generation + 2 is published
+	return (__atomic_load_n(&imageWriting, __ATOMIC_RELAXED) - generation) < 2;
+}
+
+//-----------------------------------------------------------------------------
+// Take a private copy of the last published image
+//-----------------------------------------------------------------------------
+void readProcessImage(ProcessImage *copy)
+{
+	unsigned int generation;
+	const ProcessImage *image;
+
+	do
+	{
+		image = beginImageRead(&generation);
+		memcpy(copy, image, sizeof(ProcessImage));
+	} while (!endImageRead(generation));
+}
+
+//-----------------------------------------------------------------------------
+// Staging of writes. A protocol server stages all writes of one request
+// between beginImageWrites and endImageWrites. If the queue can't take all
+// of them nothing is staged and endImageWrites returns false.
+//-----------------------------------------------------------------------------
+void beginImageWrites()
+{
+	pthread_mutex_lock(&writeQueueLock);
+	stagedStart = writeCount[activeQueue];
+	stagedOverflow = false;
+}
+
+void stageImageWrite(void *target, int size, uint64_t value, uint64_t mask)
+{
+	int queue = activeQueue;
+
+	if (writeCount[queue] >= IMAGE_WRITE_QUEUE_SIZE)
+	{
+		stagedOverflow = true;
+		return;
+	}
+
+	ImageWrite *write = &writeQueue[queue][writeCount[queue]++];
+	write->target = target;
+	write->value = value;
+	write->mask = mask;
+	write->size = size;
+}
+
+bool endImageWrites()
+{
+	bool staged = !stagedOverflow;
+
+	if (stagedOverflow) writeCount[activeQueue] = stagedStart;
+	pthread_mutex_unlock(&writeQueueLock);
+
+	return staged;
+}
+
+//-----------------------------------------------------------------------------
+// Apply the writes staged since the last call. Called by the scan cycle with
+// bufferLock held. writeQueueLock is only held while a single request is
+// staged, so the scan cycle never waits for more than that.
+//-----------------------------------------------------------------------------
+void applyImageWrites()
+{
+	pthread_mutex_lock(&writeQueueLock);
+	int queue = activeQueue;
+	activeQueue = 1 - queue;
+	pthread_mutex_unlock(&writeQueueLock);
+
+	for (int i = 0; i < writeCount[queue]; i++)
+	{
+		ImageWrite *write = &writeQueue[queue][i];
+
+		switch (write->size)
+		{
+			case 1:
+				*(IEC_BOOL *)write->target = (*(IEC_BOOL *)write->target & ~write->mask) | (write->value & write->mask);
+				break;
+			case 2:
+				*(uint16_t *)write->target = (*(uint16_t *)write->target & ~write->mask) | (write->value & write->mask);
+				break;
+			case 4:
+				*(uint32_t *)write->target = (*(uint32_t *)write->target & ~write->mask) | (write->value & write->mask);
+				break;
+			case 8:
+				*(uint64_t *)write->target = (*(uint64_t *)write->target & ~write->mask) | (write->value & write->mask);
+				break;
+		}
+	}
+	writeCount[queue] = 0;
+}
@@ -932,6 +932,7 @@ void *ITRC_Master(void *data)
     ordinal ord_save;
     int32u recvd_first_ordinal;
     struct timeval spines_timeout, *t;
+    int prime_len, prime_off;
     int32u *idx;
     seq_pair *ps;
     char ciphertext[CHECKPOINT_PAYLOAD_SIZE];
@@ -1103,123 +1104,136 @@ void *ITRC_Master(void *data)
                     FD_CLR(prime_sock, &mask);
                     exit(EXIT_FAILURE);
                 }
-                mess = (signed_message *)buff;
-                res = (client_response_message *)(mess + 1);
-                scada_mess = (signed_message *)(res + 1);
-
-                //printf("Prime [%d]: %d of %d\n", res->ord_num, res->event_idx, res->event_tot);
-
-                /* Check for valid message type */
-                /* We don't validate messages from Prime at this level, since
-                 * even if the content of the message is invalid (and we don't
-                 * want to apply it), we still want to advance our received
-                 * Prime ordinal correctly. Instead, we'll do this in
-                 * Process_Prime_Ordinal and treat it as no-op if it turns out
-                 * to be invalid. Note that we should be checking that the
-                 * signed_message and client_response headers are valid before
-                 * getting to this point though. */
-
-                /*if (!ITRC_Valid_Type(scada_mess, FROM_PRIME)) {
-                    printf("ITRC_Master: Invalid message from Prime, type = %d\n", scada_mess->type);
-                    continue;
-                }*/
+                /* Prime delivers the events of an ordinal back-to-back in
+                 * one datagram (see CLIENT_RESPONSE_BATCH_BYTES in Prime),
+                 * so walk each client response in what we received */
+                prime_len = nBytes;
+                prime_off = 0;
+                while (prime_off + (int)sizeof(signed_message) <= prime_len) {
+                    mess = (signed_message *)(buff + prime_off);
+                    prime_off += sizeof(signed_message);
+                    if (mess->len > (int32u)(prime_len - prime_off)) {
+                        printf("ITRC_Master: Truncated message from Prime, len = %u\n", mess->len);
+                        break;
+                    }
+                    prime_off += mess->len;
+                    res = (client_response_message *)(mess + 1);
+                    scada_mess = (signed_message *)(res + 1);
+
+                    //printf("Prime [%d]: %d of %d\n", res->ord_num, res->event_idx, res->event_tot);
+
+                    /* Check for valid message type */
+                    /* We don't validate messages from Prime at this level, since
+                     * even if the content of the message is invalid (and we don't
+                     * want to apply it), we still want to advance our received
+                     * Prime ordinal correctly. Instead, we'll do this in
+                     * Process_Prime_Ordinal and treat it as no-op if it turns out
+                     * to be invalid. Note that we should be checking that the
+                     * signed_message and client_response headers are valid before
+                     * getting to this point though. */
+
+                    /*if (!ITRC_Valid_Type(scada_mess, FROM_PRIME)) {
+                        printf("ITRC_Master: Invalid message from Prime, type = %d\n", scada_mess->type);
+                        continue;
+                    }*/
                 
-                /* Grab the ordinal information */
-                ord_save.ord_num   = res->ord_num;
-                ord_save.event_idx = res->event_idx;
-                ord_save.event_tot = res->event_tot;
+                    /* Grab the ordinal information */
+                    ord_save.ord_num   = res->ord_num;
+                    ord_save.event_idx = res->event_idx;
+                    ord_save.event_tot = res->event_tot;
 
-                /* Check if we received a SYSTEM RESET message from Prime, which occurs on
-                 * the initial startup or when system assumptions are violated */
-                if (scada_mess->type == PRIME_SYSTEM_RESET) {
-                    assert(ord_save.ord_num == 0);
+                    /* Check if we received a SYSTEM RESET message from Prime, which occurs on
+                     * the initial startup or when system assumptions are violated */
+                    if (scada_mess->type == PRIME_SYSTEM_RESET) {
+                        assert(ord_save.ord_num == 0);
 
-                    printf("Processed PRIME_SYSTEM_RESET @ ITRC\n");
+                        printf("Processed PRIME_SYSTEM_RESET @ ITRC\n");
                     
-                    /* Reset data structures */
-                    ITRC_Reset_Master_Data_Structures(0);
-
-                    if(Type==CC_TYPE)
-                    {
-                        /* Send the SYSTEM RESET message to the Scada Master */
-                        scada_mess = PKT_Construct_Signed_Message(0);
-                        scada_mess->machine_id = My_ID;
-                        scada_mess->len = 0;
-                        scada_mess->type = SYSTEM_RESET;
-                        IPC_Send(ns.ipc_s, (void *)scada_mess, sizeof(signed_message), ns.ipc_remote);
-                    }
+                        /* Reset data structures */
+                        ITRC_Reset_Master_Data_Structures(0);
+
+                        if(Type==CC_TYPE)
+                        {
+                            /* Send the SYSTEM RESET message to the Scada Master */
+                            scada_mess = PKT_Construct_Signed_Message(0);
+                            scada_mess->machine_id = My_ID;
+                            scada_mess->len = 0;
+                            scada_mess->type = SYSTEM_RESET;
+                            IPC_Send(ns.ipc_s, (void *)scada_mess, sizeof(signed_message), ns.ipc_remote);
+                        }
 
                     
-                    continue;
-                }
+                        continue;
+                    }
 
-                /* If this is the first ordinal you get from Prime and its further ahead than
-                 * you were expecting, request a state transfer */
-                if (recvd_first_ordinal == 0 && !ITRC_Ord_Consec(recvd_ord, ord_save)) {
-                    IPC_Send(ns.inject_s, (void *)&ns.inject_s, sizeof(ns.inject_s), ns.inject_path);
-                }
-                recvd_first_ordinal = 1;
+                    /* If this is the first ordinal you get from Prime and its further ahead than
+                     * you were expecting, request a state transfer */
+                    if (recvd_first_ordinal == 0 && !ITRC_Ord_Consec(recvd_ord, ord_save)) {
+                        IPC_Send(ns.inject_s, (void *)&ns.inject_s, sizeof(ns.inject_s), ns.inject_path);
+                    }
+                    recvd_first_ordinal = 1;
 
-                /* Check if duplicate/old ordinal coming from Prime. Maybe all of Prime was 
-                 * restarted from ordinal 1 - if so, we need to restart this to sync back up 
-                 * and accept the restarted Prime ordinals */
-                if (ITRC_Ord_Compare(ord_save, recvd_ord) <= 0) {
-                    printf("ITRC_Master: Old Prime ordinal - did Prime start from scratch?\n");
-                    continue;
-                }
+                    /* Check if duplicate/old ordinal coming from Prime. Maybe all of Prime was 
+                     * restarted from ordinal 1 - if so, we need to restart this to sync back up 
+                     * and accept the restarted Prime ordinals */
+                    if (ITRC_Ord_Compare(ord_save, recvd_ord) <= 0) {
+                        printf("ITRC_Master: Old Prime ordinal - did Prime start from scratch?\n");
+                        continue;
+                    }
                 
-                ITRC_Process_Prime_Ordinal(ord_save, mess, &ns);
-                if (ns.sp_ext_s == -1) {
-                    t = &spines_timeout;
-                }
+                    ITRC_Process_Prime_Ordinal(ord_save, mess, &ns);
+                    if (ns.sp_ext_s == -1) {
+                        t = &spines_timeout;
+                    }
 
-                /* If we completed a state transfer from this ordinal, see if there are any
-                 * pending updates that can now be applied */
-                if (completed_transfer == 1) {
-                    assert(collecting_signal == 0);
-                    completed_transfer = 0;
-
-                    /* Replay any queued pending messages now that we're done collecting anything */
-                    for (stddll_begin(&pending_updates, &it); !stddll_is_end(&pending_updates, &it) && !collecting_signal;) {
-                        mess = *(signed_message **)stdit_val(&it);
-                        res = (client_response_message *)(mess + 1);
-                        scada_mess = (signed_message *)(res + 1);
+                    /* If we completed a state transfer from this ordinal, see if there are any
+                     * pending updates that can now be applied */
+                    if (completed_transfer == 1) {
+                        assert(collecting_signal == 0);
+                        completed_transfer = 0;
+
+                        /* Replay any queued pending messages now that we're done collecting anything */
+                        for (stddll_begin(&pending_updates, &it); !stddll_is_end(&pending_updates, &it) && !collecting_signal;) {
+                            mess = *(signed_message **)stdit_val(&it);
+                            res = (client_response_message *)(mess + 1);
+                            scada_mess = (signed_message *)(res + 1);
     
-                        ord_save.ord_num   = res->ord_num;
-                        ord_save.event_idx = res->event_idx;
-                        ord_save.event_tot = res->event_tot;
+                            ord_save.ord_num   = res->ord_num;
+                            ord_save.event_idx = res->event_idx;
+                            ord_save.event_tot = res->event_tot;
                         
-                        if (ITRC_Ord_Compare(ord_save, recvd_ord) > 0)  {
-                            ITRC_Process_Prime_Ordinal(ord_save, mess, &ns);
-                            if (ns.sp_ext_s == -1) {
-                                t = &spines_timeout;
+                            if (ITRC_Ord_Compare(ord_save, recvd_ord) > 0)  {
+                                ITRC_Process_Prime_Ordinal(ord_save, mess, &ns);
+                                if (ns.sp_ext_s == -1) {
+                                    t = &spines_timeout;
+                                }
                             }
+                            free(mess);
+                            stddll_erase(&pending_updates, &it);
                         }
-                        free(mess);
-                        stddll_erase(&pending_updates, &it);
                     }
-                }
 
-                /* MK:  New checkpoint is created by Control Center replicas after processing 
-                        prime ordinal and after applying updates. This is OK as long as prime 
-                        and scada master are not separated. Data Center replicas only check
-                        the checkpoints queue for garbage collection.
-                */
-                if(ITRC_Ord_Checkpoint_Check(recvd_ord) && (Type == CC_TYPE))
-                {
-                    stddll_push_back(&ord_queue, &recvd_ord); // MK: Why do we need to do this here?
-                    checkpoint_req = PKT_Construct_Create_Checkpoint_Msg(recvd_ord, progress);
-                    nBytes = sizeof(signed_message) + checkpoint_req->len;
-                    IPC_Send(ns.ipc_s, (void *)checkpoint_req, nBytes, ns.ipc_remote);
-                    free(checkpoint_req);
-                }
-                else if (ITRC_Ord_Checkpoint_Check(recvd_ord) && (Type == DC_TYPE))
-                {
-                    // update applied ord, otherwise checkpoints will not be checked correctly
-                    // memcpy($applied_ord, $recvd_ord, sizeof(ordinal));
+                    /* MK:  New checkpoint is created by Control Center replicas after processing 
+                            prime ordinal and after applying updates. This is OK as long as prime 
+                            and scada master are not separated. Data Center replicas only check
+                            the checkpoints queue for garbage collection.
+                    */
+                    if(ITRC_Ord_Checkpoint_Check(recvd_ord) && (Type == CC_TYPE))
+                    {
+                        stddll_push_back(&ord_queue, &recvd_ord); // MK: Why do we need to do this here?
+                        checkpoint_req = PKT_Construct_Create_Checkpoint_Msg(recvd_ord, progress);
+                        nBytes = sizeof(signed_message) + checkpoint_req->len;
+                        IPC_Send(ns.ipc_s, (void *)checkpoint_req, nBytes, ns.ipc_remote);
+                        free(checkpoint_req);
+                    }
+                    else if (ITRC_Ord_Checkpoint_Check(recvd_ord) && (Type == DC_TYPE))
+                    {
+                        // update applied ord, otherwise checkpoints will not be checked correctly
+                        // memcpy($applied_ord, $recvd_ord, sizeof(ordinal));
 
-                    // MK: check the checkpoints queue
-                    ITRC_Check_CHECKPOINT(recvd_ord, &ns);
+                        // MK: check the checkpoints queue
+                        ITRC_Check_CHECKPOINT(recvd_ord, &ns);
+                    }
                 }
 
             }
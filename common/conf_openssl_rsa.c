@@ -98,6 +98,17 @@ unsigned char enc_key[32]; // = (unsigned char *)"012345678901234567890123456789
 */
 unsigned char iv_key[32]; //= (unsigned char *)"10987654321098765432109876543210";
 
+/*
+    MK: Contexts used for encrypting/decrypting, kept per thread and keyed
+        once, so each message only pays for setting its IV. enc_key_version
+        changes whenever the keys are (re)read.
+*/
+static int32u enc_key_version;
+static _Thread_local EVP_CIPHER_CTX *enc_ctx, *dec_ctx;
+static _Thread_local int32u enc_ctx_version, dec_ctx_version;
+static _Thread_local HMAC_CTX *iv_hctx;
+static _Thread_local int32u iv_hctx_version;
+
 
 void Gen_Key_Callback(int32 stage, int32 n, void *unused) 
 {
@@ -337,6 +348,8 @@ void OPENSSL_RSA_Read_Encrypt_Keys( const char *keys_dir )
   fclose(f1);
   fclose(f2);
 
+  /* Cached cipher and HMAC contexts pick up the new keys on next use */
+  enc_key_version++;
 }
 
 /* Read all of the keys for servers or clients. All of the public keys
@@ -585,8 +598,42 @@ int OPENSSL_RSA_Verify( const unsigned char *message, size_t message_length,
 
 
 /*
-  The following code is adapted from OpenSSL documentation.
-  (source: https://wiki.openssl.org/index.php/EVP_Symmetric_Encryption_and_Decryption)
+  Returns this thread's AES-256-GCM context for encrypting (encrypt = 1) or
+  decrypting (encrypt = 0), creating it and loading enc_key when needed.
+  The context keeps the expanded key between calls; callers only set the IV.
+*/
+static EVP_CIPHER_CTX *Get_Cipher_Ctx(int encrypt)
+{
+    EVP_CIPHER_CTX **ctx;
+    int32u *version;
+
+    ctx     = encrypt ? &enc_ctx : &dec_ctx;
+    version = encrypt ? &enc_ctx_version : &dec_ctx_version;
+
+    if(*ctx != NULL && *version == enc_key_version)
+      return *ctx;
+
+    if(*ctx == NULL && !(*ctx = EVP_CIPHER_CTX_new()))
+      return NULL;
+
+    if(1 != EVP_CipherInit_ex(*ctx, EVP_aes_256_gcm(), NULL, NULL, NULL, encrypt) ||
+       1 != EVP_CIPHER_CTX_ctrl(*ctx, EVP_CTRL_GCM_SET_IVLEN, DIGEST_SIZE_IV, NULL) ||
+       1 != EVP_CipherInit_ex(*ctx, NULL, NULL, enc_key, NULL, encrypt))
+    {
+      EVP_CIPHER_CTX_free(*ctx);
+      *ctx = NULL;
+      return NULL;
+    }
+
+    *version = enc_key_version;
+    return *ctx;
+}
+
+/*
+  Encrypts plaintext with AES-256-GCM under enc_key and the given
+  DIGEST_SIZE_IV byte IV. The ciphertext is the same length as the
+  plaintext and is followed by an ENC_TAG_SIZE byte authentication tag.
+  Returns the number of bytes written to ciphertext, or -1 on error.
 */
 int OPENSSL_RSA_Encrypt(char *plaintext, int plaintext_len,
             unsigned char *iv, char *ciphertext)
@@ -597,60 +644,44 @@ int OPENSSL_RSA_Encrypt(char *plaintext, int plaintext_len,
 
     int ciphertext_len;
 
-    /* Create and initialise the context */
-    if(!(ctx = EVP_CIPHER_CTX_new()))
+    if(!(ctx = Get_Cipher_Ctx(1)) ||
+       1 != EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, iv))
     {
-      printf("OPENSSL_RSA_Encrypt: failed!");
+      printf("OPENSSL_RSA_Encrypt: failed!\n");
       return -1;
     }
 
-    /*
-     * Initialise the encryption operation. IMPORTANT - ensure you use a key
-     * and IV size appropriate for your cipher
-     * In this example we are using 256 bit AES (i.e. a 256 bit key). The
-     * IV size for *most* modes is the same as the block size. For AES this
-     * is 128 bits
-     */
-    if(1 != EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, enc_key, iv))
+    if(1 != EVP_EncryptUpdate(ctx, (unsigned char *)ciphertext, &len,
+                              (unsigned char *)plaintext, plaintext_len))
     {
-      printf("OPENSSL_RSA_Encrypt: failed!");
+      printf("OPENSSL_RSA_Encrypt: failed!\n");
       return -1;
     }
 
+    ciphertext_len = len;
 
-    /*
-     * Provide the message to be encrypted, and obtain the encrypted output.
-     * EVP_EncryptUpdate can be called multiple times if necessary
-     */
-    if(1 != EVP_EncryptUpdate(ctx, ciphertext, &len, plaintext, plaintext_len))
+    if(1 != EVP_EncryptFinal_ex(ctx, (unsigned char *)ciphertext + len, &len))
     {
-      printf("OPENSSL_RSA_Encrypt: failed!");
+      printf("OPENSSL_RSA_Encrypt: failed!\n");
       return -1;
     }
 
-    ciphertext_len = len;
+    ciphertext_len += len;
 
-    /*
-     * Finalise the encryption. Further ciphertext bytes may be written at
-     * this stage.
-     */
-    if(1 != EVP_EncryptFinal_ex(ctx, ciphertext + len, &len))
+    if(1 != EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, ENC_TAG_SIZE,
+                                ciphertext + ciphertext_len))
     {
-      printf("OPENSSL_RSA_Encrypt: failed!");
+      printf("OPENSSL_RSA_Encrypt: failed!\n");
       return -1;
     }
 
-    ciphertext_len += len;
-
-    /* Clean up */
-    EVP_CIPHER_CTX_free(ctx);
-
-    return ciphertext_len;
+    return ciphertext_len + ENC_TAG_SIZE;
 }
 
 /*
-  The following code is adapted from OpenSSL documentation.
-  (source: https://wiki.openssl.org/index.php/EVP_Symmetric_Encryption_and_Decryption)
+  Reverses OPENSSL_RSA_Encrypt. ciphertext_len includes the trailing tag.
+  Returns the plaintext length, or -1 if the ciphertext was modified, was
+  sealed under a different key, or cannot be decrypted.
 */
 int OPENSSL_RSA_Decrypt(char *ciphertext, int ciphertext_len,
             unsigned char *iv, char *plaintext)
@@ -661,54 +692,44 @@ int OPENSSL_RSA_Decrypt(char *ciphertext, int ciphertext_len,
 
     int plaintext_len;
 
-    /* Create and initialise the context */
-    if(!(ctx = EVP_CIPHER_CTX_new()))
+    if(ciphertext_len < ENC_TAG_SIZE)
     {
-      printf("OPENSSL_RSA_Decrypt: failed!");
+      printf("OPENSSL_RSA_Decrypt: ciphertext too short!\n");
       return -1;
     }
+    ciphertext_len -= ENC_TAG_SIZE;
 
-
-    /*
-     * Initialise the decryption operation. IMPORTANT - ensure you use a key
-     * and IV size appropriate for your cipher
-     * In this example we are using 256 bit AES (i.e. a 256 bit key). The
-     * IV size for *most* modes is the same as the block size. For AES this
-     * is 128 bits
-     */
-    if(1 != EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, enc_key, iv))
+    if(!(ctx = Get_Cipher_Ctx(0)) ||
+       1 != EVP_DecryptInit_ex(ctx, NULL, NULL, NULL, iv))
     {
-      printf("OPENSSL_RSA_Decrypt: failed!");
+      printf("OPENSSL_RSA_Decrypt: failed!\n");
       return -1;
     }
 
-
-    /*
-     * Provide the message to be decrypted, and obtain the plaintext output.
-     * EVP_DecryptUpdate can be called multiple times if necessary.
-     */
-    if(1 != EVP_DecryptUpdate(ctx, plaintext, &len, ciphertext, ciphertext_len))
+    if(1 != EVP_DecryptUpdate(ctx, (unsigned char *)plaintext, &len,
+                              (unsigned char *)ciphertext, ciphertext_len))
     {
-      printf("OPENSSL_RSA_Decrypt: failed!");
+      printf("OPENSSL_RSA_Decrypt: failed!\n");
       return -1;
     }
 
     plaintext_len = len;
 
-    /*
-     * Finalise the decryption. Further plaintext bytes may be written at
-     * this stage.
-     */
-    if(1 != EVP_DecryptFinal_ex(ctx, plaintext + len, &len))
+    if(1 != EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, ENC_TAG_SIZE,
+                                ciphertext + ciphertext_len))
     {
-      printf("OPENSSL_RSA_Decrypt: failed!");
+      printf("OPENSSL_RSA_Decrypt: failed!\n");
       return -1;
     }
 
-    plaintext_len += len;
+    /* Fails if the tag does not match */
+    if(1 != EVP_DecryptFinal_ex(ctx, (unsigned char *)plaintext + len, &len))
+    {
+      printf("OPENSSL_RSA_Decrypt: authentication failed!\n");
+      return -1;
+    }
 
-    /* Clean up */
-    EVP_CIPHER_CTX_free(ctx);
+    plaintext_len += len;
 
     return plaintext_len;
 }
@@ -716,19 +737,25 @@ int OPENSSL_RSA_Decrypt(char *ciphertext, int ciphertext_len,
 int OPENSSL_RSA_IV(unsigned char* buffer, int buffer_size, unsigned char* iv)
 {
     
-    HMAC_CTX *hctx;
     int32u md_len2;
     unsigned char md2[EVP_MAX_MD_SIZE];
 
     memset(&md2, 0, EVP_MAX_MD_SIZE);
 
-    //HMAC_CTX_init(hctx); // deprecated 1.0.2
-    hctx = HMAC_CTX_new(); 
-    HMAC_Init_ex(hctx, iv_key, 32, message_digest_hmac, NULL);
-    HMAC_Update(hctx, buffer, buffer_size);
-    HMAC_Final(hctx, md2, &md_len2);
-    //HMAC_CTX_cleanup(hctx); // deprecated 1.0.2
-    HMAC_CTX_free(hctx);
+    /* The HMAC context is keyed with iv_key once per thread; passing a NULL
+     * key afterwards reuses it. */
+    if(iv_hctx == NULL || iv_hctx_version != enc_key_version) {
+      if(iv_hctx == NULL && (iv_hctx = HMAC_CTX_new()) == NULL)
+        return -1;
+      if(!HMAC_Init_ex(iv_hctx, iv_key, 32, message_digest_hmac, NULL))
+        return -1;
+      iv_hctx_version = enc_key_version;
+    }
+    else if(!HMAC_Init_ex(iv_hctx, NULL, 0, NULL, NULL))
+      return -1;
+
+    HMAC_Update(iv_hctx, buffer, buffer_size);
+    HMAC_Final(iv_hctx, md2, &md_len2);
 
     /* Check to determine if the digest length is expected for md5. It should
      * be 16 bytes. */
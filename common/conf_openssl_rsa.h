@@ -57,6 +57,7 @@
 
 /* Public definitions */
 #define DIGEST_SIZE_IV     16
+#define ENC_TAG_SIZE       16  /* GCM tag appended to encrypted payloads */
 #define RSA_CLIENT         1
 #define RSA_SERVER         2
 
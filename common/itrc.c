@@ -363,11 +363,12 @@ void *ITRC_Client(void *data)
                         continue;
                 }
 
+                /* The update is sized to the client message it carries */
                 ps = (seq_pair *)&buff[sizeof(signed_message)];
                 mess = PKT_Construct_Signed_Message(sizeof(signed_update_message) 
                             - sizeof(signed_message));
                 mess->machine_id = Prime_Client_ID;
-                mess->len = sizeof(signed_update_message) - sizeof(signed_message);
+                mess->len = sizeof(update_message) + nBytes;
                 mess->type = UPDATE;
                 mess->incarnation = ps->incarnation;
                 mess->global_configuration_number=My_Global_Configuration_Number;
@@ -391,9 +392,9 @@ void *ITRC_Client(void *data)
                     //printf("dest port=%d, dest addr=%s\n",SM_EXT_BASE_PORT + Curr_CC_Replicas[i-1],Curr_Ext_Site_Addrs[Curr_CC_Sites[i-1]]);
                     //dest.sin_port = htons(SM_EXT_BASE_PORT + CC_Replicas[i-1]);
                     //dest.sin_addr.s_addr = inet_addr(Ext_Site_Addrs[CC_Sites[i-1]]);
-                    ret = spines_sendto(ns.sp_ext_s, mess, sizeof(signed_update_message),
+                    ret = spines_sendto(ns.sp_ext_s, mess, sizeof(signed_message) + mess->len,
                             0, (struct sockaddr *)&dest, sizeof(struct sockaddr));
-                    if(ret != sizeof(signed_update_message)) {
+                    if(ret != (int)(sizeof(signed_message) + mess->len)) {
                         printf("*******ITRC_Client: spines_sendto error!\n");
                         spines_close(ns.sp_ext_s);
                         FD_CLR(ns.sp_ext_s, &mask);
@@ -693,7 +694,7 @@ void *ITRC_Prime_Inject(void *data)
                 mess = PKT_Construct_Signed_Message(sizeof(signed_update_message) 
                             - sizeof(signed_message));
                 mess->machine_id = My_ID;
-                mess->len = sizeof(signed_update_message) - sizeof(signed_message);
+                mess->len = sizeof(update_message) + sizeof(signed_message);
                 mess->type = UPDATE;
                 up = (update_message *)(mess + 1);
                 up->server_id = My_ID;
@@ -821,6 +822,7 @@ void *ITRC_Master(void *data)
     ordinal ord_save;
     int32u recvd_first_ordinal;
     struct timeval spines_timeout, *t;
+    int prime_len, prime_off;
 
     // Trying to ignore SIGPIP error
     //signal(SIGPIPE, SIG_IGN);
@@ -963,125 +965,139 @@ void *ITRC_Master(void *data)
                     FD_CLR(prime_sock, &mask);
                     exit(EXIT_FAILURE);
                 }
-                mess = (signed_message *)buff;
-                res = (client_response_message *)(mess + 1);
-                scada_mess = (signed_message *)(res + 1);
-
-                // REMOVE THIS - just for checking
-                //continue;
-                //MS2022 - Comment this print in actual runs
-                //struct timeval prime_t;
-                //gettimeofday(&prime_t,NULL);
-                //printf("Received message of type %d from prime_sock at %lu, %lu\n",mess->type,prime_t.tv_sec,prime_t.tv_usec);
-                //printf("Prime [%d]: %d of %d\n", res->ord_num, res->event_idx, res->event_tot);
-
-                /* Check for valid message type */
-                /* We don't validate messages from Prime at this level, since
-                 * even if the content of the message is invalid (and we don't
-                 * want to apply it), we still want to advance our received
-                 * Prime ordinal correctly. Instead, we'll do this in
-                 * Process_Prime_Ordinal and treat it as no-op if it turns out
-                 * to be invalid. Note that we should be checking that the
-                 * signed_message and client_response headers are valid before
-                 * getting to this point though. */
-                /*if (!ITRC_Valid_Type(scada_mess, FROM_PRIME)) {
-                    printf("ITRC_Master: Invalid message from Prime, type = %d\n", scada_mess->type);
-                    continue;
-                }*/
+                /* Prime delivers the events of an ordinal back-to-back in
+                 * one datagram (see CLIENT_RESPONSE_BATCH_BYTES in Prime),
+                 * so walk each client response in what we received */
+                prime_len = nBytes;
+                prime_off = 0;
+                while (prime_off + (int)sizeof(signed_message) <= prime_len) {
+                    mess = (signed_message *)(buff + prime_off);
+                    prime_off += sizeof(signed_message);
+                    if (mess->len > (int32u)(prime_len - prime_off)) {
+                        printf("ITRC_Master: Truncated message from Prime, len = %u\n", mess->len);
+                        break;
+                    }
+                    prime_off += mess->len;
+                    res = (client_response_message *)(mess + 1);
+                    scada_mess = (signed_message *)(res + 1);
+
+                    // REMOVE THIS - just for checking
+                    //continue;
+                    //MS2022 - Comment this print in actual runs
+                    //struct timeval prime_t;
+                    //gettimeofday(&prime_t,NULL);
+                    //printf("Received message of type %d from prime_sock at %lu, %lu\n",mess->type,prime_t.tv_sec,prime_t.tv_usec);
+                    //printf("Prime [%d]: %d of %d\n", res->ord_num, res->event_idx, res->event_tot);
+
+                    /* Check for valid message type */
+                    /* We don't validate messages from Prime at this level, since
+                     * even if the content of the message is invalid (and we don't
+                     * want to apply it), we still want to advance our received
+                     * Prime ordinal correctly. Instead, we'll do this in
+                     * Process_Prime_Ordinal and treat it as no-op if it turns out
+                     * to be invalid. Note that we should be checking that the
+                     * signed_message and client_response headers are valid before
+                     * getting to this point though. */
+                    /*if (!ITRC_Valid_Type(scada_mess, FROM_PRIME)) {
+                        printf("ITRC_Master: Invalid message from Prime, type = %d\n", scada_mess->type);
+                        continue;
+                    }*/
                 
-                /* Grab the ordinal information */
-                ord_save.ord_num   = res->ord_num;
-                ord_save.event_idx = res->event_idx;
-                ord_save.event_tot = res->event_tot;
-
-                /* Check if we received a SYSTEM RESET message from Prime, which occurs on
-                 * the initial startup or when system assumptions are violated */
-                if (scada_mess->type == PRIME_SYSTEM_RESET) {
-                    assert(ord_save.ord_num == 0);
-
-                    printf("Processed PRIME_SYSTEM_RESET @ ITRC\n");
-                    struct timeval reset_t;
-                    gettimeofday(&reset_t,NULL);
-                    //printf("MS2022:*****Processing prime system reset received at %lu   %lu \n",reset_t.tv_sec,reset_t.tv_usec);
-                    /* Reset data structures */
-                    ITRC_Reset_Master_Data_Structures(0);
-
-                    /* Send the SYSTEM RESET message to the Scada Master */
-                    scada_mess = PKT_Construct_Signed_Message(0);
-                    scada_mess->machine_id = My_ID;
-                    scada_mess->len = 0;
-                    scada_mess->type = SYSTEM_RESET;
-                    IPC_Send(ns.ipc_s, (void *)scada_mess, sizeof(signed_message), ns.ipc_remote);
-                    continue;
-                }
-                /* Check if we received a SYSTEM RECONF message from Prime, which occurs on
-                 * the initial startup or when system is reconfigured */
-                if (scada_mess->type == PRIME_SYSTEM_RECONF) {
-                    assert(ord_save.ord_num == 0);
-
-                    printf("Processed PRIME_SYSTEM_RECONF @ ITRC\n");
-                    struct timeval reset_t;
-                    gettimeofday(&reset_t,NULL);
-                    //printf("MS2022:*****Processing prime system reconf received at %lu   %lu \n",reset_t.tv_sec,reset_t.tv_usec);
-                    /* Reset data structures */
-                    ITRC_Reset_Master_Data_Structures(0);
-
-                    /* Send the SYSTEM RESET message to the Scada Master */
-                    scada_mess = PKT_Construct_Signed_Message(0);
-                    scada_mess->machine_id = My_ID;
-                    scada_mess->len = 0;
-                    scada_mess->type = SYSTEM_RESET;
-                    IPC_Send(ns.ipc_s, (void *)scada_mess, sizeof(signed_message), ns.ipc_remote);
-                    continue;
-                }
+                    /* Grab the ordinal information */
+                    ord_save.ord_num   = res->ord_num;
+                    ord_save.event_idx = res->event_idx;
+                    ord_save.event_tot = res->event_tot;
+
+                    /* Check if we received a SYSTEM RESET message from Prime, which occurs on
+                     * the initial startup or when system assumptions are violated */
+                    if (scada_mess->type == PRIME_SYSTEM_RESET) {
+                        assert(ord_save.ord_num == 0);
+
+                        printf("Processed PRIME_SYSTEM_RESET @ ITRC\n");
+                        struct timeval reset_t;
+                        gettimeofday(&reset_t,NULL);
+                        //printf("MS2022:*****Processing prime system reset received at %lu   %lu \n",reset_t.tv_sec,reset_t.tv_usec);
+                        /* Reset data structures */
+                        ITRC_Reset_Master_Data_Structures(0);
+
+                        /* Send the SYSTEM RESET message to the Scada Master */
+                        scada_mess = PKT_Construct_Signed_Message(0);
+                        scada_mess->machine_id = My_ID;
+                        scada_mess->len = 0;
+                        scada_mess->type = SYSTEM_RESET;
+                        IPC_Send(ns.ipc_s, (void *)scada_mess, sizeof(signed_message), ns.ipc_remote);
+                        continue;
+                    }
+                    /* Check if we received a SYSTEM RECONF message from Prime, which occurs on
+                     * the initial startup or when system is reconfigured */
+                    if (scada_mess->type == PRIME_SYSTEM_RECONF) {
+                        assert(ord_save.ord_num == 0);
+
+                        printf("Processed PRIME_SYSTEM_RECONF @ ITRC\n");
+                        struct timeval reset_t;
+                        gettimeofday(&reset_t,NULL);
+                        //printf("MS2022:*****Processing prime system reconf received at %lu   %lu \n",reset_t.tv_sec,reset_t.tv_usec);
+                        /* Reset data structures */
+                        ITRC_Reset_Master_Data_Structures(0);
+
+                        /* Send the SYSTEM RESET message to the Scada Master */
+                        scada_mess = PKT_Construct_Signed_Message(0);
+                        scada_mess->machine_id = My_ID;
+                        scada_mess->len = 0;
+                        scada_mess->type = SYSTEM_RESET;
+                        IPC_Send(ns.ipc_s, (void *)scada_mess, sizeof(signed_message), ns.ipc_remote);
+                        continue;
+                    }
 
-                /* If this is the first ordinal you get from Prime and its further ahead than
-                 * you were expecting, request a state transfer */
-                if (recvd_first_ordinal == 0 && !ITRC_Ord_Consec(recvd_ord, ord_save)) {
-                    IPC_Send(ns.inject_s, (void *)&ns.inject_s, sizeof(ns.inject_s), ns.inject_path);
-                }
-                recvd_first_ordinal = 1;
+                    /* If this is the first ordinal you get from Prime and its further ahead than
+                     * you were expecting, request a state transfer */
+                    if (recvd_first_ordinal == 0 && !ITRC_Ord_Consec(recvd_ord, ord_save)) {
+                        IPC_Send(ns.inject_s, (void *)&ns.inject_s, sizeof(ns.inject_s), ns.inject_path);
+                    }
+                    recvd_first_ordinal = 1;
 
-                /* Check if duplicate/old ordinal coming from Prime. Maybe all of Prime was 
-                 * restarted from ordinal 1 - if so, we need to restart this to sync back up 
-                 * and accept the restarted Prime ordinals */
-                if (ITRC_Ord_Compare(ord_save, recvd_ord) <= 0) {
-                    printf("ITRC_Master: Old Prime ordinal - did Prime start from scratch?\n");
-                    continue;
-                }
+                    /* Check if duplicate/old ordinal coming from Prime. Maybe all of Prime was 
+                     * restarted from ordinal 1 - if so, we need to restart this to sync back up 
+                     * and accept the restarted Prime ordinals */
+                    if (ITRC_Ord_Compare(ord_save, recvd_ord) <= 0) {
+                        printf("ITRC_Master: Old Prime ordinal - did Prime start from scratch?\n");
+                        continue;
+                    }
                 
-                ITRC_Process_Prime_Ordinal(ord_save, mess, &ns);
-                if (ns.sp_ext_s == -1) {
-                       //printf("Sahiti*****: t set to spines timeout\n");
-			t = &spines_timeout;
-                }
+                    ITRC_Process_Prime_Ordinal(ord_save, mess, &ns);
+                    if (ns.sp_ext_s == -1) {
+                           //printf("Sahiti*****: t set to spines timeout\n");
+    			t = &spines_timeout;
+                    }
 
-                /* If we completed a state transfer from this ordinal, see if there are any
-                 * pending updates that can now be applied */
-                if (completed_transfer == 1) {
-                    assert(collecting_signal == 0);
-                    completed_transfer = 0;
-
-                    /* Replay any queued pending messages now that we're done collecting anything */
-                    for (stddll_begin(&pending_updates, &it); !stddll_is_end(&pending_updates, &it) && !collecting_signal;) {
-                        mess = *(signed_message **)stdit_val(&it);
-                        res = (client_response_message *)(mess + 1);
-                        scada_mess = (signed_message *)(res + 1);
+                    /* If we completed a state transfer from this ordinal, see if there are any
+                     * pending updates that can now be applied */
+                    if (completed_transfer == 1) {
+                        assert(collecting_signal == 0);
+                        completed_transfer = 0;
+
+                        /* Replay any queued pending messages now that we're done collecting anything */
+                        for (stddll_begin(&pending_updates, &it); !stddll_is_end(&pending_updates, &it) && !collecting_signal;) {
+                            mess = *(signed_message **)stdit_val(&it);
+                            res = (client_response_message *)(mess + 1);
+                            scada_mess = (signed_message *)(res + 1);
     
-                        ord_save.ord_num   = res->ord_num;
-                        ord_save.event_idx = res->event_idx;
-                        ord_save.event_tot = res->event_tot;
+                            ord_save.ord_num   = res->ord_num;
+                            ord_save.event_idx = res->event_idx;
+                            ord_save.event_tot = res->event_tot;
                         
-                        if (ITRC_Ord_Compare(ord_save, recvd_ord) > 0)  {
-                            ITRC_Process_Prime_Ordinal(ord_save, mess, &ns);
-                            if (ns.sp_ext_s == -1) {
-                                t = &spines_timeout;
+                            if (ITRC_Ord_Compare(ord_save, recvd_ord) > 0)  {
+                                ITRC_Process_Prime_Ordinal(ord_save, mess, &ns);
+                                if (ns.sp_ext_s == -1) {
+                                    t = &spines_timeout;
+                                }
                             }
+                            free(mess);
+                            stddll_erase(&pending_updates, &it);
                         }
-                        free(mess);
-                        stddll_erase(&pending_updates, &it);
                     }
                 }
+
             }
 
             if (FD_ISSET(ns.ipc_config_s,&tmask)){
@@ -1517,9 +1533,16 @@ void ITRC_Process_Prime_Ordinal(ordinal o, signed_message *mess, net_sock *ns)
     }
 
     /* Validate the content of the message -- if it is not valid, we will treat
-     * it as a no-op */
+     * it as a no-op. Responses are sized to the update, so first make sure the
+     * whole SCADA message is actually present. */
     valid_content = 1;
-    if (!ITRC_Valid_Type(scada_mess, FROM_PRIME)) {
+    if (mess->len < sizeof(client_response_message) + sizeof(signed_message) ||
+        scada_mess->len > mess->len - sizeof(client_response_message) - sizeof(signed_message)) 
+    {
+        printf("ITRC_Process_Prime_Ordinal: Truncated message from Prime, len = %u\n", mess->len);
+        valid_content = 0;
+    }
+    else if (!ITRC_Valid_Type(scada_mess, FROM_PRIME)) {
         printf("ITRC_Process_Prime_Ordinal: Invalid message from Prime, type = %d\n", scada_mess->type);
         valid_content = 0;
     }
@@ -2374,7 +2397,8 @@ void *ITRC_CC_Connector(void *data)
 	    /* Message from IPC Client */
             if (FD_ISSET(ns.ipc_s, &tmask)) {
                 nBytes = IPC_Recv(ns.ipc_s, buff, MAX_LEN);
-                if (nBytes != sizeof(signed_update_message)) {
+                if (nBytes < (int)(sizeof(signed_message) + sizeof(update_message)) ||
+                    nBytes > (int)sizeof(signed_update_message)) {
                     printf("ITRC_CC_Connector: error! signed update message size is not as expected %d\n", nBytes);
                     continue;
                 }
@@ -2388,9 +2412,9 @@ void *ITRC_CC_Connector(void *data)
                     dest.sin_family = AF_INET;
                     dest.sin_port = htons(SM_EXT_BASE_PORT + CC_Replicas[i-1]);
                     dest.sin_addr.s_addr = inet_addr(Ext_Site_Addrs[CC_Sites[i-1]]);
-                    ret = spines_sendto(ns.sp_ext_s, buff, sizeof(signed_update_message),
+                    ret = spines_sendto(ns.sp_ext_s, buff, nBytes,
                             0, (struct sockaddr *)&dest, sizeof(struct sockaddr));
-                    if (ret != sizeof(signed_update_message)) {
+                    if (ret != nBytes) {
                         printf("ITRC_CC_Connector: spines_sendto error!\n");
                         spines_close(ns.sp_ext_s);
                         FD_CLR(ns.sp_ext_s, &mask);
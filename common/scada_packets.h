@@ -211,6 +211,8 @@ typedef struct dummy_update_message {
     /* the update content follows */
 } update_message;
 
+/* header.len is sizeof(update_message) plus the bytes of the client message
+ * actually carried, up to UPDATE_SIZE; this struct is the largest update */
 typedef struct dummy_signed_update_message {
     signed_message header;
     update_message update;
@@ -97,6 +97,23 @@
 /* Number of outstanding PO_requests that have not yet been executed */
 #define MAX_PO_IN_FLIGHT 20
 
+/* Recent ord_slots and po_slots are indexed by sequence number in rings of
+ * this many entries (must be powers of two) in front of the History hash
+ * tables. The ORD window must cover 2*CATCHUP_HISTORY plus the ordinals in
+ * progress; slots that fall outside a window are still found in the hash. */
+#define ORD_HISTORY_WINDOW 256
+#define PO_HISTORY_WINDOW  128
+
+/* Updates this replica introduces are timestamped at each stage of the
+ * pipeline (see trace.h). Stages are matched up through rings of this
+ * many recent PO-Requests and ordinals (must be a power of two). */
+#define TRACE_UPDATES    1
+#define TRACE_RING_SIZE  1024
+
+/* Per-stage latency histograms: <64us, 64-128us, ... (doubling) */
+#define TRACE_HIST_BUCKETS    12
+#define TRACE_HIST_BASE_USEC  64
+
 /* How often to print that Prime is making progress - based on number of
  * ordinals that have been ordered */
 #define PRINT_PROGRESS 1000
@@ -127,6 +144,12 @@
 #define REPLICA_IPC_PATH "/tmp/prime_replica"
 #define CLIENT_IPC_PATH "/tmp/prime_client"
 #define CA_DRIVER_IPC_PATH "/tmp/ca_driver_ipc"
+
+/* Client responses for the events of one ordinal are packed back-to-back
+ * into sends of at most this many bytes (0 sends each one separately).
+ * Must fit the client's receive buffer: MAX_LEN in the SCADA itrc and
+ * PRIME_MAX_PACKET_SIZE in the benchmark client. */
+#define CLIENT_RESPONSE_BATCH_BYTES 8192
 /* Set this to 1 if Prime daemon and Spines daemon it connects to are
  * co-located on the same physical machine */
 #define USE_SPINES_IPC 1
@@ -166,20 +189,47 @@
  * outgoing messages, each server maintains a linked lists of messages
  * that are awaiting a signature.  The server generates a single RSA
  * signature on a batch of messages (i.e., those in the list) when one
- * of two conditions occurs: (1) Enough time passes in which no
- * messages are added to the list; (2) the size of the list reaches a
- * threshold value.  SIG_SEC and SIG_USEC are the seconds and
- * microseconds of the timeout, and SIG_THRESHOLD is the threshold
- * value. */
-/*#define SIG_SEC  0
-#define SIG_USEC 1000
-#define SIG_THRESHOLD  128 */
-
-#define SIG_MIN_SEC  0
-#define SIG_MIN_USEC 1000
-#define SIG_MAX_SEC  0
-#define SIG_MAX_USEC 5000
-#define SIG_THRESHOLD 64
+ * of three conditions occurs: (1) No further message is expected
+ * soon enough to be worth waiting for; (2) the oldest deadline of a
+ * message in the list expires; (3) the size of the list reaches the
+ * current batch threshold.
+ *
+ * The wait in (1) and the threshold in (3) are adapted at runtime
+ * from moving averages of the message inter-arrival time and of the
+ * cost of signing a batch: under light load a message is signed as
+ * soon as the current event is handled, and under heavy load batches
+ * are closed at about the size needed for signing to keep up.
+ * SIG_TIMELY_TARGET_USEC and SIG_BOUNDED_TARGET_USEC bound how long a
+ * message of each traffic class may wait for company (recon traffic
+ * uses the bounded target); both can be overridden with -w.
+ * SIG_THRESHOLD is the largest batch ever made. */
+#define SIG_TIMELY_TARGET_USEC   1000
+#define SIG_BOUNDED_TARGET_USEC  5000
+#define SIG_MIN_THRESHOLD        8
+#define SIG_THRESHOLD            64
+
+/* Weight of a new sample in the arrival and signing cost averages, how
+ * many expected inter-arrival gaps to wait for the next message, and
+ * how many times the signing cost's worth of arrivals a batch may hold
+ * before it is closed early. */
+#define SIG_EWMA_WEIGHT          0.125
+#define SIG_PUSHBACK_GAPS        2
+#define SIG_LOAD_FACTOR          2
+
+/* Batch sizes and per-class wait times are kept in log2 histograms:
+ * batch sizes 1, 2-3, 4-7, ... and waits <64us, 64-128us, ...
+ * If the stats period is non-zero (-s), they are printed periodically. */
+#define SIG_HIST_BUCKETS         8
+#define SIG_HIST_WAIT_BASE_USEC  64
+
+/* Set this to 1 to sign batches on a separate thread when more than one
+ * CPU is online: the event loop keeps reading and batching while a
+ * signature is computed, and signed batches are sent in the order they
+ * were closed. At most SIG_MAX_OUTSTANDING batches are handed to the
+ * signing thread at once; closing another one waits for the oldest to
+ * be sent. */
+#define SIG_ASYNC_SIGNING        1
+#define SIG_MAX_OUTSTANDING      4
 
 /* This is the maximum number of Merkle tree digests that may be
  * appended to a given message.  This value is dependent on
@@ -199,27 +249,20 @@
 /* These values define the maximum outgoing bandwidth of each traffic
  * class when throttling is used.  The number are in bits per second
  * (e.g., 10000000 means the outgoing bandwidth is not to exceed
- * 10Mbps). Note that in the current release, RECON messages are
- * always throttled, regardless of whether the
- * THROTTLE_OUTGOING_MESSAGES flag is set. */
+ * 10Mbps). Each destination server has its own queue and token bucket
+ * per traffic class, refilled at an equal share of the class bandwidth,
+ * so a slow destination does not hold up messages to the others. Note
+ * that in the current release, RECON messages are always throttled,
+ * regardless of whether the THROTTLE_OUTGOING_MESSAGES flag is set. */
 #define MAX_OUTGOING_BANDWIDTH_TIMELY  100000000
 #define MAX_OUTGOING_BANDWIDTH_BOUNDED 100000000
 #define MAX_OUTGOING_BANDWIDTH_RECON   10000000
 
-/* This defines the maximum burst size for the token bucket. */
+/* This defines the maximum burst size for each destination's token
+ * bucket.  Queued messages are sent as soon as their bucket can pay
+ * for them; there is no polling interval. */
 #define MAX_TOKENS 900000
 
-/* These can be used to control how frequently the throttling function
- * is called (i.e., how often we check to see if we can send new
- * messsages). */
-#define THROTTLE_SEND_SEC  0
-#define THROTTLE_SEND_USEC 1000
-
-/* When throttling, we can choose to send broadcast messages out to servers
- * in order, or we can send them in a random order.  Set this to 1 to 
- * enable the randomization. */
-#define RANDOMIZE_SENDING 0
-
 /*-----------------------Periodic Sending Settings--------------------------*/
 
 /* Certain messages can be configured to be sent periodically rather than 
@@ -231,6 +274,19 @@
 //#define PRE_PREPARE_SEC  2
 //#define PRE_PREPARE_USEC 0
 
+/* If PRE_PREPARE_EVENT_DRIVEN is set, the leader also sends a Pre-Prepare
+ * as soon as a PO-ARU makes new requests eligible for ordering, and the
+ * timer above only bounds how long it can go without one (which is what
+ * suspect-leader monitoring allows for). Early Pre-Prepares are spaced at
+ * least PRE_PREPARE_MIN_GAP_USEC apart and are held back while
+ * PRE_PREPARE_MAX_OUTSTANDING of them have not been executed yet.
+ * It lowers latency at light load, but each early Pre-Prepare is an extra
+ * ordinal to sign and verify, so it raises latency when the replicas are
+ * CPU-bound. Off by default. */
+#define PRE_PREPARE_EVENT_DRIVEN    0
+#define PRE_PREPARE_MIN_GAP_USEC    5000
+#define PRE_PREPARE_MAX_OUTSTANDING 2
+
 /* When sending PreOrder messages periodically, how often the timeout
  * fires (i.e, how often we check to see if we can send new
  * messages) */
@@ -382,6 +438,14 @@
  * packets for any protocol message */
 #define PRIME_MAX_PACKET_SIZE      32000
 //#define PRIME_MAX_PACKET_SIZE      1472
+
+/* Messages that are kept after they are received (PO-Acks, Prepares,
+ * Commits, ...) are copied into the smallest of these size classes that
+ * fits, so that each one does not pin a PRIME_MAX_PACKET_SIZE body.
+ * Larger messages are kept in a full packet body. */
+#define MSG_SMALL_SIZE             512
+#define MSG_MEDIUM_SIZE            2048
+#define MSG_LARGE_SIZE             8192
 //#define NUM_SERVER_SLOTS           (NUM_SERVERS+1)
 #define NUM_CLIENT_SLOTS           (NUM_CLIENTS+1)
 
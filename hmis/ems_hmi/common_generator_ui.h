@@ -44,6 +44,7 @@
  *
  */
 #include "master_exec.h"
+#include "widget_cache.h"
 
 extern "C" {
 #include "scada_packets.h"
@@ -61,7 +62,7 @@ static int common_slotNullEvent(PARAM *p, DATA *data, const int pp_id)
     data_model *model;
     generator_info *gen;
     generator_ui_info *ui;
-    powerplant_info *pp_info = &data->dm->pp_arr[pp_id];
+    powerplant_info *pp_info = &data->view.pp_arr[pp_id];
 
     /* iteration variables */
     int gen_start = data->dm->pp_arr[pp_id].first_gen_id;
@@ -76,31 +77,30 @@ static int common_slotNullEvent(PARAM *p, DATA *data, const int pp_id)
 
 
     if(p == NULL || data == NULL) return -1;
-    if(data->dm->dirty) {
-        data->dm->dirty = 0;
-        model = data->dm;
+    if(Widget_Cache_Model_Changed(data)) {
+        model = &data->view;
         /* Reread the state and update the UI */
         for(int i = gen_start; i < gen_stop; ++i) {
             gen = &pp_info->gen_arr[i];
             ui = &gen->ui;
-            pvDisplayNum(p, ui->current, gen->current);
-            pvDisplayNum(p, ui->max, gen->max);
-            pvDisplayNum(p, ui->min, gen->target);
+            Show_Num(p, data, ui->current, gen->current);
+            Show_Num(p, data, ui->max, gen->max);
+            Show_Num(p, data, ui->min, gen->target);
             if (gen->current > 0) {
-                pvSetImage(p, ui->indicator, "red.png");
+                Show_Image(p, data, ui->indicator, "red.png");
             } else if (gen->max == 0) {
-                pvSetImage(p, ui->indicator, "black.png");
+                Show_Image(p, data, ui->indicator, "black.png");
             } else {
-                pvSetImage(p, ui->indicator, "green.png");
+                Show_Image(p, data, ui->indicator, "green.png");
             }
             total_target += gen->target;
             total_current += gen->current;
             total_maximum += gen->max;
         }
         /* Set the powerplant total stat displays */
-        pvDisplayNum(p, pp_info->pp_target, total_target);
-        pvDisplayNum(p, pp_info->pp_generation, total_current);
-        pvDisplayNum(p, pp_info->pp_maximum, total_maximum);
+        Show_Num(p, data, pp_info->pp_target, total_target);
+        Show_Num(p, data, pp_info->pp_generation, total_current);
+        Show_Num(p, data, pp_info->pp_maximum, total_maximum);
 
         total_target = 0;
         total_current = 0;
@@ -112,7 +112,7 @@ static int common_slotNullEvent(PARAM *p, DATA *data, const int pp_id)
                 pp = 1;
             }
 
-            gen = &data->dm->pp_arr[pp].gen_arr[i];
+            gen = &model->pp_arr[pp].gen_arr[i];
 
             if (i > 2 && renewable_active[i-3] == 0) {
                 continue;
@@ -122,9 +122,9 @@ static int common_slotNullEvent(PARAM *p, DATA *data, const int pp_id)
             total_current += gen->current;
         }
         /* Set the overall total stat displays */
-        pvDisplayNum(p, pp_info->overall_demand, model->current_demand);
-        pvDisplayNum(p, pp_info->overall_generation, total_current);
-        pvDisplayNum(p, pp_info->overall_target, total_target);
+        Show_Num(p, data, pp_info->overall_demand, model->current_demand);
+        Show_Num(p, data, pp_info->overall_generation, total_current);
+        Show_Num(p, data, pp_info->overall_target, total_target);
     }
     Advance_Demand(data);
     Record_History(data);
@@ -156,7 +156,6 @@ static int common_slotButtonPressedEvent(PARAM *p, int id, DATA *data,
     if(p == NULL || id == 0 || data == NULL) return -1;
 
     if (id == pp_info->home_button) {
-        data->dm->dirty = 1;
         return 1;
     }
 
@@ -164,8 +163,10 @@ static int common_slotButtonPressedEvent(PARAM *p, int id, DATA *data,
         if(id == pp_info->gen_arr[i].ui.activate) {
             // Fire the text event then set the flag to catch it and send a message
             pvText(p, pp_info->gen_arr[i].ui.target);
+            Model_Write_Begin();
             data->dm->send_text_id = pp_info->gen_arr[i].ui.target;
             data->dm->send_gen_id = i;
+            Model_Write_End();
         }
     }
 
@@ -173,7 +174,9 @@ static int common_slotButtonPressedEvent(PARAM *p, int id, DATA *data,
     for(int i = gen_start; i < gen_stop; ++i) {
         /* Find the generator that corresponds to the pressed button */
         if(id == pp_info->gen_arr[i].ui.deactivate) {
+            Model_Write_Begin();
             pp_info->gen_arr[i].target = 0;
+            Model_Write_End();
             send_SM_Message(0, i);
         }
     }
@@ -206,8 +209,10 @@ static int common_slotTextEvent(PARAM *p,
         send_SM_Message(new_target, data->dm->send_gen_id);
 
         /* Clear the flags */
+        Model_Write_Begin();
         data->dm->send_gen_id = -1;
         data->dm->send_text_id = -1;
+        Model_Write_End();
     }
     return 0;
 }
@@ -144,6 +144,8 @@ void itrc_init(int ac, char **av)
 
 void *master_connection(void *arg) 
 {
+    sp_time t;
+
     UNUSED(arg);
 
     E_init();
@@ -156,6 +158,10 @@ void *master_connection(void *arg)
     E_attach_fd(ipc_sock, READ_FD, Read_From_Master, 0, NULL, MEDIUM_PRIORITY);
     E_attach_fd(Script_Pipe[0], READ_FD, Execute_Script, 0, NULL, MEDIUM_PRIORITY);
 
+    t.sec  = EMS_DELAY_STATS_SEC;
+    t.usec = 0;
+    E_queue(Print_Update_Delay, 0, NULL, t);
+
     E_handle_events();
 
     /* while(1) {
@@ -58,6 +58,7 @@
 //extern rlPPIClient        ppi;
 
 #include "master_exec.h"
+#include "widget_cache.h"
 
 extern "C" {
 #include "scada_packets.h"
@@ -157,6 +158,7 @@ static int slotInit(PARAM *p, DATA *d)
     qpwSetCurvePen(p, Overview_graph, GENERATION_CURVE_ID, GREEN, 3, DashDotLine);
     qpwSetCurveYAxis(p, Overview_graph, GENERATION_CURVE_ID, yLeft);
     // qwt plot end --------------------------------------------------
+    Widget_Cache_Reset(d);
     return 0;
 }
 
@@ -174,30 +176,29 @@ static int slotNullEvent(PARAM *p, DATA *data)
 
     if(p == NULL || data == NULL) return -1;
 
-    if(data->dm->dirty) {
-        data->dm->dirty = 0;
-        model = data->dm;
+    if(Widget_Cache_Model_Changed(data)) {
+        model = &data->view;
         /* Reread the state and update the UI */
         for(int i = 0; i < EMS_NUM_GENERATORS; ++i) {
             gen = &model->pp_arr[pp_id].gen_arr[i];
             ui = &gen->ui;
             if (gen->current > 0) {
-                pvSetImage(p, ui->top_indicator, "red.png");
+                Show_Image(p, data, ui->top_indicator, "red.png");
             } else if (gen->max == 0) {
-                pvSetImage(p, ui->top_indicator, "black.png");
+                Show_Image(p, data, ui->top_indicator, "black.png");
             } else {
-                pvSetImage(p, ui->top_indicator, "green.png");
+                Show_Image(p, data, ui->top_indicator, "green.png");
             }
             if (i > 2 && renewable_active[i-3] == 0) {
-                pvDisplayNum(p, ui->top_current, 0);
-                pvSetImage(p, ui->top_indicator, "green.png");
+                Show_Num(p, data, ui->top_current, 0);
+                Show_Image(p, data, ui->top_indicator, "green.png");
                 continue;
             }
-            pvDisplayNum(p, ui->top_current, gen->current);
+            Show_Num(p, data, ui->top_current, gen->current);
 
             // If we hit the end of the first powerplant set its total and reset the total
-            if (i+1 == data->dm->pp_arr[1].first_gen_id) {
-                pvDisplayNum(p, PP1_Total_Generation_LCD, powerplant_generation);
+            if (i+1 == model->pp_arr[1].first_gen_id) {
+                Show_Num(p, data, PP1_Total_Generation_LCD, powerplant_generation);
                 powerplant_generation = 0;
                 pp_id = 1;
             }
@@ -206,9 +207,9 @@ static int slotNullEvent(PARAM *p, DATA *data)
             total_target += gen->target;
         }
         /* Update the totals */
-        pvDisplayNum(p, Current_Demand_LCD, model->current_demand);
-        pvDisplayNum(p, Current_Generation_LCD, total_generation);
-        pvDisplayNum(p, PP2_Total_Generation_LCD, powerplant_generation);
+        Show_Num(p, data, Current_Demand_LCD, model->current_demand);
+        Show_Num(p, data, Current_Generation_LCD, total_generation);
+        Show_Num(p, data, PP2_Total_Generation_LCD, powerplant_generation);
     }
     Advance_Demand(data);
     Record_History(data);
@@ -231,8 +232,6 @@ static int slotNullEvent(PARAM *p, DATA *data)
 static int slotButtonEvent(PARAM *p, int id, DATA *d)
 {
     if(p == NULL || id == 0 || d == NULL) return -1;
-    // Set the dirty flag so the next page updates itself when it loads
-    d->dm->dirty = 1;
     if(id == PP1_Detail_button) return 2;
     if(id == PP2_Detail_button) return 3;
     return 0;
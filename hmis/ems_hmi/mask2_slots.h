@@ -74,6 +74,8 @@ static int slotInit(PARAM *p, DATA *d)
     d->dm = &the_model;
     d->hm = &the_history_model;
 
+    /* The widget ids live in the shared model */
+    Model_Write_Begin();
     /* Generator 1 */
     d->dm->pp_arr[PP_ID].gen_arr[0].ui.current = PP1_T1_Current_LCD;
     d->dm->pp_arr[PP_ID].gen_arr[0].ui.max = PP1_T1_Max_LCD;
@@ -113,6 +115,7 @@ static int slotInit(PARAM *p, DATA *d)
     /* Misc UI Elements */
     d->dm->pp_arr[PP_ID].graph = PP1_graph;
     d->dm->pp_arr[PP_ID].home_button = PP1_Home_button;
+    Model_Write_End();
 
     // qwt plot begin ---------------------------------------------
     qpwSetCanvasBackground(p,PP1_graph,239,239,239);
@@ -148,6 +151,7 @@ static int slotInit(PARAM *p, DATA *d)
     qpwSetCurveYAxis(p, PP1_graph, 2, yLeft);
     // qwt plot end --------------------------------------------------
 
+    Widget_Cache_Reset(d);
     return 0;
 }
 
@@ -71,6 +71,8 @@ static int slotInit(PARAM *p, DATA *d)
     d->dm = &the_model;
     d->hm = &the_history_model;
 
+    /* The widget ids live in the shared model */
+    Model_Write_Begin();
     /* Generator 1 */
     d->dm->pp_arr[PP_ID].gen_arr[3].ui.current = PP2_T1_Current_LCD;
     d->dm->pp_arr[PP_ID].gen_arr[3].ui.max = PP2_T1_Max_LCD;
@@ -99,6 +101,7 @@ static int slotInit(PARAM *p, DATA *d)
     /* Misc UI Elements */
     d->dm->pp_arr[PP_ID].graph = PP2_graph;
     d->dm->pp_arr[PP_ID].home_button = PP2_Home_button;
+    Model_Write_End();
 
     // qwt plot begin ---------------------------------------------
     // TODO what are the 239s?
@@ -137,6 +140,7 @@ static int slotInit(PARAM *p, DATA *d)
     qpwSetCurveYAxis(p, PP2_graph, 2, yLeft);
     // qwt plot end --------------------------------------------------
 
+    Widget_Cache_Reset(d);
     return 0;
 }
 
@@ -145,7 +149,7 @@ static int slotNullEvent(PARAM *p, DATA *data)
     data_model *model;
     generator_info *gen;
     generator_ui_info *ui;
-    powerplant_info *pp_info = &data->dm->pp_arr[PP_ID];
+    powerplant_info *pp_info = &data->view.pp_arr[PP_ID];
 
     /* iteration variables */
     int gen_start = data->dm->pp_arr[PP_ID].first_gen_id;
@@ -160,41 +164,40 @@ static int slotNullEvent(PARAM *p, DATA *data)
 
 
     if(p == NULL || data == NULL) return -1;
-    if(data->dm->dirty) {
-        data->dm->dirty = 0;
-        model = data->dm;
+    if(Widget_Cache_Model_Changed(data)) {
+        model = &data->view;
         /* Reread the state and update the UI */
         for(int i = gen_start; i < gen_stop; ++i) {
             gen = &pp_info->gen_arr[i];
             ui = &gen->ui;
 
-            pvDisplayNum(p, ui->max, gen->max);
+            Show_Num(p, data, ui->max, gen->max);
             if (renewable_active[i-3] == 0) {
                 if (gen->max == 0) {
-                    pvSetImage(p, ui->indicator, "black.png");
+                    Show_Image(p, data, ui->indicator, "black.png");
                 } else {
-                    pvSetImage(p, ui->indicator, "green.png");
+                    Show_Image(p, data, ui->indicator, "green.png");
                 }
-                pvDisplayNum(p, ui->current, 0);
-                pvSetText(p, ui->deactivate, "Activate");
+                Show_Num(p, data, ui->current, 0);
+                Show_Text(p, data, ui->deactivate, "Activate");
                 continue;
             }
-            pvSetText(p, ui->deactivate, "Deactivate");
-            pvDisplayNum(p, ui->current, gen->current);
+            Show_Text(p, data, ui->deactivate, "Deactivate");
+            Show_Num(p, data, ui->current, gen->current);
             if (gen->current > 0) {
-                pvSetImage(p, ui->indicator, "red.png");
+                Show_Image(p, data, ui->indicator, "red.png");
             } else if (gen->max == 0) {
-                pvSetImage(p, ui->indicator, "black.png");
-                pvSetText(p, ui->deactivate, "Activate");
+                Show_Image(p, data, ui->indicator, "black.png");
+                Show_Text(p, data, ui->deactivate, "Activate");
             } else {
-                pvSetImage(p, ui->indicator, "green.png");
+                Show_Image(p, data, ui->indicator, "green.png");
             }
             total_current += gen->current;
             total_maximum += gen->max;
         }
         /* Set the powerplant total stat displays */
-        pvDisplayNum(p, pp_info->pp_generation, total_current);
-        pvDisplayNum(p, pp_info->pp_maximum, total_maximum);
+        Show_Num(p, data, pp_info->pp_generation, total_current);
+        Show_Num(p, data, pp_info->pp_maximum, total_maximum);
 
         total_target = 0;
         total_current = 0;
@@ -206,7 +209,7 @@ static int slotNullEvent(PARAM *p, DATA *data)
                 pp_id = 1;
             }
 
-            gen = &data->dm->pp_arr[pp_id].gen_arr[i];
+            gen = &model->pp_arr[pp_id].gen_arr[i];
 
             if (i > 2 && renewable_active[i-3] == 0) {
                 continue;
@@ -216,9 +219,9 @@ static int slotNullEvent(PARAM *p, DATA *data)
             total_current += gen->current;
         }
         /* Set the overall total stat displays */
-        pvDisplayNum(p, pp_info->overall_demand, model->current_demand);
-        pvDisplayNum(p, pp_info->overall_generation, total_current);
-        pvDisplayNum(p, pp_info->overall_target, total_target);
+        Show_Num(p, data, pp_info->overall_demand, model->current_demand);
+        Show_Num(p, data, pp_info->overall_generation, total_current);
+        Show_Num(p, data, pp_info->overall_target, total_target);
     }
     Advance_Demand(data);
     Record_History(data);
@@ -249,18 +252,19 @@ static int slotButtonEvent(PARAM *p, int id, DATA *data)
     if(p == NULL || data == NULL) return -1;
 
     if (id == pp_info->home_button) {
-        data->dm->dirty = 1;
         return 1;
     }
 
     for(int i = gen_start; i < gen_stop; ++i) {
         /* Find the generator that corresponds to the pressed button */
         if(id == pp_info->gen_arr[i].ui.deactivate) {
+            Model_Write_Begin();
             if (renewable_active[i-3] == 0) {
                 renewable_active[i-3] = 1;
             } else {
                 renewable_active[i-3] = 0;
             }
+            Model_Write_End();
         }
     }
     return 0;
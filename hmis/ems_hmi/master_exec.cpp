@@ -52,6 +52,8 @@
 #include <time.h>
 #include <errno.h>
 #include <stdarg.h>
+#include <pthread.h>
+#include <sys/socket.h>
 #include "master_exec.h"
 
 extern "C" {
@@ -99,28 +101,125 @@ void Process_Config_Msg(signed_message * conf_mess,int mess_size){
 }
 
 
+/* Serializes writers of the_model; Model_Seq is odd while one is inside */
+static pthread_mutex_t Model_Lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int Model_Seq;
+
+/* Queueing delay of updates from the SCADA master, from the timestamp in
+ * each hmi_update_msg to when it is applied here */
+static struct {
+    unsigned int wakeups;
+    unsigned int updates;
+    double sum_usec;
+    double max_usec;
+} Update_Delay;
+
+void Model_Write_Begin(void)
+{
+    pthread_mutex_lock(&Model_Lock);
+    __atomic_store_n(&Model_Seq, Model_Seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/* Like Model_Write_Begin, but returns 0 instead of waiting if another
+ * writer is inside */
+int Model_Try_Write_Begin(void)
+{
+    if (pthread_mutex_trylock(&Model_Lock) != 0)
+        return 0;
+    __atomic_store_n(&Model_Seq, Model_Seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return 1;
+}
+
+void Model_Write_End(void)
+{
+    __atomic_store_n(&the_model.version, the_model.version + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&Model_Seq, Model_Seq + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&Model_Lock);
+}
+
+int Model_Read(data_model *copy)
+{
+    unsigned int seq;
+
+    seq = __atomic_load_n(&Model_Seq, __ATOMIC_ACQUIRE);
+    if (seq & 1)
+        return 0;
+    memcpy(copy, &the_model, sizeof(data_model));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&Model_Seq, __ATOMIC_RELAXED) == seq;
+}
+
+unsigned int Model_Version(void)
+{
+    return __atomic_load_n(&the_model.version, __ATOMIC_ACQUIRE);
+}
+
+void Print_Update_Delay(int dummy1, void *dummy2)
+{
+    sp_time t;
+
+    UNUSED(dummy1);
+    UNUSED(dummy2);
+
+    if (Update_Delay.updates > 0) {
+        printf("Updates: %u in %u wakeups, delay avg %.1f ms, max %.1f ms\n",
+                Update_Delay.updates, Update_Delay.wakeups,
+                Update_Delay.sum_usec / Update_Delay.updates / 1000,
+                Update_Delay.max_usec / 1000);
+        memset(&Update_Delay, 0, sizeof(Update_Delay));
+    }
+
+    t.sec  = EMS_DELAY_STATS_SEC;
+    t.usec = 0;
+    E_queue(Print_Update_Delay, 0, NULL, t);
+}
+
+/* Messages received by Read_From_Master in one wakeup. Only the master
+ * connection thread uses them. */
+static char Recv_Buf[EMS_RECV_BATCH][MAX_LEN];
+static int Recv_Len[EMS_RECV_BATCH];
+
 /* Can't be int because its used elsewhere that requires void */
 void Read_From_Master(int s, int dummy1, void *dummy2)
 {
-    char buf[MAX_LEN];
-    int ret;
+    int ret, n, i;
     signed_message *cmess;
 
 
     UNUSED(dummy1);
     UNUSED(dummy2);
 
-    ret = IPC_Recv(s, buf, MAX_LEN);
-    if (ret < 0) printf("Read_From_Master: IPC_Rev failed\n");
-    cmess=(signed_message *)buf;
-    if(cmess->type ==  PRIME_OOB_CONFIG_MSG){
-        Process_Config_Msg((signed_message *)buf,ret);
-        return;
+    /* Drain everything already queued on the socket first, so that the
+     * writer section below doesn't include any system calls */
+    Update_Delay.wakeups++;
+    for (n = 0; n < EMS_RECV_BATCH; n++) {
+        ret = recv(s, Recv_Buf[n], MAX_LEN, n == 0 ? 0 : MSG_DONTWAIT);
+        if (ret < 0) {
+            if (n == 0) printf("Read_From_Master: IPC_Rev failed\n");
+            break;
+        }
+        Recv_Len[n] = ret;
+    }
+
+    /* Configuration messages don't touch the model */
+    for (i = 0; i < n; i++) {
+        cmess = (signed_message *)Recv_Buf[i];
+        if (cmess->type == PRIME_OOB_CONFIG_MSG)
+            Process_Config_Msg(cmess, Recv_Len[i]);
+    }
+
+    Model_Write_Begin();
+    for (i = 0; i < n; i++) {
+        cmess = (signed_message *)Recv_Buf[i];
+        if (cmess->type != PRIME_OOB_CONFIG_MSG)
+            Process_Message(cmess);
     }
-    
-    Process_Message((signed_message *)buf);
+    Model_Write_End();
 }
 
+/* Called by Read_From_Master inside its model writer section */
 void Process_Message(signed_message *mess)
 {
     ems_fields *ems_up;
@@ -150,6 +249,10 @@ void Process_Message(signed_message *mess)
     then.tv_sec  = hmi_up->sec;
     then.tv_usec = hmi_up->usec;
     diff = diffTime(now, then);
+    Update_Delay.updates++;
+    Update_Delay.sum_usec += diff.tv_sec * 1000000.0 + diff.tv_usec;
+    if (diff.tv_sec * 1000000.0 + diff.tv_usec > Update_Delay.max_usec)
+        Update_Delay.max_usec = diff.tv_sec * 1000000.0 + diff.tv_usec;
 
     model = &the_model;
     if(model == NULL) {
@@ -157,9 +260,6 @@ void Process_Message(signed_message *mess)
         return;
     }
 
-    // Mark the model as dirty so the UI updates
-    model->dirty = 1;
-
     // Only the HMI has a concept of powerplants, this is where we translate
     // from the nonpowerplant part of the code to the powerplant part
     if (ems_up->id < 3) {
@@ -328,13 +428,17 @@ void Append_History(const char *m, ...)
 
 int demand_delta = 5;
 
+/* Called from the rendering threads. If another writer holds the model,
+ * the demand is advanced on a later frame instead of waiting. */
 int Advance_Demand(DATA *data) {
+    if (!Model_Try_Write_Begin())
+        return 0;
     data->dm->current_demand += demand_delta;
     /* If the demand is above our cap or at 0 we want to reverse the direction of change */
     if (data->dm->current_demand >= 1500 || data->dm->current_demand == 0) {
         demand_delta *= -1;
     }
-    data->dm->dirty = 1;
+    Model_Write_End();
     return 0;
 }
 
@@ -346,7 +450,7 @@ int Record_History(DATA *data) {
     int pp_total = 0;
     int current_gen = 0;
 
-    dm = data->dm;
+    dm = &data->view;
     hm = data->hm;
 
     /* Advance the head */
@@ -61,6 +61,12 @@ extern "C" {
 
 #define MAX_LINES_IN_SEGMENT 2
 #define EMS_HISTORY_LENGTH 10000
+/* Upper bound on widget ids in any mask, sizes the per-connection widget cache */
+#define EMS_MAX_WIDGETS 128
+/* Most updates drained from the master socket per wakeup */
+#define EMS_RECV_BATCH 64
+/* How often the update delay counters are printed */
+#define EMS_DELAY_STATS_SEC 10
 using namespace std;
 
 
@@ -150,7 +156,7 @@ typedef struct data_model_d {
     int current_demand;
     int send_text_id; // Used to flag a text field to send on its next text event
     int send_gen_id; // Used to flag a text field to send on its next text event
-    bool dirty;
+    unsigned int version; // Bumped by every Model_Write_End
 } data_model;
 
 /* Circular array that we use to record history */
@@ -187,6 +193,14 @@ typedef struct {
     history_model *hm;
     struct timeval button_press_time;
     int print_seq;
+    /* This connection's copy of the_model, taken with Model_Read, which
+     * the slot functions render from */
+    data_model view;
+    /* What this connection last sent to the browser (see widget_cache.h) */
+    unsigned int shown_version;
+    char num_shown[EMS_MAX_WIDGETS];
+    int num_val[EMS_MAX_WIDGETS];
+    const char *str_shown[EMS_MAX_WIDGETS];
 }
 DATA;
 
@@ -195,4 +209,22 @@ void Read_From_Master(int s, int dummy1, void *dummy2);
 void Execute_Script(int s, int dummy1, void *dummy2);
 void Append_History(const char *m, ...);
 int Advance_Demand(DATA *data);
+
+/* the_model is written by the master connection thread and by the pvb
+ * connection threads. Every change is made between Model_Write_Begin and
+ * Model_Write_End, which serialize writers. Writer sections are kept short:
+ * nothing is received or sent inside them. Rendering threads never wait on a writer:
+ * Model_Read copies the model under a sequence counter and returns 0 if a
+ * write was in progress, in which case the caller keeps its previous copy
+ * for this frame, and the rendering path only writes with
+ * Model_Try_Write_Begin. Event handlers (button and text events) use
+ * Model_Write_Begin. */
+void Model_Write_Begin(void);
+int Model_Try_Write_Begin(void);
+void Model_Write_End(void);
+int Model_Read(data_model *copy);
+unsigned int Model_Version(void);
+
+/* Prints how long updates spent between the SCADA master and this HMI */
+void Print_Update_Delay(int dummy1, void *dummy2);
 int Record_History(DATA *data);
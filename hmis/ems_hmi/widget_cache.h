@@ -0,0 +1,117 @@
+/*
+ * Spire.
+ *
+ * The contents of this file are subject to the Spire Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * https://jhu-dsn.github.io/spire/LICENSE.txt 
+ *
+ * or in the file ``LICENSE.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * Spire is developed at the Distributed Systems and Networks Lab,
+ * Johns Hopkins University and the Resilient Systems and Societies Lab,
+ * University of Pittsburgh.
+ *
+ * Creators:
+ *   Yair Amir            yairamir@cs.jhu.edu
+ *   Trevor Aron          taron1@cs.jhu.edu
+ *   Amy Babay            babay@pitt.edu
+ *   Thomas Tantillo      tantillo@cs.jhu.edu 
+ *   Sahiti Bommareddy    sahiti@cs.jhu.edu 
+ *   Maher Khan           maherkhan@pitt.edu
+ *
+ * Major Contributors:
+ *   Marco Platania       Contributions to architecture design 
+ *   Daniel Qian          Contributions to Trip Master and IDS 
+ *
+ * Contributors:
+ *   Samuel Beckley       Contributions to HMIs
+ *
+ * Copyright (c) 2017-2026 Johns Hopkins University.
+ * All rights reserved.
+ *
+ * Partial funding for Spire research was provided by the Defense Advanced 
+ * Research Projects Agency (DARPA), the Department of Defense (DoD), and the
+ * Department of Energy (DoE).
+ * Spire is not necessarily endorsed by DARPA, the DoD or the DoE. 
+ *
+ */
+
+/* Per-connection cache of what each widget currently shows in the browser.
+ * The slot functions redraw from their copy of the model on every frame in
+ * which the model changed, but only widgets whose value differs from what was last
+ * sent are written to the pvbrowser connection. */
+
+#ifndef EMS_WIDGET_CACHE_H
+#define EMS_WIDGET_CACHE_H
+
+/* Include after master_exec.h, which defines DATA */
+#include <string.h>
+
+/* Forget everything shown, e.g. when a mask is (re)loaded. If a writer is
+ * busy, start from an empty view; the first frame that gets a copy of the
+ * model draws it. */
+static inline void Widget_Cache_Reset(DATA *d)
+{
+    memset(d->num_shown, 0, sizeof(d->num_shown));
+    memset(d->str_shown, 0, sizeof(d->str_shown));
+    if (!Model_Read(&d->view))
+        memset(&d->view, 0, sizeof(d->view));
+    d->shown_version = Model_Version() - 1;
+}
+
+/* Returns 1, with d->view refreshed, if the model changed since this
+ * connection last drew it. Returns 0 if nothing changed or a writer is
+ * busy, in which case the frame is skipped rather than waiting. */
+static inline int Widget_Cache_Model_Changed(DATA *d)
+{
+    if (d->shown_version == Model_Version())
+        return 0;
+    if (!Model_Read(&d->view))
+        return 0;
+    d->shown_version = d->view.version;
+    return 1;
+}
+
+static inline void Show_Num(PARAM *p, DATA *d, int id, int val)
+{
+    if (id >= 0 && id < EMS_MAX_WIDGETS) {
+        if (d->num_shown[id] && d->num_val[id] == val)
+            return;
+        d->num_shown[id] = 1;
+        d->num_val[id] = val;
+    }
+    pvDisplayNum(p, id, val);
+}
+
+/* str must be a string constant; only the pointer is remembered */
+static inline int Widget_Cache_Str_Changed(DATA *d, int id, const char *str)
+{
+    if (id < 0 || id >= EMS_MAX_WIDGETS)
+        return 1;
+    if (d->str_shown[id] != NULL && strcmp(d->str_shown[id], str) == 0)
+        return 0;
+    d->str_shown[id] = str;
+    return 1;
+}
+
+static inline void Show_Image(PARAM *p, DATA *d, int id, const char *image)
+{
+    if (Widget_Cache_Str_Changed(d, id, image))
+        pvSetImage(p, id, image);
+}
+
+static inline void Show_Text(PARAM *p, DATA *d, int id, const char *text)
+{
+    if (Widget_Cache_Str_Changed(d, id, text))
+        pvSetText(p, id, text);
+}
+
+#endif /* EMS_WIDGET_CACHE_H */
@@ -73,6 +73,19 @@
 /* #define CONFIG_ETHERNET_INTERFACE_ID "vboxnet0" */
 /* #define CONFIG_ETHERNET_INTERFACE_ID "en0"  // OS X uses enX in place of ethX as ethernet NIC names. */
 
+/* Number of blocks of the memory mapped receive ring (Linux TPACKET_V3) used by the GOOSE and SV receivers.
+ * Set to 0 to receive every frame with a separate system call */
+#define CONFIG_ETHERNET_RX_RING_BLOCKS 0
+
+/* Size of a receive ring block in bytes - has to be a multiple of the page size */
+#define CONFIG_ETHERNET_RX_RING_BLOCK_SIZE 65536
+
+/* Time in ms after which a partially filled receive ring block is handed to the receiver */
+#define CONFIG_ETHERNET_RX_RING_TIMEOUT_MS 1
+
+/* Maximum number of frames handled by a single GooseReceiver_tick or SVReceiver_tick call */
+#define CONFIG_ETHERNET_RX_BATCH_SIZE 64
+
 /* Set to 1 to include GOOSE support in the build. Otherwise set to 0 */
 #define CONFIG_INCLUDE_GOOSE_SUPPORT 1
 
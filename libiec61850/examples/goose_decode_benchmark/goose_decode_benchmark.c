@@ -0,0 +1,222 @@
+/*
+ * goose_decode_benchmark.c
+ *
+ * Measures the time to decode GOOSE messages with GooseReceiver_handleMessage
+ * for a subscriber with a configured data set, a subscriber that creates its
+ * own data set values and an observer.
+ *
+ * Does not need network access.
+ */
+
+#include "goose_receiver.h"
+#include "goose_subscriber.h"
+#include "hal_time.h"
+#include "mms_value.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NUMBER_OF_MESSAGES 200000
+
+#define NUMBER_OF_POINTS 8
+
+static const char* goCbRef = "simpleIOGenericIO/LLN0$GO$gcbEvents";
+
+static int received = 0;
+
+static void
+gooseListener(GooseSubscriber subscriber, void* parameter)
+{
+    received++;
+}
+
+static int
+encodeTL(uint8_t tag, int length, uint8_t* buffer, int bufPos)
+{
+    buffer[bufPos++] = tag;
+
+    if (length < 128)
+        buffer[bufPos++] = (uint8_t) length;
+    else if (length < 256) {
+        buffer[bufPos++] = 0x81;
+        buffer[bufPos++] = (uint8_t) length;
+    }
+    else {
+        buffer[bufPos++] = 0x82;
+        buffer[bufPos++] = (uint8_t) (length / 256);
+        buffer[bufPos++] = (uint8_t) (length % 256);
+    }
+
+    return bufPos;
+}
+
+static int
+encodeUint32(uint8_t tag, uint32_t value, uint8_t* buffer, int bufPos)
+{
+    bufPos = encodeTL(tag, 4, buffer, bufPos);
+
+    buffer[bufPos++] = (uint8_t) (value >> 24);
+    buffer[bufPos++] = (uint8_t) (value >> 16);
+    buffer[bufPos++] = (uint8_t) (value >> 8);
+    buffer[bufPos++] = (uint8_t) value;
+
+    return bufPos;
+}
+
+/* data set of a breaker/relay: NUMBER_OF_POINTS x (stVal, q, t) followed by NUMBER_OF_POINTS measurements */
+static MmsValue*
+createDataSetValues(void)
+{
+    MmsValue* dataSet = MmsValue_createEmptyArray(2 * NUMBER_OF_POINTS);
+    int i;
+
+    for (i = 0; i < NUMBER_OF_POINTS; i++) {
+        MmsValue* point = MmsValue_createEmptyStructure(3);
+
+        MmsValue_setElement(point, 0, MmsValue_newBoolean(i % 2));
+        MmsValue_setElement(point, 1, MmsValue_newBitString(13));
+        MmsValue_setElement(point, 2, MmsValue_newUtcTimeByMsTime(Hal_getTimeInMs()));
+
+        MmsValue_setElement(dataSet, i, point);
+        MmsValue_setElement(dataSet, NUMBER_OF_POINTS + i, MmsValue_newFloat(230.0f + i));
+    }
+
+    return dataSet;
+}
+
+static int
+createMessage(uint8_t* buffer, MmsValue* dataSet)
+{
+    uint8_t allData[1024];
+    uint8_t apdu[1400];
+    int allDataLength = 0;
+    int apduLength = 0;
+    int i;
+
+    for (i = 0; i < MmsValue_getArraySize(dataSet); i++)
+        allDataLength = MmsValue_encodeMmsData(MmsValue_getElement(dataSet, i), allData, allDataLength, true);
+
+    apduLength = encodeTL(0x80, strlen(goCbRef), apdu, apduLength);
+    memcpy(apdu + apduLength, goCbRef, strlen(goCbRef));
+    apduLength += strlen(goCbRef);
+    apduLength = encodeUint32(0x81, 2000, apdu, apduLength);
+    apduLength = encodeTL(0x82, 5, apdu, apduLength);
+    memcpy(apdu + apduLength, "dsEvt", 5);
+    apduLength += 5;
+    apduLength = encodeTL(0x83, 5, apdu, apduLength);
+    memcpy(apdu + apduLength, "goId1", 5);
+    apduLength += 5;
+    apduLength = encodeTL(0x84, 8, apdu, apduLength);
+    memset(apdu + apduLength, 0, 8);
+    apduLength += 8;
+    apduLength = encodeUint32(0x85, 1, apdu, apduLength);
+    apduLength = encodeUint32(0x86, 0, apdu, apduLength);
+    apduLength = encodeTL(0x87, 1, apdu, apduLength);
+    apdu[apduLength++] = 0;
+    apduLength = encodeUint32(0x88, 1, apdu, apduLength);
+    apduLength = encodeTL(0x89, 1, apdu, apduLength);
+    apdu[apduLength++] = 0;
+    apduLength = encodeUint32(0x8a, MmsValue_getArraySize(dataSet), apdu, apduLength);
+    apduLength = encodeTL(0xab, allDataLength, apdu, apduLength);
+    memcpy(apdu + apduLength, allData, allDataLength);
+    apduLength += allDataLength;
+
+    int bufPos = 0;
+    uint8_t dstMac[6] = { 0x01, 0x0c, 0xcd, 0x01, 0x00, 0x01 };
+    uint8_t srcMac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+    memcpy(buffer, dstMac, 6);
+    memcpy(buffer + 6, srcMac, 6);
+    bufPos = 12;
+    buffer[bufPos++] = 0x88;
+    buffer[bufPos++] = 0xb8;
+    buffer[bufPos++] = 0x03; /* APPID 1000 */
+    buffer[bufPos++] = 0xe8;
+
+    int pduStart = bufPos;
+
+    bufPos += 6; /* length and reserved fields */
+    bufPos = encodeTL(0x61, apduLength, buffer, bufPos);
+    memcpy(buffer + bufPos, apdu, apduLength);
+    bufPos += apduLength;
+
+    int length = bufPos - pduStart + 2;
+
+    buffer[pduStart] = (uint8_t) (length / 256);
+    buffer[pduStart + 1] = (uint8_t) (length % 256);
+    memset(buffer + pduStart + 2, 0, 4);
+
+    return bufPos;
+}
+
+/* position of the sqNum value in the message */
+static int
+findSqNum(uint8_t* buffer, int size)
+{
+    int i;
+
+    for (i = 6; i < size - 5; i++) {
+        if ((buffer[i] == 0x86) && (buffer[i + 1] == 0x04) && (buffer[i - 6] == 0x85))
+            return i + 2;
+    }
+
+    return -1;
+}
+
+static void
+runBenchmark(const char* name, GooseSubscriber subscriber, uint8_t* message, int size)
+{
+    GooseReceiver receiver = GooseReceiver_createEx(NULL);
+    int sqNumPos = findSqNum(message, size);
+    int i;
+
+    GooseSubscriber_setListener(subscriber, gooseListener, NULL);
+    GooseReceiver_addSubscriber(receiver, subscriber);
+
+    received = 0;
+
+    nsSinceEpoch start = Hal_getTimeInNs();
+
+    for (i = 0; i < NUMBER_OF_MESSAGES; i++) {
+        message[sqNumPos + 2] = (uint8_t) (i >> 8);
+        message[sqNumPos + 3] = (uint8_t) i;
+
+        GooseReceiver_handleMessage(receiver, message, size);
+    }
+
+    nsSinceEpoch duration = Hal_getTimeInNs() - start;
+
+    printf("%-24s %8.1f ns/message (%i messages, %i delivered)\n", name,
+            (double) duration / NUMBER_OF_MESSAGES, NUMBER_OF_MESSAGES, received);
+
+    GooseReceiver_destroy(receiver);
+}
+
+int
+main(int argc, char** argv)
+{
+    uint8_t message[1518];
+
+    MmsValue* dataSet = createDataSetValues();
+
+    int size = createMessage(message, dataSet);
+
+    printf("GOOSE message size: %i bytes, %i data set entries\n", size, MmsValue_getArraySize(dataSet));
+
+    GooseSubscriber subscriber = GooseSubscriber_create((char*) goCbRef, createDataSetValues());
+    GooseSubscriber_setAppId(subscriber, 1000);
+    runBenchmark("configured data set", subscriber, message, size);
+
+    subscriber = GooseSubscriber_create((char*) goCbRef, NULL);
+    GooseSubscriber_setAppId(subscriber, 1000);
+    runBenchmark("unknown data set", subscriber, message, size);
+
+    subscriber = GooseSubscriber_create("", NULL);
+    GooseSubscriber_setObserver(subscriber);
+    runBenchmark("observer", subscriber, message, size);
+
+    MmsValue_delete(dataSet);
+
+    return 0;
+}
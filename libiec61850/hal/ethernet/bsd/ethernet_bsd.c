@@ -410,6 +410,38 @@ Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
         return 0;
 }
 
+int
+Ethernet_receivePackets(EthernetSocket self, uint8_t* buffer, int bufferSize, int maxPackets,
+        EthernetFrameHandler handler, void* parameter)
+{
+    int received = 0;
+
+    while (received < maxPackets) {
+        int packetSize = Ethernet_receivePacket(self, buffer, bufferSize);
+
+        if (packetSize <= 0)
+            break;
+
+        handler(parameter, buffer, packetSize, Hal_getTimeInNs());
+        received++;
+    }
+
+    return received;
+}
+
+bool
+Ethernet_enableRxRing(EthernetSocket self, int blockSize, int numBlocks, int timeoutMs)
+{
+    return false;
+}
+
+void
+Ethernet_setAppIdFilter(EthernetSocket self, uint16_t etherType, const uint16_t* appIds, int appIdCount)
+{
+    /* APPIDs are checked by the receivers */
+    Ethernet_setProtocolFilter(self, etherType);
+}
+
 void
 Ethernet_sendPacket(EthernetSocket self, uint8_t* buffer, int packetSize)
 {
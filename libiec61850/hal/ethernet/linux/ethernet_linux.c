@@ -23,6 +23,7 @@
 
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <poll.h>
 #include <linux/filter.h>
 #include <linux/if_packet.h>
@@ -41,10 +42,25 @@
 #define DEBUG_SOCKET 0
 #endif
 
+/* frame slot size inside a ring block - large enough for a full ethernet frame plus the TPACKET header */
+#define RX_RING_FRAME_SIZE 2048
+
+/* maximum number of APPIDs in a kernel filter (jump offsets are 8 bit) */
+#define MAX_FILTER_APPIDS 64
+
 struct sEthernetSocket {
     int rawSocket;
     bool isBind;
     struct sockaddr_ll socketAddress;
+
+    /* TPACKET_V3 receive ring (NULL when recvfrom is used) */
+    uint8_t* rxRing;
+    size_t rxRingSize;
+    int blockSize;
+    int numBlocks;
+    int currentBlock;
+    int blockPktsLeft; /* unhandled frames in the current block or 0 if block not yet opened */
+    struct tpacket3_hdr* nextPkt;
 };
 
 struct sEthernetHandleSet {
@@ -253,17 +269,200 @@ Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType)
 }
 
 
-/* non-blocking receive */
-int
-Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
+void
+Ethernet_setAppIdFilter(EthernetSocket ethSocket, uint16_t etherType, const uint16_t* appIds, int appIdCount)
+{
+    struct sock_filter filter[MAX_FILTER_APPIDS + 9];
+    struct sock_fprog fprog;
+    int rejectIdx;
+    int i;
+
+    if (appIdCount > MAX_FILTER_APPIDS)
+        appIdCount = 0;
+
+    /* X = offset of the ethertype behind an optional VLAN tag */
+    filter[0] = (struct sock_filter) BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 0);
+    filter[1] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12);
+    filter[2] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x8100, 0, 1);
+    filter[3] = (struct sock_filter) BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 4);
+    filter[4] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_IND, 12);
+
+    if (appIdCount > 0) {
+        int acceptIdx = 8 + appIdCount;
+
+        rejectIdx = 7 + appIdCount;
+
+        filter[5] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, etherType, 0, rejectIdx - 6);
+        filter[6] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_IND, 14);
+
+        for (i = 0; i < appIdCount; i++)
+            filter[7 + i] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, appIds[i], acceptIdx - (8 + i), 0);
+
+        filter[rejectIdx] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0);
+        filter[acceptIdx] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0x00040000);
+        fprog.len = acceptIdx + 1;
+    }
+    else {
+        rejectIdx = 7;
+
+        filter[5] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, etherType, 0, rejectIdx - 6);
+        filter[6] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0x00040000);
+        filter[rejectIdx] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0);
+        fprog.len = rejectIdx + 1;
+    }
+
+    fprog.filter = filter;
+
+    if (setsockopt(ethSocket->rawSocket, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) == -1)
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: Applying filter failed");
+}
+
+static bool
+bindSocket(EthernetSocket self)
 {
     if (self->isBind == false) {
         if (bind(self->rawSocket, (struct sockaddr*) &self->socketAddress, sizeof(self->socketAddress)) == 0)
             self->isBind = true;
-        else
-            return 0;
     }
 
+    return self->isBind;
+}
+
+bool
+Ethernet_enableRxRing(EthernetSocket self, int blockSize, int numBlocks, int timeoutMs)
+{
+    struct tpacket_req3 req;
+    int version = TPACKET_V3;
+
+    if (self->rxRing != NULL)
+        return true;
+
+    if (self->isBind || (blockSize < RX_RING_FRAME_SIZE) || (numBlocks < 1))
+        return false;
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: TPACKET_V3 not supported\n");
+        return false;
+    }
+
+    memset(&req, 0, sizeof(req));
+
+    req.tp_block_size = blockSize;
+    req.tp_block_nr = numBlocks;
+    req.tp_frame_size = RX_RING_FRAME_SIZE;
+    req.tp_frame_nr = (blockSize / RX_RING_FRAME_SIZE) * numBlocks;
+    req.tp_retire_blk_tov = timeoutMs;
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: Failed to create receive ring\n");
+        return false;
+    }
+
+    self->rxRingSize = (size_t) blockSize * numBlocks;
+
+    void* ring = mmap(NULL, self->rxRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, self->rawSocket, 0);
+
+    if (ring == MAP_FAILED) {
+        if (DEBUG_SOCKET)
+            printf("ETHERNET_LINUX: Failed to map receive ring\n");
+
+        /* release the ring again so that recvfrom can be used */
+        memset(&req, 0, sizeof(req));
+        setsockopt(self->rawSocket, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+
+        return false;
+    }
+
+    self->rxRing = (uint8_t*) ring;
+    self->blockSize = blockSize;
+    self->numBlocks = numBlocks;
+    self->currentBlock = 0;
+    self->blockPktsLeft = 0;
+    self->nextPkt = NULL;
+
+    return true;
+}
+
+static int
+receiveFromRing(EthernetSocket self, int maxPackets, EthernetFrameHandler handler, void* parameter)
+{
+    int received = 0;
+
+    while (received < maxPackets) {
+
+        struct tpacket_block_desc* block =
+                (struct tpacket_block_desc*) (self->rxRing + ((size_t) self->currentBlock * self->blockSize));
+
+        if (self->blockPktsLeft == 0) {
+            if ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0)
+                break;
+
+            self->blockPktsLeft = block->hdr.bh1.num_pkts;
+            self->nextPkt = (struct tpacket3_hdr*) ((uint8_t*) block + block->hdr.bh1.offset_to_first_pkt);
+        }
+
+        while ((self->blockPktsLeft > 0) && (received < maxPackets)) {
+            struct tpacket3_hdr* pkt = self->nextPkt;
+
+            handler(parameter, (uint8_t*) pkt + pkt->tp_mac, pkt->tp_snaplen,
+                    ((nsSinceEpoch) pkt->tp_sec * 1000000000ULL) + pkt->tp_nsec);
+
+            self->nextPkt = (struct tpacket3_hdr*) ((uint8_t*) pkt + pkt->tp_next_offset);
+            self->blockPktsLeft--;
+            received++;
+        }
+
+        if (self->blockPktsLeft > 0)
+            break;
+
+        /* return block to the kernel */
+        __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+
+        self->currentBlock = (self->currentBlock + 1) % self->numBlocks;
+    }
+
+    return received;
+}
+
+int
+Ethernet_receivePackets(EthernetSocket self, uint8_t* buffer, int bufferSize, int maxPackets,
+        EthernetFrameHandler handler, void* parameter)
+{
+    int received = 0;
+
+    if (bindSocket(self) == false)
+        return 0;
+
+    if (self->rxRing)
+        return receiveFromRing(self, maxPackets, handler, parameter);
+
+    while (received < maxPackets) {
+        int packetSize = recvfrom(self->rawSocket, buffer, bufferSize, MSG_DONTWAIT, 0, 0);
+
+        if (packetSize <= 0)
+            break;
+
+        handler(parameter, buffer, packetSize, Hal_getTimeInNs());
+        received++;
+    }
+
+    return received;
+}
+
+/* non-blocking receive */
+int
+Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
+{
+    if (bindSocket(self) == false)
+        return 0;
+
+    /* frames in the receive ring are only accessible with Ethernet_receivePackets */
+    if (self->rxRing)
+        return 0;
+
     return recvfrom(self->rawSocket, buffer, bufferSize, MSG_DONTWAIT, 0, 0);
 }
 
@@ -277,6 +476,9 @@ Ethernet_sendPacket(EthernetSocket ethSocket, uint8_t* buffer, int packetSize)
 void
 Ethernet_destroySocket(EthernetSocket ethSocket)
 {
+    if (ethSocket->rxRing)
+        munmap(ethSocket->rxRing, ethSocket->rxRingSize);
+
     close(ethSocket->rawSocket);
     GLOBAL_FREEMEM(ethSocket);
 }
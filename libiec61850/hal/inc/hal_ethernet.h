@@ -25,6 +25,7 @@
 #define ETHERNET_HAL_H_
 
 #include "hal_base.h"
+#include "hal_time.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +51,18 @@ typedef struct sEthernetSocket* EthernetSocket;
 /** Opaque reference for a set of ethernet socket handles */
 typedef struct sEthernetHandleSet* EthernetHandleSet;
 
+/**
+ * \brief Callback invoked by \ref Ethernet_receivePackets for every received frame
+ *
+ * The frame buffer is only valid during the callback.
+ *
+ * \param parameter user provided parameter
+ * \param frame pointer to the start of the ethernet frame (destination address)
+ * \param frameSize size of the frame in bytes
+ * \param rxTime arrival time of the frame (kernel timestamp when available)
+ */
+typedef void (*EthernetFrameHandler) (void* parameter, uint8_t* frame, int frameSize, nsSinceEpoch rxTime);
+
 /**
  * \brief Create a new connection handle set (EthernetHandleSet)
  *
@@ -152,6 +165,59 @@ Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType);
 PAL_API int
 Ethernet_receivePacket(EthernetSocket ethSocket, uint8_t* buffer, int bufferSize);
 
+/**
+ * \brief receive a batch of ethernet packets (non-blocking)
+ *
+ * Calls \p handler for up to \p maxPackets pending frames. When the socket has
+ * a receive ring (see \ref Ethernet_enableRxRing) the frames are passed
+ * directly from the ring without copying. Otherwise each frame is copied to
+ * \p buffer first.
+ *
+ * \param ethSocket the ethernet socket handle
+ * \param buffer the buffer used when frames have to be copied
+ * \param bufferSize the maximum size of the buffer
+ * \param maxPackets maximum number of frames to handle
+ * \param handler callback function for each frame
+ * \param parameter user provided parameter passed to the callback
+ *
+ * \return number of frames handled
+ */
+PAL_API int
+Ethernet_receivePackets(EthernetSocket ethSocket, uint8_t* buffer, int bufferSize, int maxPackets,
+        EthernetFrameHandler handler, void* parameter);
+
+/**
+ * \brief Use a memory mapped receive ring for the socket (optional)
+ *
+ * Has to be called before the first packet is received. Frames are then
+ * delivered in blocks by the kernel and only \ref Ethernet_receivePackets
+ * can be used to receive.
+ *
+ * \param ethSocket the ethernet socket handle
+ * \param blockSize size of a ring block in bytes (multiple of the page size)
+ * \param numBlocks number of blocks in the ring
+ * \param timeoutMs time after which a partially filled block is passed to the user
+ *
+ * \return true if the ring is in use, false if not supported or setup failed
+ */
+PAL_API bool
+Ethernet_enableRxRing(EthernetSocket ethSocket, int blockSize, int numBlocks, int timeoutMs);
+
+/**
+ * \brief set a protocol filter for the specified etherType and a list of APPIDs
+ *
+ * Frames with the given etherType (optionally VLAN tagged) are only accepted
+ * when their APPID is in \p appIds. When \p appIdCount is 0 all frames with
+ * the etherType are accepted.
+ *
+ * \param ethSocket the ethernet socket handle
+ * \param etherType the ether type of messages to accept
+ * \param appIds list of accepted APPIDs
+ * \param appIdCount number of entries in \p appIds
+ */
+PAL_API void
+Ethernet_setAppIdFilter(EthernetSocket ethSocket, uint16_t etherType, const uint16_t* appIds, int appIdCount);
+
 /**
  * \brief Indicates if runtime provides support for direct Ethernet access
  *
@@ -58,6 +58,21 @@ struct sGoosePublisher {
     bool simulation;
 
     MmsValue* timestamp; /* time when stNum is increased */
+
+    /* positions (relative to payload start) of the fields of the cached frame that change between retransmissions */
+    int timeAllowedToLivePos;
+    int timestampPos;
+    int stNumPos;
+    int sqNumPos;
+
+    uint32_t numberOfDataSetEntries;
+    int dataSetStart; /* first byte of the encoded data set entries */
+    uint32_t dataSetSize;
+
+    /* retransmission curve (disabled when maxRetransmissionTime is 0) */
+    uint32_t minRetransmissionTime;
+    uint32_t maxRetransmissionTime;
+    uint32_t retransmissionInterval;
 };
 
 GoosePublisher
@@ -278,69 +293,81 @@ prepareGooseBuffer(GoosePublisher self, CommParameters* parameters, const char*
     }
 }
 
-static int32_t
-createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffer, size_t maxPayloadSize) {
-
-    /* Step 1 - calculate length fields */
-    uint32_t goosePduLength = 0;
-
-    goosePduLength += BerEncoder_determineEncodedStringSize(self->goCBRef);
-
-    uint32_t timeAllowedToLive = self->timeAllowedToLive;
-
-    goosePduLength += 2 + BerEncoder_UInt32determineEncodedSize(timeAllowedToLive);
+void
+GoosePublisher_setRetransmissionTimes(GoosePublisher self, uint32_t minTime, uint32_t maxTime)
+{
+    /* doubling an interval of 0 would never leave 0 */
+    if ((minTime == 0) && (maxTime > 0))
+        minTime = 1;
 
-    goosePduLength += BerEncoder_determineEncodedStringSize(self->dataSetRef);
+    if (maxTime < minTime)
+        maxTime = minTime;
 
-    if (self->goID != NULL)
-        goosePduLength += BerEncoder_determineEncodedStringSize(self->goID);
-    else
-        goosePduLength += BerEncoder_determineEncodedStringSize(self->goCBRef);
+    self->minRetransmissionTime = minTime;
+    self->maxRetransmissionTime = maxTime;
+    self->retransmissionInterval = 0;
+}
 
-    goosePduLength += 2 + 8; /* for T (UTCTIME) */
+uint32_t
+GoosePublisher_getRetransmissionInterval(GoosePublisher self)
+{
+    return self->retransmissionInterval;
+}
 
-    goosePduLength += 2 + BerEncoder_UInt32determineEncodedSize(self->sqNum);
+static void
+advanceRetransmissionCurve(GoosePublisher self)
+{
+    if (self->maxRetransmissionTime == 0)
+        return;
 
-    goosePduLength += 2 + BerEncoder_UInt32determineEncodedSize(self->stNum);
+    /* first message after a state change starts the curve again */
+    if ((self->sqNum == 0) || (self->retransmissionInterval == 0))
+        self->retransmissionInterval = self->minRetransmissionTime;
+    else {
+        self->retransmissionInterval *= 2;
 
-    goosePduLength += 2 + BerEncoder_UInt32determineEncodedSize(self->confRev);
+        if (self->retransmissionInterval > self->maxRetransmissionTime)
+            self->retransmissionInterval = self->maxRetransmissionTime;
+    }
 
-    goosePduLength += 6; /* for ndsCom and simulation */
+    self->timeAllowedToLive = self->retransmissionInterval;
+}
 
-    uint32_t numberOfDataSetEntries = LinkedList_size(dataSetValues);
+static uint32_t
+determineHeaderFieldsSize(GoosePublisher self)
+{
+    uint32_t size = 0;
 
-    goosePduLength += 2 + BerEncoder_UInt32determineEncodedSize(numberOfDataSetEntries);
+    size += BerEncoder_determineEncodedStringSize(self->goCBRef);
 
-    uint32_t dataSetSize = 0;
+    size += 2 + BerEncoder_UInt32determineEncodedSize(self->timeAllowedToLive);
 
-    LinkedList element = LinkedList_getNext(dataSetValues);
+    size += BerEncoder_determineEncodedStringSize(self->dataSetRef);
 
-    while (element != NULL) {
-        MmsValue* dataSetEntry = (MmsValue*) element->data;
+    if (self->goID != NULL)
+        size += BerEncoder_determineEncodedStringSize(self->goID);
+    else
+        size += BerEncoder_determineEncodedStringSize(self->goCBRef);
 
-        if (dataSetEntry) {
-            dataSetSize += MmsValue_encodeMmsData(dataSetEntry, NULL, 0, false);
-        }
-        else {
-            /* TODO encode MMS NULL */
-            if (DEBUG_GOOSE_PUBLISHER)
-                printf("GOOSE_PUBLISHER: NULL value in data set!\n");
-        }
+    size += 2 + 8; /* for T (UTCTIME) */
 
-        element = LinkedList_getNext(element);
-    }
+    size += 2 + BerEncoder_UInt32determineEncodedSize(self->sqNum);
 
-    uint32_t allDataSize = dataSetSize + BerEncoder_determineLengthSize(dataSetSize) + 1;
+    size += 2 + BerEncoder_UInt32determineEncodedSize(self->stNum);
 
-    goosePduLength += allDataSize;
+    size += 2 + BerEncoder_UInt32determineEncodedSize(self->confRev);
 
-    uint32_t payloadSize = 1 + BerEncoder_determineLengthSize(goosePduLength) + goosePduLength;
+    size += 6; /* for ndsCom and simulation */
 
-    if (payloadSize > maxPayloadSize)
-        return -1;
+    size += 2 + BerEncoder_UInt32determineEncodedSize(self->numberOfDataSetEntries);
 
-    /* Step 2 - encode to buffer */
+    return size;
+}
 
+/* encode everything up to the data set entries and remember the positions of the variable fields */
+static int32_t
+encodeGooseHeader(GoosePublisher self, uint32_t goosePduLength, uint8_t* buffer)
+{
     int32_t bufPos = 0;
 
     /* Encode GOOSE PDU */
@@ -350,7 +377,8 @@ createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffe
     bufPos = BerEncoder_encodeStringWithTag(0x80, self->goCBRef, buffer, bufPos);
 
     /* Encode timeAllowedToLive */
-    bufPos = BerEncoder_encodeUInt32WithTL(0x81, timeAllowedToLive, buffer, bufPos);
+    self->timeAllowedToLivePos = bufPos;
+    bufPos = BerEncoder_encodeUInt32WithTL(0x81, self->timeAllowedToLive, buffer, bufPos);
 
     /* Encode datSet reference */
     bufPos = BerEncoder_encodeStringWithTag(0x82, self->dataSetRef, buffer, bufPos);
@@ -362,12 +390,15 @@ createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffe
         bufPos = BerEncoder_encodeStringWithTag(0x83, self->goCBRef, buffer, bufPos);
 
     /* Encode t */
+    self->timestampPos = bufPos;
     bufPos = BerEncoder_encodeOctetString(0x84, self->timestamp->value.utcTime, 8, buffer, bufPos);
 
     /* Encode stNum */
+    self->stNumPos = bufPos;
     bufPos = BerEncoder_encodeUInt32WithTL(0x85, self->stNum, buffer, bufPos);
 
     /* Encode sqNum */
+    self->sqNumPos = bufPos;
     bufPos = BerEncoder_encodeUInt32WithTL(0x86, self->sqNum, buffer, bufPos);
 
     /* Encode simulation */
@@ -380,10 +411,61 @@ createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffe
     bufPos = BerEncoder_encodeBoolean(0x89, self->needsCommission, buffer, bufPos);
 
     /* Encode numDatSetEntries */
-    bufPos = BerEncoder_encodeUInt32WithTL(0x8a, numberOfDataSetEntries, buffer, bufPos);
+    bufPos = BerEncoder_encodeUInt32WithTL(0x8a, self->numberOfDataSetEntries, buffer, bufPos);
 
     /* Encode all data */
-    bufPos = BerEncoder_encodeTL(0xab, dataSetSize, buffer, bufPos);
+    bufPos = BerEncoder_encodeTL(0xab, self->dataSetSize, buffer, bufPos);
+
+    self->dataSetStart = bufPos;
+
+    return bufPos;
+}
+
+static uint32_t
+determineGoosePduLength(GoosePublisher self)
+{
+    uint32_t allDataSize = self->dataSetSize + BerEncoder_determineLengthSize(self->dataSetSize) + 1;
+
+    return determineHeaderFieldsSize(self) + allDataSize;
+}
+
+static int32_t
+createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffer, size_t maxPayloadSize) {
+
+    /* Step 1 - calculate length fields */
+    self->numberOfDataSetEntries = LinkedList_size(dataSetValues);
+
+    uint32_t dataSetSize = 0;
+
+    LinkedList element = LinkedList_getNext(dataSetValues);
+
+    while (element != NULL) {
+        MmsValue* dataSetEntry = (MmsValue*) element->data;
+
+        if (dataSetEntry) {
+            dataSetSize += MmsValue_encodeMmsData(dataSetEntry, NULL, 0, false);
+        }
+        else {
+            /* TODO encode MMS NULL */
+            if (DEBUG_GOOSE_PUBLISHER)
+                printf("GOOSE_PUBLISHER: NULL value in data set!\n");
+        }
+
+        element = LinkedList_getNext(element);
+    }
+
+    self->dataSetSize = dataSetSize;
+
+    uint32_t goosePduLength = determineGoosePduLength(self);
+
+    uint32_t payloadSize = 1 + BerEncoder_determineLengthSize(goosePduLength) + goosePduLength;
+
+    if (payloadSize > maxPayloadSize)
+        return -1;
+
+    /* Step 2 - encode to buffer */
+
+    int32_t bufPos = encodeGooseHeader(self, goosePduLength, buffer);
 
     /* Encode data set entries */
     element = LinkedList_getNext(dataSetValues);
@@ -404,6 +486,27 @@ createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffe
     return bufPos;
 }
 
+static void
+sendGooseFrame(GoosePublisher self)
+{
+    self->sqNum++;
+
+    if (self->sqNum == 0)
+        self->sqNum = 1;
+
+    int lengthIndex = self->lengthField;
+
+    size_t gooseLength = self->payloadLength + 8;
+
+    self->buffer[lengthIndex] = gooseLength / 256;
+    self->buffer[lengthIndex + 1] = gooseLength & 0xff;
+
+    if (DEBUG_GOOSE_PUBLISHER)
+        printf("GOOSE_PUBLISHER: send GOOSE message\n");
+
+    Ethernet_sendPacket(self->ethernetSocket, self->buffer, self->payloadStart + self->payloadLength);
+}
+
 int
 GoosePublisher_publish(GoosePublisher self, LinkedList dataSet)
 {
@@ -411,27 +514,67 @@ GoosePublisher_publish(GoosePublisher self, LinkedList dataSet)
 
     size_t maxPayloadSize = GOOSE_MAX_MESSAGE_SIZE - self->payloadStart;
 
+    advanceRetransmissionCurve(self);
+
     self->payloadLength = createGoosePayload(self, dataSet, buffer, maxPayloadSize);
 
     if (self->payloadLength == -1)
         return -1;
 
-    self->sqNum++;
+    sendGooseFrame(self);
 
-    if (self->sqNum == 0)
-        self->sqNum = 1;
+    return 0;
+}
 
-    int lengthIndex = self->lengthField;
+static bool
+patchUInt32Field(uint8_t* buffer, int pos, uint8_t tag, uint32_t value)
+{
+    /* only possible when the encoded size doesn't change */
+    if (buffer[pos + 1] != BerEncoder_UInt32determineEncodedSize(value))
+        return false;
 
-    size_t gooseLength = self->payloadLength + 8;
+    BerEncoder_encodeUInt32WithTL(tag, value, buffer, pos);
 
-    self->buffer[lengthIndex] = gooseLength / 256;
-    self->buffer[lengthIndex + 1] = gooseLength & 0xff;
+    return true;
+}
 
-    if (DEBUG_GOOSE_PUBLISHER)
-        printf("GOOSE_PUBLISHER: send GOOSE message\n");
+int
+GoosePublisher_retransmit(GoosePublisher self)
+{
+    if (self->payloadLength <= 0)
+        return -1;
 
-    Ethernet_sendPacket(self->ethernetSocket, self->buffer, self->payloadStart + self->payloadLength);
+    uint8_t* buffer = self->buffer + self->payloadStart;
+
+    advanceRetransmissionCurve(self);
+
+    /* usually only the sqNum and timeAllowedToLive values change and can be replaced in place */
+    bool patched = patchUInt32Field(buffer, self->timeAllowedToLivePos, 0x81, self->timeAllowedToLive) &&
+            patchUInt32Field(buffer, self->stNumPos, 0x85, self->stNum) &&
+            patchUInt32Field(buffer, self->sqNumPos, 0x86, self->sqNum);
+
+    if (patched) {
+        memcpy(buffer + self->timestampPos + 2, self->timestamp->value.utcTime, 8);
+    }
+    else {
+        /* a field changed its encoded size - rebuild the header in front of the cached data set entries */
+        uint32_t goosePduLength = determineGoosePduLength(self);
+
+        uint32_t payloadSize = 1 + BerEncoder_determineLengthSize(goosePduLength) + goosePduLength;
+
+        if (payloadSize > (uint32_t) (GOOSE_MAX_MESSAGE_SIZE - self->payloadStart))
+            return -1;
+
+        int headerSize = (int) (payloadSize - self->dataSetSize);
+
+        memmove(buffer + headerSize, buffer + self->dataSetStart, self->dataSetSize);
+
+        encodeGooseHeader(self, goosePduLength, buffer);
+
+        self->payloadLength = (int) payloadSize;
+    }
+
+    sendGooseFrame(self);
 
     return 0;
 }
@@ -98,6 +98,50 @@ GoosePublisher_publish(GoosePublisher self, LinkedList dataSet);
 LIB61850_API int
 GoosePublisher_publishAndDump(GoosePublisher self, LinkedList dataSet, char* msgBuf, int32_t* msgLen, int32_t bufSize);
 
+/**
+ * \brief Send the last published GOOSE message again without encoding the data set
+ *
+ * The message that was encoded by the last call of \ref GoosePublisher_publish is
+ * reused. Only the sequence number, state number, time allowed to live and timestamp
+ * fields are updated. Use this function for the repetitions of a state. When the data set
+ * values have changed call \ref GoosePublisher_increaseStNum and \ref GoosePublisher_publish instead.
+ *
+ * NOTE: This function also increases the sequence number of the GOOSE publisher
+ *
+ * \param self GoosePublisher instance
+ *
+ * \return 0 on success, -1 if no message has been published before
+ */
+LIB61850_API int
+GoosePublisher_retransmit(GoosePublisher self);
+
+/**
+ * \brief Set the retransmission curve of the GoosePublisher instance
+ *
+ * The first message of a new state (after \ref GoosePublisher_increaseStNum) is repeated
+ * after minTime. Every following repetition doubles the interval until maxTime is reached.
+ * The time allowed to live of each message is set to the interval until the next message.
+ * Use \ref GoosePublisher_getRetransmissionInterval after each publish/retransmit call to
+ * schedule the next \ref GoosePublisher_retransmit call.
+ *
+ * \param self GoosePublisher instance
+ * \param minTime the first retransmission interval in ms (0 together with maxTime = 0 disables the curve,
+ *        0 with a non-zero maxTime is raised to 1 ms)
+ * \param maxTime the maximum retransmission interval in ms (raised to minTime when smaller)
+ */
+LIB61850_API void
+GoosePublisher_setRetransmissionTimes(GoosePublisher self, uint32_t minTime, uint32_t maxTime);
+
+/**
+ * \brief Get the time until the next retransmission is due
+ *
+ * \param self GoosePublisher instance
+ *
+ * \return the interval in ms after the last sent message or 0 when no retransmission curve is set
+ */
+LIB61850_API uint32_t
+GoosePublisher_getRetransmissionInterval(GoosePublisher self);
+
 /**
  * \brief Sets the GoID used by the GoosePublisher instance
  *
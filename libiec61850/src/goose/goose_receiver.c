@@ -45,6 +45,11 @@
 
 #define ETH_P_GOOSE 0x88b8
 
+#define MAX_FILTER_APPIDS 64
+
+/* number of hash buckets of the subscriber indexes (power of 2) */
+#define SUBSCRIBER_INDEX_SIZE 64
+
 struct sGooseReceiver
 {
     bool running;
@@ -53,11 +58,188 @@ struct sGooseReceiver
     uint8_t* buffer;
     EthernetSocket ethSocket;
     LinkedList subscriberList;
+    nsSinceEpoch rxTime; /* arrival time of the frame being parsed */
+
+    /* subscribers with a fixed APPID by APPID and all non-observers by goCbRef */
+    GooseSubscriber appIdIndex[SUBSCRIBER_INDEX_SIZE];
+    GooseSubscriber refIndex[SUBSCRIBER_INDEX_SIZE];
+    int anyAppIdCount; /* number of non-observers that accept any APPID */
+    GooseSubscriber observer;
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     Thread thread;
 #endif
 };
 
+static uint32_t
+hashGoCbRef(const uint8_t* ref, int length)
+{
+    uint32_t hash = 2166136261u;
+    int i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= ref[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static void
+indexSubscriber(GooseReceiver self, GooseSubscriber subscriber)
+{
+    GooseSubscriber* pos;
+
+    if (subscriber->isObserver) {
+        if (self->observer == NULL)
+            self->observer = subscriber;
+        return;
+    }
+
+    subscriber->nextByAppId = NULL;
+    subscriber->nextByRef = NULL;
+    subscriber->goCBRefHash = hashGoCbRef((uint8_t*) subscriber->goCBRef, subscriber->goCBRefLen);
+
+    /* append to keep the order in which subscribers were added */
+    if (subscriber->appId == -1)
+        self->anyAppIdCount++;
+    else {
+        pos = &(self->appIdIndex[subscriber->appId % SUBSCRIBER_INDEX_SIZE]);
+
+        while (*pos != NULL)
+            pos = &((*pos)->nextByAppId);
+
+        *pos = subscriber;
+    }
+
+    pos = &(self->refIndex[subscriber->goCBRefHash % SUBSCRIBER_INDEX_SIZE]);
+
+    while (*pos != NULL)
+        pos = &((*pos)->nextByRef);
+
+    *pos = subscriber;
+}
+
+static void
+unindexSubscriber(GooseReceiver self, GooseSubscriber subscriber)
+{
+    GooseSubscriber* pos;
+
+    if (subscriber->isObserver) {
+        if (self->observer == subscriber) {
+            self->observer = NULL;
+
+            /* fall back to the next observer in the list */
+            LinkedList element = LinkedList_getNext(self->subscriberList);
+
+            while (element != NULL) {
+                GooseSubscriber other = (GooseSubscriber) LinkedList_getData(element);
+
+                if (other->isObserver && (other != subscriber)) {
+                    self->observer = other;
+                    break;
+                }
+
+                element = LinkedList_getNext(element);
+            }
+        }
+        return;
+    }
+
+    if (subscriber->appId == -1)
+        self->anyAppIdCount--;
+    else {
+        pos = &(self->appIdIndex[subscriber->appId % SUBSCRIBER_INDEX_SIZE]);
+
+        while ((*pos != NULL) && (*pos != subscriber))
+            pos = &((*pos)->nextByAppId);
+
+        if (*pos)
+            *pos = subscriber->nextByAppId;
+    }
+
+    pos = &(self->refIndex[subscriber->goCBRefHash % SUBSCRIBER_INDEX_SIZE]);
+
+    while ((*pos != NULL) && (*pos != subscriber))
+        pos = &((*pos)->nextByRef);
+
+    if (*pos)
+        *pos = subscriber->nextByRef;
+}
+
+static bool
+isDstMacAccepted(GooseSubscriber subscriber, const uint8_t* dstMac)
+{
+    return (!subscriber->dstMacSet || (memcmp(subscriber->dstMac, dstMac, 6) == 0));
+}
+
+/* check if a subscriber is interested in the APPID/destination before parsing the payload */
+static bool
+isAppIdSubscribed(GooseReceiver self, uint16_t appId, const uint8_t* dstMac)
+{
+    GooseSubscriber subscriber;
+
+    if ((self->observer != NULL) || (self->anyAppIdCount > 0))
+        return true;
+
+    subscriber = self->appIdIndex[appId % SUBSCRIBER_INDEX_SIZE];
+
+    while (subscriber != NULL) {
+        if ((subscriber->appId == appId) && isDstMacAccepted(subscriber, dstMac))
+            return true;
+
+        subscriber = subscriber->nextByAppId;
+    }
+
+    return false;
+}
+
+static GooseSubscriber
+lookupSubscriber(GooseReceiver self, uint8_t* goCbRef, int length, uint16_t appId, const uint8_t* dstMac)
+{
+    uint32_t hash = hashGoCbRef(goCbRef, length);
+    GooseSubscriber subscriber = self->refIndex[hash % SUBSCRIBER_INDEX_SIZE];
+
+    while (subscriber != NULL) {
+        if ((subscriber->goCBRefHash == hash) && (subscriber->goCBRefLen == length) &&
+                ((subscriber->appId == -1) || (subscriber->appId == appId)) &&
+                isDstMacAccepted(subscriber, dstMac) &&
+                (memcmp(subscriber->goCBRef, goCbRef, length) == 0))
+            return subscriber;
+
+        subscriber = subscriber->nextByRef;
+    }
+
+    return NULL;
+}
+
+/* restrict the kernel filter to the APPIDs of the subscribers (if all of them have one) */
+static void
+updateSocketFilter(GooseReceiver self)
+{
+    uint16_t appIds[MAX_FILTER_APPIDS];
+    int appIdCount = 0;
+
+    if (self->ethSocket == NULL)
+        return;
+
+    LinkedList element = LinkedList_getNext(self->subscriberList);
+
+    while (element != NULL) {
+        GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
+
+        if (subscriber->isObserver || (subscriber->appId == -1) || (appIdCount == MAX_FILTER_APPIDS)) {
+            appIdCount = 0;
+            break;
+        }
+
+        appIds[appIdCount++] = (uint16_t) subscriber->appId;
+
+        element = LinkedList_getNext(element);
+    }
+
+    Ethernet_setAppIdFilter(self->ethSocket, ETH_P_GOOSE, appIds, appIdCount);
+}
+
 GooseReceiver
 GooseReceiver_createEx(uint8_t* buffer)
 {
@@ -70,6 +252,11 @@ GooseReceiver_createEx(uint8_t* buffer)
         self->buffer = buffer;
         self->ethSocket = NULL;
         self->subscriberList = LinkedList_create();
+        self->rxTime = 0;
+        memset(self->appIdIndex, 0, sizeof(self->appIdIndex));
+        memset(self->refIndex, 0, sizeof(self->refIndex));
+        self->anyAppIdCount = 0;
+        self->observer = NULL;
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
         self->thread = NULL;
 #endif
@@ -94,12 +281,36 @@ void
 GooseReceiver_addSubscriber(GooseReceiver self, GooseSubscriber subscriber)
 {
     LinkedList_add(self->subscriberList, (void*) subscriber);
+
+    subscriber->receiver = self;
+    indexSubscriber(self, subscriber);
+
+    updateSocketFilter(self);
 }
 
 void
 GooseReceiver_removeSubscriber(GooseReceiver self, GooseSubscriber subscriber)
 {
     LinkedList_remove(self->subscriberList, (void*) subscriber);
+
+    unindexSubscriber(self, subscriber);
+    subscriber->receiver = NULL;
+
+    updateSocketFilter(self);
+}
+
+void
+GooseReceiver_updateSubscriber(GooseReceiver self, GooseSubscriber subscriber, int32_t appId, bool isObserver)
+{
+    /* the indexes are keyed by the old values */
+    unindexSubscriber(self, subscriber);
+
+    subscriber->appId = appId;
+    subscriber->isObserver = isObserver;
+
+    indexSubscriber(self, subscriber);
+
+    updateSocketFilter(self);
 }
 
 void
@@ -374,6 +585,240 @@ parseAllData(uint8_t* buffer, int allDataLength, MmsValue* dataSetValues)
     return pe;
 }
 
+static int
+addDecodeStep(GooseSubscriber self)
+{
+    if (self->decodePlanSteps == self->decodePlanCapacity) {
+        int newCapacity = (self->decodePlanCapacity == 0) ? 16 : (self->decodePlanCapacity * 2);
+
+        GooseDecodeStep* newPlan = (GooseDecodeStep*) GLOBAL_REALLOC(self->decodePlan, newCapacity * sizeof(GooseDecodeStep));
+
+        if (newPlan == NULL)
+            return -1;
+
+        self->decodePlan = newPlan;
+        self->decodePlanCapacity = newCapacity;
+    }
+
+    return self->decodePlanSteps++;
+}
+
+/* add the steps for the elements in buffer[start..end) - checks the same conditions as parseAllData */
+static bool
+compileDecodePlanLevel(GooseSubscriber self, uint8_t* buffer, int start, int end, MmsValue* dataSetValues)
+{
+    int bufPos = start;
+    int elementIndex = 0;
+    int maxIndex = MmsValue_getArraySize(dataSetValues) - 1;
+
+    while (bufPos < end) {
+        int hdrPos = bufPos;
+        int elementLength;
+        uint8_t tag = buffer[bufPos++];
+
+        if (elementIndex > maxIndex)
+            return false;
+
+        MmsValue* value = MmsValue_getElement(dataSetValues, elementIndex);
+
+        /* indefinite length form has no fixed layout */
+        if ((bufPos >= end) || (buffer[bufPos] == 0x80))
+            return false;
+
+        bufPos = BerDecoder_decodeLength(buffer, &elementLength, bufPos, end);
+
+        if ((bufPos < 0) || ((bufPos - hdrPos) > 4))
+            return false;
+
+        int stepIndex = addDecodeStep(self);
+
+        if (stepIndex < 0)
+            return false;
+
+        GooseDecodeStep* step = &(self->decodePlan[stepIndex]);
+
+        step->offset = hdrPos;
+        step->length = elementLength;
+        step->hdrLen = bufPos - hdrPos;
+        memcpy(step->hdr, buffer + hdrPos, step->hdrLen);
+        step->value = NULL;
+
+        switch (tag)
+        {
+        case 0x80: /* reserved for access result */
+            break;
+
+        case 0xa1: /* array */
+            if ((MmsValue_getType(value) != MMS_ARRAY) ||
+                    !compileDecodePlanLevel(self, buffer, bufPos, bufPos + elementLength, value))
+                return false;
+            break;
+
+        case 0xa2: /* structure */
+            if ((MmsValue_getType(value) != MMS_STRUCTURE) ||
+                    !compileDecodePlanLevel(self, buffer, bufPos, bufPos + elementLength, value))
+                return false;
+            break;
+
+        case 0x83: /* boolean */
+            if (MmsValue_getType(value) != MMS_BOOLEAN)
+                return false;
+            step->value = value;
+            break;
+
+        case 0x84: /* BIT STRING */
+            if ((MmsValue_getType(value) != MMS_BIT_STRING) || (elementLength < 1) ||
+                    (((8 * (elementLength - 1)) - buffer[bufPos]) != value->value.bitString.size))
+                return false;
+            step->value = value;
+            break;
+
+        case 0x85: /* integer */
+            if ((MmsValue_getType(value) != MMS_INTEGER) || (elementLength > value->value.integer->maxSize))
+                return false;
+            step->value = value;
+            break;
+
+        case 0x86: /* unsigned integer */
+            if ((MmsValue_getType(value) != MMS_UNSIGNED) || (elementLength > value->value.integer->maxSize))
+                return false;
+            step->value = value;
+            break;
+
+        case 0x87: /* Float */
+            if ((MmsValue_getType(value) != MMS_FLOAT) || ((elementLength != 9) && (elementLength != 5)))
+                return false;
+            step->value = value;
+            break;
+
+        case 0x89: /* octet string */
+            if ((MmsValue_getType(value) != MMS_OCTET_STRING) || (elementLength > value->value.octetString.maxSize))
+                return false;
+            step->value = value;
+            break;
+
+        case 0x8a: /* visible string */
+            if ((MmsValue_getType(value) != MMS_VISIBLE_STRING) || (value->value.visibleString.buf == NULL) ||
+                    ((int32_t) value->value.visibleString.size < elementLength))
+                return false;
+            step->value = value;
+            break;
+
+        case 0x8c: /* binary time */
+            if ((MmsValue_getType(value) != MMS_BINARY_TIME) || ((elementLength != 4) && (elementLength != 6)))
+                return false;
+            step->value = value;
+            break;
+
+        case 0x91: /* Utctime */
+            if ((MmsValue_getType(value) != MMS_UTC_TIME) || (elementLength != 8))
+                return false;
+            step->value = value;
+            break;
+
+        default:
+            return false;
+        }
+
+        bufPos += elementLength;
+
+        elementIndex++;
+    }
+
+    return (elementIndex > maxIndex);
+}
+
+/* compile the decode plan from a message that was successfully decoded into dataSetValues */
+static void
+compileDecodePlan(GooseSubscriber self, uint8_t* buffer, int allDataLength)
+{
+    self->decodePlanSteps = 0;
+
+    if ((buffer == NULL) || (self->dataSetValues == NULL) || (allDataLength > 0xffff))
+        return;
+
+    if (compileDecodePlanLevel(self, buffer, 0, allDataLength, self->dataSetValues))
+        self->decodePlanDataLength = allDataLength;
+    else
+        self->decodePlanSteps = 0;
+}
+
+/* decode allData with the plan - returns false if the encoding changed (values may be partially updated) */
+static bool
+decodeWithPlan(GooseSubscriber self, uint8_t* buffer, int allDataLength)
+{
+    GooseDecodeStep* step = self->decodePlan;
+    GooseDecodeStep* end = step + self->decodePlanSteps;
+
+    if ((step == end) || (buffer == NULL) || (allDataLength != self->decodePlanDataLength))
+        return false;
+
+    for (; step < end; step++) {
+        uint8_t* hdr = buffer + step->offset;
+        int i;
+
+        for (i = 0; i < step->hdrLen; i++) {
+            if (hdr[i] != step->hdr[i])
+                return false;
+        }
+
+        MmsValue* value = step->value;
+
+        if (value == NULL)
+            continue;
+
+        uint8_t* content = hdr + step->hdrLen;
+        int length = step->length;
+
+        switch (step->hdr[0])
+        {
+        case 0x83: /* boolean */
+            value->value.boolean = (content[0] != 0);
+            break;
+
+        case 0x84: /* BIT STRING */
+            /* same length, but the padding octet changed the number of bits */
+            if ((8 * (length - 1)) - content[0] != value->value.bitString.size)
+                return false;
+            memcpy(value->value.bitString.buf, content + 1, length - 1);
+            break;
+
+        case 0x85: /* integer */
+        case 0x86: /* unsigned integer */
+            value->value.integer->size = length;
+            memcpy(value->value.integer->octets, content, length);
+            break;
+
+        case 0x87: /* Float */
+            if (length == 9)
+                MmsValue_setDouble(value, BerDecoder_decodeDouble(content, 0));
+            else
+                MmsValue_setFloat(value, BerDecoder_decodeFloat(content, 0));
+            break;
+
+        case 0x89: /* octet string */
+            value->value.octetString.size = length;
+            memcpy(value->value.octetString.buf, content, length);
+            break;
+
+        case 0x8a: /* visible string */
+            memcpy(value->value.visibleString.buf, content, length);
+            value->value.visibleString.buf[length] = 0;
+            break;
+
+        case 0x8c: /* binary time */
+            memcpy(value->value.binaryTime.buf, content, length);
+            break;
+
+        case 0x91: /* Utctime */
+            MmsValue_setUtcTimeByBuffer(value, content);
+            break;
+        }
+    }
+
+    return true;
+}
+
 static MmsValue*
 parseAllDataUnknownValue(GooseSubscriber self, uint8_t* buffer, int allDataLength, bool isStructure)
 {
@@ -568,7 +1013,7 @@ parseAllDataUnknownValue(GooseSubscriber self, uint8_t* buffer, int allDataLengt
 }
 
 static int
-parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
+parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength, uint16_t appId, uint8_t* dstMac)
 {
     int bufPos = 0;
     uint32_t timeAllowedToLive = 0;
@@ -615,41 +1060,28 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
                 if (DEBUG_GOOSE_SUBSCRIBER)
                     printf("GOOSE_SUBSCRIBER:   Found gocbRef\n");
 
-                {
-                    LinkedList element = LinkedList_getNext(self->subscriberList);
-
-                    while (element != NULL) {
-                        GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
-
-                        if (subscriber->isObserver)
-                        {
-                            if (elementLength > 129) {
-                                if (DEBUG_GOOSE_SUBSCRIBER)
-                                    printf("GOOSE_SUBSCRIBER:   gocbRef too long!\n");
-                            }
-                            else {
-                                memcpy(subscriber->goCBRef, buffer + bufPos, elementLength);
-                                subscriber->goCBRef[elementLength] = 0;
-                            }
-
-                            matchingSubscriber = subscriber;
-                            break;
-                        }
-                        else if (subscriber->goCBRefLen == elementLength) {
-                            if (memcmp(subscriber->goCBRef, buffer + bufPos, elementLength) == 0) {
-                                if (DEBUG_GOOSE_SUBSCRIBER)
-                                    printf("GOOSE_SUBSCRIBER:   gocbRef is matching!\n");
-                                matchingSubscriber = subscriber;
-                                break;
-                            }
-                        }
+                matchingSubscriber = lookupSubscriber(self, buffer + bufPos, elementLength, appId, dstMac);
+
+                if (matchingSubscriber) {
+                    if (DEBUG_GOOSE_SUBSCRIBER)
+                        printf("GOOSE_SUBSCRIBER:   gocbRef is matching!\n");
+                }
+                else if (self->observer) {
+                    GooseSubscriber subscriber = self->observer;
 
-                        element = LinkedList_getNext(element);
+                    if (elementLength > 129) {
+                        if (DEBUG_GOOSE_SUBSCRIBER)
+                            printf("GOOSE_SUBSCRIBER:   gocbRef too long!\n");
+                    }
+                    else {
+                        memcpy(subscriber->goCBRef, buffer + bufPos, elementLength);
+                        subscriber->goCBRef[elementLength] = 0;
                     }
 
-                    if (matchingSubscriber == NULL)
-                        return 0;
+                    matchingSubscriber = subscriber;
                 }
+                else
+                    return 0;
 
                 break;
 
@@ -765,6 +1197,7 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
                 if ((matchingSubscriber->dataSetValues != NULL) && (matchingSubscriber->confRev != confRev)) {
                     MmsValue_delete(matchingSubscriber->dataSetValues);
                     matchingSubscriber->dataSetValues = NULL;
+                    matchingSubscriber->decodePlanSteps = 0;
                 }
             }
 
@@ -779,23 +1212,36 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
                 MmsValue_setUtcTime(matchingSubscriber->timestamp, 0);
             }
             
-            if (matchingSubscriber->isObserver && matchingSubscriber->dataSetValues != NULL) {
-                MmsValue_delete(matchingSubscriber->dataSetValues);
-                matchingSubscriber->dataSetValues = NULL;
-            }
-
             bool isValid = true;
 
-            if (matchingSubscriber->dataSetValues == NULL)
-                matchingSubscriber->dataSetValues = parseAllDataUnknownValue(matchingSubscriber, dataSetBufferAddress, dataSetBufferLength, false);
+            if (decodeWithPlan(matchingSubscriber, dataSetBufferAddress, dataSetBufferLength)) {
+                /* encoding unchanged since the plan was compiled */
+                matchingSubscriber->parseError = GOOSE_PARSE_ERROR_NO_ERROR;
+            }
             else {
-                GooseParseError parseError = parseAllData(dataSetBufferAddress, dataSetBufferLength, matchingSubscriber->dataSetValues);
+                /* the observer keeps its values only while the layout stays the same */
+                if (matchingSubscriber->isObserver && matchingSubscriber->dataSetValues != NULL) {
+                    MmsValue_delete(matchingSubscriber->dataSetValues);
+                    matchingSubscriber->dataSetValues = NULL;
+                }
 
-                if (parseError != GOOSE_PARSE_ERROR_NO_ERROR) {
-                    isValid = false;
+                if (matchingSubscriber->dataSetValues == NULL) {
+                    matchingSubscriber->dataSetValues = parseAllDataUnknownValue(matchingSubscriber, dataSetBufferAddress, dataSetBufferLength, false);
+
+                    compileDecodePlan(matchingSubscriber, dataSetBufferAddress, dataSetBufferLength);
                 }
+                else {
+                    GooseParseError parseError = parseAllData(dataSetBufferAddress, dataSetBufferLength, matchingSubscriber->dataSetValues);
 
-                matchingSubscriber->parseError = parseError;
+                    if (parseError != GOOSE_PARSE_ERROR_NO_ERROR) {
+                        isValid = false;
+                        matchingSubscriber->decodePlanSteps = 0;
+                    }
+                    else
+                        compileDecodePlan(matchingSubscriber, dataSetBufferAddress, dataSetBufferLength);
+
+                    matchingSubscriber->parseError = parseError;
+                }
             }
 
             if (matchingSubscriber->stNum == stNum) {
@@ -809,7 +1255,8 @@ parseGoosePayload(GooseReceiver self, uint8_t* buffer, int apduLength)
             matchingSubscriber->stNum = stNum;
             matchingSubscriber->sqNum = sqNum;
 
-            matchingSubscriber->invalidityTime = Hal_getTimeInMs() + timeAllowedToLive;
+            matchingSubscriber->rxTimestamp = self->rxTime;
+            matchingSubscriber->invalidityTime = (self->rxTime / 1000000) + timeAllowedToLive;
 
             if (matchingSubscriber->listener != NULL)
                 matchingSubscriber->listener(matchingSubscriber, matchingSubscriber->listenerParameter);
@@ -830,7 +1277,6 @@ static void
 parseGooseMessage(GooseReceiver self, uint8_t* buffer, int numbytes)
 {
     int bufPos;
-    bool subscriberFound = false;
 
     if (numbytes < 22)
         return;
@@ -894,34 +1340,19 @@ parseGooseMessage(GooseReceiver self, uint8_t* buffer, int numbytes)
     }
 
     /* check if there is an interested subscriber */
-    LinkedList element = LinkedList_getNext(self->subscriberList);
-
-    while (element != NULL) {
-        GooseSubscriber subscriber = (GooseSubscriber) LinkedList_getData(element);
-        
-        if (subscriber->isObserver)
-        {
-            subscriber->appId = appId;
-            memcpy(subscriber->srcMac, srcMac,6);
-            memcpy(subscriber->dstMac, dstMac, 6);
-            subscriberFound = true;
-            subscriber->vlanSet = vlanSet;
-            subscriber->vlanId = vlanId;
-            subscriber->vlanPrio = priority;
-            break;
-        }
-
-        if (((subscriber->appId == -1) || (subscriber->appId == appId)) &&
-                (!subscriber->dstMacSet || (memcmp(subscriber->dstMac, dstMac,6) == 0))) {
-            subscriberFound = true;
-            break;
-        }
-
-        element = LinkedList_getNext(element);
+    if (self->observer) {
+        GooseSubscriber subscriber = self->observer;
+
+        subscriber->appId = appId;
+        memcpy(subscriber->srcMac, srcMac,6);
+        memcpy(subscriber->dstMac, dstMac, 6);
+        subscriber->vlanSet = vlanSet;
+        subscriber->vlanId = vlanId;
+        subscriber->vlanPrio = priority;
     }
 
-    if (subscriberFound)
-        parseGoosePayload(self, buffer + bufPos, apduLength);
+    if (isAppIdSubscribed(self, appId, dstMac))
+        parseGoosePayload(self, buffer + bufPos, apduLength, appId, dstMac);
     else {
         if (DEBUG_GOOSE_SUBSCRIBER)
             printf("GOOSE_SUBSCRIBER: GOOSE message ignored due to unknown DST-MAC or APPID value\n");
@@ -1035,7 +1466,11 @@ GooseReceiver_startThreadless(GooseReceiver self)
         self->ethSocket = Ethernet_createSocket(self->interfaceId, NULL);
 
     if (self->ethSocket != NULL) {
-        Ethernet_setProtocolFilter(self->ethSocket, ETH_P_GOOSE);
+#if (CONFIG_ETHERNET_RX_RING_BLOCKS > 0)
+        Ethernet_enableRxRing(self->ethSocket, CONFIG_ETHERNET_RX_RING_BLOCK_SIZE,
+                CONFIG_ETHERNET_RX_RING_BLOCKS, CONFIG_ETHERNET_RX_RING_TIMEOUT_MS);
+#endif
+        updateSocketFilter(self);
         self->running = true;
     }
     else
@@ -1050,25 +1485,32 @@ GooseReceiver_stopThreadless(GooseReceiver self)
     if (self->ethSocket)
         Ethernet_destroySocket(self->ethSocket);
 
+    self->ethSocket = NULL;
     self->running = false;
 }
 
-/* call after reception of ethernet frame */
+static void
+handleFrame(void* parameter, uint8_t* frame, int frameSize, nsSinceEpoch rxTime)
+{
+    GooseReceiver self = (GooseReceiver) parameter;
+
+    self->rxTime = rxTime;
+
+    parseGooseMessage(self, frame, frameSize);
+}
+
+/* call after reception of ethernet frame - handles all pending frames up to the batch size */
 bool
 GooseReceiver_tick(GooseReceiver self)
 {
-    int packetSize = Ethernet_receivePacket(self->ethSocket, self->buffer, ETH_BUFFER_LENGTH);
-
-    if (packetSize > 0) {
-        parseGooseMessage(self, self->buffer, packetSize);
-        return true;
-    }
-    else
-        return false;
+    return (Ethernet_receivePackets(self->ethSocket, self->buffer, ETH_BUFFER_LENGTH,
+            CONFIG_ETHERNET_RX_BATCH_SIZE, handleFrame, self) > 0);
 }
 
 void
 GooseReceiver_handleMessage(GooseReceiver self, uint8_t* buffer, int size)
 {
+    self->rxTime = Hal_getTimeInNs();
+
     parseGooseMessage(self, buffer, size);
 }
@@ -157,11 +157,12 @@ GooseReceiver_stopThreadless(GooseReceiver self);
 /**
  * \brief Parse GOOSE messages if they are available
  *
- * Call after reception of an Ethernet frame or periodically
+ * Call after reception of an Ethernet frame or periodically. Up to
+ * CONFIG_ETHERNET_RX_BATCH_SIZE pending messages are parsed per call.
  *
  * \param self the receiver object
  *
- * \return true if a message was available and has been parsed, false otherwise
+ * \return true if at least one message was available and has been parsed, false otherwise
  */
 LIB61850_API bool
 GooseReceiver_tick(GooseReceiver self);
@@ -34,6 +34,15 @@
 #endif
 
 
+/* one element of the allData field as found when the decode plan was compiled */
+typedef struct {
+    uint16_t offset; /* offset of the element tag in allData */
+    uint16_t length; /* content length */
+    uint8_t hdrLen; /* number of tag and length octets */
+    uint8_t hdr[4]; /* tag and length octets */
+    MmsValue* value; /* value to decode the content to or NULL for constructed/reserved elements */
+} GooseDecodeStep;
+
 struct sGooseSubscriber {
     char goCBRef[130];
     char datSet[130];
@@ -48,6 +57,7 @@ struct sGooseSubscriber {
     bool ndsCom;
 
     uint64_t invalidityTime;
+    uint64_t rxTimestamp; /* arrival time of the last message in ns */
     bool stateValid;
     GooseParseError parseError;
 
@@ -65,8 +75,23 @@ struct sGooseSubscriber {
 
     GooseListener listener;
     void* listenerParameter;
-};
 
+    /* flat decode plan for the dataSetValues (decodePlanSteps == 0 when no plan is available) */
+    GooseDecodeStep* decodePlan;
+    int decodePlanSteps;
+    int decodePlanCapacity;
+    int decodePlanDataLength;
+
+    /* receiver the subscriber is added to (NULL if none) and its dispatch index */
+    struct sGooseReceiver* receiver;
+    uint32_t goCBRefHash;
+    struct sGooseSubscriber* nextByAppId;
+    struct sGooseSubscriber* nextByRef;
+};
 
+/* change the APPID/observer flag of a subscriber that is added to the receiver and re-index it */
+void
+GooseReceiver_updateSubscriber(struct sGooseReceiver* self, struct sGooseSubscriber* subscriber,
+        int32_t appId, bool isObserver);
 
 #endif /* GOOSE_RECEIVER_INTERNAL_H_ */
@@ -90,7 +90,10 @@ GooseSubscriber_setDstMac(GooseSubscriber self, uint8_t dstMac[6])
 void
 GooseSubscriber_setAppId(GooseSubscriber self, uint16_t appId)
 {
-    self->appId = (int32_t) appId;
+    if (self->receiver)
+        GooseReceiver_updateSubscriber(self->receiver, self, (int32_t) appId, self->isObserver);
+    else
+        self->appId = (int32_t) appId;
 }
 
 void
@@ -101,6 +104,9 @@ GooseSubscriber_destroy(GooseSubscriber self)
     if (self->dataSetValuesSelfAllocated)
         MmsValue_delete(self->dataSetValues);
 
+    if (self->decodePlan)
+        GLOBAL_FREEMEM(self->decodePlan);
+
     GLOBAL_FREEMEM(self);
 }
 
@@ -189,6 +195,12 @@ GooseSubscriber_getTimestamp(GooseSubscriber self)
     return MmsValue_getUtcTimeInMs(self->timestamp);
 }
 
+uint64_t
+GooseSubscriber_getRxTimestamp(GooseSubscriber self)
+{
+    return self->rxTimestamp;
+}
+
 MmsValue*
 GooseSubscriber_getDataSetValues(GooseSubscriber self)
 {
@@ -216,5 +228,8 @@ GooseSubscriber_getVlanPrio(GooseSubscriber self)
 void
 GooseSubscriber_setObserver(GooseSubscriber self)
 {
-    self->isObserver = true;
+    if (self->receiver)
+        GooseReceiver_updateSubscriber(self->receiver, self, self->appId, true);
+    else
+        self->isObserver = true;
 }
@@ -235,6 +235,18 @@ GooseSubscriber_getTimeAllowedToLive(GooseSubscriber self);
 LIB61850_API uint64_t
 GooseSubscriber_getTimestamp(GooseSubscriber self);
 
+/**
+ * \brief Get the arrival time of the last received message.
+ *
+ * When the GOOSE receiver uses a receive ring this is the kernel timestamp of the frame.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ *
+ * \return the arrival time of the last received GOOSE message in nanoseconds since epoch (1.1.1970 UTC).
+ */
+LIB61850_API uint64_t
+GooseSubscriber_getRxTimestamp(GooseSubscriber self);
+
 /**
  * \brief get the data set values received with the last report
  *
@@ -262,7 +274,8 @@ GooseSubscriber_getVlanPrio(GooseSubscriber self);
  * \brief Configure the Subscriber to listen to any received GOOSE message
  *
  * NOTE: When the observer flag is set the subscriber also has access to the
- * goCbRef, goId, and datSet values of the received GOOSE message
+ * goCbRef, goId, and datSet values of the received GOOSE message. The observer
+ * only receives messages that no other subscriber of the receiver accepts.
  */
 LIB61850_API void
 GooseSubscriber_setObserver(GooseSubscriber self);
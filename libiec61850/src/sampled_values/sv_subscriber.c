@@ -33,6 +33,10 @@
 
 #include "sv_subscriber.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #ifndef DEBUG_SV_SUBSCRIBER
 #define DEBUG_SV_SUBSCRIBER 1
 #endif
@@ -41,6 +45,11 @@
 
 #define ETH_P_SV 0x88ba
 
+#define MAX_FILTER_APPIDS 64
+
+/* number of hash buckets of the APPID index (power of 2) */
+#define SUBSCRIBER_INDEX_SIZE 64
+
 struct sSVReceiver {
     bool running;
     bool stopped;
@@ -54,6 +63,11 @@ struct sSVReceiver {
 
     LinkedList subscriberList;
 
+    /* subscribers by APPID - maintained with the subscriber list */
+    SVSubscriber appIdIndex[SUBSCRIBER_INDEX_SIZE];
+
+    nsSinceEpoch rxTime; /* arrival time of the frame being parsed */
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     Semaphore subscriberListLock;
 #endif
@@ -64,8 +78,43 @@ struct sSVSubscriber {
     uint8_t ethAddr[6];
     uint16_t appId;
 
+    uint64_t rxTimestamp;
+
     SVUpdateListener listener;
     void* listenerParameter;
+
+    SVSampleBuffer sampleBuffer;
+    SVSampleRing sampleRing;
+
+    struct sSVSubscriber* nextByAppId;
+};
+
+struct sSVSampleBuffer {
+    int numberOfChannels;
+    int capacity;
+    int size;
+
+    int32_t* values;     /* values[channel * capacity + sample] */
+    Quality* qualities;  /* qualities[channel * capacity + sample] */
+    uint16_t* smpCnts;
+    nsSinceEpoch* rxTimes;
+};
+
+struct sSVSampleRing {
+    int numberOfChannels;
+    uint32_t capacity;
+    uint32_t mask;
+
+    int32_t* values;     /* values[channel * capacity + slot] */
+    Quality* qualities;
+    uint16_t* smpCnts;
+    nsSinceEpoch* rxTimes;
+
+    /* free running positions - writePos is only written by the producer, readPos by the consumer */
+    uint32_t writePos;
+    uint32_t readPos;
+
+    uint32_t dropped;
 };
 
 struct sSVSubscriber_ASDU {
@@ -82,6 +131,8 @@ struct sSVSubscriber_ASDU {
 
     int dataBufferLength;
     uint8_t* dataBuffer;
+
+    nsSinceEpoch rxTime;
 };
 
 
@@ -125,15 +176,57 @@ SVReceiver_enableDestAddrCheck(SVReceiver self)
     self->checkDestAddr = true;
 }
 
+/* restrict the kernel filter to the APPIDs of the subscribers - call with subscriber list locked */
+static void
+updateSocketFilter(SVReceiver self)
+{
+    uint16_t appIds[MAX_FILTER_APPIDS];
+    int appIdCount = 0;
+
+    if (self->ethSocket == NULL)
+        return;
+
+    LinkedList element = LinkedList_getNext(self->subscriberList);
+
+    while (element != NULL) {
+        SVSubscriber subscriber = (SVSubscriber) LinkedList_getData(element);
+
+        if (appIdCount == MAX_FILTER_APPIDS) {
+            appIdCount = 0;
+            break;
+        }
+
+        appIds[appIdCount++] = subscriber->appId;
+
+        element = LinkedList_getNext(element);
+    }
+
+    Ethernet_setAppIdFilter(self->ethSocket, ETH_P_SV, appIds, appIdCount);
+}
+
 void
 SVReceiver_addSubscriber(SVReceiver self, SVSubscriber subscriber)
 {
+    SVSubscriber* pos;
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     Semaphore_wait(self->subscriberListLock);
 #endif
 
     LinkedList_add(self->subscriberList, (void*) subscriber);
 
+    /* append to keep the order in which subscribers were added */
+    subscriber->nextByAppId = NULL;
+
+    pos = &(self->appIdIndex[subscriber->appId % SUBSCRIBER_INDEX_SIZE]);
+
+    while (*pos != NULL)
+        pos = &((*pos)->nextByAppId);
+
+    *pos = subscriber;
+
+    updateSocketFilter(self);
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     Semaphore_post(self->subscriberListLock);
 #endif
@@ -142,12 +235,24 @@ SVReceiver_addSubscriber(SVReceiver self, SVSubscriber subscriber)
 void
 SVReceiver_removeSubscriber(SVReceiver self, SVSubscriber subscriber)
 {
+    SVSubscriber* pos;
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     Semaphore_wait(self->subscriberListLock);
 #endif
 
     LinkedList_remove(self->subscriberList, (void*) subscriber);
 
+    pos = &(self->appIdIndex[subscriber->appId % SUBSCRIBER_INDEX_SIZE]);
+
+    while ((*pos != NULL) && (*pos != subscriber))
+        pos = &((*pos)->nextByAppId);
+
+    if (*pos)
+        *pos = subscriber->nextByAppId;
+
+    updateSocketFilter(self);
+
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     Semaphore_post(self->subscriberListLock);
 #endif
@@ -253,7 +358,20 @@ SVReceiver_startThreadless(SVReceiver self)
 
     if (self->ethSocket) {
 
-        Ethernet_setProtocolFilter(self->ethSocket, ETH_P_SV);
+#if (CONFIG_ETHERNET_RX_RING_BLOCKS > 0)
+        Ethernet_enableRxRing(self->ethSocket, CONFIG_ETHERNET_RX_RING_BLOCK_SIZE,
+                CONFIG_ETHERNET_RX_RING_BLOCKS, CONFIG_ETHERNET_RX_RING_TIMEOUT_MS);
+#endif
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+        Semaphore_wait(self->subscriberListLock);
+#endif
+
+        updateSocketFilter(self);
+
+#if (CONFIG_MMS_THREADLESS_STACK == 0)
+        Semaphore_post(self->subscriberListLock);
+#endif
 
         self->running = true;
     }
@@ -267,14 +385,103 @@ SVReceiver_stopThreadless(SVReceiver self)
     if (self->ethSocket)
         Ethernet_destroySocket(self->ethSocket);
 
+    self->ethSocket = NULL;
     self->running = false;
 }
 
+#if defined(__GNUC__) || defined(__clang__)
+#define SV_RING_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define SV_RING_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#else
+#define SV_RING_LOAD_ACQUIRE(ptr) (*((volatile uint32_t*) (ptr)))
+#define SV_RING_STORE_RELEASE(ptr, val) (*((volatile uint32_t*) (ptr)) = (val))
+#endif
+
+#if defined(__SSE2__)
+static inline __m128i
+byteSwap32(__m128i x)
+{
+    /* swap the bytes of each 16 bit word and then the words of each 32 bit element */
+    x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+
+    return _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+#endif
+
+/*
+ * Decode INT32/quality pairs (big endian) into per channel arrays.
+ * values[channel * stride] and qualities[channel * stride] receive channel n.
+ */
 static void
-parseASDU(SVReceiver self, SVSubscriber subscriber, uint8_t* buffer, int length)
+decodeChannels(const uint8_t* data, int numberOfChannels, int32_t* values, Quality* qualities, int stride)
+{
+    int channel = 0;
+
+#if defined(__SSE2__)
+    for (; channel + 4 <= numberOfChannels; channel += 4) {
+        int32_t v[4];
+        uint32_t q[4];
+
+        __m128i a = byteSwap32(_mm_loadu_si128((const __m128i*) (data + channel * 8)));
+        __m128i b = byteSwap32(_mm_loadu_si128((const __m128i*) (data + channel * 8 + 16)));
+
+        /* [v0 q0 v1 q1] [v2 q2 v3 q3] -> [v0 v1 q0 q1] [v2 v3 q2 q3] */
+        a = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 1, 2, 0));
+        b = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 1, 2, 0));
+
+        _mm_storeu_si128((__m128i*) v, _mm_unpacklo_epi64(a, b));
+        _mm_storeu_si128((__m128i*) q, _mm_unpackhi_epi64(a, b));
+
+        values[(channel + 0) * stride] = v[0];
+        values[(channel + 1) * stride] = v[1];
+        values[(channel + 2) * stride] = v[2];
+        values[(channel + 3) * stride] = v[3];
+
+        qualities[(channel + 0) * stride] = (Quality) q[0];
+        qualities[(channel + 1) * stride] = (Quality) q[1];
+        qualities[(channel + 2) * stride] = (Quality) q[2];
+        qualities[(channel + 3) * stride] = (Quality) q[3];
+    }
+#endif
+
+    for (; channel < numberOfChannels; channel++) {
+        const uint8_t* pair = data + channel * 8;
+
+        values[channel * stride] = (int32_t) (((uint32_t) pair[0] << 24) | ((uint32_t) pair[1] << 16) |
+                ((uint32_t) pair[2] << 8) | (uint32_t) pair[3]);
+
+        qualities[channel * stride] = (Quality) ((pair[6] << 8) | pair[7]);
+    }
+}
+
+static void
+writeToSampleRing(SVSampleRing self, SVSubscriber_ASDU asdu)
 {
-    (void)self;
+    if ((asdu->dataBuffer == NULL) || (asdu->dataBufferLength < (self->numberOfChannels * 8)))
+        return;
+
+    uint32_t writePos = self->writePos;
 
+    if ((writePos - SV_RING_LOAD_ACQUIRE(&(self->readPos))) >= self->capacity) {
+        SV_RING_STORE_RELEASE(&(self->dropped), self->dropped + 1);
+        return;
+    }
+
+    uint32_t slot = writePos & self->mask;
+
+    decodeChannels(asdu->dataBuffer, self->numberOfChannels, self->values + slot, self->qualities + slot,
+            (int) self->capacity);
+
+    self->smpCnts[slot] = (asdu->smpCnt != NULL) ? SVSubscriber_ASDU_getSmpCnt(asdu) : 0;
+    self->rxTimes[slot] = asdu->rxTime;
+
+    SV_RING_STORE_RELEASE(&(self->writePos), writePos + 1);
+}
+
+static void
+parseASDU(SVReceiver self, SVSubscriber subscriber, uint8_t* buffer, int length)
+{
     int bufPos = 0;
     int svIdLength = 0;
     int datSetLength = 0;
@@ -282,6 +489,8 @@ parseASDU(SVReceiver self, SVSubscriber subscriber, uint8_t* buffer, int length)
     struct sSVSubscriber_ASDU asdu;
     memset(&asdu, 0, sizeof(struct sSVSubscriber_ASDU));
 
+    asdu.rxTime = self->rxTime;
+
     while (bufPos < length) {
         int elementLength;
 
@@ -368,6 +577,12 @@ parseASDU(SVReceiver self, SVSubscriber subscriber, uint8_t* buffer, int length)
 
     /* Call callback handler */
     if (subscriber) {
+        if (subscriber->sampleBuffer != NULL)
+            SVSubscriber_ASDU_decodeSamples(&asdu, subscriber->sampleBuffer);
+
+        if (subscriber->sampleRing != NULL)
+            writeToSampleRing(subscriber->sampleRing, &asdu);
+
         if (subscriber->listener != NULL)
             subscriber->listener(subscriber, subscriber->listenerParameter, &asdu);
     }
@@ -455,10 +670,9 @@ exit_error:
 }
 
 static void
-parseSVMessage(SVReceiver self, int numbytes)
+parseSVMessage(SVReceiver self, uint8_t* buffer, int numbytes)
 {
     int bufPos;
-    uint8_t* buffer = self->buffer;
 
     if (numbytes < 22) return;
 
@@ -517,10 +731,9 @@ parseSVMessage(SVReceiver self, int numbytes)
 
     SVSubscriber subscriber = NULL;
 
-    LinkedList element = LinkedList_getNext(self->subscriberList);
+    SVSubscriber subscriberElem = self->appIdIndex[appId % SUBSCRIBER_INDEX_SIZE];
 
-    while (element != NULL) {
-        SVSubscriber subscriberElem = (SVSubscriber) LinkedList_getData(element);
+    while (subscriberElem != NULL) {
 
         if (subscriberElem->appId == appId) {
 
@@ -540,32 +753,38 @@ parseSVMessage(SVReceiver self, int numbytes)
 
         }
 
-        element = LinkedList_getNext(element);
+        subscriberElem = subscriberElem->nextByAppId;
     }
 
 #if (CONFIG_MMS_THREADLESS_STACK == 0)
     Semaphore_post(self->subscriberListLock);
 #endif
 
-    if (subscriber)
+    if (subscriber) {
+        subscriber->rxTimestamp = self->rxTime;
         parseSVPayload(self, subscriber, buffer + bufPos, apduLength);
+    }
     else {
         if (DEBUG_SV_SUBSCRIBER)
             printf("SV_SUBSCRIBER: SV message ignored due to unknown APPID value or dest address mismatch\n");
     }
 }
 
+static void
+handleFrame(void* parameter, uint8_t* frame, int frameSize, nsSinceEpoch rxTime)
+{
+    SVReceiver self = (SVReceiver) parameter;
+
+    self->rxTime = rxTime;
+
+    parseSVMessage(self, frame, frameSize);
+}
+
 bool
 SVReceiver_tick(SVReceiver self)
 {
-    int packetSize = Ethernet_receivePacket(self->ethSocket, self->buffer, ETH_BUFFER_LENGTH);
-
-    if (packetSize > 0) {
-        parseSVMessage(self, packetSize);
-        return true;
-    }
-    else
-        return false;
+    return (Ethernet_receivePackets(self->ethSocket, self->buffer, ETH_BUFFER_LENGTH,
+            CONFIG_ETHERNET_RX_BATCH_SIZE, handleFrame, self) > 0);
 }
 
 SVSubscriber
@@ -598,6 +817,12 @@ SVSubscriber_setListener(SVSubscriber self,  SVUpdateListener listener, void* pa
     self->listenerParameter = parameter;
 }
 
+uint64_t
+SVSubscriber_getRxTimestamp(SVSubscriber self)
+{
+    return self->rxTimestamp;
+}
+
 uint16_t
 SVSubscriber_ASDU_getSmpCnt(SVSubscriber_ASDU self)
 {
@@ -904,6 +1129,224 @@ SVSubscriber_ASDU_getDataSize(SVSubscriber_ASDU self)
     return self->dataBufferLength;
 }
 
+SVSampleBuffer
+SVSampleBuffer_create(int numberOfChannels, int capacity)
+{
+    if ((numberOfChannels < 1) || (capacity < 1))
+        return NULL;
+
+    SVSampleBuffer self = (SVSampleBuffer) GLOBAL_CALLOC(1, sizeof(struct sSVSampleBuffer));
+
+    if (self != NULL) {
+        self->numberOfChannels = numberOfChannels;
+        self->capacity = capacity;
+
+        self->values = (int32_t*) GLOBAL_MALLOC(sizeof(int32_t) * numberOfChannels * capacity);
+        self->qualities = (Quality*) GLOBAL_MALLOC(sizeof(Quality) * numberOfChannels * capacity);
+        self->smpCnts = (uint16_t*) GLOBAL_MALLOC(sizeof(uint16_t) * capacity);
+        self->rxTimes = (nsSinceEpoch*) GLOBAL_MALLOC(sizeof(nsSinceEpoch) * capacity);
+
+        if ((self->values == NULL) || (self->qualities == NULL) || (self->smpCnts == NULL) || (self->rxTimes == NULL)) {
+            SVSampleBuffer_destroy(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+void
+SVSampleBuffer_destroy(SVSampleBuffer self)
+{
+    if (self != NULL) {
+        GLOBAL_FREEMEM(self->values);
+        GLOBAL_FREEMEM(self->qualities);
+        GLOBAL_FREEMEM(self->smpCnts);
+        GLOBAL_FREEMEM(self->rxTimes);
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+int
+SVSampleBuffer_getNumberOfChannels(SVSampleBuffer self)
+{
+    return self->numberOfChannels;
+}
+
+int
+SVSampleBuffer_getCapacity(SVSampleBuffer self)
+{
+    return self->capacity;
+}
+
+int
+SVSampleBuffer_getSize(SVSampleBuffer self)
+{
+    return self->size;
+}
+
+void
+SVSampleBuffer_clear(SVSampleBuffer self)
+{
+    self->size = 0;
+}
+
+int32_t*
+SVSampleBuffer_getValues(SVSampleBuffer self, int channel)
+{
+    return self->values + (channel * self->capacity);
+}
+
+Quality*
+SVSampleBuffer_getQualities(SVSampleBuffer self, int channel)
+{
+    return self->qualities + (channel * self->capacity);
+}
+
+uint16_t*
+SVSampleBuffer_getSmpCnts(SVSampleBuffer self)
+{
+    return self->smpCnts;
+}
+
+nsSinceEpoch*
+SVSampleBuffer_getRxTimes(SVSampleBuffer self)
+{
+    return self->rxTimes;
+}
+
+bool
+SVSubscriber_ASDU_decodeSamples(SVSubscriber_ASDU self, SVSampleBuffer buffer)
+{
+    if (buffer->size >= buffer->capacity)
+        return false;
+
+    if ((self->dataBuffer == NULL) || (self->dataBufferLength < (buffer->numberOfChannels * 8)))
+        return false;
+
+    int pos = buffer->size;
+
+    decodeChannels(self->dataBuffer, buffer->numberOfChannels, buffer->values + pos, buffer->qualities + pos,
+            buffer->capacity);
+
+    buffer->smpCnts[pos] = (self->smpCnt != NULL) ? SVSubscriber_ASDU_getSmpCnt(self) : 0;
+    buffer->rxTimes[pos] = self->rxTime;
+
+    buffer->size = pos + 1;
+
+    return true;
+}
+
+void
+SVSubscriber_setSampleBuffer(SVSubscriber self, SVSampleBuffer buffer)
+{
+    self->sampleBuffer = buffer;
+}
+
+SVSampleRing
+SVSampleRing_create(int numberOfChannels, int capacity)
+{
+    if ((numberOfChannels < 1) || (capacity < 1) || ((capacity & (capacity - 1)) != 0))
+        return NULL;
+
+    SVSampleRing self = (SVSampleRing) GLOBAL_CALLOC(1, sizeof(struct sSVSampleRing));
+
+    if (self != NULL) {
+        self->numberOfChannels = numberOfChannels;
+        self->capacity = (uint32_t) capacity;
+        self->mask = (uint32_t) (capacity - 1);
+
+        self->values = (int32_t*) GLOBAL_MALLOC(sizeof(int32_t) * numberOfChannels * capacity);
+        self->qualities = (Quality*) GLOBAL_MALLOC(sizeof(Quality) * numberOfChannels * capacity);
+        self->smpCnts = (uint16_t*) GLOBAL_MALLOC(sizeof(uint16_t) * capacity);
+        self->rxTimes = (nsSinceEpoch*) GLOBAL_MALLOC(sizeof(nsSinceEpoch) * capacity);
+
+        if ((self->values == NULL) || (self->qualities == NULL) || (self->smpCnts == NULL) || (self->rxTimes == NULL)) {
+            SVSampleRing_destroy(self);
+            self = NULL;
+        }
+    }
+
+    return self;
+}
+
+void
+SVSampleRing_destroy(SVSampleRing self)
+{
+    if (self != NULL) {
+        GLOBAL_FREEMEM(self->values);
+        GLOBAL_FREEMEM(self->qualities);
+        GLOBAL_FREEMEM(self->smpCnts);
+        GLOBAL_FREEMEM(self->rxTimes);
+        GLOBAL_FREEMEM(self);
+    }
+}
+
+int
+SVSampleRing_read(SVSampleRing self, SVSampleBuffer buffer)
+{
+    uint32_t readPos = self->readPos;
+    uint32_t available = SV_RING_LOAD_ACQUIRE(&(self->writePos)) - readPos;
+    uint32_t space = (uint32_t) (buffer->capacity - buffer->size);
+
+    int numberOfChannels = buffer->numberOfChannels;
+
+    if (numberOfChannels > self->numberOfChannels)
+        numberOfChannels = self->numberOfChannels;
+
+    uint32_t count = (available < space) ? available : space;
+
+    if (count == 0)
+        return 0;
+
+    /* copy in up to two parts when the range wraps around the end of the ring */
+    uint32_t slot = readPos & self->mask;
+    uint32_t first = self->capacity - slot;
+
+    if (first > count)
+        first = count;
+
+    uint32_t second = count - first;
+
+    int pos = buffer->size;
+    int channel;
+
+    for (channel = 0; channel < numberOfChannels; channel++) {
+        int32_t* srcValues = self->values + (channel * self->capacity);
+        Quality* srcQualities = self->qualities + (channel * self->capacity);
+        int32_t* dstValues = buffer->values + (channel * buffer->capacity) + pos;
+        Quality* dstQualities = buffer->qualities + (channel * buffer->capacity) + pos;
+
+        memcpy(dstValues, srcValues + slot, first * sizeof(int32_t));
+        memcpy(dstValues + first, srcValues, second * sizeof(int32_t));
+        memcpy(dstQualities, srcQualities + slot, first * sizeof(Quality));
+        memcpy(dstQualities + first, srcQualities, second * sizeof(Quality));
+    }
+
+    memcpy(buffer->smpCnts + pos, self->smpCnts + slot, first * sizeof(uint16_t));
+    memcpy(buffer->smpCnts + pos + first, self->smpCnts, second * sizeof(uint16_t));
+    memcpy(buffer->rxTimes + pos, self->rxTimes + slot, first * sizeof(nsSinceEpoch));
+    memcpy(buffer->rxTimes + pos + first, self->rxTimes, second * sizeof(nsSinceEpoch));
+
+    buffer->size = pos + (int) count;
+
+    SV_RING_STORE_RELEASE(&(self->readPos), readPos + count);
+
+    return (int) count;
+}
+
+uint32_t
+SVSampleRing_getDroppedSamples(SVSampleRing self)
+{
+    return SV_RING_LOAD_ACQUIRE(&(self->dropped));
+}
+
+void
+SVSubscriber_setSampleRing(SVSubscriber self, SVSampleRing ring)
+{
+    self->sampleRing = ring;
+}
+
 uint16_t
 SVClientASDU_getSmpCnt(SVSubscriber_ASDU self)
 {
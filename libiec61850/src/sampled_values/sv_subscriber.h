@@ -237,11 +237,12 @@ SVReceiver_stopThreadless(SVReceiver self);
 /**
  * \brief Parse SV messages if they are available.
  *
- * Call after reception of ethernet frame and periodically to to house keeping tasks
+ * Call after reception of ethernet frame and periodically to to house keeping tasks.
+ * Up to CONFIG_ETHERNET_RX_BATCH_SIZE pending messages are parsed per call.
  *
  * \param self the receiver object
  *
- * \return true if a message was available and has been parsed, false otherwise
+ * \return true if at least one message was available and has been parsed, false otherwise
  */
 LIB61850_API bool
 SVReceiver_tick(SVReceiver self);
@@ -272,6 +273,18 @@ SVSubscriber_create(const uint8_t* ethAddr, uint16_t appID);
 LIB61850_API void
 SVSubscriber_setListener(SVSubscriber self,  SVUpdateListener listener, void* parameter);
 
+/**
+ * \brief Get the arrival time of the SV message currently processed
+ *
+ * When the SV receiver uses a receive ring this is the kernel timestamp of the frame.
+ *
+ * \param self The subscriber object
+ *
+ * \return the arrival time in nanoseconds since epoch (1.1.1970 UTC)
+ */
+LIB61850_API uint64_t
+SVSubscriber_getRxTimestamp(SVSubscriber self);
+
 LIB61850_API void
 SVSubscriber_destroy(SVSubscriber self);
 
@@ -539,6 +552,165 @@ SVSubscriber_ASDU_getQuality(SVSubscriber_ASDU self, int index);
 LIB61850_API int
 SVSubscriber_ASDU_getDataSize(SVSubscriber_ASDU self);
 
+/**
+ * \addtogroup sv_subscriber_bulk_api_group Bulk sample decoding
+ * \ingroup sv_subscriber_api_group
+ *
+ * For data sets that consist of INT32 values each followed by a quality (like the
+ * 8 current/voltage channels of IEC 61850-9-2LE) the samples can be decoded in bulk into
+ * structure-of-arrays buffers instead of calling \ref SVSubscriber_ASDU_getINT32 and
+ * \ref SVSubscriber_ASDU_getQuality for each channel. Channel n of an ASDU is
+ * taken from data offset n * 8 (value) and n * 8 + 4 (quality).
+ *
+ * @{
+ */
+
+/**
+ * \brief Structure-of-arrays buffer for decoded samples (one array per channel)
+ */
+typedef struct sSVSampleBuffer* SVSampleBuffer;
+
+/**
+ * \brief Single producer/single consumer ring to pass decoded samples to another thread
+ */
+typedef struct sSVSampleRing* SVSampleRing;
+
+/**
+ * \brief Create a new sample buffer
+ *
+ * \param numberOfChannels number of INT32/quality pairs decoded from each ASDU
+ * \param capacity maximum number of samples the buffer can hold
+ *
+ * \return the new sample buffer instance or NULL when the parameters are invalid
+ */
+LIB61850_API SVSampleBuffer
+SVSampleBuffer_create(int numberOfChannels, int capacity);
+
+LIB61850_API void
+SVSampleBuffer_destroy(SVSampleBuffer self);
+
+LIB61850_API int
+SVSampleBuffer_getNumberOfChannels(SVSampleBuffer self);
+
+LIB61850_API int
+SVSampleBuffer_getCapacity(SVSampleBuffer self);
+
+/**
+ * \brief Get the number of samples currently stored in the buffer
+ */
+LIB61850_API int
+SVSampleBuffer_getSize(SVSampleBuffer self);
+
+/**
+ * \brief Remove all samples from the buffer
+ */
+LIB61850_API void
+SVSampleBuffer_clear(SVSampleBuffer self);
+
+/**
+ * \brief Get the decoded values of a channel
+ *
+ * \param channel the channel index (0 .. numberOfChannels - 1)
+ *
+ * \return array of \ref SVSampleBuffer_getSize values (oldest first)
+ */
+LIB61850_API int32_t*
+SVSampleBuffer_getValues(SVSampleBuffer self, int channel);
+
+/**
+ * \brief Get the decoded qualities of a channel
+ *
+ * \param channel the channel index (0 .. numberOfChannels - 1)
+ *
+ * \return array of \ref SVSampleBuffer_getSize quality values (oldest first)
+ */
+LIB61850_API Quality*
+SVSampleBuffer_getQualities(SVSampleBuffer self, int channel);
+
+/**
+ * \brief Get the SmpCnt values of the stored samples
+ */
+LIB61850_API uint16_t*
+SVSampleBuffer_getSmpCnts(SVSampleBuffer self);
+
+/**
+ * \brief Get the reception times of the frames the stored samples were taken from
+ */
+LIB61850_API nsSinceEpoch*
+SVSampleBuffer_getRxTimes(SVSampleBuffer self);
+
+/**
+ * \brief Decode the INT32/quality channels of an ASDU and append them to a sample buffer
+ *
+ * \param self ASDU object instance
+ * \param buffer the sample buffer
+ *
+ * \return true if the sample was appended, false if the buffer is full or the ASDU
+ *         contains less data than required for the channels of the buffer
+ */
+LIB61850_API bool
+SVSubscriber_ASDU_decodeSamples(SVSubscriber_ASDU self, SVSampleBuffer buffer);
+
+/**
+ * \brief Decode all received ASDUs of the subscriber into a sample buffer
+ *
+ * Every ASDU received for the subscriber is appended to the buffer before the
+ * listener is called. As long as the application doesn't clear the buffer samples
+ * accumulate across messages and receive batches (e.g. all frames handled
+ * by one call of \ref SVReceiver_tick). When the buffer is full further samples are dropped.
+ *
+ * \param self the subscriber instance
+ * \param buffer the sample buffer or NULL to disable bulk decoding
+ */
+LIB61850_API void
+SVSubscriber_setSampleBuffer(SVSubscriber self, SVSampleBuffer buffer);
+
+/**
+ * \brief Create a new sample ring
+ *
+ * \param numberOfChannels number of INT32/quality pairs decoded from each ASDU
+ * \param capacity number of samples the ring can hold (has to be a power of 2)
+ *
+ * \return the new sample ring instance or NULL when the parameters are invalid
+ */
+LIB61850_API SVSampleRing
+SVSampleRing_create(int numberOfChannels, int capacity);
+
+LIB61850_API void
+SVSampleRing_destroy(SVSampleRing self);
+
+/**
+ * \brief Move samples from the ring into a sample buffer (consumer side)
+ *
+ * Only a single thread may read from the ring. Samples are appended to the buffer
+ * until it is full or the ring is empty. The buffer has to have at most the number
+ * of channels of the ring.
+ *
+ * \return number of samples moved to the buffer
+ */
+LIB61850_API int
+SVSampleRing_read(SVSampleRing self, SVSampleBuffer buffer);
+
+/**
+ * \brief Get the number of samples that were dropped because the ring was full
+ */
+LIB61850_API uint32_t
+SVSampleRing_getDroppedSamples(SVSampleRing self);
+
+/**
+ * \brief Decode all received ASDUs of the subscriber into a sample ring (producer side)
+ *
+ * The ring is filled by the thread that runs the receiver (the receiver thread or the
+ * caller of \ref SVReceiver_tick).
+ *
+ * \param self the subscriber instance
+ * \param ring the sample ring or NULL to disable
+ */
+LIB61850_API void
+SVSubscriber_setSampleRing(SVSubscriber self, SVSampleRing ring);
+
+/**@}*/
+
 #ifndef DEPRECATED
 #if defined(__GNUC__) || defined(__clang__)
   #define DEPRECATED __attribute__((deprecated))
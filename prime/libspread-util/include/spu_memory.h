@@ -158,6 +158,9 @@ int     Mem_valid_objtype(int32u objtype);
  */
 int32u  Mem_Obj_Type(const void *object);
 
+/* Number of free objects of objtype kept in its pool (all builds) */
+unsigned int Mem_obj_in_pool(int32u objtype);
+
 #ifndef NDEBUG
 extern LOC_INLINE unsigned int Mem_total_bytes(void);
 extern LOC_INLINE unsigned int Mem_total_max_bytes(void);
@@ -167,7 +170,6 @@ extern LOC_INLINE unsigned int Mem_total_obj(void);
 extern LOC_INLINE unsigned int Mem_total_max_obj(void);
 extern LOC_INLINE unsigned int Mem_bytes(int32u objtype);
 extern LOC_INLINE unsigned int Mem_max_bytes(int32u objtype);
-extern LOC_INLINE unsigned int Mem_obj_in_pool(int32u objtype);
 extern LOC_INLINE unsigned int Mem_obj_in_app(int32u objtype);
 extern LOC_INLINE unsigned int Mem_max_in_app(int32u objtype);
 extern LOC_INLINE unsigned int Mem_obj_total(int32u objtype);    
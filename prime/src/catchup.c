@@ -264,13 +264,14 @@ void CATCH_Process_ORD_Certificate(signed_message *mess)
      * matches the one that is coming from the cert. If not, we need to throw away the
      * one we have stored and adopt the one from the certificate */
     if (slot->collected_all_parts) {
+        memset(&cert_complete_pp, 0, sizeof(cert_complete_pp));
         cert_complete_pp.seq_num = pp_specific->seq_num;
         cert_complete_pp.view = pp_specific->view;
         memcpy(&cert_complete_pp.proposal_digest, &pp_specific->proposal_digest, DIGEST_SIZE);
         memcpy(&cert_complete_pp.last_executed, &pp_specific->last_executed, 
-                sizeof(pp_specific->last_executed));
-        memcpy(&cert_complete_pp.cum_acks, (byte *)(pp_specific + 1), 
-                sizeof(po_aru_signed_message) * pp_specific->num_acks_in_this_message);
+                VAR.Num_Servers * sizeof(po_seq_pair));
+        UTIL_Unpack_PO_ARUs(cert_complete_pp.cum_acks, PP_CUM_ACKS(pp_specific, VAR.Num_Servers),
+                pp_specific->num_acks_in_this_message);
         OPENSSL_RSA_Make_Digest((byte *)&cert_complete_pp,
                 sizeof(complete_pre_prepare_message), cert_pp_digest);
         OPENSSL_RSA_Make_Digest((byte *)&slot->complete_pre_prepare, 
@@ -304,8 +305,7 @@ void CATCH_Process_ORD_Certificate(signed_message *mess)
     }
 
     /* First process the Pre-Prepare */
-    temp = UTIL_New_Signed_Message();
-    memcpy(temp, pp, UTIL_Message_Size(pp));
+    temp = UTIL_Copy_Message(pp, UTIL_Message_Size(pp));
     PROCESS_Message(temp);
     dec_ref_cnt(temp);
 
@@ -313,8 +313,7 @@ void CATCH_Process_ORD_Certificate(signed_message *mess)
     ptr = (byte *)(((byte *)pp) + UTIL_Message_Size(pp));
     for (i = 1; i <= 2*VAR.F + VAR.K + 1; i++) {
         commit = (signed_message *)ptr;
-        temp = UTIL_New_Signed_Message();
-        memcpy(temp, commit, UTIL_Message_Size(commit));
+        temp = UTIL_Copy_Message(commit, UTIL_Message_Size(commit));
         PROCESS_Message(temp);
         dec_ref_cnt(temp);
         ptr += UTIL_Message_Size(commit);
@@ -476,8 +475,7 @@ void CATCH_Process_PO_Certificate(signed_message *mess)
     }
 
     /* Process the PO Request */
-    temp = UTIL_New_Signed_Message();
-    memcpy(temp, po_req, UTIL_Message_Size(po_req));
+    temp = UTIL_Copy_Message(po_req, UTIL_Message_Size(po_req));
     PROCESS_Message(temp);
     dec_ref_cnt(temp);
 
@@ -486,11 +484,10 @@ void CATCH_Process_PO_Certificate(signed_message *mess)
     for (i = 1; i <= 2*VAR.F + VAR.K + 1; i++) {
         po_ack = (signed_message *)ptr;
 
-        temp = UTIL_New_Signed_Message();
-        memcpy(temp, po_ack, UTIL_Message_Size(po_ack));
+        temp = UTIL_Copy_Message(po_ack, UTIL_Message_Size(po_ack));
 
         po_ack_specific = (po_ack_message *)(temp + 1);
-        part = (po_ack_part *)(po_ack_specific + 1);
+        part = PO_ACK_PARTS(po_ack_specific, VAR.Num_Servers);
         
         for (j = 0; j < po_ack_specific->num_ack_parts; j++) {
             if (part[j].originator == po_req->machine_id && 
@@ -935,8 +932,7 @@ void CATCH_Process_Jump(signed_message *mess)
             Alarm(PRINT, "Process_Jump: Change from periodic to active catchup. ARU = %u, cert = %u\n",
                 DATA.ORD.ARU, oc_specific->seq_num);
             
-            DATA.CATCH.last_ord_cert[sender] = UTIL_New_Signed_Message();
-            memcpy(DATA.CATCH.last_ord_cert[sender], oc, UTIL_Message_Size(oc));
+            DATA.CATCH.last_ord_cert[sender] = UTIL_Copy_Message(oc, UTIL_Message_Size(oc));
 
             CATCH_Schedule_Catchup();
 
@@ -1034,8 +1030,8 @@ void CATCH_Process_Catchup_Reply(signed_message *mess)
         slot->pp_catchup_replies[mess->machine_id] = mess;
     
         pp_count = 0;
-        OPENSSL_RSA_Make_Digest((byte *)pp, sizeof(pre_prepare_message) +
-                pp->num_acks_in_this_message * sizeof(po_aru_signed_message), 
+        OPENSSL_RSA_Make_Digest((byte *)pp, PRE_PREPARE_SIZE(VAR.Num_Servers) +
+                pp->num_acks_in_this_message * PO_ARU_SIGNED_SIZE(VAR.Num_Servers), 
                 new_digest);
 
         for (i = 1; i <= VAR.Num_Servers; i++) {
@@ -1046,9 +1042,9 @@ void CATCH_Process_Catchup_Reply(signed_message *mess)
                         sizeof(signed_message) + sizeof(catchup_reply_message) +
                         sizeof(signed_message));
             OPENSSL_RSA_Make_Digest((byte *)stored_pp, 
-                    sizeof(pre_prepare_message) +
+                    PRE_PREPARE_SIZE(VAR.Num_Servers) +
                     stored_pp->num_acks_in_this_message * 
-                    sizeof(po_aru_signed_message), 
+                    PO_ARU_SIGNED_SIZE(VAR.Num_Servers), 
                     stored_digest);
 
             if (!OPENSSL_RSA_Digests_Equal(new_digest, stored_digest)) {
@@ -1067,9 +1063,11 @@ void CATCH_Process_Catchup_Reply(signed_message *mess)
     memset(&complete_pp, 0, sizeof(complete_pp));
     complete_pp.seq_num = pp->seq_num;              /* might not be correct for NO_OP */
     complete_pp.view = pp->view;
-    memcpy((byte *)(&complete_pp.cum_acks),
-            (byte *)(pp + 1), 
-            sizeof(po_aru_signed_message) * pp->num_acks_in_this_message);    
+    memcpy(&complete_pp.proposal_digest, &pp->proposal_digest, DIGEST_SIZE);
+    memcpy(&complete_pp.last_executed, &pp->last_executed, 
+            VAR.Num_Servers * sizeof(po_seq_pair));
+    UTIL_Unpack_PO_ARUs(complete_pp.cum_acks, PP_CUM_ACKS(pp, VAR.Num_Servers),
+            pp->num_acks_in_this_message);
 
     if (c_reply->type == SLOT_COMMIT) {
         /* Next, start grabbing the commits */
@@ -1450,8 +1448,7 @@ void CATCH_Jump_Ahead(signed_message *mess)
     o_slot->total_parts                  = pp_specific->total_parts;
 
     o_slot->pre_prepare_parts[1] = 1;
-    o_slot->pre_prepare_parts_msg[1] = UTIL_New_Signed_Message();
-    memcpy(o_slot->pre_prepare_parts_msg[1], pp, UTIL_Message_Size(pp));
+    o_slot->pre_prepare_parts_msg[1] = UTIL_Copy_Message(pp, UTIL_Message_Size(pp));
 
     o_slot->num_parts_collected = o_slot->total_parts;
     o_slot->num_forwarded_parts = o_slot->total_parts;
@@ -1466,11 +1463,11 @@ void CATCH_Jump_Ahead(signed_message *mess)
     memset(&complete_pp, 0, sizeof(complete_pp));
     complete_pp.seq_num = ord_cert->seq_num;
     complete_pp.view = ord_cert->view;
-    memcpy((byte *)&complete_pp.last_executed, &pp_specific->last_executed, sizeof(pp_specific->last_executed));
+    memcpy((byte *)&complete_pp.last_executed, &pp_specific->last_executed, 
+            VAR.Num_Servers * sizeof(po_seq_pair));
     memcpy((byte *)&complete_pp.proposal_digest, &pp_specific->proposal_digest, DIGEST_SIZE);
-    memcpy((byte *)(&complete_pp.cum_acks),
-            (byte *)(pp_specific + 1), 
-            sizeof(po_aru_signed_message) * pp_specific->num_acks_in_this_message);    
+    UTIL_Unpack_PO_ARUs(complete_pp.cum_acks, PP_CUM_ACKS(pp_specific, VAR.Num_Servers),
+            pp_specific->num_acks_in_this_message);
     memcpy(&o_slot->complete_pre_prepare, &complete_pp, sizeof(complete_pp));
 
     /* Setup preinstalled snapshot on the slot */
@@ -101,6 +101,7 @@ void Handle_Config_Msg(int s, int source, void * dummy_p);
 void full_decrypt(int decrypt_id,int32u key_parts,int32u key_part_size,int32u unenc_size,char *enc_key, char *dec_key){
     char dec_filename[250];
     char pvtkeyfilename[250];
+    openssl_rsa_key *pvtkey;
     char *dec_chunk;
     dec_chunk=malloc(key_part_size);
     int i;
@@ -108,9 +109,10 @@ void full_decrypt(int decrypt_id,int32u key_parts,int32u key_part_size,int32u un
     memset(pvtkeyfilename,0,sizeof(pvtkeyfilename));
     sprintf(pvtkeyfilename,"./tpm_keys/tpm_private%d.pem",decrypt_id);
     Alarm(DEBUG,"Pvt decryption key file is %s\n",pvtkeyfilename);
+    pvtkey = OPENSSL_RSA_Open_Key(pvtkeyfilename, RSA_KEY_PRIVATE);
     for(i =0; i< key_parts; i++){
         memset(dec_chunk,0,key_part_size);
-        OPENSSL_RSA_Decrypt(pvtkeyfilename,enc_key,key_part_size,dec_chunk);
+        OPENSSL_RSA_Decrypt(pvtkey,enc_key,key_part_size,dec_chunk);
         if(unenc_size>=key_part_size){
 	    memcpy(dec_key,dec_chunk,key_part_size);
 	    //memcpy(dec_key,enc_key,key_part_size);
@@ -128,6 +130,7 @@ void full_decrypt(int decrypt_id,int32u key_parts,int32u key_part_size,int32u un
             unenc_size-=unenc_size;
     Alarm(DEBUG,"remaining key len=%lu\n",unenc_size);
     }
+    OPENSSL_RSA_Release_Key(pvtkey);
 }
 
 
@@ -197,6 +197,7 @@ void read_pvt_key(const char * filename,int type, int id){
     FILE *fp;
     char enc_key_filename[250];
     int keysize,enc_key_size,key_parts,ret,rem_data_len = 0;
+    openssl_rsa_key *enc_key;
     pvt_key_header *pvt_header;
     char *enc_buff;
     char *data_buff;
@@ -208,7 +209,8 @@ void read_pvt_key(const char * filename,int type, int id){
     if(type==SM_TC_PVT || type == PRIME_TC_PVT){
 	sprintf(enc_key_filename,"./tpm_keys/tpm_public%d.pem",id+1);
     }
-    enc_key_size = OPENSSL_RSA_Get_KeySize(enc_key_filename);
+    enc_key = OPENSSL_RSA_Open_Key(enc_key_filename, RSA_KEY_PUBLIC);
+    enc_key_size = OPENSSL_RSA_Get_KeySize(enc_key);
     enc_buff= malloc(enc_key_size);
     data_buff= malloc(enc_key_size);
     fp=fopen(filename,"r");
@@ -262,8 +264,8 @@ void read_pvt_key(const char * filename,int type, int id){
         }
         //Alarm(DEBUG,"Read from file chunck =%d , rem_data_len=%d\n",ret,rem_data_len);
         //encrypt the chunk and write
-        //OPENSSL_RSA_Encrypt(enc_key_filename,data_buff,data_len,enc_buff);
-        OPENSSL_RSA_Encrypt(enc_key_filename,data_buff,enc_key_size,enc_buff);
+        //OPENSSL_RSA_Encrypt(enc_key,data_buff,data_len,enc_buff);
+        OPENSSL_RSA_Encrypt(enc_key,data_buff,enc_key_size,enc_buff);
         memcpy(&key_buff[curr_idx],enc_buff,enc_key_size);
         //memcpy(&key_buff[curr_idx],data_buff,enc_key_size);
         //inc curr_idx
@@ -271,6 +273,7 @@ void read_pvt_key(const char * filename,int type, int id){
     }
     
     fclose(fp);
+    OPENSSL_RSA_Release_Key(enc_key);
     Alarm(PRINT,"after %s pvtkey curr_idx=%d, header=%d, keysize=%d\n",filename,curr_idx,sizeof(pvt_key_header),key_parts*enc_key_size);
     
 }
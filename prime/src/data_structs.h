@@ -75,6 +75,18 @@ typedef struct server_variables_dummy {
   int32u  
 } configuration_variables; */
 
+/* Egress queue for one (destination, traffic class) pair.  Each queue has
+ * its own token bucket, refilled at an equal share of the class bandwidth. */
+typedef struct egress_queue_dummy {
+  dll_struct     pending;
+  double         tokens;
+  util_stopwatch sw;
+
+  /* Reporting, reset each time the stats are printed */
+  int32u         max_depth;
+  int32u         num_sent;
+} egress_queue;
+
 typedef struct network_variables_dummy {
   int32    My_Address;
   int32u   program_type;
@@ -120,25 +132,12 @@ typedef struct network_variables_dummy {
   int16u  Recon_Port;
   channel Recon_Channel;
 
-  dll_struct pending_messages_dll[NUM_TRAFFIC_CLASSES];
-  double tokens[NUM_TRAFFIC_CLASSES];
-  util_stopwatch sw[NUM_TRAFFIC_CLASSES];
+  /* Throttled messages wait in one queue per destination and traffic
+   * class, so a slow destination only delays its own traffic. */
+  egress_queue egress[MAX_NUM_SERVER_SLOTS][NUM_TRAFFIC_CLASSES];
 
 } network_variables;
 
-typedef struct dummy_net_struct {
-  signed_message *mess;
-  int32u server_id;
-  int32u site_id;
-
-  int32u dest_bits;
-  int32u num_remaining_destinations;
-  int32u destinations[MAX_NUM_SERVER_SLOTS];
-
-  int32u timeliness;
-
-} net_struct;
-
 typedef struct dummy_benchmark_struct {
   int32u updates_executed;
 
@@ -220,6 +219,9 @@ typedef struct dummy_po_data_struct {
   /* Collection of PO Slots that we have in memory */
   stdhash History[MAX_NUM_SERVER_SLOTS];
 
+  /* Recent PO Slots from History, indexed by seq_num % PO_HISTORY_WINDOW */
+  struct dummy_po_slot *History_Ring[MAX_NUM_SERVER_SLOTS][PO_HISTORY_WINDOW];
+
   /* This is the highest sequence number (client update) from each replica that
    * what we think the leader should know about. Essentially, its the highest
    * sequence number that 2f+k+1 have acked for that server. This is updated
@@ -448,6 +450,9 @@ typedef struct dummy_ordering_data_struct {
   /* The Ordering History, which stores ordering_slots */
   stdhash History;
 
+  /* Recent slots from History, indexed by seq_num % ORD_HISTORY_WINDOW */
+  ord_slot *History_Ring[ORD_HISTORY_WINDOW];
+
   util_stopwatch pre_prepare_sw;
 
   /* To store ord slots that are globally ordered but not yet ready to
@@ -806,6 +811,15 @@ typedef struct dummy_proactive_recovery_struct {
 
 } proactive_recovery_struct;
 
+/* A closed batch: its messages already carry their Merkle digests and
+ * wait for the signature on the root digest */
+typedef struct dummy_sig_batch {
+  dll_struct messages;
+  byte       root[DIGEST_SIZE];
+  byte       signature[SIGNATURE_SIZE];
+  double     sign_cost;
+} sig_batch;
+
 typedef struct dummy_signature_data_struct {
   dll_struct pending_messages_dll;
 
@@ -816,14 +830,29 @@ typedef struct dummy_signature_data_struct {
    * function immediately. */
   int32u num_consecutive_messages_read;
 
-  //sp_time sig_time;
-  sp_time sig_min_time;
-  sp_time sig_max_time;
-
-  // Debug + Benchmark timing of the batch events
-  util_stopwatch max_batch_sw;
-  util_stopwatch pb_batch_sw[100];
-  int32u pb_count;
+  /* Longest a message of each traffic class may wait to be signed */
+  sp_time class_target[NUM_TRAFFIC_CLASSES];
+
+  /* Batching controller: when the pending batch must be signed, moving
+   * averages of the gap between messages and of the time to sign a
+   * batch (in seconds), and the size at which the batch is closed */
+  sp_time batch_deadline;
+  sp_time last_arrival;
+  double  arrival_gap;
+  double  sign_cost;
+  int32u  batch_threshold;
+
+  /* Batch size and per-class wait histograms, printed every stats_period
+   * seconds if it is non-zero */
+  int32u  batch_size_hist[SIG_HIST_BUCKETS];
+  int32u  wait_hist[NUM_TRAFFIC_CLASSES][SIG_HIST_BUCKETS];
+  int32u  stats_period;
+
+  /* Batches handed to the signing thread, oldest first (see
+   * SIG_ASYNC_SIGNING) */
+  sig_batch batches[SIG_MAX_OUTSTANDING];
+  int32u    batch_head;
+  int32u    num_outstanding;
 
   float ipc_send_agg;
   float ipc_send_msg[50];
@@ -115,6 +115,7 @@ int32u update_count;
 int32u needed_count;
 double total_time;
 int32u time_stamp;
+int32u update_bytes = UPDATE_SIZE;
 int ca_driver;
 struct ip_mreq mreq;
 sp_time t;
@@ -253,6 +254,16 @@ void Usage(int argc, char **argv)
       needed_count = tmp;
       argc--; argv++;
     } 
+    /* [-u update_bytes] */
+    else if((argc > 1)&&(!strncmp(*argv, "-u", 2))) {
+      sscanf(argv[1], "%d", &tmp);
+      if(tmp < 0 || tmp > UPDATE_SIZE) {
+	Alarm(PRINT, "Update size must be between 0 and %d bytes\n", UPDATE_SIZE);
+	exit(0);
+      }
+      update_bytes = tmp;
+      argc--; argv++;
+    }
    else {
       Print_Usage();
     }
@@ -282,7 +293,8 @@ void Print_Usage()
 	"\t -l IP (A.B.C.D) \n"
 	"\t -c count_of_transactions_to_benchmark \n"
         "\t -i client_id, indexed base 1\n"
-	"\t[-s server_id, indexed base 1]\n");
+	"\t[-s server_id, indexed base 1]\n"
+	"\t[-u update_bytes, content bytes per update, default UPDATE_SIZE]\n");
 
   exit(0);
 }
@@ -454,8 +466,9 @@ void Init_Client_Network(void)
 void Net_Cli_Recv(channel sk, int dummy, void *dummy_p) 
 {
   int32  received_bytes;
-  int32u expected_total_size = 0, remaining_bytes;
+  int32u expected_total_size = 0, remaining_bytes, offset, size;
   int    ret;
+  signed_message *mess;
   struct sockaddr_un from;
   socklen_t from_len;
 
@@ -505,16 +518,28 @@ void Net_Cli_Recv(channel sk, int dummy, void *dummy_p)
     
   //Alarm(DEBUG, "Received %d bytes!\n", received_bytes);
   
-  /* Validate the client response */
-  if(!Validate_Message((signed_message*)srv_recv_scat.elements[0].buf, 
- 	       received_bytes)) {
-    Alarm(DEBUG,"CLIENT VALIDATION FAILURE\n");
-    return;
-  } 
-
-  /* Now process the message */
-  Process_Message( (signed_message*)(srv_recv_scat.elements[0].buf),  
-		   received_bytes);
+  /* The server may pack all of the responses for an ordinal back-to-back
+   * into one datagram, so validate and process each of them in turn */
+  offset = 0;
+  while (offset + sizeof(signed_message) <= (int32u)received_bytes) {
+    mess = (signed_message *)(srv_recv_scat.elements[0].buf + offset);
+    size = UTIL_Message_Size(mess);
+    if (size > received_bytes - offset) {
+      Alarm(PRINT, "Net_Cli_Recv: truncated response (%d of %d bytes)\n",
+            received_bytes - offset, size);
+      break;
+    }
+    offset += size;
+
+    /* Validate the client response */
+    if(!Validate_Message(mess, size)) {
+      Alarm(DEBUG,"CLIENT VALIDATION FAILURE\n");
+      continue;
+    } 
+
+    /* Now process the message */
+    Process_Message(mess, size);
+  }
   
   if(get_ref_cnt(srv_recv_scat.elements[0].buf) > 1) {
     dec_ref_cnt(srv_recv_scat.elements[0].buf);
@@ -653,7 +678,7 @@ void Send_Update(int dummy, void *dummyp)
     /* Build a new update */
     update             = UTIL_New_Signed_Message();
     update->machine_id = My_Client_ID;
-    update->len        = sizeof(update_message) + UPDATE_SIZE;
+    update->len        = sizeof(update_message) + update_bytes;
     update->type       = UPDATE;
     update->global_configuration_number =my_global_configuration_number;
 
@@ -681,11 +706,11 @@ void Send_Update(int dummy, void *dummyp)
 	  My_Client_ID, time_stamp, send_to_server);
 
     if (USE_IPC_CLIENT) {
-        ret = sendto(sd[send_to_server], update, sizeof(signed_update_message), 0,
+        ret = sendto(sd[send_to_server], update, UTIL_Message_Size(update), 0,
                     (struct sockaddr *)&Conn, sizeof(struct sockaddr_un));
     }
     else {
-        ret = NET_Write(sd[send_to_server], update, sizeof(signed_update_message));
+        ret = NET_Write(sd[send_to_server], update, UTIL_Message_Size(update));
     }
 
     if(ret <= 0) {
@@ -83,8 +83,8 @@ static sys_scatter srv_recv_scat;
 void Initialize_Listening_Socket(void);
 void NET_Client_Connection_Acceptor(int sd, int dummy, void *dummyp);
 #endif
-void NET_Throttle_Send             (int dummy, void* dummyp);
-void NET_Send_Message(net_struct *n);
+void NET_Throttle_Send             (int dest, void* dummyp);
+void NET_Initialize_Egress(void);
 void Initialize_IPC_Socket(void);
 void Initialize_UDP_Sockets(void);
 
@@ -94,10 +94,6 @@ int max_snd_buff(int sk);
 
 void Reconfig_Reset_Network(void) 
 {
-  int32u i;
-#if THROTTLE_OUTGOING_MESSAGES
-  sp_time t;
-#endif
 #if USE_IPC_CLIENT
   struct sockaddr_un conn;
 #endif
@@ -169,26 +165,12 @@ void Reconfig_Reset_Network(void)
 #endif
 
   /* Initialize the rest of the data structure */
-  for(i = 0; i < 2; i++) {
-    UTIL_DLL_Initialize(&NET.pending_messages_dll[i]);
-    NET.tokens[i] = 0.0;
-    UTIL_Stopwatch_Start(&NET.sw[i]);
-  }
-
-#if THROTTLE_OUTGOING_MESSAGES
-  t.sec  = THROTTLE_SEND_SEC;
-  t.usec = THROTTLE_SEND_USEC;
-  E_queue(NET_Throttle_Send, 0, NULL, t);
-#endif
+  NET_Initialize_Egress();
 }
 
 
 void Init_Network(void) 
 {
-  int32u i;
-#if THROTTLE_OUTGOING_MESSAGES
-  sp_time t;
-#endif
 #if USE_IPC_CLIENT
   struct sockaddr_un conn;
 #endif
@@ -259,17 +241,7 @@ void Init_Network(void)
 #endif
 
   /* Initialize the rest of the data structure */
-  for(i = 0; i < 2; i++) {
-    UTIL_DLL_Initialize(&NET.pending_messages_dll[i]);
-    NET.tokens[i] = 0.0;
-    UTIL_Stopwatch_Start(&NET.sw[i]);
-  }
-
-#if THROTTLE_OUTGOING_MESSAGES
-  t.sec  = THROTTLE_SEND_SEC;
-  t.usec = THROTTLE_SEND_USEC;
-  E_queue(NET_Throttle_Send, 0, NULL, t);
-#endif
+  NET_Initialize_Egress();
 }
 
 #if !USE_IPC_CLIENT
@@ -411,45 +383,80 @@ void Initialize_UDP_Sockets()
   }
 }
 
-/* Attempts to send timely and bounded messages */
-void NET_Throttle_Send(int dummy, void *dummyp)
+/* Empties every egress queue and gives each one a fresh token bucket */
+void NET_Initialize_Egress(void)
+{
+  int32u i, c;
+
+  for(i = 0; i < MAX_NUM_SERVER_SLOTS; i++) {
+    E_dequeue(NET_Throttle_Send, i, NULL);
+    for(c = 0; c < NUM_TRAFFIC_CLASSES; c++) {
+      UTIL_DLL_Clear(&NET.egress[i][c].pending);
+      UTIL_DLL_Initialize(&NET.egress[i][c].pending);
+      NET.egress[i][c].tokens    = 0.0;
+      NET.egress[i][c].max_depth = 0;
+      NET.egress[i][c].num_sent  = 0;
+      UTIL_Stopwatch_Start(&NET.egress[i][c].sw);
+    }
+  }
+}
+
+/* Bandwidth (bits/sec) of one destination's bucket for a traffic class:
+ * the class bandwidth is shared equally among the other servers. */
+static double NET_Egress_Rate(int32u class)
 {
-  int32u i, bits, bytes;
+  double bandwidth = 0;
+
+  if(class == TIMELY_TRAFFIC_CLASS)
+    bandwidth = MAX_OUTGOING_BANDWIDTH_TIMELY;
+  else if(class == BOUNDED_TRAFFIC_CLASS)
+    bandwidth = MAX_OUTGOING_BANDWIDTH_BOUNDED;
+  else if(class == RECON_TRAFFIC_CLASS)
+    bandwidth = MAX_OUTGOING_BANDWIDTH_RECON;
+  else
+    Alarm(EXIT, "Throttling unknown traffic class: %d\n", class);
+
+  if(VAR.Num_Servers > 1)
+    bandwidth /= (VAR.Num_Servers - 1);
+
+  return bandwidth;
+}
+
+/* Sends whatever a destination can afford right now, without waiting for
+ * the pacing timer, unless a timer is already running for it. */
+void NET_Kick_Egress(int32u dest)
+{
+  if(!E_in_queue(NET_Throttle_Send, dest, NULL))
+    NET_Throttle_Send(dest, NULL);
+}
+
+/* Sends the messages queued for destination dest that its token buckets
+ * can pay for, timely messages first, then bounded, then recon.  If
+ * anything is left, the timer is set for when the earliest blocked queue
+ * will have enough tokens for its head message. */
+void NET_Throttle_Send(int dest, void *dummyp)
+{
+  int32u c, bits, bytes;
+  double rate, need, wait, min_wait;
   signed_message *mess;
-  double time, add;
-  net_struct *n;
+  egress_queue *q;
   sp_time t;
 
-  /* First send timely messages, then bounded ones */
-  for(i = 0; i < NUM_TRAFFIC_CLASSES; i++) {
+  min_wait = -1;
 
-    while(!UTIL_DLL_Is_Empty(&NET.pending_messages_dll[i])) {
+  for(c = 0; c < NUM_TRAFFIC_CLASSES; c++) {
+    q = &NET.egress[dest][c];
 
-      UTIL_DLL_Set_Begin(&NET.pending_messages_dll[i]);
-      
-      UTIL_Stopwatch_Stop(&NET.sw[i]);
-      time = UTIL_Stopwatch_Elapsed(&NET.sw[i]);
-      UTIL_Stopwatch_Start(&NET.sw[i]);
-
-      /* Compute number of tokens to add based on whether we are using erasure
-       * codes, are emulated, and are dealing with timely or asynchronous
-       * messages. */
-      if(i == TIMELY_TRAFFIC_CLASS)
-	add = (double) MAX_OUTGOING_BANDWIDTH_TIMELY * time;
-      else if(i == BOUNDED_TRAFFIC_CLASS)
-	add = (double) MAX_OUTGOING_BANDWIDTH_BOUNDED * time;
-      else if(i == RECON_TRAFFIC_CLASS)
-      	add = (double) MAX_OUTGOING_BANDWIDTH_RECON * time;
-      else
-	Alarm(EXIT, "Throttling unknown traffic class: %d\n", i);
-
-      NET.tokens[i] += add;
-
-      if(NET.tokens[i] > MAX_TOKENS)
-	NET.tokens[i] = MAX_TOKENS;
-
-      n    = UTIL_DLL_Front_Message(&NET.pending_messages_dll[i]);
-      mess = n->mess;
+    rate = NET_Egress_Rate(c);
+    UTIL_Stopwatch_Stop(&q->sw);
+    q->tokens += rate * UTIL_Stopwatch_Elapsed(&q->sw);
+    UTIL_Stopwatch_Start(&q->sw);
+    if(q->tokens > MAX_TOKENS)
+      q->tokens = MAX_TOKENS;
+
+    while(!UTIL_DLL_Is_Empty(&q->pending)) {
+      UTIL_DLL_Set_Begin(&q->pending);
+      mess = UTIL_DLL_Front_Message(&q->pending);
 
       bytes = UTIL_Message_Size(mess);
 #ifdef SET_USE_SPINES
@@ -457,58 +464,66 @@ void NET_Throttle_Send(int dummy, void *dummyp)
 #endif
       bits = bytes * 8;
 
-      if(NET.tokens[i] < bits) {
-	Alarm(DEBUG, "Not enough tokens to send: %f %d, timely = %d\n",
-	      NET.tokens[i], bits, i);
+      /* A message larger than the bucket goes out once the bucket is
+       * full, leaving the bucket in debt. */
+      need = (bits > MAX_TOKENS) ? MAX_TOKENS : bits;
+
+      if(q->tokens < need) {
+	wait = (need - q->tokens) / rate;
+	if(min_wait < 0 || wait < min_wait)
+	  min_wait = wait;
+	Alarm(DEBUG, "Server %d class %d: %f tokens, need %d, wait %f\n",
+	      dest, c, q->tokens, bits, wait);
 	break;
       }
-      
-      NET.tokens[i] -= bits;
 
-      NET_Send_Message(n);
-      Alarm(DEBUG, "Num remaining = %d\n", n->num_remaining_destinations);
-      
-      if(n->num_remaining_destinations == 0) {
-	dec_ref_cnt(n->mess);
-	UTIL_DLL_Pop_Front(&NET.pending_messages_dll[i]);
-      }
+      q->tokens -= bits;
+      UTIL_Send_To_Server(mess, dest);
+      q->num_sent++;
+      UTIL_DLL_Pop_Front(&q->pending);
     }
   }
 
-  t.sec  = THROTTLE_SEND_SEC;
-  t.usec = THROTTLE_SEND_USEC;
-  E_queue(NET_Throttle_Send, 0, NULL, t);
+  if(min_wait >= 0) {
+    t.sec  = (long) min_wait;
+    t.usec = (long) ((min_wait - t.sec) * 1000000) + 1;
+    E_queue(NET_Throttle_Send, dest, NULL, t);
+  }
 }
 
-void NET_Send_Message(net_struct *n)
+void NET_Print_Egress_Stats(void)
 {
-  int32u i;
-
-  assert(n->mess);
+  int32u i, c, active;
+  egress_queue *q;
+
+  active = 0;
+  for(i = 1; i <= VAR.Num_Servers; i++)
+    for(c = 0; c < NUM_TRAFFIC_CLASSES; c++)
+      if(NET.egress[i][c].num_sent > 0 || NET.egress[i][c].max_depth > 0)
+	active = 1;
+  if(!active)
+    return;
 
-  /* We can either send to the destination servers sequentially, or we
-   * can pick one that still needs the message at random. */
-  if(RANDOMIZE_SENDING) {
-    while(1) {
-      i = (rand() % VAR.Num_Servers) + 1;
-      if(n->destinations[i] == 1)
-	break;
+  Alarm(PRINT, "Egress queues (depth/max/sent, head age ms):\n");
+  Alarm(PRINT, "  %-6s  %-22s %-22s %-22s\n", "server", "timely", "bounded",
+	"recon");
+  for(i = 1; i <= VAR.Num_Servers; i++) {
+    if(i == VAR.My_Server_ID)
+      continue;
+    q = NET.egress[i];
+    Alarm(PRINT, "  %-6u  %4u/%4u/%6u %5.1f  %4u/%4u/%6u %5.1f  "
+	  "%4u/%4u/%6u %5.1f\n", i,
+	  q[0].pending.length, q[0].max_depth, q[0].num_sent,
+	  UTIL_DLL_Elapsed_Front(&q[0].pending) * 1000,
+	  q[1].pending.length, q[1].max_depth, q[1].num_sent,
+	  UTIL_DLL_Elapsed_Front(&q[1].pending) * 1000,
+	  q[2].pending.length, q[2].max_depth, q[2].num_sent,
+	  UTIL_DLL_Elapsed_Front(&q[2].pending) * 1000);
+    for(c = 0; c < NUM_TRAFFIC_CLASSES; c++) {
+      q[c].max_depth = q[c].pending.length;
+      q[c].num_sent  = 0;
     }
   }
-  else {
-    for(i = 1; i <= VAR.Num_Servers; i++)
-      if(n->destinations[i] == 1)
-	break;
-  }
-
-  assert(i != VAR.My_Server_ID);
-  assert(i <= VAR.Num_Servers);
-
-  /* We've decided to send to server i */
-  UTIL_Send_To_Server(n->mess, i);
-
-  n->destinations[i] = 0;
-  n->num_remaining_destinations--;
 }
 
 #ifdef SET_USE_SPINES
@@ -847,6 +862,15 @@ void Net_Srv_Recv(channel sk, int source, void *dummy_p)
     return;
   }
 
+  /* Process a copy sized to the message, so that the packet body is
+   * reused for the next one whether or not the message is stored. */
+  if(received_bytes <= MSG_LARGE_SIZE) {
+    mess = UTIL_Copy_Message(mess, received_bytes);
+    PROCESS_Message(mess);
+    dec_ref_cnt(mess);
+    return;
+  }
+
   /* NEW - Process message both applies and (potentially) dispatches
    *    new messages as a result */
   PROCESS_Message(mess);
@@ -52,6 +52,10 @@ void Init_Network(void);
 void Reconfig_Reset_Network(void);
 void Net_Srv_Recv(channel sk, int source, void * dummy_p);
 
+/* Throttled egress: start pacing a destination's queues, report depths */
+void NET_Kick_Egress(int32u dest);
+void NET_Print_Egress_Stats(void);
+
 #ifdef SET_USE_SPINES
 void Initialize_Spines(int dummy, void *dummy_p);
 #endif
@@ -432,7 +432,7 @@ void NM_Send_Application_OOB_Update()
     event->machine_id = VAR.My_Server_ID;
     event->type = UPDATE;
     event->incarnation = DATA.PR.new_incarnation_val[VAR.My_Server_ID];
-    event->len = sizeof(signed_update_message) - sizeof(signed_message);
+    event->len = sizeof(update_message) + sizeof(signed_message);
 
     up->update.server_id = VAR.My_Server_ID;
     up->header.incarnation = DATA.PO.intro_client_seq[VAR.My_Server_ID].incarnation;
@@ -73,10 +73,17 @@
 #define ERASURE_NODE_OBJ        15
 #define ERASURE_PART_OBJ        16
 #define RECON_SLOT_OBJ          17
-#define NET_STRUCT_OBJ          18
 #define RB_SLOT_OBJ             19
 #define MSG_ARRAY_OBJ           20
 
+/* Size classes for stored copies of messages */
+#define MSG_SMALL_OBJ           21
+#define MSG_MEDIUM_OBJ          22
+#define MSG_LARGE_OBJ           23
+
+/* Pool threshold for objects that are never freed back to malloc */
+#define MSG_POOL_KEEP           0xffffffff
+
 /* Special objects */
 #define UNKNOWN_OBJ             25      /* This should be the last one */ 
 
@@ -51,7 +51,9 @@
 #include <openssl/evp.h>
 #include <openssl/pem.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include "data_structs.h"
 #include "arch.h"
 #include "spu_alarm.h"
@@ -601,49 +603,136 @@ int OPENSSL_RSA_Verify( const unsigned char *message, size_t message_length,
     return ret;
 }
 
-int OPENSSL_RSA_Get_KeySize(const char *pubKeyFile){
+/* Key handles for the RSA encryption helpers below.  Each PEM file is
+ * parsed once; opening the same file again shares the handle, and the key
+ * is only re-read if the file has changed on disk since it was loaded. */
+struct openssl_rsa_key_dummy {
+  char    path[RSA_KEY_PATH_LEN];
+  int32u  type;
+  RSA    *rsa;
+  int32u  refs;
 
-   FILE *f=fopen(pubKeyFile,"r");
+  /* Identity of the file the key was read from, to detect changes */
+  dev_t   dev;
+  ino_t   ino;
+  off_t   size;
+  struct timespec mtime;
+
+  struct openssl_rsa_key_dummy *next;
+};
+
+static openssl_rsa_key *Key_Store;
+
+static RSA *OPENSSL_RSA_Read_Key_File(const char *file, int32u type)
+{
+   FILE *f;
+   RSA *rsa;
+
+   f=fopen(file,"r");
    if (!f){
-        printf("Error opening file\n");
+        printf("Error opening file %s\n",file);
         exit(1);
    }
 
-   RSA *pubkey=RSA_new();
-   pubkey = PEM_read_RSA_PUBKEY(f, &pubkey, NULL, NULL);
-    if(!pubkey){
-        printf("OPENSSL_RSA: Error reading pub key\n");
-        fclose(f);
-        exit(1);
-    }
+   if(type == RSA_KEY_PUBLIC)
+     rsa = PEM_read_RSA_PUBKEY(f, NULL, NULL, NULL);
+   else
+     rsa = PEM_read_RSAPrivateKey(f, NULL, NULL, NULL);
    fclose(f);
-   return RSA_size(pubkey);
-}
 
-int OPENSSL_RSA_Encrypt(const char *pubKeyFile,unsigned char *data, int data_len, unsigned char * encrypted_data){
+   if(!rsa){
+        printf("OPENSSL_RSA: Error reading %s key from %s\n",
+               type == RSA_KEY_PUBLIC ? "pub" : "pvt", file);
+        exit(1);
+   }
+   return rsa;
+}
 
-   int ret;
+/* Re-reads the key if its file has been replaced or modified since it was
+ * loaded. Returns 1 if the key was reloaded, 0 otherwise. */
+int OPENSSL_RSA_Reload_Key(openssl_rsa_key *key)
+{
+   struct stat st;
 
-  FILE *f=fopen(pubKeyFile,"r");
-   if (!f){
-        printf("Error opening file\n");
+   if(stat(key->path, &st) != 0){
+        printf("Error opening file %s\n",key->path);
         exit(1);
    }
 
-   RSA *pubkey=RSA_new();
-   pubkey = PEM_read_RSA_PUBKEY(f, &pubkey, NULL, NULL);
-    if(!pubkey){
-        printf("OPENSSL_RSA: Error reading pub key\n");
-        fclose(f);
+   if(key->rsa != NULL && st.st_dev == key->dev && st.st_ino == key->ino &&
+      st.st_size == key->size &&
+      st.st_mtim.tv_sec == key->mtime.tv_sec &&
+      st.st_mtim.tv_nsec == key->mtime.tv_nsec)
+     return 0;
+
+   if(key->rsa != NULL)
+     RSA_free(key->rsa);
+   key->rsa   = OPENSSL_RSA_Read_Key_File(key->path, key->type);
+   key->dev   = st.st_dev;
+   key->ino   = st.st_ino;
+   key->size  = st.st_size;
+   key->mtime = st.st_mtim;
+   return 1;
+}
+
+openssl_rsa_key *OPENSSL_RSA_Open_Key(const char *file, int32u type)
+{
+   openssl_rsa_key *key;
+
+   if(strlen(file) >= RSA_KEY_PATH_LEN){
+        printf("OPENSSL_RSA: Key file name too long: %s\n",file);
         exit(1);
-    }
-   fclose(f);
+   }
 
-   /*printf("Read pub key \n");*/
-   /*printf("Read key size=%d\n",RSA_size(pubkey));*/
+   for(key = Key_Store; key != NULL; key = key->next)
+     if(key->type == type && strcmp(key->path, file) == 0)
+       break;
+
+   if(key == NULL){
+     key = calloc(1, sizeof(*key));
+     if(!key){
+          printf("OPENSSL_RSA: Could not allocate key handle\n");
+          exit(1);
+     }
+     strcpy(key->path, file);
+     key->type = type;
+     key->next = Key_Store;
+     Key_Store = key;
+   }
 
-   ret = RSA_public_encrypt(data_len,data,encrypted_data,pubkey,RSA_NO_PADDING);
-   /*ret = RSA_public_encrypt(data_len,data,encrypted_data,pubkey,RSA_PKCS1_PADDING);*/
+   OPENSSL_RSA_Reload_Key(key);
+   key->refs++;
+   return key;
+}
+
+void OPENSSL_RSA_Release_Key(openssl_rsa_key *key)
+{
+   openssl_rsa_key **p;
+
+   if(--key->refs > 0)
+     return;
+
+   for(p = &Key_Store; *p != key; p = &(*p)->next)
+     ;
+   *p = key->next;
+
+   RSA_free(key->rsa);
+   free(key);
+}
+
+int OPENSSL_RSA_Get_KeySize(openssl_rsa_key *pubkey){
+
+   return RSA_size(pubkey->rsa);
+}
+
+int OPENSSL_RSA_Encrypt(openssl_rsa_key *pubkey,unsigned char *data, int data_len, unsigned char * encrypted_data){
+
+   int ret;
+
+   /*printf("Read key size=%d\n",RSA_size(pubkey->rsa));*/
+
+   ret = RSA_public_encrypt(data_len,data,encrypted_data,pubkey->rsa,RSA_NO_PADDING);
+   /*ret = RSA_public_encrypt(data_len,data,encrypted_data,pubkey->rsa,RSA_PKCS1_PADDING);*/
    if(ret<=0){
         printf("OPENSSL_RSA: Encrypt error ret=%d\n",ret);
         exit(1);
@@ -653,29 +742,13 @@ int OPENSSL_RSA_Encrypt(const char *pubKeyFile,unsigned char *data, int data_len
    return ret;
 }
 
-void OPENSSL_RSA_Decrypt(const char *pvtKeyFile,unsigned char *data, int data_len, unsigned char *decrypted_data){
+void OPENSSL_RSA_Decrypt(openssl_rsa_key *pvtkey,unsigned char *data, int data_len, unsigned char *decrypted_data){
     int ret;
 
-   FILE *f=fopen(pvtKeyFile,"r");
-   if (!f){
-        printf("Error opening file\n");
-        exit(1);
-   }
-   RSA *pvtkey=RSA_new();
-   /*pvtkey = PEM_read_RSAPrivateKey(f, NULL, NULL, NULL);*/
-   pvtkey = PEM_read_RSAPrivateKey(f, &pvtkey, NULL, NULL);
-    if(!pvtkey){
-        printf("OPENSSL_RSA: Error reading pvt key\n");
-        fclose(f);
-        exit(1);
-    }
-   fclose(f);
-
-
    /*RSA_PKCS1_PADDING - 11B padding */
    /*RSA_PKCS1_OAEP_PADDING - 42B padding */
-    ret= RSA_private_decrypt(data_len,data,decrypted_data,pvtkey,RSA_NO_PADDING);
-    /*ret= RSA_private_decrypt(data_len,data,decrypted_data,pvtkey,RSA_PKCS1_PADDING);*/
+    ret= RSA_private_decrypt(data_len,data,decrypted_data,pvtkey->rsa,RSA_NO_PADDING);
+    /*ret= RSA_private_decrypt(data_len,data,decrypted_data,pvtkey->rsa,RSA_PKCS1_PADDING);*/
    if(ret<=0){
         printf("OPENSSL_RSA: Decrypt error ret=%d\n",ret);
         exit(1);
@@ -57,6 +57,9 @@
 #define RSA_NM             3 //MK Reconf: Network Manager
 #define RSA_CONFIG_MNGR    4
 #define RSA_CONFIG_AGENT   5
+#define RSA_KEY_PUBLIC     1
+#define RSA_KEY_PRIVATE    2
+#define RSA_KEY_PATH_LEN   256
 
 /* Public functions */
 void OPENSSL_RSA_Init();
@@ -90,13 +93,25 @@ void OPENSSL_RSA_Make_Digest( const void *buffer, size_t buffer_size,
 void OPENSSL_RSA_Print_Digest( unsigned char *digest_value ); 
 
 
-int OPENSSL_RSA_Get_KeySize(const char *pubKeyFile);
+/* Handles for the RSA keys used to encrypt and decrypt key material.
+ * OPENSSL_RSA_Open_Key parses a PEM file once and shares the handle with
+ * later opens of the same file; OPENSSL_RSA_Reload_Key re-reads it if the
+ * file has changed. */
+typedef struct openssl_rsa_key_dummy openssl_rsa_key;
 
+openssl_rsa_key *OPENSSL_RSA_Open_Key(const char *file, int32u type);
 
-void OPENSSL_RSA_Decrypt(const char  *pvtKeyFile,unsigned char *data, int data_len,unsigned char *decrypted_data);
+int OPENSSL_RSA_Reload_Key(openssl_rsa_key *key);
 
+void OPENSSL_RSA_Release_Key(openssl_rsa_key *key);
 
-int OPENSSL_RSA_Encrypt(const char *pubKeyFile,unsigned char *data, int data_len, unsigned char * encrypted_data);
+int OPENSSL_RSA_Get_KeySize(openssl_rsa_key *pubkey);
+
+
+void OPENSSL_RSA_Decrypt(openssl_rsa_key *pvtkey,unsigned char *data, int data_len,unsigned char *decrypted_data);
+
+
+int OPENSSL_RSA_Encrypt(openssl_rsa_key *pubkey,unsigned char *data, int data_len, unsigned char * encrypted_data);
 
 int getFileSize(const char * fileName);
 
@@ -60,6 +60,7 @@
 #include "view_change.h"
 #include "catchup.h"
 #include "proactive_recovery.h"
+#include "trace.h"
 
 #include "spu_alarm.h"
 #include "spu_memory.h"
@@ -90,6 +91,8 @@ void   ORDER_Move_Commit_Certificate   (ord_slot *slot);
 
 //int32u ORDER_Pre_Prepare_Backward_Progress(complete_pre_prepare_message *pp);
 void ORDER_Flood_PP_Wrapper(int d, void *message);
+int32u ORDER_New_Eligible(void);
+void ORDER_Paced_Pre_Prepare(int dummy, void *dummyp);
 
 void ORDER_Initialize_Data_Structure()
 {
@@ -111,6 +114,7 @@ void ORDER_Initialize_Data_Structure()
 
   stdhash_construct(&DATA.ORD.History, sizeof(int32u), 
 		    sizeof(ord_slot *), NULL, NULL, 0);
+  memset(DATA.ORD.History_Ring, 0, sizeof(DATA.ORD.History_Ring));
   
   stdhash_construct(&DATA.ORD.Pending_Execution, sizeof(int32u),
 		    sizeof(ord_slot *), NULL, NULL, 0);
@@ -170,28 +174,86 @@ void ORDER_Periodically(int dummy, void *dummyp)
   E_queue(ORDER_Periodically, 0, NULL, t);
 }
 
+/* Would a Pre-Prepare sent now make any PO-Request eligible beyond what
+ * the last one did? A PO-ARU moving forward is not enough on its own:
+ * 2f+k+1 of them must cover a request before it can be ordered. */
+int32u ORDER_New_Eligible()
+{
+  int32u i;
+  po_seq_pair ps;
+  ord_slot *slot;
+
+  slot = UTIL_Get_ORD_Slot_If_Exists(DATA.ORD.seq - 1);
+  if (slot == NULL || !slot->populated_eligible)
+    return 1;
+
+  for (i = 0; i < VAR.Num_Servers; i++) {
+    ps = PRE_ORDER_Proof_ARU(i+1, DATA.PO.cum_acks+1);
+    if (PRE_ORDER_Seq_Compare(ps, slot->made_eligible[i]) > 0)
+      return 1;
+  }
+  return 0;
+}
+
+void ORDER_Paced_Pre_Prepare(int dummy, void *dummyp)
+{
+  sp_time t;
+
+  if (!UTIL_I_Am_Leader() || 
+      DATA.ORD.seq - 1 - DATA.ORD.ARU >= PRE_PREPARE_MAX_OUTSTANDING)
+    return;
+
+  /* The timer only has to cover the time since the last Pre-Prepare */
+  if (ORDER_Send_One_Pre_Prepare(MESSAGE_CALLER)) {
+    t.sec  = PRE_PREPARE_SEC;
+    t.usec = PRE_PREPARE_USEC;
+    E_queue(ORDER_Periodically, 0, NULL, t);
+  }
+}
+
+/* Called when there may be something new to put in a Pre-Prepare (a PO-ARU
+ * that moved forward) or room to send one (an ordinal executed). Schedules
+ * a Pre-Prepare for the end of the current event, or for when the minimum
+ * gap since the last one has passed. The periodic timer is left alone; it
+ * only runs while the leader is ordering normally and the delay attack
+ * relies on it, so nothing is sent early outside of those conditions. */
+void ORDER_Pace_Pre_Prepare()
+{
+#if PRE_PREPARE_EVENT_DRIVEN
+  sp_time t;
+  double elap, gap;
+
+  if (DATA.ORD.should_send_pp == 0 || !UTIL_I_Am_Leader() ||
+      DATA.ORD.delay_attack == 1 ||
+      DATA.ORD.seq - 1 - DATA.ORD.ARU >= PRE_PREPARE_MAX_OUTSTANDING ||
+      !E_in_queue(ORDER_Periodically, 0, NULL) ||
+      E_in_queue(ORDER_Paced_Pre_Prepare, 0, NULL) ||
+      !ORDER_New_Eligible())
+    return;
+
+  UTIL_Stopwatch_Stop(&DATA.ORD.pre_prepare_sw);
+  elap = UTIL_Stopwatch_Elapsed(&DATA.ORD.pre_prepare_sw);
+  gap  = PRE_PREPARE_MIN_GAP_USEC / 1000000.0 - elap;
+
+  t.sec  = 0;
+  t.usec = 0;
+  if (gap > 0)
+    t.usec = (long)(gap * 1000000);
+  E_queue(ORDER_Paced_Pre_Prepare, 0, NULL, t);
+#endif
+}
+
 int32u ORDER_Send_One_Pre_Prepare(int32u caller)
 {
   signed_message *mset[VAR.Num_Servers];
   signed_message *pp;
   pre_prepare_message *pp_specific;
   po_aru_signed_message *cum_acks;
+  po_aru_signed_message pp_acks[MAX_NUM_SERVERS];
   po_seq_pair ps;
   int32u num_parts, i;
-  double time;
   ord_slot *slot;
 
-  /* Make sure enough time has elapsed since we've sent a Pre-Prepare */
-  UTIL_Stopwatch_Stop(&DATA.ORD.pre_prepare_sw);
-  time = UTIL_Stopwatch_Elapsed(&DATA.ORD.pre_prepare_sw);
-  if (time * 1000 < 20)
-    Alarm(PRINT, "PP Elapsed Early: %f ms\n", time * 1000);
-  //UTIL_Stopwatch_Start(&DATA.ORD.pre_prepare_sw);
-  /* if(time < (PRE_PREPARE_USEC / 1000000.0)) {
-    Alarm(PRINT, "Send_One_Pre_Prepare not ready. Elapsed = %f ms\n", time * 1000);
-    return 0;
-  } */
-
 #if DELAY_ATTACK
   while(!UTIL_DLL_Is_Empty(&DATA.PO.proof_matrix_dll) &&
 	UTIL_DLL_Elapsed_Front(&DATA.PO.proof_matrix_dll) > DELAY_TARGET) {
@@ -204,6 +266,11 @@ int32u ORDER_Send_One_Pre_Prepare(int32u caller)
   //if(!PRE_ORDER_Latest_Proof_Updated())
   if (DATA.ORD.should_send_pp == 0)
     return 0;
+
+  /* Paced (MESSAGE_CALLER) Pre-Prepares are spaced from this one */
+  UTIL_Stopwatch_Start(&DATA.ORD.pre_prepare_sw);
+  if (caller == MESSAGE_CALLER)
+    Alarm(DEBUG, "Sending paced Pre-Prepare %u\n", DATA.ORD.seq);
   
   /* Construct the Pre-Prepare */
   ORDER_Construct_Pre_Prepare(mset, &num_parts);
@@ -254,10 +321,11 @@ int32u ORDER_Send_One_Pre_Prepare(int32u caller)
 
     pp = (signed_message *)(attack_mess);
     pp_specific = (pre_prepare_message *)(pp + 1);
-    cum_acks = (po_aru_signed_message *)(pp_specific + 1);
-    /*MS2022: MAX_NUM_SERVERS as this is a packet with MAX_NUM_SERVERS in defines, we need to null the whole struct*/ 
-    memset(cum_acks[VAR.My_Server_ID - 1].cum_ack.ack_for_server, 0, sizeof(po_seq_pair) * MAX_NUM_SERVERS);
-    UTIL_RSA_Sign_Message(&cum_acks[VAR.My_Server_ID - 1].header);
+    /* PO-ARUs are packed in compact form, so step over them by their wire size */
+    cum_acks = (po_aru_signed_message *)(PP_CUM_ACKS(pp_specific, VAR.Num_Servers) +
+                (VAR.My_Server_ID - 1) * PO_ARU_SIGNED_SIZE(VAR.Num_Servers));
+    memset(cum_acks->cum_ack.ack_for_server, 0, sizeof(po_seq_pair) * VAR.Num_Servers);
+    UTIL_RSA_Sign_Message(&cum_acks->header);
 
     dest_bits = 0;
     for (i = 1; i <= cutoff; i++)
@@ -289,7 +357,9 @@ int32u ORDER_Send_One_Pre_Prepare(int32u caller)
    * large signed message */
   pp = (signed_message *)(mset[1]);
   pp_specific = (pre_prepare_message *)(pp + 1);
-  cum_acks = (po_aru_signed_message *)(pp_specific + 1);
+  UTIL_Unpack_PO_ARUs(pp_acks, PP_CUM_ACKS(pp_specific, VAR.Num_Servers),
+            pp_specific->num_acks_in_this_message);
+  cum_acks = pp_acks;
 
   slot = UTIL_Get_ORD_Slot(pp_specific->seq_num);
   if (!slot->populated_eligible) {
@@ -304,8 +374,6 @@ int32u ORDER_Send_One_Pre_Prepare(int32u caller)
     }    
   }
 
-  //UTIL_Stopwatch_Start(&DATA.ORD.pre_prepare_sw);
-
   return 1;
 }
 
@@ -442,7 +510,7 @@ void ORDER_Process_Pre_Prepare(signed_message *mess)
     memcpy(&slot->complete_pre_prepare.proposal_digest, &pp_specific->proposal_digest, 
             DIGEST_SIZE);
     memcpy(&slot->complete_pre_prepare.last_executed, &pp_specific->last_executed, 
-            sizeof(pp_specific->last_executed));
+            VAR.Num_Servers * sizeof(po_seq_pair));
   }
   else {
     /* If from a different view, just ignore for view. One of us may be behind and
@@ -504,16 +572,15 @@ void ORDER_Process_Pre_Prepare(signed_message *mess)
         part_num, slot->seq_num);
 
   num_acks_per_message = (PRIME_MAX_PACKET_SIZE -
-                   sizeof(signed_message) - sizeof(pre_prepare_message) -
+                   sizeof(signed_message) - PRE_PREPARE_SIZE(VAR.Num_Servers) -
                    (MAX_MERKLE_DIGESTS * DIGEST_SIZE)) /
-                   sizeof(po_aru_signed_message);
+                   PO_ARU_SIGNED_SIZE(VAR.Num_Servers);
   index = (part_num - 1) * num_acks_per_message;
 
-  /* Copy the bytes of this Pre-Prepare into the complete PP */
+  /* Copy the PO-ARUs of this Pre-Prepare into the complete PP */
   Alarm(DEBUG, "Copying part %d to starting index %d\n", part_num, index);
-  memcpy((byte *)(slot->complete_pre_prepare.cum_acks + index),
-           (byte *)(pp_specific + 1),
-           sizeof(po_aru_signed_message) *
+  UTIL_Unpack_PO_ARUs(slot->complete_pre_prepare.cum_acks + index,
+           PP_CUM_ACKS(pp_specific, VAR.Num_Servers),
            pp_specific->num_acks_in_this_message);
 
   slot->num_parts_collected++;
@@ -534,6 +601,7 @@ void ORDER_Process_Pre_Prepare(signed_message *mess)
     return;
 
   slot->collected_all_parts = 1;
+  TRACE_Ordinal(TRACE_PRE_PREPARE, slot->seq_num);
 
   /* A Prepare certificate could be ready if we get some Prepares
    * before we get the Pre-Prepare. */
@@ -1084,6 +1152,7 @@ void ORDER_Move_Prepare_Certificate(ord_slot *slot)
 
   /* Mark that we have a Prepare Certificate.*/
   slot->prepare_certificate_ready = 1;
+  TRACE_Ordinal(TRACE_PREPARED, slot->seq_num);
   if (DATA.ORD.high_prepared < slot->seq_num)
     DATA.ORD.high_prepared = slot->seq_num;
 }
@@ -1286,6 +1355,7 @@ void ORDER_Move_Commit_Certificate(ord_slot *slot)
   }
 
   slot->ordered = 1;
+  TRACE_Ordinal(TRACE_COMMITTED, slot->seq_num);
   if (DATA.ORD.high_committed < slot->seq_num)
     DATA.ORD.high_committed = slot->seq_num;
 
@@ -1576,6 +1646,9 @@ void ORDER_Execute_Commit(ord_slot *o_slot)
 
   if (DATA.ORD.ARU % PRINT_PROGRESS == 0)
     Alarm(PRINT, "Executed through ordinal %u\n", DATA.ORD.ARU);
+
+  /* One fewer Pre-Prepare outstanding: send any that were held back */
+  ORDER_Pace_Pre_Prepare();
   /* if (DATA.ORD.ARU % (PRINT_PROGRESS*10) == 0) {
     Alarm(PRINT, "Profiling since start!\n");
     Alarm(PRINT, "  Messages with process > 0.002 s\n");
@@ -1680,6 +1753,7 @@ void ORDER_Execute_Commit(ord_slot *o_slot)
        * it up. */
       //PRE_ORDER_Garbage_Collect_PO_Slot(i, j, 1);
       if (i == VAR.My_Server_ID) {
+        TRACE_Executed(ps, gseq);
         /* if (j != DATA.PO.po_seq_executed.seq_num + 1)
             printf("uh oh! [%u,%u], po_seq_executed + 1 = %u + 1\n", i, j, DATA.PO.po_seq_executed);
         assert(j == DATA.PO.po_seq_executed + 1); */
@@ -1741,6 +1815,7 @@ void ORDER_Execute_Commit(ord_slot *o_slot)
   DATA.SIG.ipc_count = 0;
   util_stopwatch ipc_timer;
   UTIL_Stopwatch_Start(&ipc_timer);
+  UTIL_Begin_Client_Batch();
   event_idx = 0;
   if (event_tot > 0) {
     for (stddll_begin(&eventq, &it); !stddll_is_end(&eventq, &it); stdit_next(&it)) {
@@ -1757,7 +1832,7 @@ void ORDER_Execute_Commit(ord_slot *o_slot)
     event->machine_id = VAR.My_Server_ID;
     event->type = UPDATE;
     event->incarnation = DATA.PR.new_incarnation_val[VAR.My_Server_ID];
-    event->len = sizeof(signed_update_message) - sizeof(signed_message);
+    event->len = sizeof(update_message) + sizeof(signed_message);
 
     up->update.server_id = VAR.My_Server_ID;
     up->header.incarnation = DATA.PO.intro_client_seq[VAR.My_Server_ID].incarnation;
@@ -1768,6 +1843,7 @@ void ORDER_Execute_Commit(ord_slot *o_slot)
     
     ORDER_Execute_Event(event, pp->seq_num, 1, 1); 
   }
+  UTIL_End_Client_Batch();
   stddll_destruct(&eventq);
   UTIL_Stopwatch_Stop(&ipc_timer);
   /* if (UTIL_Stopwatch_Elapsed(&ipc_timer) >= 0.002) {
@@ -1891,6 +1967,7 @@ void ORDER_Execute_Event(signed_message *event, int32u ord_num, int32u event_idx
 void ORDER_Execute_Update(signed_message *mess, int32u ord_num, int32u event_idx, int32u event_tot)
 {
   signed_update_message *u;
+  int32u content_len;
 
   assert(mess->type == UPDATE);
   Alarm(STATUS,"MS2022: Sending to client mess of type %d\n",mess->type);
@@ -1916,9 +1993,16 @@ void ORDER_Execute_Update(signed_message *mess, int32u ord_num, int32u event_idx
 
   UTIL_State_Machine_Output(u); */
 
+  /* Only return the content bytes the client actually sent */
+  content_len = 0;
+  if (mess->len > sizeof(update_message))
+    content_len = mess->len - sizeof(update_message);
+  if (content_len > UPDATE_SIZE)
+    content_len = UPDATE_SIZE;
+
   UTIL_Respond_To_Client(mess->machine_id, u->header.incarnation, 
             u->update.seq_num, ord_num, event_idx, event_tot, 
-            u->update_contents);
+            u->update_contents, content_len);
 
   /* if(BENCH.updates_executed == BENCHMARK_END_RUN) {
     ORDER_Cleanup();
@@ -2170,6 +2254,7 @@ void ORDER_Garbage_Collect_ORD_Slot(ord_slot *slot, int erase)
   }
 
   /* Now get rid of the slot itself */
+  UTIL_Forget_ORD_Slot(slot);
   dec_ref_cnt(slot);
   if (erase)
   {
@@ -57,6 +57,7 @@
 #define SLOT_NO_OP_PLUS 4
 
 void ORDER_Periodically(int dummy, void *dummyp);
+void ORDER_Pace_Pre_Prepare(void);
 int32u ORDER_Send_One_Pre_Prepare   (int32u caller);
 void   ORDER_Periodic_Retrans            (int d1, void *d2);
 
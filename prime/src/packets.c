@@ -53,6 +53,7 @@
 #include "recon.h"
 #include "tc_wrapper.h"
 #include "proactive_recovery.h"
+#include "trace.h"
 
 #include "spu_alarm.h"
 #include "spu_memory.h"
@@ -69,6 +70,7 @@ signed_message* PRE_ORDER_Construct_PO_Request()
   int32u bytes, this_mess_len, num_events, wa_bytes, cutoff, special_first;
   signed_message *mess;
   char *p;
+  sp_time received;
 
   /* Check for special case: If I am a recovering replica, the first PO_Request
    * I send must be TPM-signed, containing a single update that was generated
@@ -136,6 +138,9 @@ signed_message* PRE_ORDER_Construct_PO_Request()
     this_mess_len = mess->len + sizeof(signed_message) + wa_bytes;
 
     if((bytes + this_mess_len) < cutoff) {
+      /* Trace from when the oldest update in the PO-Request was queued */
+      if (num_events == 0)
+        received = DATA.PO.po_request_dll.begin->sw.start;
       num_events++;
       bytes += this_mess_len;
 
@@ -167,6 +172,8 @@ signed_message* PRE_ORDER_Construct_PO_Request()
   
   BENCH.num_po_requests_sent++;
   BENCH.total_updates_requested += num_events;
+  if (num_events > 0)
+    TRACE_PO_Request(po_request_specific->seq, received, num_events);
 
   return po_request;
 }
@@ -189,14 +196,14 @@ signed_message* PRE_ORDER_Construct_PO_Ack(int32u *more_to_ack, int32u send_all_
   po_ack->machine_id  = VAR.My_Server_ID;
   po_ack->incarnation = DATA.PR.new_incarnation_val[VAR.My_Server_ID];
   po_ack->type        = PO_ACK;
-  po_ack->len         = sizeof(po_ack_message);   // updated later with ack_parts
+  po_ack->len         = PO_ACK_SIZE(VAR.Num_Servers);   // updated later with ack_parts
           
   /* Write in the latest preinstalled incarnation for each server */
   for (i = 0; i < VAR.Num_Servers; i++) 
     po_ack_specific->preinstalled_incarnations[i] = DATA.PR.preinstalled_incarnations[i+1];
 
   /* we must ack all of the unacked po request messages, received contiguously */
-  ack_part = (po_ack_part *)(po_ack_specific + 1);
+  ack_part = PO_ACK_PARTS(po_ack_specific, VAR.Num_Servers);
   nparts = 0;
 
   /* Use the placeholder to start off at the correct server */
@@ -697,7 +704,7 @@ signed_message* PRE_ORDER_Construct_PO_ARU()
   po_aru->machine_id  = VAR.My_Server_ID;
   po_aru->incarnation = DATA.PR.new_incarnation_val[VAR.My_Server_ID];
   po_aru->type        = PO_ARU;
-  po_aru->len         = sizeof(po_aru_message);
+  po_aru->len         = PO_ARU_SIZE(VAR.Num_Servers);
   
   po_aru_specific->num         = ++DATA.PO.po_aru_num;
 
@@ -730,13 +737,13 @@ void PRE_ORDER_Construct_Proof_Matrix(signed_message **mset,
     num_acks = (PRIME_MAX_PACKET_SIZE - sizeof(signed_message) - 
                sizeof(proof_matrix_message) - 
                (MAX_MERKLE_DIGESTS * DIGEST_SIZE)) / 
-               sizeof(po_aru_signed_message);
+               PO_ARU_SIGNED_SIZE(VAR.Num_Servers);
 
     if (num_acks <  VAR.Num_Servers)
         Alarm(EXIT, "Proof_Matrix needs space! %u bytes needed\n",
             sizeof(signed_message) + sizeof(proof_matrix_message) +
             (MAX_MERKLE_DIGESTS * DIGEST_SIZE) +
-            (VAR.Num_Servers * sizeof(po_aru_signed_message)));
+            (VAR.Num_Servers * PO_ARU_SIGNED_SIZE(VAR.Num_Servers)));
 
     while (remaining_vectors > 0) {
         curr_part++;
@@ -763,11 +770,8 @@ void PRE_ORDER_Construct_Proof_Matrix(signed_message **mset,
             remaining_vectors = 0;
         }
     
-        length = (sizeof(po_aru_signed_message) * 
-                pm_specific->num_acks_in_this_message);
-    
-        memcpy((byte *)(pm_specific + 1), (byte *)(DATA.PO.cum_acks+index),
-                length);
+        length = UTIL_Pack_PO_ARUs((byte *)(pm_specific + 1), 
+                DATA.PO.cum_acks+index, pm_specific->num_acks_in_this_message);
         mset[curr_part]->len = sizeof(proof_matrix_message) + length;
         index += pm_specific->num_acks_in_this_message;
     }
@@ -793,7 +797,7 @@ signed_message* PRE_ORDER_Construct_Update(int32u type)
 
     mess->machine_id = VAR.My_Server_ID;
     mess->type = UPDATE;
-    mess->len = sizeof(signed_update_message) - sizeof(signed_message);
+    mess->len = sizeof(update_message) + sizeof(signed_message);
 
     //mess->incarnation = DATA.PR.new_incarnation_val[VAR.My_Server_ID]; 
       // ^ filled in Process_Update
@@ -840,15 +844,15 @@ void ORDER_Construct_Pre_Prepare(signed_message **mset,int32u *num_parts)
     index = 1;
     remaining_vectors =  VAR.Num_Servers;
     num_acks = (PRIME_MAX_PACKET_SIZE - sizeof(signed_message) - 
-               sizeof(pre_prepare_message) - 
+               PRE_PREPARE_SIZE(VAR.Num_Servers) - 
                (MAX_MERKLE_DIGESTS * DIGEST_SIZE)) / 
-               sizeof(po_aru_signed_message);
+               PO_ARU_SIGNED_SIZE(VAR.Num_Servers);
 
     if (num_acks <  VAR.Num_Servers)
         Alarm(EXIT, "Proof_Matrix needs space! %u bytes needed\n",
-            sizeof(signed_message) + sizeof(pre_prepare_message) +
+            sizeof(signed_message) + PRE_PREPARE_SIZE(VAR.Num_Servers) +
             (MAX_MERKLE_DIGESTS * DIGEST_SIZE) +
-            ( VAR.Num_Servers * sizeof(po_aru_signed_message)));
+            ( VAR.Num_Servers * PO_ARU_SIGNED_SIZE(VAR.Num_Servers)));
 
     /* TEST - forcing View Change for testing NO_OP and PC_SET messages */
     /* if (DATA.View == 1 && DATA.ORD.seq == 100)
@@ -905,10 +909,9 @@ void ORDER_Construct_Pre_Prepare(signed_message **mset,int32u *num_parts)
             remaining_vectors = 0;
         }
     
-        length = (sizeof(po_aru_signed_message) * 
-                pp_specific->num_acks_in_this_message);
-       
-        memcpy((byte *)(pp_specific + 1), (byte *)(DATA.PO.cum_acks+index), length);
+        /* Packed over the unused tail of last_executed, so after it is filled in */
+        length = UTIL_Pack_PO_ARUs(PP_CUM_ACKS(pp_specific, VAR.Num_Servers),
+                DATA.PO.cum_acks+index, pp_specific->num_acks_in_this_message);
 
         UTIL_Stopwatch_Stop(&DATA.ORD.leader_duration_sw);
         if (DATA.ORD.inconsistent_pp_attack == 1 && DATA.ORD.inconsistent_pp_type == 1 &&
@@ -920,11 +923,11 @@ void ORDER_Construct_Pre_Prepare(signed_message **mset,int32u *num_parts)
             DATA.ORD.inconsistent_pp_type = 0;
            
             po_aru_signed_message *cacks;
-            cacks = (po_aru_signed_message *)(pp_specific + 1);
+            cacks = (po_aru_signed_message *)PP_CUM_ACKS(pp_specific, VAR.Num_Servers);
             cacks[0].cum_ack.ack_for_server[1].seq_num++;
         }
 
-        mset[curr_part]->len = sizeof(pre_prepare_message) + length;
+        mset[curr_part]->len = PRE_PREPARE_SIZE(VAR.Num_Servers) + length;
         index += pp_specific->num_acks_in_this_message;
     }
 
@@ -956,7 +959,7 @@ signed_message* ORDER_Construct_Prepare(complete_pre_prepare_message *pp)
   prepare->machine_id  = VAR.My_Server_ID;
   prepare->incarnation = DATA.PR.new_incarnation_val[VAR.My_Server_ID];
   prepare->type        = PREPARE;
-  prepare->len         = sizeof(prepare_message);
+  prepare->len         = PREPARE_SIZE(VAR.Num_Servers);
     
   prepare_specific->seq_num = pp->seq_num;
   prepare_specific->view    = pp->view;
@@ -984,7 +987,7 @@ signed_message *ORDER_Construct_Commit(complete_pre_prepare_message *pp)
   commit->machine_id  = VAR.My_Server_ID;
   commit->incarnation = DATA.PR.new_incarnation_val[VAR.My_Server_ID];
   commit->type        = COMMIT;
-  commit->len         = sizeof(commit_message);
+  commit->len         = COMMIT_SIZE(VAR.Num_Servers);
 
   commit_specific->seq_num = pp->seq_num;
   commit_specific->view    = pp->view;
@@ -1000,7 +1003,7 @@ signed_message *ORDER_Construct_Commit(complete_pre_prepare_message *pp)
 
 signed_message *ORDER_Construct_Client_Response(int32u client_id, int32u incarnation,
         int32u seq_num, int32u ord_num, int32u event_idx, int32u event_tot, 
-        byte content[UPDATE_SIZE])
+        byte *content, int32u content_len)
 {
   signed_message *response;
   client_response_message *response_specific;
@@ -1014,7 +1017,7 @@ signed_message *ORDER_Construct_Client_Response(int32u client_id, int32u incarna
   response->machine_id  = VAR.My_Server_ID;
   response->incarnation = DATA.PR.new_incarnation_val[VAR.My_Server_ID];
   response->type        = CLIENT_RESPONSE;
-  response->len         = sizeof(client_response_message) + UPDATE_SIZE;
+  response->len         = sizeof(client_response_message) + content_len;
 
   response_specific->machine_id   = client_id;      /* Original client ID */
   response_specific->incarnation  = incarnation;    /* Original client incarnation */
@@ -1025,7 +1028,7 @@ signed_message *ORDER_Construct_Client_Response(int32u client_id, int32u incarna
   response_specific->PO_time      = 0; 
 
   buf = (byte *)(response_specific + 1);
-  memcpy(buf, content, UPDATE_SIZE);
+  memcpy(buf, content, content_len);
 
   return response;
 }
@@ -1608,7 +1611,7 @@ signed_message *CATCH_Construct_Catchup_Request(int32u catchup_flag)
     cr->machine_id        = VAR.My_Server_ID;
     cr->incarnation       = DATA.PR.new_incarnation_val[VAR.My_Server_ID];
     cr->type              = CATCHUP_REQUEST;
-    cr->len               = sizeof(catchup_request_message);
+    cr->len               = CATCHUP_REQUEST_SIZE(VAR.Num_Servers);
     cr->monotonic_counter = 1;  // PRTODO: use TPM for this
 
     cr_specific->flag        = catchup_flag;
@@ -1660,7 +1663,7 @@ signed_message *CATCH_Construct_Jump(int32u sender_nonce)
             UTIL_Bitmap_Set(&dest_bits, VAR.My_Server_ID);
             SIG_Add_To_Pending_Messages(oslot->ord_certificate, dest_bits, 
                     UTIL_Get_Timeliness(ORD_CERT));
-            SIG_Make_Batch(0, NULL);
+            SIG_Flush_Pending_Messages();
             Alarm(DEBUG, "Force Make Batch when construct Jump ORD_Cert\n");
             assert(oslot->signed_ord_cert == 1);
 	   
@@ -1680,7 +1683,7 @@ signed_message *CATCH_Construct_Jump(int32u sender_nonce)
     if (memcmp(DATA.PR.reset_certificate->sig, zero_sig, SIGNATURE_SIZE) == 0) {
         SIG_Add_To_Pending_Messages(DATA.PR.reset_certificate, BROADCAST,
             UTIL_Get_Timeliness(RESET_CERT));
-        SIG_Make_Batch(0, NULL);
+        SIG_Flush_Pending_Messages();
         Alarm(DEBUG, "Force Make Batch for reset cert when constructing Jump\n");
     }
     size = UTIL_Message_Size(DATA.PR.reset_certificate);
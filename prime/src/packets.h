@@ -169,6 +169,9 @@ typedef struct dummy_pub_key_header {
     /*key contents of len size*/
 } pub_key_header;
 
+/* Updates are sized to their content: header.len is sizeof(update_message)
+ * plus the number of content bytes actually used, which may be anywhere up
+ * to UPDATE_SIZE. This struct describes the largest possible update. */
 typedef struct dummy_signed_update_message {
   signed_message header;
   update_message update;
@@ -224,7 +227,7 @@ typedef struct dummy_proof_matrix_message {
   int32u sec;
   int32u usec;
 
-  /* The content follows: some number of po_aru_signed_messages */
+  /* The content follows: some number of compact po_aru_signed_messages */
 } proof_matrix_message;
 
 typedef struct dummy_pre_prepare_message {
@@ -242,13 +245,15 @@ typedef struct dummy_pre_prepare_message {
    * reset proposal that started this instantiation of the system */
   byte proposal_digest[DIGEST_SIZE];
 
-  /* Last Executed Vector */
-  po_seq_pair last_executed[MAX_NUM_SERVERS];
-
   int16u part_num;
   int16u total_parts;
   int32u num_acks_in_this_message;
 
+  /* Last Executed Vector */
+  po_seq_pair last_executed[MAX_NUM_SERVERS];
+
+  /* The content follows (at PP_CUM_ACKS): some number of compact
+   * po_aru_signed_messages */
 } pre_prepare_message;
 
 /* Structure of a Prepare Message */
@@ -267,6 +272,25 @@ typedef struct dummy_commit_message {
   int32u preinstalled_incarnations[MAX_NUM_SERVERS]; 
 } commit_message;
 
+/* Compact wire sizes. The per-server vectors above are declared with
+ * MAX_NUM_SERVERS entries, but only the first n = VAR.Num_Servers are
+ * meaningful, and each vector is the last field of its message. On the
+ * wire a message stops after entry n, so its len, signature and Merkle
+ * leaf digest all cover the compact form. Anything that follows such a
+ * message (PO-Ack parts, the PO-ARUs packed into Pre-Prepares and Proof
+ * Matrices) starts at the compact offset rather than at (msg + 1). */
+#define VECTOR_TRIM(elem, n)      ((MAX_NUM_SERVERS - (n)) * sizeof(elem))
+#define PO_ACK_SIZE(n)            (sizeof(po_ack_message) - VECTOR_TRIM(int32u, n))
+#define PO_ARU_SIZE(n)            (sizeof(po_aru_message) - VECTOR_TRIM(po_seq_pair, n))
+#define PO_ARU_SIGNED_SIZE(n)     (sizeof(signed_message) + PO_ARU_SIZE(n))
+#define PRE_PREPARE_SIZE(n)       (sizeof(pre_prepare_message) - VECTOR_TRIM(po_seq_pair, n))
+#define PREPARE_SIZE(n)           (sizeof(prepare_message) - VECTOR_TRIM(int32u, n))
+#define COMMIT_SIZE(n)            (sizeof(commit_message) - VECTOR_TRIM(int32u, n))
+#define CATCHUP_REQUEST_SIZE(n)   (sizeof(catchup_request_message) - VECTOR_TRIM(po_seq_pair, n))
+
+#define PO_ACK_PARTS(pa, n)       ((po_ack_part *)((byte *)(pa) + PO_ACK_SIZE(n)))
+#define PP_CUM_ACKS(pp, n)        ((byte *)(pp) + PRE_PREPARE_SIZE(n))
+
 typedef struct dummy_complete_pre_prepare_message {
   int32u seq_num;
   int32u view;
@@ -401,8 +425,8 @@ typedef struct dummy_catchup_request {
   int32u flag;    // CATCHUP, JUMP, PERIODIC, RECOVERY
   int32u nonce;
   int32u aru;
-  po_seq_pair po_aru[MAX_NUM_SERVERS];
   byte   proposal_digest[DIGEST_SIZE];
+  po_seq_pair po_aru[MAX_NUM_SERVERS];
   /* possibly include PO.aru vector so that the
    * receiver can know if they should EXCLUDE any of the
    * PO_Requests that became eligible for exection from
@@ -554,7 +578,7 @@ signed_message* ORDER_Construct_Prepare(complete_pre_prepare_message *pp);
 signed_message* ORDER_Construct_Commit (complete_pre_prepare_message *pp);
 signed_message* ORDER_Construct_Client_Response(int32u client_id, int32u incarnation, 
                     int32u seq_num, int32u ord_num, int32u event_idx, 
-                    int32u event_tot, byte content[UPDATE_SIZE]);
+                    int32u event_tot, byte *content, int32u content_len);
 
 signed_message* SUSPECT_Construct_TAT_Measure(double max_tat);
 signed_message* SUSPECT_Construct_RTT_Ping(void);
@@ -57,6 +57,7 @@
 #include "recon.h"
 #include "validate.h"
 #include "proactive_recovery.h"
+#include "trace.h"
 
 /* Globally Accessible Variables */
 extern server_variables    VAR;
@@ -525,7 +526,7 @@ void PRE_ORDER_Process_PO_Ack(signed_message *po_ack)
   Alarm(DEBUG, "PO_Ack from %d\n", po_ack->machine_id);
 
   po_ack_specific = (po_ack_message *)(po_ack+1);
-  part            = (po_ack_part *)(po_ack_specific + 1);
+  part            = PO_ACK_PARTS(po_ack_specific, VAR.Num_Servers);
 
   for (p = 0; p < po_ack_specific->num_ack_parts; p++) {
     PRE_ORDER_Process_PO_Ack_Part(&part[p], po_ack);
@@ -741,6 +742,8 @@ void PRE_ORDER_Update_Cum_ARU(int32u server_id)
 
     /* This will be signed later if needed by a replica for catchup */
     slot->po_cert = CATCH_Construct_PO_Certificate(s, slot);
+    if (s == VAR.My_Server_ID)
+      TRACE_PO_Cert(ps);
 
     DATA.PO.cum_aru[s] = ps; 
     DATA.PO.cum_aru_updated = 1;
@@ -881,8 +884,10 @@ void PRE_ORDER_Process_PO_ARU(signed_message *mess)
   }
   
   DATA.PO.new_po_aru = 1;
-  memcpy( (void*)( &DATA.PO.cum_acks[mess->machine_id]),
-        (void*)mess, sizeof(po_aru_signed_message));
+  UTIL_Unpack_PO_ARUs(&DATA.PO.cum_acks[mess->machine_id], (byte *)mess, 1);
+
+  /* Get the new PO-ARU ordered without waiting for the Pre-Prepare timer */
+  ORDER_Pace_Pre_Prepare();
  
   /* if (DATA.PO.already_timed == 0) {
     count = 0;
@@ -1284,7 +1289,8 @@ void PRE_ORDER_Process_Proof_Matrix(signed_message *mess)
   //  Alarm(PRINT, "  PM from %2d, lat = %f ms\n", mess->machine_id, UTIL_Stopwatch_Elapsed(&sw) * 1000);
 
   for(s = 0; s < pm_specific->num_acks_in_this_message; s++)
-    PRE_ORDER_Process_PO_ARU((signed_message *)&cum_ack[s]);
+    PRE_ORDER_Process_PO_ARU((signed_message *)((byte *)cum_ack + 
+                s * PO_ARU_SIGNED_SIZE(VAR.Num_Servers)));
 }
 
 void PRE_ORDER_Garbage_Collect_PO_Slot(int32u server_id, po_seq_pair seq, int erase)
@@ -1318,6 +1324,7 @@ void PRE_ORDER_Garbage_Collect_PO_Slot(int32u server_id, po_seq_pair seq, int er
     dec_ref_cnt(slot->po_cert);
 
   /* Now remove the slot itself */
+  UTIL_Forget_PO_Slot(server_id, slot);
   dec_ref_cnt(slot);
   if (erase) {
     stdhash_erase_key(&DATA.PO.History[server_id], &seq);
@@ -1437,6 +1444,7 @@ void PRE_ORDER_Initialize_Data_Structure()
     stdhash_construct(&DATA.PO.Recon_History[s], sizeof(po_seq_pair),
 		      sizeof(recon_slot *), NULL, NULL, 0);
   }
+  memset(DATA.PO.History_Ring, 0, sizeof(DATA.PO.History_Ring));
   stdhash_construct(&DATA.PO.incarnation_tally, sizeof(int32u),
             sizeof(int32u), NULL, NULL, 0);
 
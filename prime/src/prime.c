@@ -56,6 +56,9 @@
 #include "recon.h"
 #include "tc_wrapper.h"
 #include "proactive_recovery.h"
+#include "order.h"
+#include "pre_order.h"
+#include "trace.h"
 
 /* Externally defined global variables */
 extern server_variables   VAR;
@@ -68,6 +71,13 @@ extern int Curr_f;
 void Usage(int argc, char **argv);
 void Print_Usage(void);
 void Init_Memory_Objects(void);
+void Slot_Benchmark(int32u num_ordinals);
+
+/* Number of ordinals to run through the slot benchmark (-b), 0 = disabled */
+static int32u Slot_Bench_Ordinals = 0;
+
+/* File to dump update trace records to (-T), NULL = none */
+static char *Trace_File = NULL;
 
 int main(int argc, char** argv) 
 {
@@ -127,6 +137,12 @@ int main(int argc, char** argv)
 
   E_init(); 
   Init_Memory_Objects();
+
+  if (Slot_Bench_Ordinals > 0) {
+    Slot_Benchmark(Slot_Bench_Ordinals);
+    return 0;
+  }
+
   Init_Network();
   
   /* Initialize RSA Keys */
@@ -140,6 +156,7 @@ int main(int argc, char** argv)
 
   /* Initialize this server's data structures */
   DAT_Initialize();  
+  TRACE_Initialize(Trace_File);
 
   /* Start the proactive recovery process for this replica */
   PR_Start_Recovery();
@@ -156,20 +173,28 @@ void Init_Memory_Objects(void)
   Mem_init_object_abort(PACK_BODY_OBJ,    "packet",         sizeof(packet),           100,  1);
   Mem_init_object_abort(SYS_SCATTER,      "sys_scatter",    sizeof(sys_scatter),      100,  1);
   Mem_init_object_abort(DLL_NODE_OBJ,     "dll_node_obj",   sizeof(dll_node_struct),  200, 20);
-  Mem_init_object_abort(PO_SLOT_OBJ,      "po_slot",        sizeof(po_slot),          200, 20);
-  Mem_init_object_abort(ORD_SLOT_OBJ,     "ord_slot",       sizeof(ord_slot),         200, 20);
+  /* Slots are recycled through their free lists rather than returned to
+   * malloc, so size the lists to cover a full window of live slots */
+  Mem_init_object_abort(PO_SLOT_OBJ,      "po_slot",        sizeof(po_slot),
+                        MAX_PO_IN_FLIGHT * MAX_NUM_SERVERS, 20);
+  Mem_init_object_abort(ORD_SLOT_OBJ,     "ord_slot",       sizeof(ord_slot),
+                        ORD_HISTORY_WINDOW, 2 * CATCHUP_HISTORY);
   Mem_init_object_abort(ERASURE_NODE_OBJ, "erasure_node",   sizeof(erasure_node),     200, 20);
   Mem_init_object_abort(ERASURE_PART_OBJ, "erasure_part",   sizeof(erasure_part_obj), 200, 20);
   Mem_init_object_abort(RECON_SLOT_OBJ,   "recon_slot",     sizeof(recon_slot),       200, 20);
-  Mem_init_object_abort(NET_STRUCT_OBJ,   "net_struct",     sizeof(net_struct),       200, 20);
   Mem_init_object_abort(RB_SLOT_OBJ,      "rb_slot",        sizeof(rb_slot),          200, 20);
   /*SM2022: TODO*/
   Mem_init_object_abort(MSG_ARRAY_OBJ,    "msg_array",      sizeof(signed_message *) * MAX_NUM_SERVER_SLOTS,          200, 20);
+  /* Message size classes start empty and are never returned to malloc,
+   * so their use can be counted (see UTIL_Print_Message_Pools) */
+  Mem_init_object_abort(MSG_SMALL_OBJ,    "msg_small",      MSG_SMALL_SIZE,     MSG_POOL_KEEP, 0);
+  Mem_init_object_abort(MSG_MEDIUM_OBJ,   "msg_medium",     MSG_MEDIUM_SIZE,    MSG_POOL_KEEP, 0);
+  Mem_init_object_abort(MSG_LARGE_OBJ,    "msg_large",      MSG_LARGE_SIZE,     MSG_POOL_KEEP, 0);
 }
 
 void Usage(int argc, char **argv)
 {
-  int tmp;
+  int tmp, tmp3;
   float tmp2;
 
   if(MAX_NUM_SERVERS < (3*NUM_F + 2*NUM_K + 1)) {
@@ -196,6 +221,14 @@ void Usage(int argc, char **argv)
   DATA.ORD.inconsistent_pp_attack = 0;
   DATA.ORD.inconsistent_pp_type   = 0;
   DATA.ORD.inconsistent_delay     = 30.0;
+
+  DATA.SIG.class_target[TIMELY_TRAFFIC_CLASS].sec   = 0;
+  DATA.SIG.class_target[TIMELY_TRAFFIC_CLASS].usec  = SIG_TIMELY_TARGET_USEC;
+  DATA.SIG.class_target[BOUNDED_TRAFFIC_CLASS].sec  = 0;
+  DATA.SIG.class_target[BOUNDED_TRAFFIC_CLASS].usec = SIG_BOUNDED_TARGET_USEC;
+  DATA.SIG.class_target[RECON_TRAFFIC_CLASS]        = 
+    DATA.SIG.class_target[BOUNDED_TRAFFIC_CLASS];
+  DATA.SIG.stats_period = 0;
   while(--argc > 0) {
     Alarm(DEBUG, "MS2022: argc=%d\n",argc);
     argv++;
@@ -251,6 +284,41 @@ void Usage(int argc, char **argv)
         }
         argc--; argv++;
     }
+    else if ((argc > 1) && (!strncmp(*argv, "-b", 2))){
+        sscanf(argv[1], "%d", &tmp);
+        if (tmp <= 0) {
+            Alarm(PRINT, "Invalid number of benchmark ordinals %d. Must be > 0\n", tmp);
+            exit(0);
+        }
+        Slot_Bench_Ordinals = tmp;
+        argc--; argv++;
+    }
+    else if ((argc > 2) && (!strncmp(*argv, "-w", 2))){
+        sscanf(argv[1], "%d", &tmp);
+        sscanf(argv[2], "%d", &tmp3);
+        if (tmp <= 0 || tmp3 <= 0 || tmp >= 1000000 || tmp3 >= 1000000) {
+            Alarm(PRINT, "Invalid signature batch targets %d %d. Must be "
+                  "between 1 and 999999 us\n", tmp, tmp3);
+            exit(0);
+        }
+        DATA.SIG.class_target[TIMELY_TRAFFIC_CLASS].usec  = tmp;
+        DATA.SIG.class_target[BOUNDED_TRAFFIC_CLASS].usec = tmp3;
+        DATA.SIG.class_target[RECON_TRAFFIC_CLASS].usec   = tmp3;
+        argc -= 2; argv += 2;
+    }
+    else if ((argc > 1) && (!strncmp(*argv, "-T", 2))){
+        Trace_File = argv[1];
+        argc--; argv++;
+    }
+    else if ((argc > 1) && (!strncmp(*argv, "-s", 2))){
+        sscanf(argv[1], "%d", &tmp);
+        if (tmp <= 0) {
+            Alarm(PRINT, "Invalid signature stats period %d. Must be > 0\n", tmp);
+            exit(0);
+        }
+        DATA.SIG.stats_period = tmp;
+        argc--; argv++;
+    }
     else
       Print_Usage();
   }
@@ -259,6 +327,88 @@ void Usage(int argc, char **argv)
 void Print_Usage()
 {
   Alarm(PRINT, "Usage: ./server\n"
-	"\t[-i local_id -g tpm_id, indexed base 1, default 1]\n");
+	"\t[-i local_id -g tpm_id, indexed base 1, default 1]\n"
+	"\t[-b num_ordinals : run the ORD/PO slot benchmark and exit]\n"
+	"\t[-w timely_usec bounded_usec : longest wait to batch a signature, per class]\n"
+	"\t[-s sec : print signature batching and update latency histograms every sec seconds]\n"
+	"\t[-T file : write update latency trace records to file, see trace_summary]\n");
   exit(0);
 }
+
+/* Drive the ORD and PO histories through the same create / lookup /
+ * garbage collect pattern that ordering produces, without any network or
+ * crypto, and report the cost per ordinal and per slot lookup. Each
+ * ordinal introduces one PO slot per server and is collected once it
+ * falls 2*gc_width behind, as in ORDER_Execute_Commit. */
+void Slot_Benchmark(int32u num_ordinals)
+{
+  int32u g, s, i, lookups, misses;
+  po_seq_pair ps;
+  po_id pid;
+  ord_slot *o_slot;
+  po_slot *p_slot;
+  stdit it;
+  util_stopwatch sw;
+  double total, hash_time;
+
+  PRE_ORDER_Initialize_Data_Structure();
+  ORDER_Initialize_Data_Structure();
+
+  lookups = 0;
+  misses  = 0;
+  ps.incarnation = 0;
+
+  UTIL_Stopwatch_Start(&sw);
+  for (g = 1; g <= num_ordinals; g++) {
+    o_slot = UTIL_Get_ORD_Slot(g);
+    ps.seq_num = g;
+
+    for (s = 1; s <= VAR.Num_Servers; s++) {
+      p_slot = UTIL_Get_PO_Slot(s, ps);
+      /* PO-Acks from every server, then execution */
+      for (i = 1; i <= VAR.Num_Servers; i++) {
+        if (UTIL_Get_PO_Slot_If_Exists(s, ps) != p_slot)
+          misses++;
+      }
+      lookups += VAR.Num_Servers;
+
+      DATA.PO.cum_aru[s] = ps;
+      pid.server_id = s;
+      pid.seq = ps;
+      stddll_push_back(&o_slot->po_slot_list, &pid);
+    }
+
+    /* Prepares and Commits from every server, plus the previous ordinal */
+    for (i = 1; i <= 2 * VAR.Num_Servers; i++) {
+      if (UTIL_Get_ORD_Slot_If_Exists(g) != o_slot)
+        misses++;
+    }
+    UTIL_Get_ORD_Slot_If_Exists(g - 1);
+    lookups += 2 * VAR.Num_Servers + 1;
+
+    if (g > 2 * DATA.ORD.gc_width) {
+      o_slot = UTIL_Get_ORD_Slot_If_Exists(g - 2 * DATA.ORD.gc_width);
+      ORDER_Garbage_Collect_ORD_Slot(o_slot, 1);
+    }
+  }
+  UTIL_Stopwatch_Stop(&sw);
+  total = UTIL_Stopwatch_Elapsed(&sw);
+
+  /* For comparison, the same number of lookups against the hash alone */
+  UTIL_Stopwatch_Start(&sw);
+  for (i = 0; i < lookups; i++) {
+    g = num_ordinals - (i % (2 * DATA.ORD.gc_width));
+    stdhash_find(&DATA.ORD.History, &it, &g);
+  }
+  UTIL_Stopwatch_Stop(&sw);
+  hash_time = UTIL_Stopwatch_Elapsed(&sw);
+
+  Alarm(PRINT, "Slot benchmark: %u ordinals, %u servers, %u lookups, %u misses\n",
+        num_ordinals, VAR.Num_Servers, lookups, misses);
+  Alarm(PRINT, "  %.1f ns/ordinal, %.1f ns/lookup incl. create+GC, "
+        "%.1f ns/hash lookup\n", total * 1e9 / num_ordinals,
+        total * 1e9 / lookups, hash_time * 1e9 / lookups);
+  Alarm(PRINT, "  live ord slots %u, live po slots %u\n",
+        (int32u)stdhash_size(&DATA.ORD.History),
+        (int32u)stdhash_size(&DATA.PO.History[1]));
+}
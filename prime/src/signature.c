@@ -40,9 +40,11 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <pthread.h>
 #include "signature.h"
 #include "data_structs.h"
 #include "openssl_rsa.h"
@@ -53,8 +55,11 @@
 #include "order.h"
 #include "validate.h"
 #include "proactive_recovery.h"
+#include "trace.h"
+#include "network.h"
 
 #include "spu_alarm.h"
+#include "spu_events.h"
 #include "spu_memory.h"
 
 extern server_data_struct DATA;
@@ -63,38 +68,88 @@ extern network_variables  NET;
 extern benchmark_struct   BENCH;
 
 //void SIG_Make_Batch(int trigger, void *dummyp);
-void SIG_Finish_Pending_Messages(byte *signature);
+byte *SIG_Close_Batch(dll_struct *batch);
+void SIG_Finish_Pending_Messages(dll_struct *batch, byte *signature);
+void SIG_Observe_Arrival(sp_time now);
+void SIG_Observe_Batch(double cost);
+int32u SIG_Hist_Bucket(int32u val);
+double SIG_Bounded_Target(void);
+
+void  SIG_Start_Signer(void);
+void *SIG_Signer_Thread(void *dummyp);
+void  SIG_Batch_Signed(int fd, int dummy, void *dummyp);
+sig_batch *SIG_Next_Signed_Batch(void);
+void  SIG_Send_Batch(void);
+
+/* Closed batches are handed to the signing thread through Sign_Request_Pipe
+ * and come back, in the same order, through Sign_Done_Pipe, which the event
+ * loop watches. Only batch pointers cross the pipes: between the two, the
+ * signing thread reads the root digest and writes the signature and cost,
+ * and nothing else in the batch is touched by either side. */
+static int Sign_Request_Pipe[2];
+static int Sign_Done_Pipe[2];
+static int Signer_Checked = 0;
+static int Signer_Started = 0;
 
 void SIG_Initialize_Data_Structure()
 {
-  UTIL_DLL_Initialize(&DATA.SIG.pending_messages_dll);
+  int32u i, j;
+  sp_time t;
 
-  /* After adding a message to the pending_messages_dll, how long do
-   * we wait before making a batch with whatever we have on the queue
-   * (in the hopes of reading more messages and aggregating. This is
-   * currently set to a zero timeout -- poll to read as many as we can
-   * (up to threshold), then make the signature on the batch.*/
-  //DATA.SIG.sig_time.sec  = SIG_SEC;
-  //DATA.SIG.sig_time.usec = SIG_USEC;
-					
-  DATA.SIG.sig_min_time.sec  = SIG_MIN_SEC;
-  DATA.SIG.sig_min_time.usec = SIG_MIN_USEC;
+  UTIL_DLL_Initialize(&DATA.SIG.pending_messages_dll);
 
-  DATA.SIG.sig_max_time.sec  = SIG_MAX_SEC;
-  DATA.SIG.sig_max_time.usec = SIG_MAX_USEC;
+  /* The per-class targets are set from the command line (see Usage) and
+   * are kept across reinitialization. Start the controller off as if
+   * traffic were light: a sample or two of real load moves it. */
+  DATA.SIG.batch_deadline.sec  = 0;
+  DATA.SIG.batch_deadline.usec = 0;
+  DATA.SIG.last_arrival        = E_get_time();
+  DATA.SIG.arrival_gap         = SIG_Bounded_Target();
+  DATA.SIG.sign_cost           = 0;
+  DATA.SIG.batch_threshold     = SIG_THRESHOLD;
+
+  for(i = 0; i < SIG_HIST_BUCKETS; i++) {
+    DATA.SIG.batch_size_hist[i] = 0;
+    for(j = 0; j < NUM_TRAFFIC_CLASSES; j++)
+      DATA.SIG.wait_hist[j][i] = 0;
+  }
 
   DATA.SIG.num_consecutive_messages_read = 0;
+
+  DATA.SIG.batch_head      = 0;
+  DATA.SIG.num_outstanding = 0;
+  for(i = 0; i < SIG_MAX_OUTSTANDING; i++)
+    UTIL_DLL_Initialize(&DATA.SIG.batches[i].messages);
+
+#if SIG_ASYNC_SIGNING
+  if(!Signer_Checked)
+    SIG_Start_Signer();
+#endif
+
+  if(DATA.SIG.stats_period > 0) {
+    t.sec  = DATA.SIG.stats_period;
+    t.usec = 0;
+    E_queue(SIG_Print_Stats, 0, NULL, t);
+  }
 }
 
 void SIG_Upon_Reset()
 {
+  sig_batch *b;
+
+  /* Batches still being signed are dropped, like the pending messages */
+  while(DATA.SIG.num_outstanding > 0) {
+    b = SIG_Next_Signed_Batch();
+    UTIL_DLL_Clear(&b->messages);
+  }
   UTIL_DLL_Clear(&DATA.SIG.pending_messages_dll);
 }
 
 void SIG_Add_To_Pending_Messages(signed_message *m, int32u dest_bits,
 				 int32u timeliness)
 {
-  //sp_time t;
+  sp_time now, deadline, wait;
+  double remaining, pushback;
 
   /* Apply the message first, then enqueue it to be signed and sent later.
    * This assumes that Process() will not require a valid signature from ourselves,
@@ -102,9 +157,18 @@ void SIG_Add_To_Pending_Messages(signed_message *m, int32u dest_bits,
   //if (dest_bits == BROADCAST)
   //  PROCESS_Message(m);
 
-  if(UTIL_DLL_Is_Empty(&DATA.SIG.pending_messages_dll)) {
-    UTIL_Stopwatch_Start(&DATA.SIG.max_batch_sw);
-    E_queue(SIG_Make_Batch, BATCH_MAX_TRIGGER, NULL, DATA.SIG.sig_max_time);
+  now = E_get_time();
+  SIG_Observe_Arrival(now);
+
+  /* The batch must be signed by the earliest deadline of the messages in
+   * it, so a timely message joining a batch of bounded ones pulls the
+   * deadline in. */
+  deadline = E_add_time(now, DATA.SIG.class_target[timeliness]);
+  if(UTIL_DLL_Is_Empty(&DATA.SIG.pending_messages_dll) ||
+     E_compare_time(deadline, DATA.SIG.batch_deadline) < 0) {
+    DATA.SIG.batch_deadline = deadline;
+    E_queue(SIG_Make_Batch, BATCH_MAX_TRIGGER, NULL, 
+            DATA.SIG.class_target[timeliness]);
   }
     
   UTIL_DLL_Add_Data(&DATA.SIG.pending_messages_dll, m);
@@ -112,38 +176,43 @@ void SIG_Add_To_Pending_Messages(signed_message *m, int32u dest_bits,
   UTIL_DLL_Set_Last_Extra(&DATA.SIG.pending_messages_dll, TIMELINESS,
 			  timeliness);
   
-  if(DATA.SIG.pending_messages_dll.length == SIG_THRESHOLD)
+  if(DATA.SIG.pending_messages_dll.length >= DATA.SIG.batch_threshold) {
     SIG_Make_Batch(0, NULL);
+    return;
+  }
+
+  /* Wait for the next message only if it is expected before the batch
+   * deadline and messages arrive faster than we could sign them one by
+   * one. Otherwise sign once the current event is handled, which still
+   * picks up any other messages it generates, or, if a batch is being
+   * signed, as soon as it is done (see SIG_Batch_Signed). */
+  wait = E_sub_time(DATA.SIG.batch_deadline, now);
+  remaining = wait.sec + wait.usec / 1000000.0;
+  if(DATA.SIG.arrival_gap >= remaining ||
+     DATA.SIG.arrival_gap >= SIG_LOAD_FACTOR * DATA.SIG.sign_cost) {
+    if(DATA.SIG.num_outstanding > 0)
+      return;
+    wait.sec  = 0;
+    wait.usec = 0;
+  }
   else {
-    /* UTIL_Stopwatch_Stop(&DATA.SIG.pb_batch_sw);
-    if (DATA.SIG.pb_count > 0 && 
-        UTIL_Stopwatch_Elapsed(&DATA.SIG.pb_batch_sw) >= DATA.SIG.sig_min_time.usec/1000000.0)
-    {
-        //Alarm(PRINT, "PB even though %f s elapse\n", UTIL_Stopwatch_Elapsed(&DATA.SIG.pb_batch_sw));
-    } */
-    if (DATA.SIG.pb_count < 100)
-        UTIL_Stopwatch_Start(&DATA.SIG.pb_batch_sw[DATA.SIG.pb_count]);
-    E_queue(SIG_Make_Batch, BATCH_PUSHBACK_TRIGGER, NULL, DATA.SIG.sig_min_time);
-    DATA.SIG.pb_count++;
-
-    /* if (DATA.VIEW.view_change_done == 0) {
-        t = DATA.SIG.sig_time;
-        t.usec /= 4;
-        E_queue(SIG_Make_Batch, 0, NULL, t);
+    pushback = SIG_PUSHBACK_GAPS * DATA.SIG.arrival_gap;
+    if(pushback < remaining) {
+      wait.sec  = (long)pushback;
+      wait.usec = (long)((pushback - wait.sec) * 1000000);
     }
-    else
-        E_queue(SIG_Make_Batch, 0, NULL, DATA.SIG.sig_time); */
   }
+  E_queue(SIG_Make_Batch, BATCH_PUSHBACK_TRIGGER, NULL, wait);
 }
 
 void SIG_Make_Batch(int trigger, void *dummyp)
 {
   int ret;
-  byte signature[SIGNATURE_SIZE];
   byte *proot = NULL;
-  //int32u i;
-  //signed_message *mess;
-  //sp_time elap;
+  sig_batch *b;
+  dll_struct batch;
+  byte signature[SIGNATURE_SIZE];
+  util_stopwatch sw;
  
   /* Find out how this function was called (from pushback timeout, max timeout,
    * or threshold number of messages reached), and dequeue the other sources 
@@ -153,32 +222,11 @@ void SIG_Make_Batch(int trigger, void *dummyp)
     if (ret != 0)
         Alarm(PRINT, "Batch Error: Failure to Dequeue MAX\n");
   } else if (trigger == BATCH_MAX_TRIGGER) {
-    /* if (DATA.SIG.pending_messages_dll.length <= DATA.SIG.sig_max_time.usec / 1000) {
-        UTIL_Stopwatch_Stop(&DATA.SIG.max_batch_sw);
-        Alarm(PRINT, "MAX timeout %f s, %u M, %u C\n",
-                UTIL_Stopwatch_Elapsed(&DATA.SIG.max_batch_sw),
-                DATA.SIG.pending_messages_dll.length,
-                DATA.SIG.pb_count);
-        elap = E_add_time(DATA.SIG.max_batch_sw.start, DATA.SIG.sig_max_time);
-        printf("   max elap @ %lu.%lu\n", elap.sec, elap.usec); 
-        elap = E_add_time(DATA.SIG.pb_batch_sw[DATA.SIG.pb_count-1].start, DATA.SIG.sig_min_time);
-        printf("   last pb elap @ %lu.%lu\n", elap.sec, elap.usec);
-        UTIL_DLL_Set_Begin(&DATA.SIG.pending_messages_dll);
-        i = 0;
-        while ((mess = (signed_message *)UTIL_DLL_Get_Signed_Message(&DATA.SIG.pending_messages_dll)) != NULL) {
-            if (i < 100) {
-                printf("      [%u]:[%lu.%lu]  %s\n", i, DATA.SIG.pb_batch_sw[i].start.sec,
-                    DATA.SIG.pb_batch_sw[i].start.usec, UTIL_Type_To_String(mess->type));
-            }
-            UTIL_DLL_Next(&DATA.SIG.pending_messages_dll);
-            i++;
-        }
-    } */
     ret = E_dequeue(SIG_Make_Batch, BATCH_PUSHBACK_TRIGGER, NULL);
     if (ret != 0)
         Alarm(PRINT, "Batch Error: Failure to Dequeue PUSHBACK\n");
   } else {
-    Alarm(PRINT, "Make_Batch. Threshold reached\n");
+    Alarm(DEBUG, "Make_Batch. Threshold reached\n");
     ret = E_dequeue(SIG_Make_Batch, BATCH_MAX_TRIGGER, NULL);
     if (ret != 0)
         Alarm(PRINT, "Thresh Error: Failure to Dequeue MAX\n");
@@ -186,7 +234,6 @@ void SIG_Make_Batch(int trigger, void *dummyp)
     if (ret != 0)
         Alarm(PRINT, "Thresh Error: Failure to Dequeue PUSHBACK\n");
   }
-  DATA.SIG.pb_count = 0;
 
   /* If there's nothing to do, we're done. */
   if(UTIL_DLL_Is_Empty(&DATA.SIG.pending_messages_dll))
@@ -198,51 +245,74 @@ void SIG_Make_Batch(int trigger, void *dummyp)
 	UTIL_DLL_Elapsed_Front(&DATA.SIG.pending_messages_dll));
 #endif
 
+  if(Signer_Started) {
+    /* Make room for the batch by sending the oldest one. Its messages may
+     * close a batch of their own, which takes these pending ones along. */
+    while(DATA.SIG.num_outstanding == SIG_MAX_OUTSTANDING)
+      SIG_Send_Batch();
+    if(UTIL_DLL_Is_Empty(&DATA.SIG.pending_messages_dll))
+      return;
+
+    /* Build the root digest here and leave signing it to the signing
+     * thread. SIG_Batch_Signed sends the batch once it comes back. */
+    b = &DATA.SIG.batches[(DATA.SIG.batch_head + DATA.SIG.num_outstanding) %
+                          SIG_MAX_OUTSTANDING];
+    proot = SIG_Close_Batch(&b->messages);
+    memcpy(b->root, proot, DIGEST_SIZE);
+    DATA.SIG.num_outstanding++;
+
+    while((ret = write(Sign_Request_Pipe[1], &b, sizeof(b))) < 0 && 
+          errno == EINTR);
+    if(ret != sizeof(b))
+      Alarm(EXIT, "SIG_Make_Batch: could not hand batch to signing thread\n");
+    return;
+  }
+
   /* Build the root digest out of the list of pending messages, and then
    * generate a signature on the root digest. */
-  proot = MT_Make_Digest_From_List(&DATA.SIG.pending_messages_dll);
+  UTIL_DLL_Initialize(&batch);
+  proot = SIG_Close_Batch(&batch);
 
   /* Sign the root digest */
+  UTIL_Stopwatch_Start(&sw);
   memset(signature, 0, SIGNATURE_SIZE);
   OPENSSL_RSA_Make_Signature(proot, signature);
-  
-  BENCH.num_signatures++;
-  BENCH.total_signed_messages += DATA.SIG.pending_messages_dll.length;
-  if(DATA.SIG.pending_messages_dll.length > BENCH.max_signature_batch_size) {
-    BENCH.max_signature_batch_size = 
-      DATA.SIG.pending_messages_dll.length;
-  }
+  UTIL_Stopwatch_Stop(&sw);
+  SIG_Observe_Batch(UTIL_Stopwatch_Elapsed(&sw));
 
-  SIG_Finish_Pending_Messages(signature);
+  SIG_Finish_Pending_Messages(&batch, signature);
 }
 
-void SIG_Attempt_To_Generate_PO_Messages()
+/* Sign and send all pending messages now, for callers that need their
+ * message signed before going on. */
+void SIG_Flush_Pending_Messages()
 {
-  if(SEND_PO_REQUESTS_PERIODICALLY)
-    PRE_ORDER_Send_PO_Request();
+  SIG_Make_Batch(0, NULL);
 
-  if(SEND_PO_ACKS_PERIODICALLY)
-    PRE_ORDER_Send_PO_Ack();
-
-  if(SEND_PO_ARU_PERIODICALLY)
-    PRE_ORDER_Send_PO_ARU();
-
-  if(!UTIL_I_Am_Leader())
-    PRE_ORDER_Send_Proof_Matrix();
+  while(DATA.SIG.num_outstanding > 0)
+    SIG_Send_Batch();
 }
 
-void SIG_Finish_Pending_Messages(byte *signature)
+/* Move the pending messages to batch, appending to each the Merkle 
+ * digests it needs for verification. Returns the root digest to sign. */
+byte *SIG_Close_Batch(dll_struct *batch)
 {
   signed_message *mess;
   dll_struct *list;
-  dll_struct original_list;
-  int32u sn, i, dest_bits, timeliness, sig_type;
+  byte *proot;
+  int32u sn, i, dest_bits, timeliness;
 
   list = &DATA.SIG.pending_messages_dll;
   sn   = list->length;
-  MT_Set_Num(sn);
 
-  UTIL_DLL_Initialize(&original_list);
+  BENCH.num_signatures++;
+  BENCH.total_signed_messages += sn;
+  if(sn > BENCH.max_signature_batch_size)
+    BENCH.max_signature_batch_size = sn;
+  DATA.SIG.batch_size_hist[SIG_Hist_Bucket(sn)]++;
+
+  proot = MT_Make_Digest_From_List(list);
+
   UTIL_DLL_Set_Begin(list);
   i = 1;
   
@@ -251,10 +321,9 @@ void SIG_Finish_Pending_Messages(byte *signature)
     assert(mess);
     dest_bits  = UTIL_DLL_Front_Extra(list, DEST);
     timeliness = UTIL_DLL_Front_Extra(list, TIMELINESS);
+    DATA.SIG.wait_hist[timeliness][SIG_Hist_Bucket(
+        UTIL_DLL_Elapsed_Front(list) * 1000000 / (SIG_HIST_WAIT_BASE_USEC / 2))]++;
 
-    /* Copy the signature into the message. */
-    memcpy((byte*)mess, signature, SIGNATURE_SIZE);
-    
     /* Generate the digests and stick them into the message */
     MT_Extract_Set(i, mess);
     if(mess->mt_index > mess->mt_num) {
@@ -264,24 +333,256 @@ void SIG_Finish_Pending_Messages(byte *signature)
     }
     i++;
 
-    /* Add it to the original list.  Keep track of this because applying
-     * may cause new messages to be added to the pending_local_messages_dll. */
-    UTIL_DLL_Add_Data(&original_list, mess);    
-    UTIL_DLL_Set_Last_Extra(&original_list, DEST, dest_bits);
-    UTIL_DLL_Set_Last_Extra(&original_list, TIMELINESS, timeliness);
+    UTIL_DLL_Add_Data(batch, mess);    
+    UTIL_DLL_Set_Last_Extra(batch, DEST, dest_bits);
+    UTIL_DLL_Set_Last_Extra(batch, TIMELINESS, timeliness);
 
     UTIL_DLL_Pop_Front(list);
   }
 
-  UTIL_DLL_Set_Begin(&original_list);
-  while((mess = (signed_message *)UTIL_DLL_Front_Message(&original_list)) 
-	!= NULL) {
+  return proot;
+}
+
+/* With a single CPU the signing thread could only take turns with the
+ * event loop, and handing batches back and forth would cost more than it
+ * saves, so batches are signed inline. */
+void SIG_Start_Signer()
+{
+  pthread_t tid;
+
+  Signer_Checked = 1;
+  if(sysconf(_SC_NPROCESSORS_ONLN) < 2) {
+    Alarm(PRINT, "Single CPU: signing batches on the event loop\n");
+    return;
+  }
+
+  if(pipe(Sign_Request_Pipe) < 0 || pipe(Sign_Done_Pipe) < 0)
+    Alarm(EXIT, "SIG_Start_Signer: pipe failed: %s\n", strerror(errno));
+
+  if(pthread_create(&tid, NULL, SIG_Signer_Thread, NULL) != 0)
+    Alarm(EXIT, "SIG_Start_Signer: could not create signing thread\n");
+  pthread_detach(tid);
+
+  E_attach_fd(Sign_Done_Pipe[0], READ_FD, SIG_Batch_Signed, 0, NULL, 
+              HIGH_PRIORITY);
+  Signer_Started = 1;
+}
+
+/* Runs on its own thread: sign batches in the order they were closed */
+void *SIG_Signer_Thread(void *dummyp)
+{
+  sig_batch *b;
+  util_stopwatch sw;
+  int ret;
+
+  while(1) {
+    while((ret = read(Sign_Request_Pipe[0], &b, sizeof(b))) < 0 &&
+          errno == EINTR);
+    if(ret != sizeof(b))
+      break;
+
+    UTIL_Stopwatch_Start(&sw);
+    memset(b->signature, 0, SIGNATURE_SIZE);
+    OPENSSL_RSA_Make_Signature(b->root, b->signature);
+    UTIL_Stopwatch_Stop(&sw);
+    b->sign_cost = UTIL_Stopwatch_Elapsed(&sw);
+
+    while((ret = write(Sign_Done_Pipe[1], &b, sizeof(b))) < 0 &&
+          errno == EINTR);
+    if(ret != sizeof(b))
+      break;
+  }
+
+  Alarm(EXIT, "SIG_Signer_Thread: lost the signing pipes\n");
+  return NULL;
+}
+
+/* The oldest batch is signed: send it, and close the messages that
+ * gathered while it was being signed once the event loop comes back */
+void SIG_Batch_Signed(int fd, int dummy, void *dummyp)
+{
+  sp_time now = {0, 0};
+
+  SIG_Send_Batch();
+
+  if(DATA.SIG.num_outstanding == 0 &&
+     !UTIL_DLL_Is_Empty(&DATA.SIG.pending_messages_dll))
+    E_queue(SIG_Make_Batch, BATCH_PUSHBACK_TRIGGER, NULL, now);
+}
+
+/* Wait for the oldest outstanding batch to be signed and release its
+ * slot. The caller takes the messages out of it before closing another. */
+sig_batch *SIG_Next_Signed_Batch()
+{
+  sig_batch *b;
+  int ret;
+
+  assert(DATA.SIG.num_outstanding > 0);
+
+  while((ret = read(Sign_Done_Pipe[0], &b, sizeof(b))) < 0 && errno == EINTR);
+  if(ret != sizeof(b))
+    Alarm(EXIT, "SIG_Next_Signed_Batch: lost the signing thread\n");
+  assert(b == &DATA.SIG.batches[DATA.SIG.batch_head]);
+
+  DATA.SIG.batch_head = (DATA.SIG.batch_head + 1) % SIG_MAX_OUTSTANDING;
+  DATA.SIG.num_outstanding--;
+
+  return b;
+}
+
+/* Send the oldest outstanding batch, waiting for its signature if need be */
+void SIG_Send_Batch()
+{
+  sig_batch *b, done;
+
+  b    = SIG_Next_Signed_Batch();
+  done = *b;
+  UTIL_DLL_Initialize(&b->messages);
+
+  SIG_Observe_Batch(done.sign_cost);
+  SIG_Finish_Pending_Messages(&done.messages, done.signature);
+}
+
+/* The bounded class target in seconds, as configured with -w */
+double SIG_Bounded_Target()
+{
+  return DATA.SIG.class_target[BOUNDED_TRAFFIC_CLASS].sec +
+         DATA.SIG.class_target[BOUNDED_TRAFFIC_CLASS].usec / 1000000.0;
+}
+
+/* Fold the gap since the previous message into the arrival average. Gaps
+ * longer than the bounded target are all "idle" as far as batching is
+ * concerned, so they are clamped to keep one quiet period from taking
+ * many messages to forget. */
+void SIG_Observe_Arrival(sp_time now)
+{
+  sp_time diff;
+  double gap, max_gap;
+
+  if(E_compare_time(now, DATA.SIG.last_arrival) > 0) {
+    diff = E_sub_time(now, DATA.SIG.last_arrival);
+    gap  = diff.sec + diff.usec / 1000000.0;
+  }
+  else
+    gap = 0;
+  DATA.SIG.last_arrival = now;
+
+  max_gap = SIG_Bounded_Target();
+  if(gap > max_gap)
+    gap = max_gap;
+
+  DATA.SIG.arrival_gap += SIG_EWMA_WEIGHT * (gap - DATA.SIG.arrival_gap);
+}
+
+/* Fold the signing cost of a batch into the average, and pick the size
+ * at which the next batch is closed:
+ * enough to hold SIG_LOAD_FACTOR signatures' worth of arrivals, so that
+ * signing keeps up with the offered load without making the messages at
+ * the head of a large batch wait for the rest. */
+void SIG_Observe_Batch(double cost)
+{
+  double thresh;
+
+  if(DATA.SIG.sign_cost == 0)
+    DATA.SIG.sign_cost = cost;
+  else
+    DATA.SIG.sign_cost += SIG_EWMA_WEIGHT * (cost - DATA.SIG.sign_cost);
+
+  if(DATA.SIG.arrival_gap * SIG_THRESHOLD <= 
+     SIG_LOAD_FACTOR * DATA.SIG.sign_cost)
+    thresh = SIG_THRESHOLD;
+  else
+    thresh = SIG_LOAD_FACTOR * DATA.SIG.sign_cost / DATA.SIG.arrival_gap + 1;
+
+  if(thresh < SIG_MIN_THRESHOLD)
+    thresh = SIG_MIN_THRESHOLD;
+  DATA.SIG.batch_threshold = (int32u)thresh;
+}
+
+/* Log2 histogram bucket: 0 for val <= 1, 1 for 2-3, 2 for 4-7, ... */
+int32u SIG_Hist_Bucket(int32u val)
+{
+  int32u b = 0;
+
+  while(val > 1 && b < SIG_HIST_BUCKETS - 1) {
+    val >>= 1;
+    b++;
+  }
+  return b;
+}
+
+void SIG_Print_Stats(int dummy, void *dummyp)
+{
+  int32u i, lo;
+  sp_time t;
+
+  Alarm(PRINT, "Signature batching: gap %.1f us, sign %.1f us, "
+        "threshold %u, outstanding %u, targets %u/%u us\n", 
+        DATA.SIG.arrival_gap * 1000000, DATA.SIG.sign_cost * 1000000,
+        DATA.SIG.batch_threshold, DATA.SIG.num_outstanding,
+        DATA.SIG.class_target[TIMELY_TRAFFIC_CLASS].usec +
+        DATA.SIG.class_target[TIMELY_TRAFFIC_CLASS].sec * 1000000,
+        DATA.SIG.class_target[BOUNDED_TRAFFIC_CLASS].usec +
+        DATA.SIG.class_target[BOUNDED_TRAFFIC_CLASS].sec * 1000000);
+  Alarm(PRINT, "  %-7s  %8s   %-12s %8s %8s %8s\n", "size", "batches",
+        "wait", "timely", "bounded", "recon");
+  for(i = 0; i < SIG_HIST_BUCKETS; i++) {
+    lo = (i == 0) ? 0 : SIG_HIST_WAIT_BASE_USEC << (i - 1);
+    Alarm(PRINT, "  >= %-4u %8u   >= %6u us %8u %8u %8u\n",
+          1 << i, DATA.SIG.batch_size_hist[i], lo,
+          DATA.SIG.wait_hist[TIMELY_TRAFFIC_CLASS][i],
+          DATA.SIG.wait_hist[BOUNDED_TRAFFIC_CLASS][i],
+          DATA.SIG.wait_hist[RECON_TRAFFIC_CLASS][i]);
+  }
+
+  TRACE_Print_Stats();
+  UTIL_Print_Message_Pools();
+  NET_Print_Egress_Stats();
+
+  if(DATA.SIG.stats_period > 0) {
+    t.sec  = DATA.SIG.stats_period;
+    t.usec = 0;
+    E_queue(SIG_Print_Stats, 0, NULL, t);
+  }
+}
+
+void SIG_Attempt_To_Generate_PO_Messages()
+{
+  if(SEND_PO_REQUESTS_PERIODICALLY)
+    PRE_ORDER_Send_PO_Request();
+
+  if(SEND_PO_ACKS_PERIODICALLY)
+    PRE_ORDER_Send_PO_Ack();
+
+  if(SEND_PO_ARU_PERIODICALLY)
+    PRE_ORDER_Send_PO_ARU();
+
+  if(!UTIL_I_Am_Leader())
+    PRE_ORDER_Send_Proof_Matrix();
+}
+
+/* Stamp the signature on each message of a closed batch, then apply
+ * and send them. */
+void SIG_Finish_Pending_Messages(dll_struct *batch, byte *signature)
+{
+  signed_message *mess;
+  int32u i, dest_bits, sig_type;
+
+  /* Copy the signature into all the messages before applying any of
+   * them, since applying may cause new messages to be added to the 
+   * pending_messages_dll. */
+  UTIL_DLL_Set_Begin(batch);
+  while((mess = (signed_message *)UTIL_DLL_Get_Signed_Message(batch)) != NULL) {
+    memcpy((byte*)mess, signature, SIGNATURE_SIZE);
+    UTIL_DLL_Next(batch);
+  }
+
+  while((mess = (signed_message *)UTIL_DLL_Front_Message(batch)) != NULL) {
 
     assert(mess->type != UPDATE);
     BENCH.signature_types[mess->type]++;
 
-    dest_bits  = UTIL_DLL_Front_Extra(&original_list, DEST);
-    timeliness = UTIL_DLL_Front_Extra(&original_list, TIMELINESS);
+    dest_bits = UTIL_DLL_Front_Extra(batch, DEST);
     
     /* Once signed, client responses should be sent to the client */
     if(mess->type == CLIENT_RESPONSE)
@@ -303,7 +604,8 @@ void SIG_Finish_Pending_Messages(byte *signature)
            * queue based on timeliness. Otherwise, send immediately to the 
            * appropriate destination. */
 #if THROTTLE_OUTGOING_MESSAGES
-          NET_Add_To_Pending_Messages(mess, dest_bits, timeliness);
+          NET_Add_To_Pending_Messages(mess, dest_bits, 
+                                      UTIL_DLL_Front_Extra(batch, TIMELINESS));
 #else
   #if 0
           /* Send the proof matrix to the leader, send recon messages to only
@@ -363,7 +665,7 @@ void SIG_Finish_Pending_Messages(byte *signature)
     } 
     
     /* Always pop */
-    UTIL_DLL_Pop_Front(&original_list);
+    UTIL_DLL_Pop_Front(batch);
   }
-  assert(UTIL_DLL_Is_Empty(&original_list));
+  assert(UTIL_DLL_Is_Empty(batch));
 }
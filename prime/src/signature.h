@@ -54,5 +54,7 @@ void SIG_Attempt_To_Generate_PO_Messages(void);
 void SIG_Add_To_Pending_Messages(signed_message *m, int32u dest_bits,
 				 int32u timeliness);
 void SIG_Make_Batch(int trigger, void *dummyp);
+void SIG_Flush_Pending_Messages(void);
+void SIG_Print_Stats(int dummy, void *dummyp);
 
 #endif
@@ -0,0 +1,260 @@
+/*
+ * Prime.
+ *     
+ * The contents of this file are subject to the Prime Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * https://jhu-dsn.github.io/prime/LICENSE.txt
+ *
+ * or in the file ``LICENSE.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * Creators:
+ *   Yair Amir            yairamir@cs.jhu.edu
+ *   Jonathan Kirsch      jak@cs.jhu.edu
+ *   John Lane            johnlane@cs.jhu.edu
+ *   Marco Platania       platania@cs.jhu.edu
+ *   Amy Babay            babay@pitt.edu
+ *   Thomas Tantillo      tantillo@cs.jhu.edu 
+ *
+ *
+ * Major Contributors:
+ *   Brian Coan           Design of the Prime algorithm
+ *   Jeff Seibert         View Change protocol 
+ *   Sahiti Bommareddy    Reconfiguration 
+ *   Maher Khan           Reconfiguration 
+ *      
+ * Copyright (c) 2008-2025
+ * The Johns Hopkins University.
+ * All rights reserved.
+ * 
+ * Partial funding for Prime research was provided by the Defense Advanced 
+ * Research Projects Agency (DARPA) and the National Science Foundation (NSF).
+ * Prime is not necessarily endorsed by DARPA or the NSF.  
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "trace.h"
+#include "data_structs.h"
+#include "utility.h"
+#include "pre_order.h"
+
+#include "spu_alarm.h"
+#include "spu_events.h"
+
+extern server_variables VAR;
+
+int32u TRACE_Usec_Since(sp_time start, sp_time t);
+void   TRACE_Add_Sample(int32u row, int32u usec);
+
+/* Prime is single threaded, so the rings are written and read from the
+ * event loop only and need no locking. Entries are tagged with the
+ * sequence number they hold, and a stale entry simply misses. */
+typedef struct dummy_trace_po_entry {
+  po_seq_pair seq;
+  int32u      num_updates;
+  sp_time     t[TRACE_PO_CERT + 1];
+  int32u      seen[TRACE_PO_CERT + 1];
+} trace_po_entry;
+
+typedef struct dummy_trace_ord_entry {
+  int32u  seq;
+  sp_time t[TRACE_NUM_STAGES];
+  int32u  seen[TRACE_NUM_STAGES];
+} trace_ord_entry;
+
+static trace_po_entry  PO_Ring[TRACE_RING_SIZE];
+static trace_ord_entry ORD_Ring[TRACE_RING_SIZE];
+
+/* Row 0 is the total (received to executed), row i is stage i-1 to i */
+static int32u Hist[TRACE_NUM_STAGES][TRACE_HIST_BUCKETS];
+static double Sum_Usec[TRACE_NUM_STAGES];
+static int32u Count[TRACE_NUM_STAGES];
+static int32u Num_Records, Num_Updates;
+
+static FILE  *Dump_fp;
+
+static char *Stage_Name[TRACE_NUM_STAGES] = {
+  "total", "po_request", "po_cert", "pre_prepare", 
+  "prepared", "committed", "executed"
+};
+
+int32u TRACE_Usec_Since(sp_time start, sp_time t)
+{
+  sp_time d;
+
+  if (E_compare_time(t, start) <= 0)
+    return 0;
+  d = E_sub_time(t, start);
+  return d.sec * 1000000 + d.usec;
+}
+
+void TRACE_Add_Sample(int32u row, int32u usec)
+{
+  int32u b = 0, v = usec / TRACE_HIST_BASE_USEC;
+
+  while (v > 0 && b < TRACE_HIST_BUCKETS - 1) {
+    v >>= 1;
+    b++;
+  }
+  Hist[row][b]++;
+  Sum_Usec[row] += usec;
+  Count[row]++;
+}
+
+void TRACE_Initialize(char *dump_file)
+{
+  memset(PO_Ring, 0, sizeof(PO_Ring));
+  memset(ORD_Ring, 0, sizeof(ORD_Ring));
+  memset(Hist, 0, sizeof(Hist));
+  memset(Sum_Usec, 0, sizeof(Sum_Usec));
+  memset(Count, 0, sizeof(Count));
+  Num_Records = Num_Updates = 0;
+
+  Dump_fp = NULL;
+  if (dump_file != NULL && (Dump_fp = fopen(dump_file, "w")) == NULL)
+    Alarm(EXIT, "TRACE_Initialize: could not open %s\n", dump_file);
+}
+
+void TRACE_PO_Request(po_seq_pair seq, sp_time received, int32u num_updates)
+{
+#if TRACE_UPDATES
+  trace_po_entry *e = &PO_Ring[seq.seq_num & (TRACE_RING_SIZE - 1)];
+
+  memset(e, 0, sizeof(*e));
+  e->seq         = seq;
+  e->num_updates = num_updates;
+  e->t[TRACE_RECEIVED]   = received;
+  e->t[TRACE_PO_REQUEST] = E_get_time();
+  e->seen[TRACE_RECEIVED] = e->seen[TRACE_PO_REQUEST] = 1;
+#endif
+}
+
+void TRACE_PO_Cert(po_seq_pair seq)
+{
+#if TRACE_UPDATES
+  trace_po_entry *e = &PO_Ring[seq.seq_num & (TRACE_RING_SIZE - 1)];
+
+  if (PRE_ORDER_Seq_Compare(e->seq, seq) != 0 || e->seen[TRACE_PO_CERT])
+    return;
+  e->t[TRACE_PO_CERT]    = E_get_time();
+  e->seen[TRACE_PO_CERT] = 1;
+#endif
+}
+
+void TRACE_Ordinal(int32u stage, int32u ord_seq)
+{
+#if TRACE_UPDATES
+  trace_ord_entry *e = &ORD_Ring[ord_seq & (TRACE_RING_SIZE - 1)];
+
+  if (e->seq != ord_seq) {
+    memset(e, 0, sizeof(*e));
+    e->seq = ord_seq;
+  }
+  if (e->seen[stage])
+    return;
+  e->t[stage]    = E_get_time();
+  e->seen[stage] = 1;
+#endif
+}
+
+/* The PO-Request's journey is complete: combine its stages with those of
+ * the ordinal that executed it, and account for each stage's share */
+void TRACE_Executed(po_seq_pair seq, int32u ord_seq)
+{
+#if TRACE_UPDATES
+  trace_po_entry  *p = &PO_Ring[seq.seq_num & (TRACE_RING_SIZE - 1)];
+  trace_ord_entry *o = &ORD_Ring[ord_seq & (TRACE_RING_SIZE - 1)];
+  sp_time t[TRACE_NUM_STAGES];
+  int32u seen[TRACE_NUM_STAGES];
+  int32u i, prev;
+  trace_record rec;
+
+  if (PRE_ORDER_Seq_Compare(p->seq, seq) != 0)
+    return;
+
+  memset(seen, 0, sizeof(seen));
+  for (i = TRACE_RECEIVED; i <= TRACE_PO_CERT; i++) {
+    t[i]    = p->t[i];
+    seen[i] = p->seen[i];
+  }
+  if (o->seq == ord_seq) {
+    for (i = TRACE_PRE_PREPARE; i < TRACE_EXECUTED; i++) {
+      t[i]    = o->t[i];
+      seen[i] = o->seen[i];
+    }
+  }
+  t[TRACE_EXECUTED]    = E_get_time();
+  seen[TRACE_EXECUTED] = 1;
+
+  /* Stages need not happen in order: this replica may collect its PO
+   * certificate after the Pre-Prepare that orders the request. Such a
+   * stage is counted as taking no time, and the next one is measured
+   * from the latest stage so far. */
+  TRACE_Add_Sample(0, TRACE_Usec_Since(t[TRACE_RECEIVED], t[TRACE_EXECUTED]));
+  prev = TRACE_RECEIVED;
+  for (i = TRACE_PO_REQUEST; i < TRACE_NUM_STAGES; i++) {
+    if (!seen[i])
+      continue;
+    TRACE_Add_Sample(i, TRACE_Usec_Since(t[prev], t[i]));
+    if (E_compare_time(t[i], t[prev]) > 0)
+      prev = i;
+  }
+  Num_Records++;
+  Num_Updates += p->num_updates;
+
+  if (Dump_fp != NULL) {
+    rec.server_id      = VAR.My_Server_ID;
+    rec.ord_seq        = ord_seq;
+    rec.po_incarnation = seq.incarnation;
+    rec.po_seq_num     = seq.seq_num;
+    rec.num_updates    = p->num_updates;
+    rec.received_sec   = t[TRACE_RECEIVED].sec;
+    rec.received_usec  = t[TRACE_RECEIVED].usec;
+    for (i = 0; i < TRACE_NUM_STAGES; i++)
+      rec.stage_usec[i] = seen[i] ? TRACE_Usec_Since(t[TRACE_RECEIVED], t[i]) 
+                                  : TRACE_UNKNOWN;
+    fwrite(&rec, sizeof(rec), 1, Dump_fp);
+  }
+
+  /* Executed once only */
+  p->seq.incarnation = p->seq.seq_num = 0;
+#endif
+}
+
+/* Printed along with the signature batching statistics (-s) */
+void TRACE_Print_Stats()
+{
+  int32u i, b;
+  char line[256];
+  int len;
+
+  Alarm(PRINT, "Update latency: %u updates in %u PO-Requests\n", 
+        Num_Updates, Num_Records);
+
+  /* Histogram columns are headed by their upper bound in microseconds */
+  len = snprintf(line, sizeof(line), "  %-12s %7s %8s", "stage", "count", "mean_ms");
+  for (b = 0; b < TRACE_HIST_BUCKETS - 1; b++)
+    len += snprintf(line + len, sizeof(line) - len, " %6u", 
+                    TRACE_HIST_BASE_USEC << b);
+  Alarm(PRINT, "%s %6s\n", line, "more");
+
+  for (i = 0; i < TRACE_NUM_STAGES; i++) {
+    len = snprintf(line, sizeof(line), "  %-12s %7u %8.3f", Stage_Name[i], 
+                   Count[i], Count[i] ? Sum_Usec[i] / Count[i] / 1000 : 0.0);
+    for (b = 0; b < TRACE_HIST_BUCKETS; b++)
+      len += snprintf(line + len, sizeof(line) - len, " %6u", Hist[i][b]);
+    Alarm(PRINT, "%s\n", line);
+  }
+
+  if (Dump_fp != NULL)
+    fflush(Dump_fp);
+}
@@ -0,0 +1,86 @@
+/*
+ * Prime.
+ *     
+ * The contents of this file are subject to the Prime Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * https://jhu-dsn.github.io/prime/LICENSE.txt
+ *
+ * or in the file ``LICENSE.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * Creators:
+ *   Yair Amir            yairamir@cs.jhu.edu
+ *   Jonathan Kirsch      jak@cs.jhu.edu
+ *   John Lane            johnlane@cs.jhu.edu
+ *   Marco Platania       platania@cs.jhu.edu
+ *   Amy Babay            babay@pitt.edu
+ *   Thomas Tantillo      tantillo@cs.jhu.edu 
+ *
+ *
+ * Major Contributors:
+ *   Brian Coan           Design of the Prime algorithm
+ *   Jeff Seibert         View Change protocol 
+ *   Sahiti Bommareddy    Reconfiguration 
+ *   Maher Khan           Reconfiguration 
+ *      
+ * Copyright (c) 2008-2025
+ * The Johns Hopkins University.
+ * All rights reserved.
+ * 
+ * Partial funding for Prime research was provided by the Defense Advanced 
+ * Research Projects Agency (DARPA) and the National Science Foundation (NSF).
+ * Prime is not necessarily endorsed by DARPA or the NSF.  
+ *
+ */
+
+#ifndef PRIME_TRACE_H
+#define PRIME_TRACE_H
+
+#include "arch.h"
+#include "packets.h"
+
+/* Stages of Prime's pipeline that the updates a replica introduces are
+ * timestamped at. Each stage's latency is measured from the one before. */
+#define TRACE_RECEIVED    0   /* read from the client */
+#define TRACE_PO_REQUEST  1   /* packed into a PO-Request for signing */
+#define TRACE_PO_CERT     2   /* PO-Request acknowledged by 2f+k+1 */
+#define TRACE_PRE_PREPARE 3   /* all parts of the ordering Pre-Prepare in */
+#define TRACE_PREPARED    4   /* prepare certificate for that ordinal */
+#define TRACE_COMMITTED   5   /* commit certificate for that ordinal */
+#define TRACE_EXECUTED    6   /* delivered for execution */
+#define TRACE_NUM_STAGES  7
+
+/* Stage not seen (e.g. the ordinal arrived through catchup) */
+#define TRACE_UNKNOWN     0xffffffff
+
+/* One record per PO-Request, written to the dump file (-T) when the
+ * PO-Request executes. Stage times are microseconds since the oldest
+ * update in it was received. */
+typedef struct dummy_trace_record {
+  int32u server_id;
+  int32u ord_seq;
+  int32u po_incarnation;
+  int32u po_seq_num;
+  int32u num_updates;
+  int32u received_sec;
+  int32u received_usec;
+  int32u stage_usec[TRACE_NUM_STAGES];
+} trace_record;
+
+void TRACE_Initialize(char *dump_file);
+
+void TRACE_PO_Request(po_seq_pair seq, sp_time received, int32u num_updates);
+void TRACE_PO_Cert(po_seq_pair seq);
+void TRACE_Ordinal(int32u stage, int32u ord_seq);
+void TRACE_Executed(po_seq_pair seq, int32u ord_seq);
+
+void TRACE_Print_Stats(void);
+
+#endif
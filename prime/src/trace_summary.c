@@ -0,0 +1,175 @@
+/*
+ * Prime.
+ *     
+ * The contents of this file are subject to the Prime Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * https://jhu-dsn.github.io/prime/LICENSE.txt
+ *
+ * or in the file ``LICENSE.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * Creators:
+ *   Yair Amir            yairamir@cs.jhu.edu
+ *   Jonathan Kirsch      jak@cs.jhu.edu
+ *   John Lane            johnlane@cs.jhu.edu
+ *   Marco Platania       platania@cs.jhu.edu
+ *   Amy Babay            babay@pitt.edu
+ *   Thomas Tantillo      tantillo@cs.jhu.edu 
+ *
+ *
+ * Major Contributors:
+ *   Brian Coan           Design of the Prime algorithm
+ *   Jeff Seibert         View Change protocol 
+ *   Sahiti Bommareddy    Reconfiguration 
+ *   Maher Khan           Reconfiguration 
+ *      
+ * Copyright (c) 2008-2025
+ * The Johns Hopkins University.
+ * All rights reserved.
+ * 
+ * Partial funding for Prime research was provided by the Defense Advanced 
+ * Research Projects Agency (DARPA) and the National Science Foundation (NSF).
+ * Prime is not necessarily endorsed by DARPA or the NSF.  
+ *
+ */
+
+/* Offline summary of the update trace records Prime writes with -T.
+ *
+ * Usage: trace_summary file [file ...]
+ *
+ * Prints each stage's share of the update latency (count, mean and
+ * percentiles), and how often each stage was the largest share of a
+ * PO-Request's total. Files of several replicas can be given together. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "trace.h"
+
+static char *Stage_Name[TRACE_NUM_STAGES] = {
+  "total", "po_request", "po_cert", "pre_prepare", 
+  "prepared", "committed", "executed"
+};
+
+typedef struct dummy_sample_array {
+  int32u *v;
+  int32u  num;
+  int32u  size;
+} sample_array;
+
+static sample_array Samples[TRACE_NUM_STAGES];
+static int32u Dominant[TRACE_NUM_STAGES];
+
+static void Add_Sample(int32u row, int32u usec)
+{
+  sample_array *s = &Samples[row];
+
+  if (s->num == s->size) {
+    s->size = s->size ? 2 * s->size : 1024;
+    if ((s->v = realloc(s->v, s->size * sizeof(int32u))) == NULL) {
+      fprintf(stderr, "trace_summary: out of memory\n");
+      exit(1);
+    }
+  }
+  s->v[s->num++] = usec;
+}
+
+static int Compare_Usec(const void *a, const void *b)
+{
+  int32u x = *(const int32u *)a, y = *(const int32u *)b;
+
+  return (x > y) - (x < y);
+}
+
+/* Same accounting as TRACE_Executed: a stage that completed before the
+ * latest one so far counts as taking no time */
+static void Process_Record(trace_record *rec)
+{
+  int32u i, prev, d, max_d, max_i;
+
+  if (rec->stage_usec[TRACE_EXECUTED] == TRACE_UNKNOWN)
+    return;
+  Add_Sample(0, rec->stage_usec[TRACE_EXECUTED]);
+
+  prev  = rec->stage_usec[TRACE_RECEIVED];
+  max_d = 0;
+  max_i = TRACE_PO_REQUEST;
+  for (i = TRACE_PO_REQUEST; i < TRACE_NUM_STAGES; i++) {
+    if (rec->stage_usec[i] == TRACE_UNKNOWN)
+      continue;
+    d = rec->stage_usec[i] > prev ? rec->stage_usec[i] - prev : 0;
+    Add_Sample(i, d);
+    if (d > max_d) {
+      max_d = d;
+      max_i = i;
+    }
+    if (rec->stage_usec[i] > prev)
+      prev = rec->stage_usec[i];
+  }
+  Dominant[max_i]++;
+}
+
+static double Percentile(sample_array *s, double p)
+{
+  int32u idx;
+
+  if (s->num == 0)
+    return 0.0;
+  idx = (int32u)(p * (s->num - 1) + 0.5);
+  return s->v[idx] / 1000.0;
+}
+
+int main(int argc, char **argv)
+{
+  FILE *fp;
+  trace_record rec;
+  int32u i, j, num_records = 0, num_updates = 0;
+  double sum;
+  int a;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s trace_file [trace_file ...]\n", argv[0]);
+    return 1;
+  }
+
+  for (a = 1; a < argc; a++) {
+    if ((fp = fopen(argv[a], "r")) == NULL) {
+      perror(argv[a]);
+      return 1;
+    }
+    while (fread(&rec, sizeof(rec), 1, fp) == 1) {
+      Process_Record(&rec);
+      num_records++;
+      num_updates += rec.num_updates;
+    }
+    fclose(fp);
+  }
+
+  printf("%u updates in %u PO-Requests\n", num_updates, num_records);
+  printf("  %-12s %8s %8s %8s %8s %8s %8s %9s\n", "stage", "count", 
+         "mean_ms", "p50_ms", "p90_ms", "p99_ms", "max_ms", "dominant");
+
+  for (i = 0; i < TRACE_NUM_STAGES; i++) {
+    sample_array *s = &Samples[i];
+
+    qsort(s->v, s->num, sizeof(int32u), Compare_Usec);
+    for (j = 0, sum = 0; j < s->num; j++)
+      sum += s->v[j];
+    printf("  %-12s %8u %8.3f %8.3f %8.3f %8.3f %8.3f", Stage_Name[i], 
+           s->num, s->num ? sum / s->num / 1000 : 0.0, Percentile(s, 0.50), 
+           Percentile(s, 0.90), Percentile(s, 0.99), Percentile(s, 1.0));
+    if (i == 0)
+      printf(" %9s\n", "");
+    else
+      printf(" %8.1f%%\n", 
+             Samples[0].num ? 100.0 * Dominant[i] / Samples[0].num : 0.0);
+  }
+
+  return 0;
+}
@@ -187,6 +187,7 @@ void UTIL_DLL_Add_Data_To_Front(dll_struct *dll, void *data)
   dll->begin = node;
   node->extra[0] = 0;
   node->extra[1] = 0;
+  UTIL_Stopwatch_Start( &(node->sw) );
   
   if(dll->end == NULL)
     dll->end = node;
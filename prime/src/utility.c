@@ -190,6 +190,32 @@ int32u UTIL_Message_Size(signed_message *m)
 	  MT_Digests_(m->mt_num) * DIGEST_SIZE);
 }
 
+/* Copy num compact PO-ARUs, as packed back-to-back in a Pre-Prepare or
+ * Proof Matrix, into fixed-size slots. The unused tail of each vector is
+ * zeroed so that digests over complete Pre-Prepares agree everywhere. */
+void UTIL_Unpack_PO_ARUs(po_aru_signed_message *dst, byte *src, int32u num)
+{
+  int32u i, size;
+
+  size = PO_ARU_SIGNED_SIZE(VAR.Num_Servers);
+  memset(dst, 0, num * sizeof(po_aru_signed_message));
+  for (i = 0; i < num; i++)
+    memcpy(&dst[i], src + i * size, size);
+}
+
+/* Pack num fixed-size PO-ARUs back-to-back in compact form. Returns the
+ * number of bytes written. */
+int32u UTIL_Pack_PO_ARUs(byte *dst, po_aru_signed_message *src, int32u num)
+{
+  int32u i, size;
+
+  size = PO_ARU_SIGNED_SIZE(VAR.Num_Servers);
+  for (i = 0; i < num; i++)
+    memcpy(dst + i * size, &src[i], size);
+
+  return num * size;
+}
+
 int32u UTIL_Get_Timeliness(int32u type)
 {
   int32u ret;
@@ -694,6 +720,60 @@ signed_message* UTIL_New_Signed_Message()
   return mess;
 }
 
+/* Objects of each message size class created so far. Their pools keep
+ * every object (MSG_POOL_KEEP), so those not sitting in their pool are in
+ * use. */
+static int32u Msg_Class_Type[]    = { MSG_SMALL_OBJ, MSG_MEDIUM_OBJ, MSG_LARGE_OBJ };
+static int32u Msg_Class_Size[]    = { MSG_SMALL_SIZE, MSG_MEDIUM_SIZE, MSG_LARGE_SIZE };
+static char  *Msg_Class_Name[]    = { "small", "medium", "large" };
+static int32u Msg_Class_Created[] = { 0, 0, 0 };
+
+/* Copy the first size bytes of a message that is to be kept into the
+ * smallest size class that holds them. The rest is zeroed, as in
+ * UTIL_New_Signed_Message. */
+signed_message* UTIL_Copy_Message(signed_message *mess, int32u size)
+{
+  signed_message *copy;
+  int32u i, type = PACK_BODY_OBJ, class_size = sizeof(packet_body);
+  int32u pooled;
+
+  for(i = 0; i < 3; i++) {
+    if(size <= Msg_Class_Size[i]) {
+      type       = Msg_Class_Type[i];
+      class_size = Msg_Class_Size[i];
+      break;
+    }
+  }
+
+  pooled = Mem_obj_in_pool(type);
+  if((copy = (signed_message*) new_ref_cnt(type)) == NULL)
+    Alarm(EXIT,"UTIL_Copy_Message: Could not allocate memory.\n");
+
+  /* the object was created rather than taken from the pool */
+  if(i < 3 && Mem_obj_in_pool(type) == pooled)
+    Msg_Class_Created[i]++;
+  memcpy(copy, mess, size);
+  memset((byte *)copy + size, 0, class_size - size);
+  return copy;
+}
+
+void UTIL_Print_Message_Pools()
+{
+  int32u i, in_use, pooled, used_kb = 0, body_kb = 0;
+
+  Alarm(PRINT, "Message pools: %8s %8s %10s %14s\n", "class", "in_use", 
+        "pooled", "in_use_KB");
+  for(i = 0; i < 3; i++) {
+    pooled  = Mem_obj_in_pool(Msg_Class_Type[i]);
+    in_use  = Msg_Class_Created[i] - pooled;
+    used_kb += in_use * Msg_Class_Size[i] / 1024;
+    body_kb += in_use * sizeof(packet_body) / 1024;
+    Alarm(PRINT, "               %8s %8u %10u %14u\n", Msg_Class_Name[i], 
+          in_use, pooled, in_use * Msg_Class_Size[i] / 1024);
+  }
+  Alarm(PRINT, "  %u KB held, %u KB as full packet bodies\n", used_kb, body_kb);
+}
+
 void UTIL_RSA_Sign_Message(signed_message *mess) 
 {
   util_stopwatch w;
@@ -1038,12 +1118,25 @@ void UTIL_Test_Server_Address_Functions()
   }
 }
 
+/* The History_Ring arrays cache recent slots by sequence number so that
+ * lookups in the active window do not go through the History hashes. The
+ * hash remains the authoritative store: a ring miss falls back to it, and
+ * the Garbage Collect functions forget a slot from the ring before freeing
+ * it. */
+#define PO_RING_IDX(ps)   ((ps).seq_num & (PO_HISTORY_WINDOW - 1))
+#define ORD_RING_IDX(seq) ((seq) & (ORD_HISTORY_WINDOW - 1))
+
 po_slot* UTIL_Get_PO_Slot(int32u server_id, po_seq_pair ps)
 {
   po_slot *slot;
   stdit it;
   stdhash *h;
 
+  slot = DATA.PO.History_Ring[server_id][PO_RING_IDX(ps)];
+  if (slot != NULL && slot->seq.seq_num == ps.seq_num &&
+      slot->seq.incarnation == ps.incarnation)
+    return slot;
+
   h = &DATA.PO.History[server_id];
 
   stdhash_find(h, &it, &ps);
@@ -1074,6 +1167,8 @@ po_slot* UTIL_Get_PO_Slot(int32u server_id, po_seq_pair ps)
   else
     slot = *((po_slot**) stdhash_it_val(&it));
 
+  DATA.PO.History_Ring[server_id][PO_RING_IDX(ps)] = slot;
+
   return slot;
 }
 
@@ -1083,6 +1178,11 @@ po_slot* UTIL_Get_PO_Slot_If_Exists(int32u server_id, po_seq_pair ps)
   stdit it;
   stdhash *h;
   
+  slot = DATA.PO.History_Ring[server_id][PO_RING_IDX(ps)];
+  if (slot != NULL && slot->seq.seq_num == ps.seq_num &&
+      slot->seq.incarnation == ps.incarnation)
+    return slot;
+
   h = &DATA.PO.History[server_id];
   
   stdhash_find(h, &it, &ps);
@@ -1091,18 +1191,33 @@ po_slot* UTIL_Get_PO_Slot_If_Exists(int32u server_id, po_seq_pair ps)
   if (stdhash_is_end( h, &it))
     /* There is no slot. */
     slot = NULL;
-  else
+  else {
     slot = *((po_slot**) stdhash_it_val(&it));
+    DATA.PO.History_Ring[server_id][PO_RING_IDX(ps)] = slot;
+  }
   
   return slot;
 }
 
+void UTIL_Forget_PO_Slot(int32u server_id, po_slot *slot)
+{
+  po_slot **entry;
+
+  entry = &DATA.PO.History_Ring[server_id][PO_RING_IDX(slot->seq)];
+  if (*entry == slot)
+    *entry = NULL;
+}
+
 ord_slot *UTIL_Get_ORD_Slot(int32u seq_num)
 {
   ord_slot *slot;
   stdit it;
   stdhash *h;
 
+  slot = DATA.ORD.History_Ring[ORD_RING_IDX(seq_num)];
+  if (slot != NULL && slot->seq_num == seq_num)
+    return slot;
+
   h = &DATA.ORD.History;
 
   stdhash_find(h, &it, &seq_num);
@@ -1125,6 +1240,8 @@ ord_slot *UTIL_Get_ORD_Slot(int32u seq_num)
   } 
   else
     slot = *((ord_slot**)stdhash_it_val(&it));
+
+  DATA.ORD.History_Ring[ORD_RING_IDX(seq_num)] = slot;
   
   return slot;
 }
@@ -1135,18 +1252,33 @@ ord_slot *UTIL_Get_ORD_Slot_If_Exists(int32u seq_num)
   stdit it;
   stdhash *h;
   
+  slot = DATA.ORD.History_Ring[ORD_RING_IDX(seq_num)];
+  if (slot != NULL && slot->seq_num == seq_num)
+    return slot;
+
   h    = &DATA.ORD.History;
   slot = NULL;
   
   stdhash_find(h, &it, &seq_num);
   
   /* If there is nothing in the slot, then create a slot. */
-  if(!stdhash_is_end( h, &it))
+  if(!stdhash_is_end( h, &it)) {
     slot = *((ord_slot**)stdhash_it_val(&it));
+    DATA.ORD.History_Ring[ORD_RING_IDX(seq_num)] = slot;
+  }
   
   return slot;
 }
 
+void UTIL_Forget_ORD_Slot(ord_slot *slot)
+{
+  ord_slot **entry;
+
+  entry = &DATA.ORD.History_Ring[ORD_RING_IDX(slot->seq_num)];
+  if (*entry == slot)
+    *entry = NULL;
+}
+
 ord_slot *UTIL_Get_Pending_ORD_Slot_If_Exists(int32u gseq)
 {
   ord_slot *slot;
@@ -1407,12 +1539,13 @@ erasure_part_obj *UTIL_New_Erasure_Part_Obj()
 void UTIL_Respond_To_Client(int32u machine_id, int32u incarnation, 
                             int32u seq_num, int32u ord_num,
                             int32u event_idx, int32u event_tot, 
-                            byte content[UPDATE_SIZE])
+                            byte *content, int32u content_len)
 {
   signed_message *mess;
   
   mess = ORDER_Construct_Client_Response(machine_id, incarnation, seq_num, 
-                                        ord_num, event_idx, event_tot, content);
+                                        ord_num, event_idx, event_tot, content,
+                                        content_len);
 
   /* Treated specially, no need to set dest_bits or timeliness */
   /* For Benchmarking Prime, we sign client responses. In Prime for SCADA,
@@ -1423,19 +1556,10 @@ void UTIL_Respond_To_Client(int32u machine_id, int32u incarnation,
   dec_ref_cnt(mess);
 }
 
-void UTIL_Write_Client_Response(signed_message *mess)
+static void UTIL_Send_To_Client(void *buf, int32u size, int32u machine_id)
 {
-  client_response_message *response;
-  int32u machine_id, size;
   int32 ret;
 
-  response   = (client_response_message *)(mess+1);
-  machine_id = response->machine_id;
-
-  size = UTIL_Message_Size(mess);
-  Alarm(DEBUG, "Getting ready to write %d bytes to client %d seq %d\n", 
-	size, machine_id, response->seq_num);
-
   /* if(NET.client_sd[machine_id] == 0) {
     Alarm(PRINT, "Unable to write reply to client %d, no open connection.\n",
 	  machine_id);
@@ -1452,13 +1576,13 @@ void UTIL_Write_Client_Response(signed_message *mess)
 #if USE_IPC_CLIENT
   util_stopwatch ipc_send_time;
   UTIL_Stopwatch_Start(&ipc_send_time);
-  ret = IPC_Send(NET.to_client_sd, mess, size, NET.client_addr.sun_path);
+  ret = IPC_Send(NET.to_client_sd, buf, size, NET.client_addr.sun_path);
   UTIL_Stopwatch_Stop(&ipc_send_time);
   DATA.SIG.ipc_send_agg += UTIL_Stopwatch_Elapsed(&ipc_send_time);
   //DATA.SIG.ipc_send_msg[DATA.SIG.ipc_count] = UTIL_Stopwatch_Elapsed(&ipc_send_time);
   //DATA.SIG.ipc_count++;
 #else
-  ret = NET_Write(NET.to_client_sd, mess, size);
+  ret = NET_Write(NET.to_client_sd, buf, size);
 #endif
 
   if(ret <= 0) {
@@ -1490,61 +1614,94 @@ void UTIL_Write_Client_Response(signed_message *mess)
     Alarm(DEBUG, "&&&&&&&MS2022: Sent %d TCP bytes to client on %s \n", ret,NET.client_addr.sun_path);
 }
 
-net_struct *UTIL_New_Net_Struct()
+/* While a batch is open (see UTIL_Begin_Client_Batch), client responses
+ * are packed back-to-back into Client_Batch and written to the client in
+ * one send when the batch is flushed or would overflow. */
+static byte   Client_Batch[CLIENT_RESPONSE_BATCH_BYTES > 0 ? CLIENT_RESPONSE_BATCH_BYTES : 1];
+static int32u Client_Batch_Len;
+static int32u Client_Batch_Count;
+static int    Client_Batch_Open;
+
+void UTIL_Write_Client_Response(signed_message *mess)
 {
-  net_struct *n;
+  client_response_message *response;
+  int32u machine_id, size;
 
-  n = new_ref_cnt(NET_STRUCT_OBJ);
-  memset(n, 0, sizeof(*n));
-  return n;
+  response   = (client_response_message *)(mess+1);
+  machine_id = response->machine_id;
+
+  size = UTIL_Message_Size(mess);
+  Alarm(DEBUG, "Getting ready to write %d bytes to client %d seq %d\n", 
+	size, machine_id, response->seq_num);
+
+  if (!Client_Batch_Open || size > CLIENT_RESPONSE_BATCH_BYTES) {
+    UTIL_Send_To_Client(mess, size, machine_id);
+    return;
+  }
+
+  if (Client_Batch_Len + size > CLIENT_RESPONSE_BATCH_BYTES)
+    UTIL_Flush_Client_Batch();
+
+  memcpy(Client_Batch + Client_Batch_Len, mess, size);
+  Client_Batch_Len += size;
+  Client_Batch_Count++;
 }
 
-int32u NET_Add_To_Pending_Messages(signed_message *mess, int32u dest_bits,
-				   int32u timeliness)
+void UTIL_Begin_Client_Batch()
 {
-  net_struct *n;
-  int32u i;
+  Client_Batch_Open = (CLIENT_RESPONSE_BATCH_BYTES > 0);
+  Client_Batch_Len = 0;
+  Client_Batch_Count = 0;
+}
 
-  n = UTIL_New_Net_Struct();
+void UTIL_Flush_Client_Batch()
+{
+  if (Client_Batch_Len > 0) {
+    Alarm(DEBUG, "Writing batch of %u responses (%u bytes) to client\n",
+          Client_Batch_Count, Client_Batch_Len);
+    UTIL_Send_To_Client(Client_Batch, Client_Batch_Len, 0);
+  }
+  Client_Batch_Len = 0;
+  Client_Batch_Count = 0;
+}
 
-  inc_ref_cnt(mess);
-  n->mess       = mess;
-  n->dest_bits  = dest_bits;
-  n->timeliness = timeliness;
+void UTIL_End_Client_Batch()
+{
+  UTIL_Flush_Client_Batch();
+  Client_Batch_Open = 0;
+}
 
-  /* How many destinations are there for this message? */
+int32u NET_Add_To_Pending_Messages(signed_message *mess, int32u dest_bits,
+				   int32u timeliness)
+{
+  egress_queue *q;
+  int32u i;
 
   /* Broadcast: Send to all servers but me */
   if(dest_bits == BROADCAST) {
-    for(i = 1; i <= VAR.Num_Servers; i++) {
-      if(i != VAR.My_Server_ID) {
-	n->destinations[i] = 1;
-	n->num_remaining_destinations++;
-      }
-    }
-    assert(n->num_remaining_destinations == (VAR.Num_Servers - 1));
-  }
-
-  /* Non-broadcast: Send only to those marked as desinations */
-  else {
-    for(i = 1; i <= VAR.Num_Servers; i++) {
-      if(i != VAR.My_Server_ID && UTIL_Bitmap_Is_Set(&dest_bits, i)) {
-	n->destinations[i] = 1;
-	n->num_remaining_destinations++;
-      }
-    }
-    assert(n->num_remaining_destinations == 
-	   UTIL_Bitmap_Num_Bits_Set(&dest_bits));
+    dest_bits = 0;
+    for(i = 1; i <= VAR.Num_Servers; i++)
+      if(i != VAR.My_Server_ID)
+	UTIL_Bitmap_Set(&dest_bits, i);
   }
 
-  /* Add to either the timely or bounded queue */
   if(timeliness == BOUNDED_TRAFFIC_CLASS)
     Alarm(DEBUG, "Added BOUNDED message (type %d) to pending queue\n",
-	  n->mess->type);
+	  mess->type);
+
+  /* Each destination gets its own reference to the message on its own
+   * queue, so destinations drain independently. */
+  for(i = 1; i <= VAR.Num_Servers; i++) {
+    if(i == VAR.My_Server_ID || !UTIL_Bitmap_Is_Set(&dest_bits, i))
+      continue;
 
-  UTIL_DLL_Add_Data(&NET.pending_messages_dll[timeliness], n);
-  assert(get_ref_cnt(n) > 1);
-  dec_ref_cnt(n); /* One copy on queue only */
+    q = &NET.egress[i][timeliness];
+    UTIL_DLL_Add_Data(&q->pending, mess);
+    if(q->pending.length > q->max_depth)
+      q->max_depth = q->pending.length;
+
+    NET_Kick_Egress(i);
+  }
 
   return 1;
 }
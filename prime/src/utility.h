@@ -67,6 +67,11 @@ int poseqcmp(const void *n1, const void *n2);
  * tree digest bytes that are appended. */
 int32u UTIL_Message_Size(signed_message *m);
 
+/* Convert between the compact PO-ARUs carried in Pre-Prepares and Proof
+ * Matrices and the fixed-size po_aru_signed_message slots kept locally. */
+void   UTIL_Unpack_PO_ARUs(po_aru_signed_message *dst, byte *src, int32u num);
+int32u UTIL_Pack_PO_ARUs  (byte *dst, po_aru_signed_message *src, int32u num);
+
 /* Returns the traffic class (timeliness) of a message.  Currently the
  * only options are BOUNDED and TIMELY. */
 int32u UTIL_Get_Timeliness(int32u type);
@@ -117,11 +122,12 @@ int32u UTIL_Bitmap_Num_Bits_Set(int32u *bm);
 int32u UTIL_Bitmap_Is_Superset(int32u *bm_old, int32u *bm_new);
 
 /* Memory allocation functions */
-net_struct *UTIL_New_Net_Struct(void);
 erasure_node *UTIL_New_Erasure_Node(int32u dest_bits, int32u type, 
 				    int32u part_len, int32u mess_len);
 erasure_part_obj *UTIL_New_Erasure_Part_Obj(void);
 signed_message* UTIL_New_Signed_Message(void);
+signed_message* UTIL_Copy_Message(signed_message *mess, int32u size);
+void            UTIL_Print_Message_Pools(void);
 
 /* Slot get() functions.  The regular variant will allocate memory for
  * a new slot if no slot exists.  The "if exists" variant will not
@@ -130,6 +136,9 @@ po_slot    *UTIL_Get_PO_Slot             (int32u server_id, po_seq_pair ps);
 po_slot    *UTIL_Get_PO_Slot_If_Exists   (int32u server_id, po_seq_pair ps);
 ord_slot   *UTIL_Get_ORD_Slot            (int32u seq_num);
 ord_slot   *UTIL_Get_ORD_Slot_If_Exists  (int32u seq_num);
+/* Drop a slot from the History_Ring index before it is garbage collected */
+void        UTIL_Forget_PO_Slot          (int32u server_id, po_slot *slot);
+void        UTIL_Forget_ORD_Slot         (ord_slot *slot);
 recon_slot *UTIL_Get_Recon_Slot          (int32u originator, po_seq_pair ps);
 recon_slot *UTIL_Get_Recon_Slot_If_Exists(int32u originator, po_seq_pair ps);
 void      UTIL_Mark_ORD_Slot_As_Pending      (int32u gseq, ord_slot *slot);
@@ -148,7 +157,13 @@ void UTIL_RSA_Sign_Message(signed_message *mess);
 void UTIL_Respond_To_Client    (int32u machine_id, int32u incarnation, 
                                 int32u seq_num, int32u ord_num, 
                                 int32u event_idx, int32u event_tot, 
-                                byte content[UPDATE_SIZE]);
+                                byte *content, int32u content_len);
 void UTIL_Write_Client_Response(signed_message *mess);
 
+/* Responses written between Begin and End are delivered to the client
+ * back-to-back in as few sends as CLIENT_RESPONSE_BATCH_BYTES allows */
+void UTIL_Begin_Client_Batch   (void);
+void UTIL_Flush_Client_Batch   (void);
+void UTIL_End_Client_Batch     (void);
+
 #endif
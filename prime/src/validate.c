@@ -1165,12 +1165,12 @@ int32u VAL_Validate_PO_Ack(po_ack_message *po_ack, int32u num_bytes)
   po_ack_part *part;
   int32u p;
 
-  if(num_bytes < sizeof(po_ack_message)) {
+  if(num_bytes < PO_ACK_SIZE(VAR.Num_Servers)) {
     VALIDATE_FAILURE("PO-Ack wrong size");
     return 0;
   }
 
-  expected_num_bytes = sizeof(po_ack_message) + 
+  expected_num_bytes = PO_ACK_SIZE(VAR.Num_Servers) + 
                         (po_ack->num_ack_parts * sizeof(po_ack_part));
 
   if(num_bytes != expected_num_bytes) {
@@ -1179,7 +1179,7 @@ int32u VAL_Validate_PO_Ack(po_ack_message *po_ack, int32u num_bytes)
   }
 
   /* Iterate over each ack part in the aggregate PO-Ack, and sanity check it */
-  part = (po_ack_part *)(po_ack+1);
+  part = PO_ACK_PARTS(po_ack, VAR.Num_Servers);
   for (p = 0; p < po_ack->num_ack_parts; p++) {
     if (part[p].seq.seq_num == 0) { 
       VALIDATE_FAILURE("Invalid PO-Ack part seq_num");
@@ -1196,7 +1196,7 @@ int32u VAL_Validate_PO_Ack(po_ack_message *po_ack, int32u num_bytes)
 
 int32u VAL_Validate_PO_ARU(po_aru_message *po_aru, int32u num_bytes)
 {
-  if (num_bytes != (sizeof(po_aru_message))) {
+  if (num_bytes != PO_ARU_SIZE(VAR.Num_Servers)) {
     VALIDATE_FAILURE("PO_ARU bad size");
     return 0;
   }
@@ -1217,7 +1217,7 @@ int32u VAL_Validate_Proof_Matrix(proof_matrix_message *pm, int32u num_bytes)
   }
 
   expected_size = sizeof(proof_matrix_message) + 
-                  (pm->num_acks_in_this_message * sizeof(po_aru_signed_message));
+                  (pm->num_acks_in_this_message * PO_ARU_SIGNED_SIZE(VAR.Num_Servers));
   if (num_bytes != expected_size) {
     VALIDATE_FAILURE("proof_matrix wrong size");
     return 0;
@@ -1225,20 +1225,19 @@ int32u VAL_Validate_Proof_Matrix(proof_matrix_message *pm, int32u num_bytes)
   
   DATA.PO.Nested_Ignore_Incarnation = 1;
   po_aru = (po_aru_signed_message *)(pm+1);
-  for (i = 1; i <= pm->num_acks_in_this_message; i++)
+  for (i = 1; i <= pm->num_acks_in_this_message; i++, 
+       po_aru = (po_aru_signed_message *)((byte *)po_aru + PO_ARU_SIGNED_SIZE(VAR.Num_Servers)))
   {
     /* If the type is 0 (DUMMY), this may be a NULL vector, i.e., we haven't received a
      * PO_ARU yet from this replica. In either case, we will not process it later */
     if (po_aru->header.type == DUMMY)
       continue;
 
-    if (po_aru->header.type != PO_ARU || !VAL_Validate_Message((signed_message *) po_aru, sizeof(po_aru_signed_message))) {
+    if (po_aru->header.type != PO_ARU || !VAL_Validate_Message((signed_message *) po_aru, PO_ARU_SIGNED_SIZE(VAR.Num_Servers))) {
       VALIDATE_FAILURE("Invalid PO-ARU in Proof Matrix");
       DATA.PO.Nested_Ignore_Incarnation = nested_state;
       return 0;
     }
-
-    po_aru = (po_aru_signed_message *)(po_aru + 1);
   }
   
   DATA.PO.Nested_Ignore_Incarnation = nested_state;
@@ -1254,13 +1253,13 @@ int32u VAL_Validate_Pre_Prepare(pre_prepare_message *pp, int32u num_bytes)
 
   Alarm(DEBUG, "VAL_Validate_Pre_Prepare\n");
 
-  if(num_bytes < sizeof(pre_prepare_message)) {
+  if(num_bytes < PRE_PREPARE_SIZE(VAR.Num_Servers)) {
     VALIDATE_FAILURE("Pre-Prepare too small");
     return 0;
   }
  
-  expected_size = sizeof(pre_prepare_message) + 
-                  (pp->num_acks_in_this_message * sizeof(po_aru_signed_message));
+  expected_size = PRE_PREPARE_SIZE(VAR.Num_Servers) + 
+                  (pp->num_acks_in_this_message * PO_ARU_SIGNED_SIZE(VAR.Num_Servers));
   if (num_bytes != expected_size) {
     VALIDATE_FAILURE("Pre-Prepare wrong size");
     return 0;
@@ -1279,21 +1278,20 @@ int32u VAL_Validate_Pre_Prepare(pre_prepare_message *pp, int32u num_bytes)
   }
 
   DATA.PO.Nested_Ignore_Incarnation = 1;
-  po_aru = (po_aru_signed_message *)(pp+1);
-  for (i = 1; i <= pp->num_acks_in_this_message; i++)
+  po_aru = (po_aru_signed_message *)PP_CUM_ACKS(pp, VAR.Num_Servers);
+  for (i = 1; i <= pp->num_acks_in_this_message; i++, 
+       po_aru = (po_aru_signed_message *)((byte *)po_aru + PO_ARU_SIGNED_SIZE(VAR.Num_Servers)))
   {
     /* If the type is 0 (DUMMY), this may be a NULL vector, i.e., we haven't received a
      * PO_ARU yet from this replica. In either case, we will not process it later */
     if (po_aru->header.type == DUMMY)
       continue;
 
-    if (po_aru->header.type != PO_ARU || !VAL_Validate_Message((signed_message *) po_aru, sizeof(po_aru_signed_message))) {
+    if (po_aru->header.type != PO_ARU || !VAL_Validate_Message((signed_message *) po_aru, PO_ARU_SIGNED_SIZE(VAR.Num_Servers))) {
       VALIDATE_FAILURE("Invalid PO-ARU in Pre-Prepare");
       DATA.PO.Nested_Ignore_Incarnation = nested_state;
       return 0;
     }
-
-    po_aru = (po_aru_signed_message *)(po_aru + 1);
   }
 
   DATA.PO.Nested_Ignore_Incarnation = nested_state;
@@ -1302,7 +1300,7 @@ int32u VAL_Validate_Pre_Prepare(pre_prepare_message *pp, int32u num_bytes)
 
 int32u VAL_Validate_Prepare(prepare_message *prepare, int32u num_bytes)
 {
-  if(num_bytes != sizeof(prepare_message)) {
+  if(num_bytes != PREPARE_SIZE(VAR.Num_Servers)) {
     VALIDATE_FAILURE("Prepare, bad size");
     return 0;
   }
@@ -1317,7 +1315,7 @@ int32u VAL_Validate_Prepare(prepare_message *prepare, int32u num_bytes)
 
 int32u VAL_Validate_Commit(commit_message *commit, int32u num_bytes)
 {
-  if(num_bytes != sizeof(commit_message)) {
+  if(num_bytes != COMMIT_SIZE(VAR.Num_Servers)) {
     VALIDATE_FAILURE("Commit: bad size");
     return 0;
   }
@@ -1603,10 +1601,11 @@ int32u VAL_Validate_PC_Set(pc_set_message *pc, int32u num_bytes)
   memset(&complete_pp,0,sizeof(complete_pre_prepare_message));
   complete_pp.seq_num = pp->seq_num;
   complete_pp.view = pp->view;
-  memcpy((byte *)&complete_pp.last_executed, &pp->last_executed, sizeof(pp->last_executed));
+  memcpy((byte *)&complete_pp.last_executed, &pp->last_executed, 
+            VAR.Num_Servers * sizeof(po_seq_pair));
   memcpy((byte *)&complete_pp.proposal_digest, &pp->proposal_digest, DIGEST_SIZE);
-  memcpy((byte *)&complete_pp.cum_acks, (byte *)(pp + 1),  
-            sizeof(po_aru_signed_message) * pp->num_acks_in_this_message);
+  UTIL_Unpack_PO_ARUs(complete_pp.cum_acks, PP_CUM_ACKS(pp, VAR.Num_Servers), 
+            pp->num_acks_in_this_message);
 
 
 
@@ -1744,7 +1743,7 @@ int32u VAL_Validate_Replay_Commit(replay_commit_message *r_commit, int32u num_by
 
 int32u VAL_Validate_Catchup_Request(catchup_request_message *c_request, int32u num_bytes)
 {
-  if (num_bytes != sizeof(catchup_request_message)) {
+  if (num_bytes != CATCHUP_REQUEST_SIZE(VAR.Num_Servers)) {
     VALIDATE_FAILURE("Catchup_Request: invalid size");
     return 0;
   }
@@ -1802,10 +1801,11 @@ int32u VAL_Validate_ORD_Certificate(ord_certificate_message *ord_cert, int32u nu
   memset(&complete_pp,0,sizeof(complete_pre_prepare_message));
   complete_pp.seq_num = pp->seq_num;
   complete_pp.view = pp->view;
-  memcpy((byte *)&complete_pp.last_executed, &pp->last_executed, sizeof(pp->last_executed));
+  memcpy((byte *)&complete_pp.last_executed, &pp->last_executed, 
+            VAR.Num_Servers * sizeof(po_seq_pair));
   memcpy((byte *)&complete_pp.proposal_digest, &pp->proposal_digest, DIGEST_SIZE);
-  memcpy((byte *)&complete_pp.cum_acks, (byte *)(pp + 1), 
-            sizeof(po_aru_signed_message) * pp->num_acks_in_this_message);
+  UTIL_Unpack_PO_ARUs(complete_pp.cum_acks, PP_CUM_ACKS(pp, VAR.Num_Servers), 
+            pp->num_acks_in_this_message);
 
   /* Compute the digest of the PP */
   OPENSSL_RSA_Make_Digest((byte*)&complete_pp, sizeof(complete_pre_prepare_message), pp_digest);
@@ -1946,7 +1946,7 @@ int32u VAL_Validate_PO_Certificate(po_certificate_message *po_cert, int32u num_b
     DATA.PO.Nested_Ignore_Incarnation = nested_state;
 
     pa_specific = (po_ack_message *)(pa + 1);
-    part = (po_ack_part *)(pa_specific + 1);
+    part = PO_ACK_PARTS(pa_specific, VAR.Num_Servers);
     /* Need to make sure all preinstall vectors match, so grab the first one
      * and we'll compare all the rest to that one */
     if (count == 0) {
@@ -1105,11 +1105,12 @@ void VIEW_Execute_Replay()
         pp->part_num = 1;
         pp->total_parts = 1;
         pp->num_acks_in_this_message = VAR.Num_Servers;
-        memset(((char*)pp) + sizeof(pre_prepare_message), 0, 
-                pp->num_acks_in_this_message * sizeof(po_aru_signed_message));
+        memset(PP_CUM_ACKS(pp, VAR.Num_Servers), 0, 
+                pp->num_acks_in_this_message * PO_ARU_SIGNED_SIZE(VAR.Num_Servers));
         
-        dummy_pp_part->len = pp->num_acks_in_this_message * 
-                                sizeof(po_aru_signed_message);
+        dummy_pp_part->len = PRE_PREPARE_SIZE(VAR.Num_Servers) + 
+                                pp->num_acks_in_this_message * 
+                                PO_ARU_SIGNED_SIZE(VAR.Num_Servers);
         prev_pp_part = dummy_pp_part;
         /* Here, we just need a po_seq_pair array of size VAR.Num_Servers
          * that is set to all zeros, so be borrow from last_executed */
@@ -1179,7 +1180,7 @@ void VIEW_Execute_Replay()
 
             /* Copy in the last_executed and proposal_digest */
             memcpy((byte *)slot->complete_pre_prepare.last_executed, 
-                    &pp->last_executed, sizeof(pp->last_executed));
+                    &pp->last_executed, VAR.Num_Servers * sizeof(po_seq_pair));
             memcpy((byte *)&slot->complete_pre_prepare.proposal_digest, 
                     &pp->proposal_digest, DIGEST_SIZE);
 
@@ -1187,9 +1188,8 @@ void VIEW_Execute_Replay()
              * reference count, assuming large messages with 1 part
              * for now. If we use multiple parts, we need to copy
              * them over one by one, and make sure we collect all parts. */
-            memcpy((byte *)slot->complete_pre_prepare.cum_acks, 
-                (byte *)(pp + 1), sizeof(po_aru_signed_message) * 
-                pp->num_acks_in_this_message);
+            UTIL_Unpack_PO_ARUs(slot->complete_pre_prepare.cum_acks, 
+                PP_CUM_ACKS(pp, VAR.Num_Servers), pp->num_acks_in_this_message);
             
             memcpy(slot->pre_prepare_parts_msg[1], pptr, UTIL_Message_Size(pptr));
             slot->collected_all_parts = 1;
@@ -254,7 +254,8 @@ int main(int argc, char *argv[])
                  test = (signed_message *)buff;
                  printf("Sending to CC mess type %lu from client %lu\n",test->type,test->machine_id);
                  
-                 if(ret==sizeof(signed_update_message)){
+                 if(ret >= (int)(sizeof(signed_message) + sizeof(update_message)) &&
+                    ret <= (int)sizeof(signed_update_message)){
                     printf("Received feedback message on substation dissemination network size=%d\n",ret);
                     ret2 = IPC_Send(ipc_sock, buff, ret, itrc_main.ipc_remote);   
                     if(ret2!=ret){
@@ -72,9 +72,20 @@
 
 #define MAX_PATH 1000
 
+/* Max number of waiting protocol messages drained at once for coalescing */
+#define COALESCE_MAX 16
+
 extern int32u My_Global_Configuration_Number;
 
+/* Messages drained from a protocol channel; a length of 0 marks a message
+ * that was superseded by a newer one */
+static char Coalesce_Buf[COALESCE_MAX][MAX_LEN];
+static int  Coalesce_Len[COALESCE_MAX];
+static unsigned long Coalesced_Count;
+
 void Process_Config_Msg(signed_message * conf_mess,int mess_size);
+int  Coalescable_RTU(char *buf, int len);
+int  Drain_And_Coalesce(int sock);
 
 void Process_Config_Msg(signed_message * conf_mess,int mess_size){
     config_message *c_mess;
@@ -105,6 +116,58 @@ void Process_Config_Msg(signed_message * conf_mess,int mess_size){
 }
 
 
+/* Returns the RTU id if this is an RTU_DATA message that carries the full
+ * state of its RTU (so a newer one from the same RTU supersedes it), or -1 */
+int Coalescable_RTU(char *buf, int len)
+{
+    signed_message *mess;
+    rtu_data_msg *rtud;
+
+    if (len < (int)(sizeof(signed_message) + sizeof(rtu_data_msg)))
+        return -1;
+    mess = (signed_message *)buf;
+    if (mess->type != RTU_DATA)
+        return -1;
+    rtud = (rtu_data_msg *)(mess + 1);
+    if (rtud->scen_type == EMS)
+        return -1;
+    return (int)rtud->rtu_id;
+}
+
+/* Read the ready message from a protocol channel plus any others already
+ * waiting behind it. If the PLC/RTU polls faster than updates get through
+ * the ITRC, only the latest RTU_DATA per RTU is kept, so Prime orders one
+ * update per RTU instead of a backlog of stale ones. Returns the number of
+ * slots filled in Coalesce_Buf. */
+int Drain_And_Coalesce(int sock)
+{
+    int n, k, rtu;
+
+    Coalesce_Len[0] = IPC_Recv(sock, Coalesce_Buf[0], MAX_LEN);
+    if (Coalesce_Len[0] <= 0)
+        return 0;
+    n = 1;
+
+    while (n < COALESCE_MAX) {
+        Coalesce_Len[n] = recv(sock, Coalesce_Buf[n], MAX_LEN, MSG_DONTWAIT);
+        if (Coalesce_Len[n] <= 0)
+            break;
+
+        rtu = Coalescable_RTU(Coalesce_Buf[n], Coalesce_Len[n]);
+        for (k = 0; rtu >= 0 && k < n; k++) {
+            if (Coalesce_Len[k] > 0 && 
+                Coalescable_RTU(Coalesce_Buf[k], Coalesce_Len[k]) == rtu) 
+            {
+                Coalesce_Len[k] = 0;
+                Coalesced_Count++;
+            }
+        }
+        n++;
+    }
+
+    return n;
+}
+
 // conver string to protocol enum
 int string_to_protocol(char * prot) {
     int p_n;
@@ -125,7 +188,7 @@ int string_to_protocol(char * prot) {
 /* RTU Proxy implementation */
 int main(int argc, char *argv[])
 {
-    int i, num, ret, nBytes, sub,ret2;
+    int i, j, num, num_pend, ret, nBytes, sub,ret2;
     int ipc_sock;
     struct timeval now;
     struct sockaddr_in;
@@ -330,17 +393,25 @@ int main(int argc, char *argv[])
                     continue;
                 /* Message from a proxy */
                 if (FD_ISSET(ipc_s[i], &tmask)) {
-                    nBytes = IPC_Recv(ipc_s[i], buff, MAX_LEN);
-                    mess = (signed_message *)buff;
-                    mess->global_configuration_number = My_Global_Configuration_Number;
-                    rtud = (rtu_data_msg *)(mess + 1);
-                    ps = (seq_pair *)&rtud->seq;
-                    ps->incarnation = My_Incarnation;
-                    printf("PROXY: message from plc, sending data to sm\n");
-                    ret = IPC_Send(ipc_sock, (void *)buff, nBytes, itrc_main.ipc_remote);
-                    if(ret!=nBytes){
-                        printf("PROXY: error sending to SM\n");
+                    num_pend = Drain_And_Coalesce(ipc_s[i]);
+                    for (j = 0; j < num_pend; j++) {
+                        nBytes = Coalesce_Len[j];
+                        if (nBytes <= 0)
+                            continue;
+                        mess = (signed_message *)Coalesce_Buf[j];
+                        mess->global_configuration_number = My_Global_Configuration_Number;
+                        rtud = (rtu_data_msg *)(mess + 1);
+                        ps = (seq_pair *)&rtud->seq;
+                        ps->incarnation = My_Incarnation;
+                        printf("PROXY: message from plc, sending data to sm\n");
+                        ret = IPC_Send(ipc_sock, (void *)mess, nBytes, itrc_main.ipc_remote);
+                        if(ret!=nBytes){
+                            printf("PROXY: error sending to SM\n");
+                        }
                     }
+                    if (num_pend > 1)
+                        printf("PROXY: drained %d messages, %lu superseded so far\n",
+                                num_pend, Coalesced_Count);
                 }
             }
         }
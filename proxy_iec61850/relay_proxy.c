@@ -113,6 +113,7 @@ static void TM_IPC_Recv(int source, void *dummy);
 static void publish_cc_goose(int code, int v_trip);
 static void publish_goose(int code, int v_trip);
 static void repeat_goose(int code, void *dummy);
+static void queue_repeat_goose();
 static void print_notice();
 
 int main(int argc, char** argv)
@@ -145,6 +146,7 @@ int main(int argc, char** argv)
     //GoosePublisher_setDataSetRef(publisher, "Dataset1");
     GoosePublisher_setDataSetRef(publisher, argv[6]);
     GoosePublisher_setGoID(publisher,argv[5]);
+    GoosePublisher_setRetransmissionTimes(publisher, T1, T0);
 
     //Create publisher for CC commands
     cc_publisher = GoosePublisher_create(&cc_gooseCommParameters, argv[4]);
@@ -279,27 +281,33 @@ void publish_goose(int code, int v_trip)
     GoosePublisher_increaseStNum(publisher);
     MmsValue_setBoolean(mms_trip, trip);
 
-
-    timeout_ms= T1;
-    repeat_goose(0, NULL);
+    /* the new state is encoded once, repeat_goose resends the cached frame */
+    if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+        Alarm(PRINT, "Publisher: Error sending message!\n");
+    }
+    queue_repeat_goose();
 }
 
-/* Send the next seqnum of the Goose publisher and double the timeout if needed*/
+/* Resend the cached goose frame with the next seqnum */
 void repeat_goose(int code, void *dummy)
 {
-    sp_time e_timeout;
-    GoosePublisher_setTimeAllowedToLive(publisher, timeout_ms);
-    if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+    if (GoosePublisher_retransmit(publisher) == -1) {
         Alarm(PRINT, "Publisher: Error sending message!\n");
     }
+    queue_repeat_goose();
+}
+
+/* Schedule the next repetition, the publisher doubles the timeout up to T0 */
+void queue_repeat_goose()
+{
+    sp_time e_timeout;
+
+    timeout_ms = GoosePublisher_getRetransmissionInterval(publisher);
     Alarm(DEBUG, "\t******Publisher: Sending repeat goose message timeout=%lu!\n",timeout_ms);
 
     e_timeout.sec = timeout_ms / 1000;
     e_timeout.usec = (timeout_ms % 1000) * 1000;
 
-    timeout_ms *= 2;
-    if (timeout_ms > T0) timeout_ms = T0;
-
     E_queue(repeat_goose, 0, NULL, e_timeout);
 }
 
@@ -115,6 +115,7 @@ static void goose_listener(GooseSubscriber subscriber, void* parameter);
 static void Init_goosepub();
 static void publish_goose(int code, int v_trip);
 static void repeat_goose(int code, void *dummy);
+static void queue_repeat_goose();
 
 static void Init_goosepub()
 {
@@ -143,6 +144,7 @@ static void Init_goosepub()
     GoosePublisher_setConfRev(publisher, 1);
     GoosePublisher_setDataSetRef(publisher, "SPCBMaster/LLN0$GOOSE1");
     GoosePublisher_setGoID(publisher,"SPCBMaster");
+    GoosePublisher_setRetransmissionTimes(publisher, BRKR_T1, BRKR_T0);
 }
 
 
@@ -161,27 +163,33 @@ void publish_goose(int code, int v_trip)
     GoosePublisher_increaseStNum(publisher);
     MmsValue_setBoolean(mms_trip, trip);
 
-
-    timeout_ms= BRKR_T1;
-    repeat_goose(0, NULL);
+    /* the new state is encoded once, repeat_goose resends the cached frame */
+    if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+        Alarm(PRINT, "Publisher: Error sending message!\n");
+    }
+    queue_repeat_goose();
 }
 
-/* Send the next seqnum of the Goose publisher and double the timeout if needed*/
+/* Resend the cached goose frame with the next seqnum */
 void repeat_goose(int code, void *dummy)
 {
-    sp_time e_timeout;
-    GoosePublisher_setTimeAllowedToLive(publisher, timeout_ms);
-    if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+    if (GoosePublisher_retransmit(publisher) == -1) {
         Alarm(PRINT, "Publisher: Error sending message!\n");
     }
+    queue_repeat_goose();
+}
+
+/* Schedule the next repetition, the publisher doubles the timeout up to BRKR_T0 */
+void queue_repeat_goose()
+{
+    sp_time e_timeout;
+
+    timeout_ms = GoosePublisher_getRetransmissionInterval(publisher);
     Alarm(DEBUG, "\t******Publisher: Sending repeat goose message timeout=%lu!\n",timeout_ms);
 
     e_timeout.sec = timeout_ms / 1000;
     e_timeout.usec = (timeout_ms % 1000) * 1000;
 
-    timeout_ms *= 2;
-    if (timeout_ms > BRKR_T0) timeout_ms = BRKR_T0;
-
     E_queue(repeat_goose, 0, NULL, e_timeout);
 }
 
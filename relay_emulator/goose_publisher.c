@@ -80,6 +80,7 @@ void cc_repeat_goose(int code, void *dummy);
 void cc_publish_goose(int code, void *v_trip);
 void repeat_goose(int code, void *dummy);
 void publish_goose(int code, void *v_trip);
+void queue_goose_repetition(void (*repeat)(int code, void *dummy));
 
 //For HMI Cmds
 static GooseReceiver goose_receiver;
@@ -152,6 +153,7 @@ int main(int argc, char** argv)
     GoosePublisher_setGoCbRef(publisher, GOOSE_CB_REF);
     GoosePublisher_setConfRev(publisher, 1);
     GoosePublisher_setDataSetRef(publisher, "simpleIOGenericIO/LLN0$AnalogValues");
+    GoosePublisher_setRetransmissionTimes(publisher, T1, T0);
     
     /* Setup Socket and timing code */
     int s = init_socket();
@@ -318,6 +320,19 @@ void handle_event(int s, int code, void *dummy)
     
 }
 
+/* Schedule the next repetition, the publisher doubles the timeout up to T0 */
+void queue_goose_repetition(void (*repeat)(int code, void *dummy))
+{
+    sp_time timeout;
+
+    timeout_ms = GoosePublisher_getRetransmissionInterval(publisher);
+
+    timeout.sec = timeout_ms / 1000;
+    timeout.usec = (timeout_ms % 1000) * 1000;
+
+    E_queue(repeat, 0, NULL, timeout);
+}
+
 /* Publish a new goose event, i.e. increase state number and change state */
 void publish_goose(int code, void *v_trip)
 {
@@ -335,27 +350,22 @@ void publish_goose(int code, void *v_trip)
     
     free(trip);    
 
-    timeout_ms = T1;
-    repeat_goose(0, NULL);
+    /* the new state is encoded once, repeat_goose resends the cached frame */
+    if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+        Alarm(PRINT, "Publisher: Error sending message!\n");
+    }
+    queue_goose_repetition(repeat_goose);
 }
 
-/* Send the next seqnum of the Goose publisher and double the timeout if needed*/
+/* Resend the cached goose frame with the next seqnum */
 void repeat_goose(int code, void *dummy)
 {
-    sp_time timeout;
-
-    if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+    if (GoosePublisher_retransmit(publisher) == -1) {
         Alarm(PRINT, "Publisher: Error sending message!\n");
     }
     Alarm(DEBUG, "Publisher: Sending repeat goose message!\n");
 
-    timeout.sec = timeout_ms / 1000;
-    timeout.usec = (timeout_ms % 1000) * 1000;
-
-    timeout_ms *= 2;
-    if (timeout_ms > T0) timeout_ms = T0;        
-
-    E_queue(repeat_goose, 0, NULL, timeout);
+    queue_goose_repetition(repeat_goose);
 }
 
 
@@ -375,27 +385,22 @@ void cc_publish_goose(int code, void *v_trip)
     
     free(trip);    
 
-    timeout_ms = T1;
-    cc_repeat_goose(0, NULL);
+    /* the new state is encoded once, cc_repeat_goose resends the cached frame */
+    if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+        Alarm(PRINT, "Publisher: Error sending message!\n");
+    }
+    queue_goose_repetition(cc_repeat_goose);
 }
 
-/* Send the next seqnum of the Goose publisher and double the timeout if needed*/
+/* Resend the cached goose frame with the next seqnum */
 void cc_repeat_goose(int code, void *dummy)
 {
-    sp_time timeout;
-
-    if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+    if (GoosePublisher_retransmit(publisher) == -1) {
         Alarm(PRINT, "Publisher: Error sending message!\n");
     }
     Alarm(DEBUG, "Publisher: Sending repeat goose message!\n");
 
-    timeout.sec = timeout_ms / 1000;
-    timeout.usec = (timeout_ms % 1000) * 1000;
-
-    timeout_ms *= 2;
-    if (timeout_ms > T0) timeout_ms = T0;        
-
-    E_queue(cc_repeat_goose, 0, NULL, timeout);
+    queue_goose_repetition(cc_repeat_goose);
 }
 
 
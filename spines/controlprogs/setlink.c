@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h> 
+#include <sys/un.h>
 #include <netdb.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
@@ -54,9 +55,11 @@ int main(int argc, char *argv[])
 {
     int port, sk, ret;
     float loss_rate, burst_rate;
-    int bandwidth, latency;
+    int bandwidth, latency, jitter;
     int i1, i2, i3, i4;
-    struct sockaddr_in daemon, *daemon_ptr = NULL;
+    struct sockaddr_in daemon;
+    struct sockaddr_un unix_addr;
+    struct sockaddr *daemon_ptr = NULL;
     int local_interf_id, remote_interf_id;
 
     port = DEFAULT_SPINES_PORT;   /* 8100 */
@@ -67,7 +70,9 @@ int main(int argc, char *argv[])
     }
     
     sscanf(argv[1], "%d", &bandwidth);
-    sscanf(argv[2], "%d", &latency);
+    /* latency may be given as "delay:jitter" */
+    jitter = 0;
+    sscanf(argv[2], "%d:%d", &latency, &jitter);
     sscanf(argv[3], "%f", &loss_rate);
     sscanf(argv[4], "%f", &burst_rate);
 
@@ -77,9 +82,16 @@ int main(int argc, char *argv[])
     sscanf(argv[6], "%d.%d.%d.%d", &i1, &i2, &i3, &i4);
     local_interf_id = ((i1 << 24 ) | (i2 << 16) | (i3 << 8) | i4);
 
-    if (argc > 7) {
+    if (argc > 7 && argv[7][0] == '/') {
+      /* unix domain socket path of the daemon, as given to its -ud option */
+      memset(&unix_addr, 0, sizeof(unix_addr));
+      unix_addr.sun_family = AF_UNIX;
+      strncpy(unix_addr.sun_path, argv[7], sizeof(unix_addr.sun_path) - 1);
+      daemon_ptr = (struct sockaddr*) &unix_addr;
+    }
+    else if (argc > 7) {
       memset(&daemon, 0, sizeof(daemon));
-      daemon_ptr = &daemon;
+      daemon_ptr = (struct sockaddr*) &daemon;
 
       sscanf(argv[7], "%d.%d.%d.%d", &i1, &i2, &i3, &i4);
       daemon.sin_family = AF_INET;
@@ -88,12 +100,12 @@ int main(int argc, char *argv[])
       daemon.sin_port = htons(DEFAULT_SPINES_PORT);
     }
 
-    if (argc > 8) {
+    if (argc > 8 && daemon_ptr == (struct sockaddr*) &daemon) {
       sscanf(argv[8], "%d", &port);
       daemon.sin_port = htons(port);
     }
 
-    spines_init((struct sockaddr*) daemon_ptr);
+    spines_init(daemon_ptr);
 
     sk = spines_socket(PF_SPINES, SOCK_STREAM, 0, NULL);
     if (sk < 0) {
@@ -101,7 +113,7 @@ int main(int argc, char *argv[])
 	exit(1);
     }
 
-    ret = spines_setlink(sk, remote_interf_id, local_interf_id, bandwidth*1000, latency, loss_rate, burst_rate);
+    ret = spines_setlink_jitter(sk, remote_interf_id, local_interf_id, bandwidth*1000, latency, jitter, loss_rate, burst_rate);
     if( ret < 0 ) {
 	printf("setlink error\n");
 	exit(1);
@@ -113,6 +125,6 @@ int main(int argc, char *argv[])
 }
 
 void print_usage(void) {
-  printf("Usage:\tsetlink bandwidth (kbps) latency (ms) loss_rate (%%) burst_rate (%%) remote_interf_id (src) local_interf_id (dst) [daemon_ip [daemon_port]]\n\n");
+  printf("Usage:\tsetlink bandwidth (kbps) latency (ms)[:jitter (ms)] loss_rate (%%) burst_rate (%%) remote_interf_id (src) local_interf_id (dst) [daemon_ip [daemon_port] | daemon_unix_path]\n\n");
 }
 
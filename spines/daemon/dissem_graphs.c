@@ -42,6 +42,7 @@
 #include "stdutil/stdhash.h"
 #include "spu_alarm.h"
 #include "configuration.h"
+#include "hello.h"
 
 #define ext_dg
 #include "dissem_graphs.h"
@@ -98,7 +99,14 @@ typedef struct SD_Edge {
 /* Variables for maintaining state about source/destination problems for my
  * flows */
 static DG_Src  DG_Source;
-static stdskl  DG_Problem_List;
+
+/* Runtime state is kept in bitmasks indexed by edge index (the same layout
+ * as the dissemination bitmasks), so checking a graph against the current
+ * problems is a few word-wide ANDs */
+static unsigned char *DG_Problem_Mask;                  /* Edges currently marked as problematic */
+static unsigned char *DG_Src_Edge_Mask[MAX_NODES + 1];  /* Edges leaving each node */
+static unsigned char *DG_Dst_Edge_Mask[MAX_NODES + 1];  /* Edges entering each node */
+static DG_Edge_Users *DG_Users;                         /* Per edge index: destinations whose graphs use it */
 
 /* Basic graph construction functions */
 static void Graph_Init(Graph *g);
@@ -109,6 +117,9 @@ static int Edge_Ptr_Cmp(const void *l, const void *r);
 static int Node_Cmp(const void *l, const void *r);
 static int DG_Edge_Cmp(const void *l, const void *r);
 static int DG_Edge_In_Graph(int16u edge_index, unsigned char *graph_mask);
+static int DG_Problem_On_Graph(unsigned char *graph_mask, Edge_Key edge_key, int type);
+static void DG_Build_Edge_Users(void);
+static void DG_Apply_Edge_Update(Edge *edge, int16 new_cost);
 
 /* Shortest path functions */
 static double Shortest_Path(Graph *g, Node_ID src, Node_ID dst);
@@ -1359,6 +1370,7 @@ void DG_Compute_Graphs(void)
     unsigned char *zero_mask;
     Graph base_graph;
     Graph *dst_graph, *src_graph;
+    stdskl k2_edges;
     sp_time start, stop;
     long duration = 0;
     int num_paths;
@@ -1373,8 +1385,6 @@ void DG_Compute_Graphs(void)
         for (j = 0; j <= DG_NUM_GRAPHS; j++)
         {
             DG_Destinations[i].bitmasks[j] = NULL;
-            stdskl_construct(&DG_Destinations[i].edge_lists[j],
-                sizeof(Edge_Key), sizeof(index), DG_Edge_Cmp);
         }
         for (j = 0; j <= MAX_NODES; j++)
         {
@@ -1383,9 +1393,37 @@ void DG_Compute_Graphs(void)
         DG_Destinations[i].problem_count = 0;
 
         DG_Source.problems[i] = 0;
+
+        DG_Src_Edge_Mask[i] = new(MP_BITMASK);
+        DG_Dst_Edge_Mask[i] = new(MP_BITMASK);
+        if (DG_Src_Edge_Mask[i] == NULL || DG_Dst_Edge_Mask[i] == NULL)
+            Alarm(EXIT, "DG_Compute_Graphs: could not allocate edge masks\n");
+        memset(DG_Src_Edge_Mask[i], 0x00, MultiPath_Bitmask_Size);
+        memset(DG_Dst_Edge_Mask[i], 0x00, MultiPath_Bitmask_Size);
     }
     DG_Source.problem_count = 0;
-    stdskl_construct(&DG_Problem_List, sizeof(Edge_Key), sizeof(index), DG_Edge_Cmp);
+
+    if ((DG_Problem_Mask = new(MP_BITMASK)) == NULL)
+        Alarm(EXIT, "DG_Compute_Graphs: could not allocate problem mask\n");
+    memset(DG_Problem_Mask, 0x00, MultiPath_Bitmask_Size);
+
+    if ((DG_Users = calloc(MultiPath_Bitmask_Size * 8, sizeof(DG_Edge_Users))) == NULL)
+        Alarm(EXIT, "DG_Compute_Graphs: could not allocate edge users\n");
+
+    DG_Update_Timing.count = 0;
+    DG_Update_Timing.total_usec = 0;
+    DG_Update_Timing.max_usec = 0;
+    DG_Update_Timing.slow_count = 0;
+
+    /* Edges leaving and entering each node, used to ignore source or
+     * destination problems when checking a graph for problems */
+    for (stdskl_begin(&Sorted_Edges, &it); !stdskl_is_end(&Sorted_Edges, &it); stdit_next(&it))
+    {
+        key = *(Edge_Key *)stdskl_it_key(&it);
+        val = *(Edge_Value *)stdskl_it_val(&it);
+        *(DG_Src_Edge_Mask[key.src_id] + (val.index / 8)) |= 0x80 >> (val.index % 8);
+        *(DG_Dst_Edge_Mask[key.dst_id] + (val.index / 8)) |= 0x80 >> (val.index % 8);
+    }
 
     if (!Directed_Edges) {
         Alarm(PRINT, "WARNING: Dissemination graphs do not work with undirected "
@@ -1423,14 +1461,14 @@ void DG_Compute_Graphs(void)
         /* Fill in edge list for static 2 paths based on computed bitmask
          * (needs to happen before we calculate source/destination graph, since
          * we'll use this to add 2 disjoint paths to that graph if needed */
+        stdskl_construct(&k2_edges, sizeof(Edge_Key), sizeof(index), DG_Edge_Cmp);
         for (stdskl_begin(&Sorted_Edges, &eit); !stdskl_is_end(&Sorted_Edges, &eit); stdskl_it_next(&eit))
         {
             key = *(Edge_Key*)stdskl_it_key(&eit);
             val = *(Edge_Value*)stdskl_it_val(&eit);
 
             if (DG_Edge_In_Graph(val.index, DG_Destinations[dest_id].bitmasks[DG_K2_GRAPH])) {
-                stdskl_insert(&DG_Destinations[dest_id].edge_lists[DG_K2_GRAPH],
-                              &lit, &key, &val.index, STDFALSE);
+                stdskl_insert(&k2_edges, &lit, &key, &val.index, STDFALSE);
             }
         }
 
@@ -1443,8 +1481,8 @@ void DG_Compute_Graphs(void)
 
         DG_Destinations[dest_id].bitmasks[DG_SRC_DST_GRAPH] =
                     Source_Destination_Problem_Bitmask_from_SDP_Graphs(My_ID, dest_id,
-                    DG_LATENCY_REQ, src_graph, dst_graph, num_paths,
-                    &DG_Destinations[dest_id].edge_lists[DG_K2_GRAPH]);
+                    DG_LATENCY_REQ, src_graph, dst_graph, num_paths, &k2_edges);
+        stdskl_destruct(&k2_edges);
 
         if (src_graph != NULL) {
             Graph_Finish(src_graph);
@@ -1471,23 +1509,6 @@ void DG_Compute_Graphs(void)
             }
         }
 
-        /* Fill in edge lists based on computed bitmasks */
-        for (stdskl_begin(&Sorted_Edges, &eit); !stdskl_is_end(&Sorted_Edges, &eit); stdskl_it_next(&eit))
-        {
-            key = *(Edge_Key*)stdskl_it_key(&eit);
-            val = *(Edge_Value*)stdskl_it_val(&eit);
-
-            for (j = 1; j <= DG_NUM_GRAPHS; j++)
-            {
-                /* Skip DG_K2_GRAPH, since we calculate that above */
-                if (j == DG_K2_GRAPH) continue;
-
-                if (DG_Edge_In_Graph(val.index, DG_Destinations[dest_id].bitmasks[j])) {
-                    stdskl_insert(&DG_Destinations[dest_id].edge_lists[j], &lit, &key, &val.index, STDFALSE);
-                }
-            }
-        }
-
         stop = E_get_time();
         duration += (stop.sec - start.sec) * 1000000;
         duration += stop.usec - start.usec;
@@ -1496,18 +1517,19 @@ void DG_Compute_Graphs(void)
         for (j = 1; j <= DG_NUM_GRAPHS; j++)
         {
             Alarm(PRINT, "Printing graph %d\n", j);
-            for (stdskl_begin(&DG_Destinations[dest_id].edge_lists[j], &eit);
-                 !stdskl_is_end(&DG_Destinations[dest_id].edge_lists[j], &eit);
-                 stdskl_it_next(&eit))
+            for (stdskl_begin(&Sorted_Edges, &eit); !stdskl_is_end(&Sorted_Edges, &eit); stdskl_it_next(&eit))
             {
                 key = *(Edge_Key*)stdskl_it_key(&eit);
-                index = *(int16u*)stdskl_it_val(&eit);
+                index = ((Edge_Value*)stdskl_it_val(&eit))->index;
 
-                Alarm(PRINT, "\t[%2d, %2d] (%02d)\n", key.src_id, key.dst_id, index);
+                if (DG_Edge_In_Graph(index, DG_Destinations[dest_id].bitmasks[j]))
+                    Alarm(PRINT, "\t[%2d, %2d] (%02d)\n", key.src_id, key.dst_id, index);
             }
         }
     }
 
+    DG_Build_Edge_Users();
+
     /* Clean up */
     Graph_Finish(&base_graph);
     dispose(zero_mask);
@@ -1515,64 +1537,87 @@ void DG_Compute_Graphs(void)
     Alarm(PRINT, "Dissemination graphs computation took %ld usec\n", duration);
 }
 
-int DG_Edge_In_Graph(int16u edge_index, unsigned char *graph_mask)
+/* Builds the per-edge lists of destinations whose graphs contain each edge,
+ * once all graphs have been computed */
+static void DG_Build_Edge_Users(void)
 {
-    unsigned char *edge_mask;
-    int64u *tmp_mask, *edge_mask_ptr;
-    int64u temp, j;
+    int i, j, e;
+    DG_Edge_Users *u;
 
-    edge_mask = new(MP_BITMASK);
-    memset(edge_mask, 0x00, MultiPath_Bitmask_Size);
-    *(edge_mask + (edge_index / 8)) = 0x80 >> (edge_index % 8);
+    for (e = 0; e < MultiPath_Bitmask_Size * 8; e++)
+    {
+        u = &DG_Users[e];
+        for (j = 1; j <= DG_NUM_GRAPHS; j++)
+        {
+            for (i = 1; i <= MAX_NODES; i++)
+            {
+                if (DG_Destinations[i].current_graph_type != DG_NONE_GRAPH &&
+                    DG_Edge_In_Graph(e, DG_Destinations[i].bitmasks[j]))
+                {
+                    u->count[j]++;
+                }
+            }
+            if (u->count[j] == 0)
+                continue;
 
-    tmp_mask      = (int64u*) graph_mask;
-    edge_mask_ptr = (int64u*) edge_mask;
-    temp          = 0;
-    for (j = 0; j < MultiPath_Bitmask_Size/sizeof(int64u); j++)
-        temp = temp | (*(tmp_mask+j) & *(edge_mask_ptr+j));
+            if ((u->dests[j] = malloc(sizeof(int16u) * u->count[j])) == NULL)
+                Alarm(EXIT, "DG_Build_Edge_Users: could not allocate user list\n");
 
-    dispose(edge_mask);
+            u->count[j] = 0;
+            for (i = 1; i <= MAX_NODES; i++)
+            {
+                if (DG_Destinations[i].current_graph_type != DG_NONE_GRAPH &&
+                    DG_Edge_In_Graph(e, DG_Destinations[i].bitmasks[j]))
+                {
+                    u->dests[j][u->count[j]++] = i;
+                }
+            }
+        }
+    }
+}
 
-    if (temp)
+static int DG_Edge_In_Graph(int16u edge_index, unsigned char *graph_mask)
+{
+    if (*(graph_mask + (edge_index / 8)) & (0x80 >> (edge_index % 8)))
         return 1;
     else
         return 0;
 }
 
-int DG_Problem_On_Graph(stdskl *edge_list, Edge_Key edge_key, int type)
+static int DG_Problem_On_Graph(unsigned char *graph_mask, Edge_Key edge_key, int type)
 {
-    stdit it, prob_it;
-    Edge_Key *tmp_key;
-
-    /* Iterate over edges in this graph and check to see if any are currently
-     * in the list of problematic edges (note that we ignore destination
-     * problems when checking a destination-problem graph and ignore source
-     * problems when checking a source-problem graph */
-    for (stdskl_begin(edge_list, &it); !stdskl_is_end(edge_list, &it); stdskl_it_next(&it))
-    {
-        tmp_key = (Edge_Key *) stdit_key(&it);
-        if ((type == DG_SRC_GRAPH && tmp_key->src_id == edge_key.src_id) ||
-            (type == DG_DST_GRAPH && tmp_key->dst_id == edge_key.dst_id))
-        {
-            continue;
-        }
-            
-        stdskl_find(&DG_Problem_List, &prob_it, tmp_key);
-        if (!stdskl_is_end(&DG_Problem_List, &prob_it)) {
-            return 1;
-        }
+    int64u *graph_ptr = (int64u *) graph_mask;
+    int64u *prob_ptr = (int64u *) DG_Problem_Mask;
+    int64u *ignore_ptr = NULL;
+    int64u temp = 0;
+    int16u j;
+
+    /* Check whether any edge in this graph is currently marked as
+     * problematic (note that we ignore destination problems when checking a
+     * destination-problem graph and ignore source problems when checking a
+     * source-problem graph */
+    if (type == DG_SRC_GRAPH)
+        ignore_ptr = (int64u *) DG_Src_Edge_Mask[edge_key.src_id];
+    else if (type == DG_DST_GRAPH)
+        ignore_ptr = (int64u *) DG_Dst_Edge_Mask[edge_key.dst_id];
+
+    for (j = 0; j < MultiPath_Bitmask_Size/sizeof(int64u); j++) {
+        if (ignore_ptr != NULL)
+            temp = temp | (*(graph_ptr+j) & *(prob_ptr+j) & ~*(ignore_ptr+j));
+        else
+            temp = temp | (*(graph_ptr+j) & *(prob_ptr+j));
     }
 
-    return 0;
+    if (temp)
+        return 1;
+    else
+        return 0;
 }
 
 void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
 {
-    DG_Dst *dg_dst, *tmp_dst;
-    Edge_Key edge_key, tmp_edge_key;
-    stdit it;
-    int16u edge_index;
-    int i;
+    sp_time start, stop;
+    long usec;
 
     /* Dissemination graph-based routing only works with problem-type routing
      * (as it requires identifying problems at the source and/or destination of
@@ -1587,6 +1632,40 @@ void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
         return;
     }
 
+    start = E_get_time();
+    DG_Apply_Edge_Update(edge, new_cost);
+    stop = E_get_time();
+
+    /* Graph switching has to finish well within a hello interval for
+     * problem-type routing to react to the problem that triggered it */
+    usec = (stop.sec - start.sec) * 1000000 + (stop.usec - start.usec);
+    DG_Update_Timing.count++;
+    DG_Update_Timing.total_usec += usec;
+    if (usec > DG_Update_Timing.max_usec)
+        DG_Update_Timing.max_usec = usec;
+    if (usec > hello_timeout.sec * 1000000 + hello_timeout.usec) {
+        DG_Update_Timing.slow_count++;
+        Alarm(PRINT, "DG_Process_Edge_Update: WARNING: update took %ld usec, "
+                     "longer than the hello interval\n", usec);
+    }
+
+    Alarm(PRINT, "DG_Process_Edge_Update: update took %ld usec (avg %ld, max %ld, "
+                 "%ld slow of %ld)\n", usec,
+                 DG_Update_Timing.total_usec / DG_Update_Timing.count,
+                 DG_Update_Timing.max_usec, DG_Update_Timing.slow_count,
+                 DG_Update_Timing.count);
+}
+
+/* Updates problem counts and switches the graph type used for each affected
+ * destination for an edge whose problem status changed */
+static void DG_Apply_Edge_Update(Edge *edge, int16 new_cost)
+{
+    DG_Dst *dg_dst, *tmp_dst;
+    Edge_Key edge_key, tmp_edge_key;
+    stdit it;
+    int16u edge_index;
+    int i, j, t;
+
     /* Get src and dst indexes */
     stdhash_find(&Node_Lookup_Addr_to_ID, &it, &edge->dst_id);
     if (stdhash_is_end(&Node_Lookup_Addr_to_ID,  &it)) {
@@ -1611,29 +1690,31 @@ void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
     /* Update problem counts and graphs based on this update */
     if (new_cost < 0) { /* PROBLEM STARTED */
         /* If we already knew about this problem, nothing more to do */
-        stdskl_lowerb(&DG_Problem_List, &it, &edge_key);
-        if (!stdskl_is_end(&DG_Problem_List, &it) && DG_Edge_Cmp(&edge_key, (Edge_Key *)stdit_key(&it)) == 0)
+        if (DG_Edge_In_Graph(edge_index, DG_Problem_Mask))
             return;
 
         /* Otherwise, a problem just started on this edge, add to problem list */
-        stdskl_insert(&DG_Problem_List, &it, &edge_key, &edge_index, STDTRUE);
+        *(DG_Problem_Mask + (edge_index / 8)) |= 0x80 >> (edge_index % 8);
 
         /* Check whether we need to switch any destinations currently using a
          * source or destination graph to the more robust source-destination graph
-         * due to a new problem on this edge */
-        for (i = 1; i <= MAX_NODES; i++)
+         * due to a new problem on this edge. Only destinations whose source or
+         * destination graph contains the edge can be affected */
+        for (t = DG_SRC_GRAPH; t <= DG_DST_GRAPH; t++)
         {
-            tmp_dst = &DG_Destinations[i];
-            if (tmp_dst->current_graph_type == DG_NONE_GRAPH) continue;
-
-            /* Check whether newly problematic edge is on the current graph for
-             * this destination: if we are currently using source graph, ignore
-             * additional source issues; if we are currently using dest graph,
-             * ignore additional dest issues */
-            if ((tmp_dst->current_graph_type == DG_SRC_GRAPH && edge_key.src_id != My_ID) ||
-                (tmp_dst->current_graph_type == DG_DST_GRAPH && edge_key.dst_id != i))
+            for (j = 0; j < DG_Users[edge_index].count[t]; j++)
             {
-                if (DG_Edge_In_Graph(edge_index, tmp_dst->bitmasks[tmp_dst->current_graph_type])) {
+                i = DG_Users[edge_index].dests[t][j];
+                tmp_dst = &DG_Destinations[i];
+                if (tmp_dst->current_graph_type != t) continue;
+
+                /* Newly problematic edge is on the current graph for this
+                 * destination: if we are currently using source graph, ignore
+                 * additional source issues; if we are currently using dest
+                 * graph, ignore additional dest issues */
+                if ((t == DG_SRC_GRAPH && edge_key.src_id != My_ID) ||
+                    (t == DG_DST_GRAPH && edge_key.dst_id != i))
+                {
                     Alarm(PRINT, "DG_Process_Edge_Update: switching dest %d to source-dest graph from %d\n", i, tmp_dst->current_graph_type);
                     tmp_dst->current_graph_type = DG_SRC_DST_GRAPH;
                 }
@@ -1667,7 +1748,7 @@ void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
                 } else if (dg_dst->current_graph_type == DG_K2_GRAPH) {
                     /* We were using kpaths: Check for existing problems on
                      * the dst graph before switching to it */
-                    if (DG_Problem_On_Graph(&dg_dst->edge_lists[DG_DST_GRAPH], edge_key, DG_DST_GRAPH)) {
+                    if (DG_Problem_On_Graph(dg_dst->bitmasks[DG_DST_GRAPH], edge_key, DG_DST_GRAPH)) {
                         dg_dst->current_graph_type = DG_SRC_DST_GRAPH;
                         Alarm(PRINT, "Now using src-dst mask (from other)\n");
                     } else {
@@ -1707,7 +1788,7 @@ void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
                     } else if (tmp_dst->current_graph_type == DG_K2_GRAPH) {
                         /* We were using kpaths: Check for existing problems on
                          * the source graph before switching to it */
-                        if (DG_Problem_On_Graph(&tmp_dst->edge_lists[DG_SRC_GRAPH], edge_key, DG_SRC_GRAPH)) {
+                        if (DG_Problem_On_Graph(tmp_dst->bitmasks[DG_SRC_GRAPH], edge_key, DG_SRC_GRAPH)) {
                             tmp_dst->current_graph_type = DG_SRC_DST_GRAPH;
                             Alarm(PRINT, "Now using src-dst mask for %d (from other)\n", i);
                         } else {
@@ -1720,12 +1801,12 @@ void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
         }
     } else { /* PROBLEM RESOLVED */
         /* If we don't have a problem currently marked on this edge, nothing to do */
-        if (stdskl_is_end(&DG_Problem_List, stdskl_find(&DG_Problem_List, &it, &edge_key)))
+        if (!DG_Edge_In_Graph(edge_index, DG_Problem_Mask))
             return;
 
         /* Otherwise, a problem just ended on this edge, remove from  problem
          * list */
-        stdskl_erase(&DG_Problem_List, &it);
+        *(DG_Problem_Mask + (edge_index / 8)) &= ~(0x80 >> (edge_index % 8));
 
         /* RESOLVED DESTINATION PROBLEM */
         if (dg_dst->current_graph_type != DG_NONE_GRAPH && dg_dst->problems[edge_key.src_id] == 1) {
@@ -1750,7 +1831,7 @@ void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
                                      "edge (%u, %u) %d %d (from src-dst to k2)\n", edge_key.src_id,
                                      edge_key.dst_id, edge->cost, new_cost);
                         dg_dst->current_graph_type = DG_K2_GRAPH;
-                    } else if (!DG_Problem_On_Graph(&dg_dst->edge_lists[DG_SRC_GRAPH], tmp_edge_key, DG_SRC_GRAPH)) {
+                    } else if (!DG_Problem_On_Graph(dg_dst->bitmasks[DG_SRC_GRAPH], tmp_edge_key, DG_SRC_GRAPH)) {
                         Alarm(PRINT, "DG_Process_Edge_Update: RESOLVED destination problem on "
                                      "edge (%u, %u) %d %d (from src-dst to src)\n", edge_key.src_id,
                                      edge_key.dst_id, edge->cost, new_cost);
@@ -1797,7 +1878,7 @@ void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
                                          "edge (%u, %u) %d %d for %d (from src-dst to k2)\n", edge_key.src_id,
                                          edge_key.dst_id, edge->cost, new_cost, i);
                             tmp_dst->current_graph_type = DG_K2_GRAPH;
-                        } else if (!DG_Problem_On_Graph(&tmp_dst->edge_lists[DG_DST_GRAPH], tmp_edge_key, DG_DST_GRAPH)) {
+                        } else if (!DG_Problem_On_Graph(tmp_dst->bitmasks[DG_DST_GRAPH], tmp_edge_key, DG_DST_GRAPH)) {
                             Alarm(PRINT, "DG_Process_Edge_Update: RESOLVED source problem on "
                                          "edge (%u, %u) %d %d for %d (from src-dst to dst)\n", edge_key.src_id,
                                          edge_key.dst_id, edge->cost, new_cost, i);
@@ -1834,14 +1915,14 @@ void DG_Process_Edge_Update(Edge *edge, int16 new_cost)
                 tmp_edge_key.dst_id = i;
 
                 if (DG_Source.problem_count < DG_PROB_COUNT_THRESH) {
-                    if (!DG_Problem_On_Graph(&tmp_dst->edge_lists[DG_DST_GRAPH], tmp_edge_key, DG_DST_GRAPH)) {
+                    if (!DG_Problem_On_Graph(tmp_dst->bitmasks[DG_DST_GRAPH], tmp_edge_key, DG_DST_GRAPH)) {
                         Alarm(PRINT, "DG_Process_Edge_Update: RESOLVED mid-net problem on "
                                      "edge (%u, %u) %d %d (from src-dst to dst) for %d\n", edge_key.src_id,
                                      edge_key.dst_id, edge->cost, new_cost, i);
                         tmp_dst->current_graph_type = DG_DST_GRAPH;
                     }
                 } else if (tmp_dst->problem_count < DG_PROB_COUNT_THRESH) {
-                    if (!DG_Problem_On_Graph(&tmp_dst->edge_lists[DG_SRC_GRAPH], tmp_edge_key, DG_SRC_GRAPH)) {
+                    if (!DG_Problem_On_Graph(tmp_dst->bitmasks[DG_SRC_GRAPH], tmp_edge_key, DG_SRC_GRAPH)) {
                         Alarm(PRINT, "DG_Process_Edge_Update: RESOLVED mid-net problem on "
                                      "edge (%u, %u) %d %d (from src-dst to src) for %d\n", edge_key.src_id,
                                      edge_key.dst_id, edge->cost, new_cost, i);
@@ -62,7 +62,6 @@
  * problems for my flows */
 typedef struct DG_Dst_d {
     unsigned char *bitmasks[DG_NUM_GRAPHS+1];   /* Includes 2-path, src-problem, dst-problem, and src-dst-problem bitmasks */
-    stdskl         edge_lists[DG_NUM_GRAPHS+1]; /* Contains edge keys and indexes corresponding to the bitmasks */
     int            current_graph_type;          /* Which graph are we currently using for this dest? (2path, src, dst, src-dst */
     int            problem_count;               /* How many edge problems do we know about for this destination? */
     int            problems[MAX_NODES + 1];     /* Which neighbors are currently problematic for this dst? */
@@ -73,6 +72,21 @@ typedef struct DG_Src_d {
     int problems[MAX_NODES + 1];                /* Which neighbors am I currently having problems with? */
 } DG_Src;
 
+/* Destinations whose precomputed graph of each type contains a given edge,
+ * so that an edge update only visits the flows it can affect */
+typedef struct DG_Edge_Users_d {
+    int16u  count[DG_NUM_GRAPHS+1];
+    int16u *dests[DG_NUM_GRAPHS+1];
+} DG_Edge_Users;
+
+/* Timing of edge update processing for problem-type routing */
+typedef struct DG_Update_Stats_d {
+    long    count;                              /* Status changes processed */
+    long    total_usec;
+    long    max_usec;
+    long    slow_count;                         /* Updates that took longer than a hello interval */
+} DG_Update_Stats;
+
 #undef ext
 #ifndef ext_dg
 #define ext extern
@@ -80,7 +94,8 @@ typedef struct DG_Src_d {
 #define ext
 #endif
 
-ext DG_Dst  DG_Destinations[MAX_NODES+1];
+ext DG_Dst          DG_Destinations[MAX_NODES+1];
+ext DG_Update_Stats DG_Update_Timing;
 
 void DG_Compute_Graphs(void);
 void DG_Process_Edge_Update(Edge *edge, int16 new_cost);
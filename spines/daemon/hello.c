@@ -97,6 +97,8 @@ static       sp_time cnt_timeout    = {     0,    100000};
  * for reconnection since we aren't actively using the wireless capabilities */
 static       sp_time ad_timeout     = {     1,    0};
 /* static       sp_time ad_timeout     = {     6,    0}; */
+static const sp_time hello_stats_timeout = { HELLO_STATS_SEC, 0};
+static       sp_time hello_stats_start;
 
 int          hello_cnt_start        = (int) (0.5 + 0.7 * DEAD_LINK_CNT); 
 int          stable_delay_flag      = 1;
@@ -111,6 +113,14 @@ void Flip_hello_pkt( hello_packet *hello_pkt )
     hello_pkt->response_seq_no = Flip_int32(hello_pkt->response_seq_no);
     hello_pkt->diff_time       = Flip_int32(hello_pkt->diff_time);
     hello_pkt->loss_rate       = Flip_int32(hello_pkt->loss_rate);
+    hello_pkt->hello_usec      = Flip_int32(hello_pkt->hello_usec);
+}
+
+/* hello_usec is only sent with fast failure detection (-fd), so daemons
+ * without it keep exchanging hellos of the original size */
+static int Hello_Packet_Len(void)
+{
+    return (Fast_Detect ? sizeof(hello_packet) : sizeof(hello_packet) - sizeof(int32u));
 }
 
 /***********************************************************/
@@ -149,6 +159,127 @@ void Init_Connections(void)
   if (stable_delay_flag) {
     stable_timeout = 2.0 * DEAD_LINK_CNT * (hello_timeout.sec + hello_timeout.usec / 1000000.0);
   } 
+
+  if (Fast_Detect) {
+    hello_stats_start = E_get_time();
+    E_queue(Print_Hello_Statistics, 0, NULL, hello_stats_timeout);
+  }
+}
+
+/***********************************************************
+ * Fast failure detection helpers.
+ ***********************************************************/
+
+static int32 Usec_Since(sp_time now, sp_time then)
+{
+  sp_time diff;
+
+  if (E_compare_time(now, then) <= 0) {
+    return 0;
+  }
+  diff = E_sub_time(now, then);
+  if (diff.sec > 1000) {
+    return 1000 * 1000000;
+  }
+  return diff.sec * 1000000 + diff.usec;
+}
+
+/* Hello interval for this link: a round trip plus jitter, so that probing
+ * is never faster than the leg can answer, within [FAST_HELLO_MIN_USEC,
+ * hello_timeout]. Moves at most by a factor of 2 per hello. */
+static int32 Fast_Hello_Interval(Control_Data *c_data)
+{
+  int32 max_usec = hello_timeout.sec * 1000000 + hello_timeout.usec;
+  int32 target;
+
+  if (c_data->srtt_usec == 0) {      /* no rtt sample yet */
+    return max_usec;
+  }
+
+  target = c_data->srtt_usec + 4 * c_data->rttvar_usec;
+
+  if (target > 2 * c_data->hello_usec) {
+    target = 2 * c_data->hello_usec;
+  } else if (target < c_data->hello_usec / 2) {
+    target = c_data->hello_usec / 2;
+  }
+
+  if (target < FAST_HELLO_MIN_USEC) {
+    target = FAST_HELLO_MIN_USEC;
+  } else if (target > max_usec) {
+    target = max_usec;
+  }
+  return target;
+}
+
+/* Silence after which the leg is declared dead: FAST_DEAD_LINK_CNT of the
+ * other side's hello intervals, plus the jitter of this leg */
+static int32 Fast_Detect_Usec(Control_Data *c_data)
+{
+  return FAST_DEAD_LINK_CNT * c_data->remote_hello_usec + 4 * c_data->rttvar_usec;
+}
+
+/***********************************************************
+ * Called on every packet received on a leg with fast
+ * failure detection: the other side is alive.
+ ***********************************************************/
+
+void Hello_Recv_Liveness(Network_Leg *leg)
+{
+  leg->last_recv_any = E_get_time();
+  leg->hellos_out    = 0;
+}
+
+/***********************************************************
+ * Fast failure detection version of Send_Hello, used on
+ * connected legs once the other side advertised its
+ * interval. The link is declared dead when nothing was
+ * received for the detection time. The hello is skipped
+ * while we are sending data on the leg, except that one is
+ * sent at least every hello_timeout to keep rtt and loss
+ * measurements going.
+ ***********************************************************/
+
+static void Send_Fast_Hello(Link *lk)
+{
+  Network_Leg  *leg    = lk->leg;
+  Control_Data *c_data = (Control_Data*) lk->prot_data;
+  sp_time       now    = E_get_time();
+  sp_time       next;
+  int32         silence, detect, interval;
+
+  silence = Usec_Since(now, leg->last_recv_any);
+  detect  = Fast_Detect_Usec(c_data);
+
+  if (silence >= detect) {
+    Alarm(PRINT, "Dead_Leg: (" IPF " -> " IPF ") nothing received for %.3f ms (detection time %.3f ms, "
+          "hello interval %d usec, remote %d usec); DISCONNECTING!\n", 
+          IP(leg->local_interf->net_addr), IP(leg->remote_interf->net_addr), silence / 1000.0, 
+          detect / 1000.0, c_data->hello_usec, c_data->remote_hello_usec);
+    Disconnect_Network_Leg(leg);
+    return;
+  }
+
+  /* a longer interval must reach the other side before we start using it */
+  interval = Fast_Hello_Interval(c_data);
+
+  if (interval <= c_data->hello_usec && !c_data->reply_pending &&
+      Usec_Since(now, leg->last_sent_any) < c_data->hello_usec &&
+      Usec_Since(now, c_data->last_hello_sent) < hello_timeout.sec * 1000000 + hello_timeout.usec) {
+    c_data->hellos_suppressed++;
+    c_data->hello_usec = interval;
+
+  } else {
+    c_data->hello_usec = interval;
+
+    /* poll for an immediate answer once the other side is late */
+    Net_Send_Hello((int16u) lk->link_id, silence > 2 * c_data->remote_hello_usec);
+    ++leg->hellos_out;
+  }
+
+  next.sec  = c_data->hello_usec / 1000000;
+  next.usec = c_data->hello_usec % 1000000;
+  E_queue(Send_Hello, lk->link_id, NULL, next);
 }
 
 /***********************************************************
@@ -199,6 +330,14 @@ void Send_Hello(int linkid, void *dummy)
     Alarm(EXIT, "Send_Hello: invalid control link!\r\n");
   }
 
+  Clean_RT_history(lk->leg->links[REALTIME_UDP_LINK]);     /* TODO: move to realtime_udp.c where it belongs */
+
+  if (Fast_Detect && lk->leg->status == CONNECTED_LEG &&
+      ((Control_Data*) lk->prot_data)->remote_hello_usec != 0) {
+    Send_Fast_Hello(lk);
+    return;
+  }
+
   if (lk->leg->hellos_out > 1) {
     dead_timeout = E_sub_time(E_get_time(), lk->leg->last_recv_hello);  /* just tmp used for following print */
 
@@ -228,7 +367,6 @@ void Send_Hello(int linkid, void *dummy)
   Net_Send_Hello((int16u) linkid, 0);
   ++lk->leg->hellos_out;
 
-  Clean_RT_history(lk->leg->links[REALTIME_UDP_LINK]);     /* TODO: move to realtime_udp.c where it belongs */
   E_queue(Send_Hello, linkid, NULL, hello_timeout);	
 }
 
@@ -377,7 +515,7 @@ void Net_Send_Hello(int16 linkid, int mode)
   scat.num_elements    = 2;
   scat.elements[0].len = sizeof(packet_header);
   scat.elements[0].buf = (char*) &hdr;
-  scat.elements[1].len = sizeof(hello_packet);
+  scat.elements[1].len = Hello_Packet_Len();
   scat.elements[1].buf = (char*) &pkt;
 
   hdr.type             = (mode == 0 ? HELLO_TYPE : HELLO_REQ_TYPE);
@@ -385,7 +523,7 @@ void Net_Send_Hello(int16 linkid, int mode)
 
   hdr.sender_id        = My_Address;
   hdr.ctrl_link_id     = link->leg->ctrl_link_id;
-  hdr.data_len         = sizeof(hello_packet);
+  hdr.data_len         = Hello_Packet_Len();
   hdr.ack_len          = 0;
   hdr.seq_no           = Set_Loss_SeqNo(link->leg, CONTROL_LINK);
 
@@ -395,6 +533,11 @@ void Net_Send_Hello(int16 linkid, int mode)
   pkt.response_seq_no  = c_data->other_side_hello_seq;
   pkt.diff_time        = c_data->diff_time;
   pkt.loss_rate        = Compute_Loss_Rate(link->leg);
+  pkt.hello_usec       = (Fast_Detect ? c_data->hello_usec : 0);
+
+  c_data->last_hello_sent = now;
+  c_data->reply_pending   = 0;
+  c_data->hellos_sent++;
     
   if(network_flag == 1) {
     ret = Link_Send(link, &scat);
@@ -421,7 +564,7 @@ void Net_Send_Hello_Ping(channel chan, Network_Address addr)
   scat.num_elements    = 2;
   scat.elements[0].len = sizeof(packet_header);
   scat.elements[0].buf = (char*) &hdr;
-  scat.elements[1].len = sizeof(hello_packet);
+  scat.elements[1].len = Hello_Packet_Len();
   scat.elements[1].buf = (char*) &pkt;
 
   hdr.type             = HELLO_PING_TYPE;	
@@ -429,7 +572,7 @@ void Net_Send_Hello_Ping(channel chan, Network_Address addr)
 
   hdr.sender_id        = My_Address;
   hdr.ctrl_link_id     = 0;
-  hdr.data_len         = sizeof(hello_packet);
+  hdr.data_len         = Hello_Packet_Len();
   hdr.ack_len          = 0;
   hdr.seq_no           = 0;
 
@@ -437,6 +580,7 @@ void Net_Send_Hello_Ping(channel chan, Network_Address addr)
   pkt.my_time_sec      = (int32) now.sec;
   pkt.my_time_usec     = (int32) now.usec;
   pkt.diff_time        = 0;
+  pkt.hello_usec       = 0;
 
   if(network_flag == 1) {
     ret = DL_send(chan, addr, Port + CONTROL_LINK, &scat);
@@ -472,7 +616,10 @@ void Process_hello_packet(Link *lk, packet_header *pack_hdr, char *buf,
   Loss_Data     *l_data;
   int           i;
 
-  if (remaining_bytes != sizeof(hello_packet))
+  /* daemons running without fast failure detection (-fd) send hellos
+   * without hello_usec, as do older daemons */
+  if (remaining_bytes != sizeof(hello_packet) && 
+      remaining_bytes != sizeof(hello_packet) - sizeof(pkt->hello_usec))
   {
     Alarmp(SPLOG_WARNING, PRINT, "Process_hello_packet: Wrong # of bytes for "
                                  "hello: %d\n", remaining_bytes);
@@ -483,6 +630,10 @@ void Process_hello_packet(Link *lk, packet_header *pack_hdr, char *buf,
     Flip_hello_pkt(pkt);
   }
 
+  if (remaining_bytes != sizeof(hello_packet)) {
+    pkt->hello_usec = 0;
+  }
+
   /* Check if other side crashed and came back up before I disconnected it */
   if (pack_hdr->ctrl_link_id != leg->other_side_ctrl_link_id) {  /* packet's ctrl link id doesn't match what we expected */
 
@@ -558,6 +709,17 @@ void Process_hello_packet(Link *lk, packet_header *pack_hdr, char *buf,
 
     /*update_cost     = 1;*/
     lk->r_data->rtt = c_data->rtt;
+
+    /* rtt and jitter at full resolution for the fast hello interval */
+    if (c_data->srtt_usec == 0) {
+      c_data->srtt_usec   = rtt_int;
+      c_data->rttvar_usec = rtt_int / 2;
+    } else {
+      int32 err = rtt_int - c_data->srtt_usec;
+
+      c_data->srtt_usec   += err / 8;
+      c_data->rttvar_usec += ((err < 0 ? -err : err) - c_data->rttvar_usec) / 4;
+    }
   }
 
   /* update loss rate */
@@ -574,11 +736,14 @@ void Process_hello_packet(Link *lk, packet_header *pack_hdr, char *buf,
 
   lk->leg->hellos_out = 0;
   lk->leg->last_recv_hello = now;
+  lk->leg->last_recv_any = now;
+  c_data->remote_hello_usec = pkt->hello_usec;
   E_dequeue(Send_Hello_Request_Cnt, lk->link_id, NULL); 
 
   /* answer requests immediately */
 			
   if (Is_hello_req(type)) {
+    c_data->reply_pending = 1;
     E_queue(Send_Hello, lk->link_id, NULL, zero_timeout);
   }
 
@@ -755,3 +920,59 @@ void Process_hello_ping(packet_header *pack_hdr, Network_Address from_addr,
     Alarm(DEBUG, "Process_hello_ping: already have a ctrl link for sender ("IPF").\n", IP((*leg)->remote_interf->net_addr));
   }
 }
+
+/***********************************************************/
+/* Print_Hello_Statistics(int dummy_int, void *dummy)      */
+/*                                                         */
+/* Called periodically by the event system with fast       */
+/* failure detection. Prints, for each connected leg, the  */
+/* measured rtt and jitter, the hello intervals of both    */
+/* sides, the resulting detection time, and the hello      */
+/* overhead since the last report.                         */
+/*                                                         */
+/* Arguments                                               */
+/*                                                         */
+/* NONE                                                    */
+/*                                                         */
+/***********************************************************/
+
+void Print_Hello_Statistics(int dummy_int, void* dummy)
+{
+  stdit         tit;
+  sp_time       now = E_get_time();
+  double        elapsed;
+  Control_Data *c_data;
+
+  elapsed = Usec_Since(now, hello_stats_start) / 1.0e6;
+  if (elapsed <= 0) {
+    elapsed = HELLO_STATS_SEC;
+  }
+
+  for (stdhash_begin(&Network_Legs, &tit); !stdhash_is_end(&Network_Legs, &tit); stdhash_it_next(&tit)) {
+
+    Network_Leg *leg = *(Network_Leg**) stdhash_it_val(&tit);
+
+    if (leg->status != CONNECTED_LEG || leg->links[CONTROL_LINK] == NULL) {
+      continue;
+    }
+    c_data = (Control_Data*) leg->links[CONTROL_LINK]->prot_data;
+
+    Alarm(PRINT, "Hello (" IPF " -> " IPF "): rtt %.3f ms, jitter %.3f ms, interval %.3f ms, "
+          "remote %.3f ms, detection %.3f ms, %.1f hellos/s (%.0f bytes/s), %.1f%% replaced by data\n",
+          IP(leg->local_interf->net_addr), IP(leg->remote_interf->net_addr),
+          c_data->srtt_usec / 1000.0, c_data->rttvar_usec / 1000.0, c_data->hello_usec / 1000.0,
+          c_data->remote_hello_usec / 1000.0, 
+          (c_data->remote_hello_usec != 0 ? Fast_Detect_Usec(c_data) : 
+              DEAD_LINK_CNT * (hello_timeout.sec * 1000000 + hello_timeout.usec)) / 1000.0,
+          c_data->hellos_sent / elapsed, 
+          c_data->hellos_sent * (sizeof(packet_header) + Hello_Packet_Len()) / elapsed,
+          (c_data->hellos_sent + c_data->hellos_suppressed > 0 ?
+              100.0 * c_data->hellos_suppressed / (c_data->hellos_sent + c_data->hellos_suppressed) : 0));
+
+    c_data->hellos_sent       = 0;
+    c_data->hellos_suppressed = 0;
+  }
+
+  hello_stats_start = now;
+  E_queue(Print_Hello_Statistics, 0, NULL, hello_stats_timeout);
+}
@@ -44,6 +44,14 @@
 #define DEAD_LINK_CNT     10                        /* Number of hellos unacked until declaring a dead link */
 #define CONNECT_LINK_CNT  (1 + DEAD_LINK_CNT / 2)  /* Number of hellos needed b4 connection established */
 
+/* Fast failure detection (-fd): each side picks its hello interval from the
+ * measured rtt and jitter of the leg and advertises it in its hellos. A leg is
+ * dead after FAST_DEAD_LINK_CNT of the other side's intervals (plus jitter)
+ * with no packets at all from it; data packets count as hellos both ways */
+#define FAST_DEAD_LINK_CNT    3        /* Intervals of silence before declaring a dead link */
+#define FAST_HELLO_MIN_USEC   1000     /* Shortest hello interval */
+#define HELLO_STATS_SEC       15       /* Period of the per-link hello report */
+
 struct Node_d;
 struct Edge_d;
 struct Interface_d;
@@ -60,6 +68,8 @@ void Send_Hello_Ping(int dummy_int, void* dummy);
 void Send_Discovery_Hello_Ping(int dummy_int, void* dummy);
 void Net_Send_Hello(int16 linkid, int mode);
 void Net_Send_Hello_Ping(channel chan, Network_Address addr);
+void Hello_Recv_Liveness(struct Network_Leg_d *leg);
+void Print_Hello_Statistics(int dummy_int, void* dummy);
 
 void Process_hello_packet(struct Link_d *lk, packet_header *pack_hdr, char *buf, int remaining_bytes, int32u type);
 
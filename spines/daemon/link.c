@@ -245,6 +245,10 @@ int16 Create_Link(Network_Leg *leg,
     c_data->reported_loss_rate   = UNKNOWN;
     c_data->reported_ts.sec = 0;
     c_data->reported_ts.usec = 0;
+    c_data->hello_usec           = hello_timeout.sec * 1000000 + hello_timeout.usec;
+    c_data->last_hello_sent      = E_get_time();
+    leg->last_recv_any           = c_data->last_hello_sent;
+    leg->last_sent_any           = c_data->last_hello_sent;
 
     /* For determining loss_rate */
     c_data->l_data.my_seq_no = PACK_MAX_SEQ;
@@ -763,6 +767,11 @@ int Link_Send(Link *lk, sys_scatter *scat)
     return ret;
   }
 
+  /* Any packet we send tells the other side we are alive */
+  if (Fast_Detect) {
+    leg->last_sent_any = E_get_time();
+  }
+
   /* AB: added for cost accounting */
   if (Print_Cost) {
     hdr = (packet_header *)scat->elements[0].buf;
@@ -164,6 +164,7 @@ typedef struct Lk_Param_d {
     int32 bucket;
     sp_time last_time_add;
     sp_time delay;
+    sp_time jitter;  /* extra delay drawn uniformly from [0, jitter] */
 } Lk_Param;
 
 typedef struct Leg_Buf_Cell_d {
@@ -271,6 +272,16 @@ typedef struct Control_Data_d {
     int32  reported_rtt;          /* RTT last reported in a link_state (if any) */
     float  reported_loss_rate;    /* Loss rate last reported in a link_state (if any) */
     sp_time reported_ts;          /* Time at which we last sent an update for this link */
+
+    /* Fast failure detection (-fd) */
+    int32  srtt_usec;             /* Smoothed rtt, without the 1ms floor of rtt */
+    int32  rttvar_usec;           /* Mean deviation of rtt samples */
+    int32  hello_usec;            /* My current hello interval on this link */
+    int32  remote_hello_usec;     /* Other side's hello interval, 0 if fixed/unknown */
+    int    reply_pending;         /* Other side requested an immediate hello */
+    sp_time last_hello_sent;      /* Time at which I last sent a hello */
+    int64u hellos_sent;           /* Hellos sent since the last statistics report */
+    int64u hellos_suppressed;     /* Hellos replaced by data since the last report */
 } Control_Data;
 
 typedef int64u rt_seq_type;
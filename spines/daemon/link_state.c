@@ -311,13 +311,13 @@ void *Edge_Process_state_cell(Node_ID source, Node_ID sender, char *pos, int32 t
 
     DG_Process_Edge_Update(edge, edge_cell->cost);
 
+    /* Invalidate K-paths results that this change can affect */
+    MultiPath_Edge_Update(edge, edge_cell->cost);
+
     edge->age  = edge_cell->age;
     edge->cost = edge_cell->cost;
     edge->lts  = edge_cell->lts;
 
-    /* Clear the cache stored for the K-paths calculation */
-    MultiPath_Clear_Cache();
-
     return edge;
 
   } else {  /* I will publish my own edges' costs and ages thank you very much! */
@@ -39,18 +39,50 @@
 #undef ext_multipath
 
 #include <string.h>
+#include <stdlib.h>
+#include <limits.h>
 #include <float.h>
 #include "dissem_graphs.h"
 
 extern int16u *Neighbor_IDs[];
 
-unsigned char  *MP_Cache[MAX_NODES+1][MULTIPATH_MAX_K+1];
+#define MULTIPATH_EDGE_DOWN  INT_MIN    /* Flow_Edge cost for unusable edges */
+#define MULTIPATH_INF_DIST   INT_MAX    /* Flow_Node distance when unreached */
+
+/* Cached K-paths result for one (destination, k, cost mode) */
+typedef struct MP_Cache_Entry_d {
+    unsigned char *mask;    /* computed bitmask, NULL if never computed */
+    int32u         epoch;   /* topology epoch in which mask is known to be valid */
+    int16u         found;   /* number of disjoint paths actually found */
+    unsigned char  wanted;  /* looked up since it was last (re)computed */
+} MP_Cache_Entry;
+
+/* Entry of the binary min-heap used by the Dijkstra runs. Entries are never
+ * decreased in place: a node is pushed again when its distance improves and
+ * stale entries are skipped when popped */
+typedef struct MP_Heap_Entry_d {
+    int32      distance;
+    Flow_Node *node;
+} MP_Heap_Entry;
+
+static MP_Cache_Entry  MP_Cache[MAX_NODES+1][MULTIPATH_MAX_K+1][MULTIPATH_NUM_COST_MODES];
+static int32u          MP_Epoch[MULTIPATH_NUM_COST_MODES];
+static MP_Heap_Entry  *MP_Heap;
+static int32u          MP_Heap_Size;
+static int32u          MP_Heap_Cap;
+
 unsigned char  *MP_Flooding_Bitmask;
 unsigned char **MP_Neighbor_Mask;
 
+static const sp_time zero_timeout       = {0, 0};
+static const sp_time MP_Refresh_Timeout = {0, MULTIPATH_REFRESH_USEC};
+
+static void           MultiPath_Refresh_Cache(int dummy, void *dummy_p);
+static unsigned char *MultiPath_Cached_Mask(int16u dest_id, int16u k, int mode);
+
 void MultiPath_Pre_Conf_Setup()
 {
-    int i, j;
+    int i, j, m;
     Flow_Edge *fe;
 
     MultiPath_Bitmask_Size = MULTIPATH_BITMASK_SIZE_DEFAULT / 8;
@@ -60,10 +92,24 @@ void MultiPath_Pre_Conf_Setup()
         Flow_Nodes_Inbound[i]  = NULL;
         Flow_Nodes_Outbound[i] = NULL;
 
-        for (j = 0; j <= MULTIPATH_MAX_K; j++)
-            MP_Cache[i][j] = NULL;
+        for (j = 0; j <= MULTIPATH_MAX_K; j++) {
+            for (m = 0; m < MULTIPATH_NUM_COST_MODES; m++) {
+                MP_Cache[i][j][m].mask   = NULL;
+                MP_Cache[i][j][m].epoch  = 0;
+                MP_Cache[i][j][m].found  = 0;
+                MP_Cache[i][j][m].wanted = 0;
+            }
+        }
     }
 
+    /* Cache entries stamped with epoch 0 are never valid */
+    for (m = 0; m < MULTIPATH_NUM_COST_MODES; m++)
+        MP_Epoch[m] = 1;
+
+    MP_Heap = NULL;
+    MP_Heap_Size = 0;
+    MP_Heap_Cap = 0;
+
     MP_Flooding_Bitmask = NULL;
 
     fe = &Flow_Edge_Head;
@@ -315,174 +361,330 @@ void Init_MultiPath()
         stdskl_it_next(&it);
     }
 
+    /* Size the Dijkstra heap: a node is pushed at most once per successful
+     * relaxation, so one slot per flow edge (plus the source) is enough */
+    MP_Heap_Cap = 1;
+    for (real = Flow_Edge_Head.next; real != NULL; real = real->next)
+        MP_Heap_Cap++;
+    MP_Heap = Mem_alloc(sizeof(MP_Heap_Entry) * MP_Heap_Cap);
+    if (MP_Heap == NULL)
+        Alarm(EXIT, "Init_MultiPath: could not allocate memory for MP_Heap\r\n");
+
     /* Init Static Dissemination Graphs */
     DG_Compute_Graphs();
 }
 
+/* Invalidates every cached K-paths result by moving to a new topology
+ * epoch. Stale masks are kept around and reused as buffers when the entry is
+ * recomputed */
 void MultiPath_Clear_Cache()
 {
-    int i, j;
+    int m;
+
+    for (m = 0; m < MULTIPATH_NUM_COST_MODES; m++)
+        MP_Epoch[m]++;
+}
+
+/* Maps a runtime edge cost to the cost MultiPath_Compute uses for it (with
+ * require_reverse unset), or MULTIPATH_EDGE_DOWN if the edge is unusable */
+static int32 MultiPath_Effective_Cost(int16 cost)
+{
+    if (cost == -1)
+        return MULTIPATH_EDGE_DOWN;
+    return abs(cost);
+}
+
+/* Called before an edge's cost is changed from edge->cost to new_cost.
+ * Moves the current cost results to a new topology epoch, carrying forward
+ * every entry whose result provably cannot change:
+ *   - the edge is not in the mask and did not get cheaper (a min-cost
+ *     solution that avoids an edge stays optimal when that edge gets worse
+ *     or goes down)
+ * Entries that use the edge, or that might now prefer it, are left stale. If
+ * they have been looked up since they were last computed, they are
+ * recomputed in the background so the next lookup finds them ready. */
+void MultiPath_Edge_Update(Edge *edge, int16 new_cost)
+{
+    int i, j, refresh = 0;
+    int32 old_eff, new_eff;
+    int32u old_epoch;
+    MP_Cache_Entry *ce;
+
+    old_eff = MultiPath_Effective_Cost(edge->cost);
+    new_eff = MultiPath_Effective_Cost(new_cost);
+    if (old_eff == new_eff)
+        return;
+
+    old_epoch = MP_Epoch[MULTIPATH_CURRENT_COST]++;
 
     for (i = 0; i <= MAX_NODES; i++) {
         for (j = 0; j <= MULTIPATH_MAX_K; j++) {
-            if (MP_Cache[i][j] != NULL)
-                dispose(MP_Cache[i][j]);
-            MP_Cache[i][j] = NULL;
+            ce = &MP_Cache[i][j][MULTIPATH_CURRENT_COST];
+            if (ce->mask == NULL || ce->epoch != old_epoch)
+                continue;
+
+            /* Edge went down (MULTIPATH_EDGE_DOWN is the smallest value) or got
+             * more expensive, and is not used by this result */
+            if ((new_eff == MULTIPATH_EDGE_DOWN || 
+                    (old_eff != MULTIPATH_EDGE_DOWN && new_eff > old_eff)) &&
+                !(ce->mask[edge->index / 8] & (0x80 >> (edge->index % 8))))
+            {
+                ce->epoch = MP_Epoch[MULTIPATH_CURRENT_COST];
+            }
+            else if (ce->wanted) {
+                refresh = 1;
+            }
+        }
+    }
+
+    if (refresh)
+        E_queue(MultiPath_Refresh_Cache, 0, NULL, zero_timeout);
+}
+
+/* Recomputes one stale cache entry that has been looked up since it was last
+ * computed, then reschedules itself if there is more to do. Spreading the
+ * work over separate events keeps the event loop responsive after a
+ * topology change */
+static void MultiPath_Refresh_Cache(int dummy, void *dummy_p)
+{
+    int i, j, more = 0;
+    MP_Cache_Entry *ce;
+
+    for (i = 0; i <= MAX_NODES; i++) {
+        for (j = 1; j <= MULTIPATH_MAX_K; j++) {
+            ce = &MP_Cache[i][j][MULTIPATH_CURRENT_COST];
+            if (ce->mask == NULL || !ce->wanted || 
+                    ce->epoch == MP_Epoch[MULTIPATH_CURRENT_COST])
+                continue;
+
+            if (more) {
+                E_queue(MultiPath_Refresh_Cache, 0, NULL, MP_Refresh_Timeout);
+                return;
+            }
+
+            Alarm(DEBUG, "MultiPath_Refresh_Cache: refreshing [%u,%u] for k = %u\r\n",
+                    My_ID, i, j);
+            MultiPath_Cached_Mask(i, j, MULTIPATH_CURRENT_COST);
+            ce->wanted = 0;
+            more = 1;
         }
     }
 }
 
+/* Pushes node onto the Dijkstra heap with the given distance */
+static void MP_Heap_Push(Flow_Node *node, int32 distance)
+{
+    int32u i, parent;
+
+    if (MP_Heap_Size >= MP_Heap_Cap)
+        Alarm(EXIT, "MP_Heap_Push: heap overflow (%u)\r\n", MP_Heap_Cap);
+
+    i = MP_Heap_Size++;
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (MP_Heap[parent].distance <= distance)
+            break;
+        MP_Heap[i] = MP_Heap[parent];
+        i = parent;
+    }
+    MP_Heap[i].distance = distance;
+    MP_Heap[i].node = node;
+}
+
+/* Pops the entry with the smallest distance off the Dijkstra heap */
+static MP_Heap_Entry MP_Heap_Pop(void)
+{
+    MP_Heap_Entry top, last;
+    int32u i, child;
+
+    top = MP_Heap[0];
+    last = MP_Heap[--MP_Heap_Size];
+
+    i = 0;
+    while ((child = 2 * i + 1) < MP_Heap_Size) {
+        if (child + 1 < MP_Heap_Size && 
+                MP_Heap[child + 1].distance < MP_Heap[child].distance)
+            child++;
+        if (last.distance <= MP_Heap[child].distance)
+            break;
+        MP_Heap[i] = MP_Heap[child];
+        i = child;
+    }
+    MP_Heap[i] = last;
+
+    return top;
+}
+
+/* Computes the cost of flow edge e for one MultiPath_Compute run. Residual
+ * edges get the negated cost of their real twin */
+static int32 MultiPath_Flow_Edge_Cost(Flow_Edge *e, int use_base_cost, int require_reverse)
+{
+    int32 cost, c1, c2;
+
+    if (e->edge == NULL && e->reverse_edge == NULL)
+        cost = 0;
+    else if (e->edge == NULL || e->reverse_edge == NULL) {
+        Alarm(EXIT, "Multipath_Compute: Edge or Reverse is NULL\n");
+        return MULTIPATH_EDGE_DOWN;
+    }
+    else {
+        if (use_base_cost) {
+            c1 = e->edge->base_cost;
+            c2 = e->reverse_edge->base_cost;
+        } else {
+            c1 = e->edge->cost;
+            c2 = e->reverse_edge->cost;
+            /* link is considered broken if either is -1 */
+            if (c1 == -1 || (require_reverse && c2 == -1))
+                return MULTIPATH_EDGE_DOWN;
+            /* AB: negative costs are legal now */
+            c1 = abs(e->edge->cost);
+            c2 = abs(e->reverse_edge->cost);
+        }
+        if (require_reverse)
+            cost = (c1 > c2) ? c1 : c2;
+        else
+            cost = c1;
+    }
+
+    /* if edge is residual, flip cost */
+    if (e->residual == 1)
+        cost = -cost;
+
+    return cost;
+}
+
+/* Computes a minimum cost set of k node-disjoint paths from My_ID to dest_id
+ * using successive shortest paths (Suurballe). Each augmenting path is found
+ * with Dijkstra over reduced costs c(u,v) + p(u) - p(v), where p is the node
+ * potential; updating p with the distances found keeps reduced costs
+ * non-negative on every edge with remaining capacity, including the residual
+ * edges that carry negated costs. Returns the number of paths found, and if
+ * ret_mask is not NULL, the bitmask of edges used by those paths */
 int MultiPath_Compute(int16u dest_id, int16u k, unsigned char **ret_mask, int use_base_cost, int require_reverse)
 {
-    int i, path_index, progress = 0; /* total_cost; */
+    int i, path_index;
     unsigned char *mask;
-    stdhash bag_of_edges;
-    int16 cost = 0, c1, c2;
+    int32 reduced;
     Flow_Edge *e;
-    Flow_Node *t;
-    stdit it;
+    Flow_Node *t, *src, *dst, *n;
+    MP_Heap_Entry top;
     sp_time start, stop;
 
     start = E_get_time();
 
     /* Special case for myself: don't need to send anywhere else, so just set
      * bitmask to all zeros */
-    if (dest_id == My_ID) {
-        /*MP_Cache[dest_id][k] = mask;*/
+    if (dest_id == My_ID || Flow_Nodes_Inbound[dest_id] == NULL) {
         if (ret_mask != NULL) {
             mask = new(MP_BITMASK);
             memset(mask, 0x00, MultiPath_Bitmask_Size);
             *ret_mask = mask;
         }
 
-        return k;
+        return (dest_id == My_ID) ? k : 0;
     }
 
-    /* Iterate through Flow_Edges to initalize flow on each edge, 
+    src = Flow_Nodes_Outbound[My_ID];
+    dst = Flow_Nodes_Inbound[dest_id];
+
+    /* Iterate through Flow_Edges to initalize flow and cost on each edge, 
      *      real edges get flow = 0, residual get flow = capacity */
-    e = Flow_Edge_Head.next;
-    while (e != NULL) {
+    for (e = Flow_Edge_Head.next; e != NULL; e = e->next) {
         if (e->residual == 0)
             e->flow = 0;
         else
             e->flow = e->capacity;
-        e = e->next;
+        e->cost = MultiPath_Flow_Edge_Cost(e, use_base_cost, require_reverse);
     }
 
-    /* Construct the hash table which will keep track of the edges
-     *      traversed by the Bellman-Ford iterations */
-    stdhash_construct(&bag_of_edges, sizeof(Flow_Edge*), 0, NULL, NULL, 0);
+    /* Before the first augmentation only real edges have capacity, and their
+     * costs are non-negative, so all potentials can start at zero */
+    for (i = 1; i <= MAX_NODES; i++) {
+        if (Flow_Nodes_Inbound[i] != NULL)
+            Flow_Nodes_Inbound[i]->potential = 0;
+        if (Flow_Nodes_Outbound[i] != NULL)
+            Flow_Nodes_Outbound[i]->potential = 0;
+    }
 
-    /* FORD-FULKERSON START */
+    /* SUCCESSIVE SHORTEST PATHS START */
     for (path_index = 1; path_index <= k; path_index++) {
 
-        /* BELLMAN-FORD START */
-        /* Step 1: Initialize the graph: 
-         *      Each vertex gets distance = "INF" and predecessor = NULL */
+        /* DIJKSTRA START */
         for (i = 1; i <= MAX_NODES; i++) {
             if (Flow_Nodes_Inbound[i] != NULL) {
                 Flow_Nodes_Inbound[i]->previous_edge = NULL;
-                Flow_Nodes_Inbound[i]->distance = USHRT_MAX;
+                Flow_Nodes_Inbound[i]->distance = MULTIPATH_INF_DIST;
             }
             if (Flow_Nodes_Outbound[i] != NULL) {
                 Flow_Nodes_Outbound[i]->previous_edge = NULL;
-                Flow_Nodes_Outbound[i]->distance = USHRT_MAX;
+                Flow_Nodes_Outbound[i]->distance = MULTIPATH_INF_DIST;
             }
         }
-        Flow_Nodes_Outbound[My_ID]->distance = 0;
-
-        /* Step 2: Relax edges repeatedly */
-        for (i = 1; i <= Num_Nodes * 2 + 1; i++) {
-            progress = 0;
-            e = Flow_Edge_Head.next;
-            while (e != NULL) {
-                if (e->edge == NULL && e->reverse_edge == NULL)
-                    cost = 0;
-                else if (e->edge == NULL || e->reverse_edge == NULL)
-                    Alarm(EXIT, "Multipath_Compute: Edge or Reverse is NULL\n");
-                else {
-                    if (use_base_cost) {
-                        c1 = e->edge->base_cost;
-                        c2 = e->reverse_edge->base_cost;
-                    } else {
-                        c1 = e->edge->cost;
-                        c2 = e->reverse_edge->cost;
-                        /* link is considered broken if either is -1 */
-                        if (c1 == -1 || (require_reverse && c2 == -1)) {
-                            e = e->next;
-                            continue;
-                        }
-                        /* AB: negative costs are legal now */
-                        c1 = abs(e->edge->cost);
-                        c2 = abs(e->reverse_edge->cost);
-                    }
-                    if (require_reverse)
-                        cost = (c1 > c2) ? c1 : c2;
-                    else
-                        cost = c1;
-                }
-                /* if edge is residual, flip cost */
-                if (e->residual == 1)
-                    cost = -cost;
-                if (e->flow < e->capacity &&
-                    e->end->distance > e->start->distance + cost) 
-                {
-                    e->end->distance = e->start->distance + cost;
+        src->distance = 0;
+        MP_Heap_Size = 0;
+        MP_Heap_Push(src, 0);
+
+        while (MP_Heap_Size > 0) {
+            top = MP_Heap_Pop();
+            n = top.node;
+            if (top.distance > n->distance)
+                continue;   /* stale entry */
+
+            for (i = 0; i < n->outgoing_num; i++) {
+                e = n->outgoing[i];
+                if (e->cost == MULTIPATH_EDGE_DOWN || e->flow >= e->capacity)
+                    continue;
+
+                reduced = e->cost + n->potential - e->end->potential;
+                if (reduced < 0)
+                    Alarm(EXIT, "MultiPath_Compute: Negative reduced cost %d\r\n", reduced);
+
+                if (e->end->distance > n->distance + reduced) {
+                    e->end->distance = n->distance + reduced;
                     e->end->previous_edge = e;
-                    progress = 1;
+                    MP_Heap_Push(e->end, e->end->distance);
                 }
-                e = e->next;
             }
-            if (progress == 0)
-                break;
         }
+        /* DIJKSTRA END */
 
-        /* Step 3: Modified (using Progress variable) way to check for
-         *      negative cycles */
-        if (progress == 1)
-            Alarm(EXIT, "MultiPath_Compute: Negative Cycle Found\r\n");
+        if (dst->distance == MULTIPATH_INF_DIST)
+            break;
 
-        /* BELLMAN-FORD END */
+        /* Update potentials. Nodes not reached now can never be reached later
+         * in this computation, since augmenting only adds residual capacity
+         * between reached nodes, so their potentials do not matter */
+        for (i = 1; i <= MAX_NODES; i++) {
+            if (Flow_Nodes_Inbound[i] != NULL && 
+                    Flow_Nodes_Inbound[i]->distance != MULTIPATH_INF_DIST)
+                Flow_Nodes_Inbound[i]->potential += Flow_Nodes_Inbound[i]->distance;
+            if (Flow_Nodes_Outbound[i] != NULL && 
+                    Flow_Nodes_Outbound[i]->distance != MULTIPATH_INF_DIST)
+                Flow_Nodes_Outbound[i]->potential += Flow_Nodes_Outbound[i]->distance;
+        }
 
-        if (Flow_Nodes_Inbound[dest_id]->distance == USHRT_MAX)
-            break;
-        
-        /* Path Augmentation and Add Edges to Bag */
-        t = Flow_Nodes_Inbound[dest_id];
-        while (t != Flow_Nodes_Outbound[My_ID]) {
-            if (t->previous_edge->residual == 1) {
-                stdhash_find(&bag_of_edges, &it, &(t->previous_edge->twin));
-                stdhash_erase(&bag_of_edges, &it);
-            }
-            else
-                stdhash_insert(&bag_of_edges, &it, &(t->previous_edge), 0);
+        /* Path Augmentation */
+        t = dst;
+        while (t != src) {
             t->previous_edge->flow = t->previous_edge->capacity;
             t->previous_edge->twin->flow = 0;
             t = t->previous_edge->start;
         }
 
-    } /* FORD-FULKERSON END */
+    } /* SUCCESSIVE SHORTEST PATHS END */
 
-    /* Construct bitmask */
+    /* Construct bitmask: the paths use exactly the real (non-residual)
+     * network edges that are left carrying flow, since pushing flow back over
+     * a residual edge cancels the flow on its twin */
     if (ret_mask != NULL) {
         mask = new(MP_BITMASK);
         memset(mask, 0x00, MultiPath_Bitmask_Size);
 
-        stdhash_begin(&bag_of_edges, &it);
-        /* j = 0; */ /* Added for testing */
-        /* total_cost = 0; */ /* Added for testing */
-        /*printf("Edges: ");*/
-        while(!stdhash_is_end(&bag_of_edges, &it)) {
-            e = *((Flow_Edge**)stdhash_it_key(&it));
-            if (e->edge != NULL && ret_mask != NULL) {
+        for (e = Flow_Edge_Head.next; e != NULL; e = e->next) {
+            if (e->residual == 0 && e->edge != NULL && e->flow == e->capacity)
                 *(mask + (e->index / 8)) |= 0x80 >> (e->index % 8);
-                /* j++; */ /* Added for testing */
-                /* printf("  %d  ", e->index); *//* Added for testing */
-                /* total_cost += e->edge->cost; */ /* Added for testing */
-            }
-            stdhash_erase(&bag_of_edges, &it);
         }
-        /* printf("\n"); */
 
         /* Return the computed mask as ret_mask */
         *ret_mask = mask;
@@ -492,9 +694,6 @@ int MultiPath_Compute(int16u dest_id, int16u k, unsigned char **ret_mask, int us
         Alarm(EXIT, "MultiPath_Compute: paths found (%d) > k (%d) !!!\r\n",
                 path_index - 1, k);
 
-    /* Cleanup the hash table */
-    stdhash_destruct(&bag_of_edges);
-   
     stop = E_get_time();
 
     Alarm(DEBUG, "Computation took %f seconds.\r\n",
@@ -503,9 +702,63 @@ int MultiPath_Compute(int16u dest_id, int16u k, unsigned char **ret_mask, int us
     return path_index - 1;
 }
 
-int MultiPath_Stamp_Bitmask(int16u dest_id, int16u k, unsigned char *mask)
+/* Returns the cached K-paths bitmask for (dest_id, k, mode), computing it
+ * first if it is missing or was computed in an older topology epoch */
+static unsigned char *MultiPath_Cached_Mask(int16u dest_id, int16u k, int mode)
 {
     int i, ret;
+    MP_Cache_Entry *ce, *other;
+
+    ce = &MP_Cache[dest_id][k][mode];
+    ce->wanted = 1;
+
+    if (ce->mask != NULL && ce->epoch == MP_Epoch[mode])
+        return ce->mask;
+
+    Alarm(PRINT, "COMPUTING [%u,%u] for k = %u\r\n", My_ID, dest_id, k);
+
+    if (ce->mask != NULL)
+        dispose(ce->mask);
+    ce->mask = NULL;
+
+    /* Amy: Note that "require_reverse" option to MultiPath_Compute was
+     * previously always set to 1. This may matter for the
+     * intrusion-tolerant protocols. Should revisit how to unify. */
+    ret = MultiPath_Compute(dest_id, k, &ce->mask, mode == MULTIPATH_BASE_COST, 0);
+    ce->epoch = MP_Epoch[mode];
+    ce->found = ret;
+
+    if (ret == 0) {
+        Alarm(PRINT, "MultiPath_Stamp_Bitmask: Warning! Compute returned 0, "
+            "no paths found with current network conditions\r\n");
+        /* This is not necessarily an error: If a message is destined to
+         * myself, I can still deliver it with a bitmask of all 0s */
+    }
+    else if (ret < k) {
+        /* If we didn't find all the paths we requested, update cache for
+         * all higher numbers of paths as well (since we won't be able to
+         * compute the requested number for those either) */
+        for (i = ret; i <= MULTIPATH_MAX_K; i++) {
+            if (i == k) continue;
+
+            other = &MP_Cache[dest_id][i][mode];
+            if (other->mask == NULL)
+                other->mask = new(MP_BITMASK);
+            memcpy(other->mask, ce->mask, MultiPath_Bitmask_Size);
+            other->epoch = ce->epoch;
+            other->found = ret;
+        }
+            
+        Alarm(PRINT, "MultiPath_Stamp_Bitmask: Requested K = %d, "
+            "Compute found %d\r\n", k, ret);
+    }
+
+    return ce->mask;
+}
+
+int MultiPath_Stamp_Bitmask(int16u dest_id, int16u k, unsigned char *mask)
+{
+    int i;
     int64u *tmp_msk, *tmp_dg_msk;
     DG_Dst *dg_dst;
 
@@ -540,22 +793,8 @@ int MultiPath_Stamp_Bitmask(int16u dest_id, int16u k, unsigned char *mask)
         } else if (dg_dst->current_graph_type == DG_K2_GRAPH ||
                    dg_dst->current_graph_type == DG_SRC_DST_GRAPH)
         {
-            if (MP_Cache[dest_id][2] == NULL) {
-                Alarm(PRINT, "COMPUTING [%u,%u] for k = %u\r\n", My_ID, dest_id, 2);
-
-                /* Amy: Note that "require_reverse" option to MultiPath_Compute was
-                 * previously always set to 1. This may matter for the
-                 * intrusion-tolerant protocols. Should revisit how to unify. */
-                ret = MultiPath_Compute(dest_id, 2, &MP_Cache[dest_id][2], 0, 0);
-                if (ret == 0) {
-                    Alarm(PRINT, "MultiPath_Stamp_Bitmask: Warning! Compute returned 0, "
-                        "no paths found with current network conditions\r\n");
-                    /* This is not necessarily an error: If a message is destined to
-                     * myself, I can still deliver it with a bitmask of all 0s */
-                    /*return 0;*/
-                }
-            }
-            memcpy(mask, MP_Cache[dest_id][2], MultiPath_Bitmask_Size);
+            memcpy(mask, MultiPath_Cached_Mask(dest_id, 2, MULTIPATH_CURRENT_COST), 
+                    MultiPath_Bitmask_Size);
 
             if (dg_dst->current_graph_type == DG_SRC_DST_GRAPH)
             {
@@ -574,39 +813,8 @@ int MultiPath_Stamp_Bitmask(int16u dest_id, int16u k, unsigned char *mask)
     }
 
     /* K Node Disjoint Paths */
-    if (MP_Cache[dest_id][k] == NULL) {
-        Alarm(PRINT, "COMPUTING [%u,%u] for k = %u\r\n", My_ID, dest_id, k);
-
-        /* Amy: Note that "require_reverse" option to MultiPath_Compute was
-         * previously always set to 1. This may matter for the
-         * intrusion-tolerant protocols. Should revisit how to unify. */
-        ret = MultiPath_Compute(dest_id, k, &MP_Cache[dest_id][k], 0, 0);
-        if (ret == 0) {
-            Alarm(PRINT, "MultiPath_Stamp_Bitmask: Warning! Compute returned 0, "
-                "no paths found with current network conditions\r\n");
-            /* This is not necessarily an error: If a message is destined to
-             * myself, I can still deliver it with a bitmask of all 0s */
-            /*return 0;*/
-        }
-        else if (ret < k) {
-            /* If we didn't find all the paths we requested, update cache for
-             * all higher numbers of paths as well (since we won't be able to
-             * compute the requested number for those either) */
-            for (i = ret; i <= MULTIPATH_MAX_K; i++) {
-                if (i == k) continue;
-
-                if (MP_Cache[dest_id][i] != NULL)
-                    dispose(MP_Cache[dest_id][i]);
-                MP_Cache[dest_id][i] = new(MP_BITMASK);
-                memcpy(MP_Cache[dest_id][i], MP_Cache[dest_id][k], MultiPath_Bitmask_Size);
-            }
-                
-            Alarm(PRINT, "MultiPath_Stamp_Bitmask: Requested K = %d, "
-                "Compute found %d\r\n", k, ret);
-        }
-    }
-
-    memcpy(mask, MP_Cache[dest_id][k], MultiPath_Bitmask_Size);
+    memcpy(mask, MultiPath_Cached_Mask(dest_id, k, MULTIPATH_CURRENT_COST), 
+            MultiPath_Bitmask_Size);
     return 1;
 }
 
@@ -680,3 +888,77 @@ int MultiPath_Is_Equal(unsigned char *old_mask, unsigned char *new_mask)
     /* If all parts of the masks matched, the masks are equal (return 1) */
     return 1;
 }
+
+/* Times K-paths bitmask computation for every destination in the configured
+ * topology, for each k and cost mode, both uncached (MultiPath_Compute) and
+ * through the cache. Run with the -mpb option against configuration files
+ * of different sizes to see how latency scales with the topology */
+void MultiPath_Benchmark(int iterations)
+{
+    int i, iter, k, mode, num_dests = 0, calls;
+    unsigned char *mask;
+    sp_time start, stop, call_start, call_stop;
+    double usec, call_usec, max_usec, total_usec;
+    int16u dests[MAX_NODES];
+
+    for (i = 1; i <= MAX_NODES; i++) {
+        if (i != My_ID && Flow_Nodes_Inbound[i] != NULL)
+            dests[num_dests++] = i;
+    }
+
+    Alarm(PRINT, "MultiPath_Benchmark: %d nodes, %d edges, %d destinations, "
+            "%d iterations\r\n", Num_Nodes, (int) stdskl_size(&Sorted_Edges), 
+            num_dests, iterations);
+    if (num_dests == 0 || iterations <= 0)
+        return;
+
+    for (mode = 0; mode < MULTIPATH_NUM_COST_MODES; mode++) {
+        for (k = 1; k <= MULTIPATH_MAX_K; k++) {
+
+            /* Uncached computation */
+            max_usec = 0;
+            total_usec = 0;
+            calls = 0;
+            for (iter = 0; iter < iterations; iter++) {
+                for (i = 0; i < num_dests; i++) {
+                    call_start = E_get_time();
+                    MultiPath_Compute(dests[i], k, &mask, mode == MULTIPATH_BASE_COST, 0);
+                    call_stop = E_get_time();
+                    dispose(mask);
+
+                    call_usec = (call_stop.sec - call_start.sec) * 1.0e6 + 
+                                    (call_stop.usec - call_start.usec);
+                    total_usec += call_usec;
+                    if (call_usec > max_usec)
+                        max_usec = call_usec;
+                    calls++;
+                }
+            }
+            Alarm(PRINT, "MultiPath_Benchmark: %s cost, k = %d: compute avg %.2f "
+                    "usec, max %.0f usec\r\n", 
+                    (mode == MULTIPATH_BASE_COST) ? "base" : "current", k,
+                    total_usec / calls, max_usec);
+
+            /* Cached lookups, after a topology epoch change */
+            MultiPath_Clear_Cache();
+            start = E_get_time();
+            for (i = 0; i < num_dests; i++)
+                MultiPath_Cached_Mask(dests[i], k, mode);
+            stop = E_get_time();
+            usec = (stop.sec - start.sec) * 1.0e6 + (stop.usec - start.usec);
+
+            start = E_get_time();
+            for (iter = 0; iter < iterations; iter++) {
+                for (i = 0; i < num_dests; i++)
+                    MultiPath_Cached_Mask(dests[i], k, mode);
+            }
+            stop = E_get_time();
+            total_usec = (stop.sec - start.sec) * 1.0e6 + (stop.usec - start.usec);
+
+            Alarm(PRINT, "MultiPath_Benchmark: %s cost, k = %d: cold lookup avg "
+                    "%.2f usec, warm lookup avg %.3f usec\r\n",
+                    (mode == MULTIPATH_BASE_COST) ? "base" : "current", k,
+                    usec / num_dests, total_usec / ((double) iterations * num_dests));
+        }
+    }
+}
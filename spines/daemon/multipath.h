@@ -57,6 +57,17 @@
                                            dissemination graphs with src/dst
                                            redundancy */
 
+/* Cost modes for which K-paths bitmasks are cached. Base costs come from the
+ * configuration file and never change at runtime, so base cost results stay
+ * valid across link status changes */
+#define MULTIPATH_CURRENT_COST         0
+#define MULTIPATH_BASE_COST            1
+#define MULTIPATH_NUM_COST_MODES       2
+
+/* Spacing between background recomputations of invalidated cache entries,
+ * so that a topology change does not hold the event loop for all of them */
+#define MULTIPATH_REFRESH_USEC         500
+
 struct Flow_Node_d;
 struct Flow_Edge_d;
 
@@ -69,7 +80,8 @@ typedef struct Flow_Node_d {
     unsigned char         inbound_node; 
     int16u                outgoing_num;
     int16u                incoming_num;
-    int16u                distance;
+    int32                 distance;  /* reduced distance from source in current Dijkstra run */
+    int32                 potential; /* node potential keeping reduced edge costs non-negative */
         /* True if all edges to other real nodes are incoming to this node 
              (one outgoing edge to twin), 
            False if all edges to other real nodes are outgoing from this 
@@ -79,6 +91,7 @@ typedef struct Flow_Node_d {
 typedef struct Flow_Edge_d {
     int16u                flow;
     int16u                capacity;
+    int32                 cost;     /* cost for the current computation (MULTIPATH_EDGE_DOWN if unusable) */
     Edge                 *edge;
     Edge                 *reverse_edge;
     Flow_Node            *start;
@@ -105,11 +118,13 @@ ext Flow_Edge Flow_Edge_Head;
 void   MultiPath_Pre_Conf_Setup(void);
 void   Init_MultiPath(void);
 void   MultiPath_Clear_Cache(void);
+void   MultiPath_Edge_Update(Edge *edge, int16 new_cost);
 int    MultiPath_Compute(int16u dest_id, int16u k, unsigned char **ret_mask, int use_base_cost, int require_reverse); 
 int    MultiPath_Stamp_Bitmask(int16u dest_id, int16u k, unsigned char *mask);
 int    MultiPath_Neighbor_On_Path(unsigned char* mask, int16u ngbr_iter);
 int    MultiPath_Is_Superset(unsigned char* old_mask, unsigned char* new_mask);
 void   MultiPath_Create_Superset(unsigned char* old_mask, unsigned char* new_mask);
 int    MultiPath_Is_Equal(unsigned char* old_mask, unsigned char* new_mask);
+void   MultiPath_Benchmark(int iterations);
 
 #endif /* MULTIPATH_H */
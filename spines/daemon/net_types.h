@@ -311,6 +311,8 @@ typedef	struct	dummy_hello_packet {
     int32           diff_time;
     int32           loss_rate;   /* estimated loss rate of data */
                                  /* (from 0 to LOSS_RATE_SCALE for 0% to 100%) */
+    int32u          hello_usec;  /* sender's hello interval with fast failure */
+                                 /* detection, 0 if it uses the fixed interval */
 } hello_packet;
 
 typedef	struct	dummy_link_state_packet {
@@ -618,10 +618,10 @@ void Network_Leg_Set_Cost(Network_Leg *leg, int16 new_leg_cost)
   /* Check whether dissemination graphs need to be updated */
   DG_Process_Edge_Update(edge, new_leg_cost);
 
-  edge->cost = new_leg_cost;
+  /* Invalidate K-Paths routing results that this change can affect */
+  MultiPath_Edge_Update(edge, new_leg_cost);
 
-  /* Clear the cache used for K-Paths routing */
-  MultiPath_Clear_Cache();
+  edge->cost = new_leg_cost;
 
   if (++edge->timestamp_usec >= 1000000) {
     edge->timestamp_usec = 0;
@@ -932,6 +932,8 @@ int Read_UDP(Interface *local_interf, channel sk, int mode, sys_scatter *scat)
   packet_header *pack_hdr;
   sp_time now = {0, 0};
   sp_time diff;
+  sp_time pkt_delay = {0, 0};
+  long long jitter_usec;
   stdit it;
   double chance = 100.0;
   double test = 0.0;
@@ -1127,7 +1129,19 @@ int Read_UDP(Interface *local_interf, channel sk, int mode, sys_scatter *scat)
 
   if (network_flag == 1 && chance >= test) {
 
-    if (lkp == NULL || (lkp->delay.sec == 0 && lkp->delay.usec == 0)) {
+    if (lkp != NULL) {
+      pkt_delay = lkp->delay;
+
+      if (lkp->jitter.sec > 0 || lkp->jitter.usec > 0) {
+        jitter_usec  = (long long)lkp->jitter.sec * 1000000 + lkp->jitter.usec;
+        jitter_usec  = (long long)(jitter_usec * ((double)rand() / RAND_MAX));
+        diff.sec     = (long)(jitter_usec / 1000000);
+        diff.usec    = (long)(jitter_usec % 1000000);
+        pkt_delay    = E_add_time(pkt_delay, diff);
+      }
+    }
+
+    if (lkp == NULL || (pkt_delay.sec == 0 && pkt_delay.usec == 0)) {
 
       Prot_process_scat(scat, stripped_bytes, local_interf, mode, pack_type, remote_addr, remote_port);
 
@@ -1147,7 +1161,7 @@ int Read_UDP(Interface *local_interf, channel sk, int mode, sys_scatter *scat)
       dpkt.buff          = scat->elements[1].buf;
       dpkt.buf_len       = stripped_bytes - scat->elements[0].len;
       dpkt.type          = pack_type;
-      dpkt.schedule_time = E_add_time(now, lkp->delay);
+      dpkt.schedule_time = E_add_time(now, pkt_delay);
       dpkt.local_interf  = local_interf;
       dpkt.mode          = mode;
       dpkt.remote_addr   = remote_addr;
@@ -1159,7 +1173,7 @@ int Read_UDP(Interface *local_interf, channel sk, int mode, sys_scatter *scat)
 
       scat->elements[0].buf = (char*) new_ref_cnt(PACK_HEAD_OBJ);
       scat->elements[1].buf = (char*) new_ref_cnt(PACK_BODY_OBJ);
-      E_queue(Proc_Delayed_Pkt, Delay_Index, NULL, lkp->delay);
+      E_queue(Proc_Delayed_Pkt, Delay_Index, NULL, pkt_delay);
       Delay_Index++;
     }
 
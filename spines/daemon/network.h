@@ -121,6 +121,8 @@ typedef struct Network_Leg_d
 
   int16              hellos_out;               /* number of outstanding hello msgs on this leg */  
   sp_time            last_recv_hello;          /* time at which we last recvd a hello from other side */
+  sp_time            last_recv_any;            /* time at which we last recvd any packet from other side (fast detection) */
+  sp_time            last_sent_any;            /* time at which we last sent any packet to other side (fast detection) */
 
   int16              connect_cnter;            /* hello counter used to establish connection */
   sp_time            last_connected;           /* TS of most recent time this leg was connected */
@@ -96,6 +96,7 @@
 #define RESERVED_DATA1          44 /* MN */
 #define RESERVED_DATA2          45 /* SC2 */
 #define INTRUSION_TOL_DATA      46
+#define PRIO_FLOOD_EXPIRE_NODE  47
 
 #define SESSION_OBJ             51
 
@@ -86,11 +86,35 @@ prio_stats Prio_Stats[MAX_NODES+1];
 sp_time elapsed_for_stats;
 int64u total_dropped;
 
+/* Highest and lowest non-empty priority for each Prio_PQ levels bitmap */
+static unsigned char Prio_Highest_Level[1 << (MAX_PRIORITY + 1)];
+static unsigned char Prio_Lowest_Level[1 << (MAX_PRIORITY + 1)];
+
+/* Expiration timer wheel */
+static Prio_Expire_Node *Prio_Wheel[PRIO_WHEEL_SLOTS];
+static int64  Prio_Wheel_Tick_Usec;
+static int64  Prio_Wheel_Now;
+static int32u Prio_Wheel_Count;
+static int    Prio_Wheel_Queued;
+
 void Priority_Garbage_Collect (int dummy1, void *dummy2);
 void Cleanup_prio_flood_ds(int ngbr_index, int src_id, 
                             Prio_Flood_Value *fbv_ptr, int ngbr_flag);
 void Priority_Print_Statistics (int dummy1, void* dummy2);
 
+static void Prio_Init_Link_Data(Prio_Link_Data *pldata);
+static void Prio_PQ_Insert(Prio_Link_Data *pldata, int32u src_id, 
+                            Prio_PQ_Node *pqnode, int32u priority, int16u packets);
+static void Prio_PQ_Remove(Prio_Link_Data *pldata, int32u src_id, 
+                            Prio_PQ_Node *pqnode, int32u priority, int16u packets);
+static void Prio_Activate_Source(Prio_Link_Data *pldata, int32u src_id);
+static Send_Fair_Queue *Prio_Next_Source(Prio_Link_Data *pldata, 
+                                            Prio_PQ_Node **pqnode);
+static void Prio_Charge_Source(Prio_Link_Data *pldata, Send_Fair_Queue *sfq,
+                                int16u packets);
+static int32u Prio_Find_Hog(Prio_Link_Data *pldata);
+static void Prio_Wheel_Insert(int32u src_id, Prio_Flood_Key *key, sp_time expire);
+
 
 void Flip_prio_flood_hdr( prio_flood_header *f_hdr )
 {
@@ -148,8 +172,14 @@ void Prio_Pre_Conf_Setup()
 /***********************************************************/
 void Prio_Post_Conf_Setup() 
 {
-    prio_garb_coll_timeout.sec = Conf_Prio.Garbage_Collection_Sec;
-    prio_garb_coll_timeout.usec = 0;
+    /* The expiration wheel spans Garbage_Collection_Sec seconds */
+    Prio_Wheel_Tick_Usec = (int64) Conf_Prio.Garbage_Collection_Sec * 1000000 /
+                                PRIO_WHEEL_SLOTS;
+    if (Prio_Wheel_Tick_Usec < PRIO_WHEEL_MIN_TICK_USEC)
+        Prio_Wheel_Tick_Usec = PRIO_WHEEL_MIN_TICK_USEC;
+
+    prio_garb_coll_timeout.sec = Prio_Wheel_Tick_Usec / 1000000;
+    prio_garb_coll_timeout.usec = Prio_Wheel_Tick_Usec % 1000000;
 }
 
 /***********************************************************/
@@ -211,38 +241,30 @@ void Init_Priority_Flooding()
     Edge_Data = (Prio_Link_Data *)
         Mem_alloc(sizeof(Prio_Link_Data) * (Degree[My_ID] + 1));
 
-    for (h = 0; h <= Degree[My_ID]; h++) {
-        
-        for (i = 0; i <= MAX_NODES; i++) {
-            Edge_Data[h].msg_count[i] = 0;
-            Edge_Data[h].in_send_queue[i] = 0;
-            Edge_Data[h].max_pq[i] = 0;
-            Edge_Data[h].min_pq[i] = MAX_PRIORITY + 1;
-
-            for (j = 0; j <= MAX_PRIORITY; j++) {
-                Edge_Data[h].pq[i].head[j].next = NULL;
-                Edge_Data[h].pq[i].head[j].entry = NULL;
-                Edge_Data[h].pq[i].tail[j] =
-                    &Edge_Data[h].pq[i].head[j];
+    for (h = 0; h <= Degree[My_ID]; h++)
+        Prio_Init_Link_Data(&Edge_Data[h]);
+
+    /* levels bitmap -> highest/lowest set bit, bit 0 is never used */
+    for (i = 0; i < (1 << (MAX_PRIORITY + 1)); i++) {
+        Prio_Highest_Level[i] = 0;
+        Prio_Lowest_Level[i] = MAX_PRIORITY + 1;
+        for (j = 1; j <= MAX_PRIORITY; j++) {
+            if (i & (1 << j)) {
+                Prio_Highest_Level[i] = j;
+                if (Prio_Lowest_Level[i] == MAX_PRIORITY + 1)
+                    Prio_Lowest_Level[i] = j;
             }
         }
-
-        Edge_Data[h].total_msg = 0;
-
-        Edge_Data[h].norm_head.next = NULL;
-        Edge_Data[h].norm_head.src_id = -1;
-        Edge_Data[h].norm_tail = &Edge_Data[h].norm_head;
-
-        Edge_Data[h].urgent_head.next = NULL;
-        Edge_Data[h].urgent_head.src_id = -1;
-        Edge_Data[h].urgent_tail = &Edge_Data[h].urgent_head;
-        
-        Edge_Data[h].sent_messages = 0;
     }
 
+    for (i = 0; i < PRIO_WHEEL_SLOTS; i++)
+        Prio_Wheel[i] = NULL;
+    Prio_Wheel_Now = ((int64) now.sec * 1000000 + now.usec) / Prio_Wheel_Tick_Usec;
+    Prio_Wheel_Count = 0;
+    Prio_Wheel_Queued = 0;
+
     Bytes_Since_Checkpoint = 0;
     Time_Since_Checkpoint = now;
-    E_queue( Priority_Garbage_Collect, 0, NULL, prio_garb_coll_timeout);
     /* E_queue( Suicide_Control, 0, NULL, prio_suicide_timeout); */
     Alarm(DEBUG, "Created Flood Best Effort Data Structures\n");
 
@@ -266,6 +288,230 @@ void Init_Priority_Flooding()
     /* E_queue( Priority_Print_Statistics, 0, NULL, prio_print_stat_timeout); */
 }
 
+/* Resets the per-source priority queues and send queues of a link */
+static void Prio_Init_Link_Data(Prio_Link_Data *pldata)
+{
+    int32u i, j;
+
+    for (i = 0; i <= MAX_NODES; i++) {
+        pldata->msg_count[i] = 0;
+        pldata->in_send_queue[i] = 0;
+        pldata->pq[i].levels = 0;
+
+        for (j = 0; j <= MAX_PRIORITY; j++) {
+            pldata->pq[i].head[j].next = NULL;
+            pldata->pq[i].head[j].entry = NULL;
+            pldata->pq[i].tail[j] = &pldata->pq[i].head[j];
+        }
+    }
+
+    pldata->total_msg = 0;
+
+    pldata->norm_head.next = NULL;
+    pldata->norm_head.src_id = -1;
+    pldata->norm_tail = &pldata->norm_head;
+
+    pldata->urgent_head.next = NULL;
+    pldata->urgent_head.src_id = -1;
+    pldata->urgent_tail = &pldata->urgent_head;
+
+    pldata->sent_messages = 0;
+}
+
+/* Appends pqnode to the src_id queue of the given priority on this link */
+static void Prio_PQ_Insert(Prio_Link_Data *pldata, int32u src_id, 
+                            Prio_PQ_Node *pqnode, int32u priority, int16u packets)
+{
+    Prio_PQ *pq = &pldata->pq[src_id];
+
+    pqnode->next = NULL;
+    pqnode->prev = pq->tail[priority];
+    pq->tail[priority]->next = pqnode;
+    pq->tail[priority] = pqnode;
+    pq->levels |= (1 << priority);
+
+    pldata->msg_count[src_id] += packets;
+    pldata->total_msg += packets;
+}
+
+/* Unlinks pqnode from the src_id queue of the given priority on this link.
+ * The caller disposes of the node */
+static void Prio_PQ_Remove(Prio_Link_Data *pldata, int32u src_id, 
+                            Prio_PQ_Node *pqnode, int32u priority, int16u packets)
+{
+    Prio_PQ *pq = &pldata->pq[src_id];
+
+    pqnode->prev->next = pqnode->next;
+    if (pqnode->next != NULL)
+        pqnode->next->prev = pqnode->prev;
+    else {
+        pq->tail[priority] = pqnode->prev;
+        if (pq->head[priority].next == NULL)
+            pq->levels &= ~(1 << priority);
+    }
+
+    if (pldata->msg_count[src_id] < packets)
+        Alarm(EXIT, "Prio_PQ_Remove(): msg_count can't be < 0");
+    pldata->msg_count[src_id] -= packets;
+    pldata->total_msg -= packets;
+}
+
+/* Puts a source that just got a message into the urgent send queue */
+static void Prio_Activate_Source(Prio_Link_Data *pldata, int32u src_id)
+{
+    Send_Fair_Queue *sfq;
+
+    if (pldata->in_send_queue[src_id] != 0)
+        return;
+
+    if ((sfq = (Send_Fair_Queue *) new(SEND_QUEUE_NODE)) == NULL) {
+        Alarm(EXIT, "Prio_Activate_Source: Cannot allocate send_queue object\r\n");
+    }
+    sfq->next = NULL;
+    sfq->src_id = src_id;
+    sfq->deficit = 0;
+    sfq->in_turn = 0;
+    pldata->urgent_tail->next = sfq;
+    pldata->urgent_tail = sfq;
+    pldata->in_send_queue[src_id] = 1;
+}
+
+/* Deficit round robin over the sources with messages for this link. Newly
+ * active sources (urgent queue) are served once right away, then join the
+ * normal queue, where a source gets PRIO_DRR_QUANTUM packets of credit each
+ * turn and sends while its credit covers its next message. Sources that run
+ * out of messages are dropped from the queues here.
+ *
+ * Returns the chosen source, with its highest priority, oldest message in
+ * pqnode, or NULL if no source has anything to send. */
+static Send_Fair_Queue *Prio_Next_Source(Prio_Link_Data *pldata, 
+                                            Prio_PQ_Node **pqnode)
+{
+    Send_Fair_Queue *sfq, *head;
+    int32u src_id;
+
+    while (1) {
+        if (pldata->urgent_head.next != NULL)
+            head = &pldata->urgent_head;
+        else if (pldata->norm_head.next != NULL)
+            head = &pldata->norm_head;
+        else
+            return NULL;
+
+        sfq = head->next;
+        src_id = sfq->src_id;
+
+        if (pldata->msg_count[src_id] == 0) {
+            head->next = sfq->next;
+            if (head == &pldata->urgent_head && pldata->urgent_tail == sfq)
+                pldata->urgent_tail = &pldata->urgent_head;
+            else if (head == &pldata->norm_head && pldata->norm_tail == sfq)
+                pldata->norm_tail = &pldata->norm_head;
+            pldata->in_send_queue[src_id] = 0;
+            dispose(sfq);
+            continue;
+        }
+
+        *pqnode = pldata->pq[src_id].head[
+                    Prio_Highest_Level[pldata->pq[src_id].levels]].next;
+        assert(*pqnode != NULL);
+
+        if (head == &pldata->urgent_head)
+            return sfq;
+
+        if (!sfq->in_turn) {
+            sfq->deficit += PRIO_DRR_QUANTUM;
+            sfq->in_turn = 1;
+        }
+        if (sfq->deficit >= (*pqnode)->entry->packets)
+            return sfq;
+
+        /* end of this source's turn, move to back of normal queue */
+        sfq->in_turn = 0;
+        if (sfq->next != NULL) {
+            pldata->norm_head.next = sfq->next;
+            sfq->next = NULL;
+            pldata->norm_tail->next = sfq;
+            pldata->norm_tail = sfq;
+        }
+    }
+}
+
+/* Charges a source chosen by Prio_Next_Source for the packets it sent */
+static void Prio_Charge_Source(Prio_Link_Data *pldata, Send_Fair_Queue *sfq,
+                                int16u packets)
+{
+    if (sfq == pldata->urgent_head.next) {
+        pldata->urgent_head.next = sfq->next;
+        if (pldata->urgent_tail == sfq)
+            pldata->urgent_tail = &pldata->urgent_head;
+
+        /* move to back of normal queue, paying for this message there */
+        sfq->deficit = 0;
+        sfq->in_turn = 0;
+        sfq->next = NULL;
+        pldata->norm_tail->next = sfq;
+        pldata->norm_tail = sfq;
+    }
+    else if (sfq == pldata->norm_head.next) {
+        sfq->deficit -= packets;
+    }
+    else { /* error */
+        Alarm(PRINT, "Prio_Charge_Source(): send_fair_queue \
+                        node not possible\r\n");
+    }
+}
+
+/* Returns the active source using the most of this link's storage */
+static int32u Prio_Find_Hog(Prio_Link_Data *pldata)
+{
+    Send_Fair_Queue *sfq;
+    int32u hog_index = 0, max_usage = 0;
+
+    for (sfq = pldata->urgent_head.next; sfq != NULL; sfq = sfq->next) {
+        if (pldata->msg_count[sfq->src_id] > max_usage) {
+            hog_index = sfq->src_id;
+            max_usage = pldata->msg_count[sfq->src_id];
+        }
+    }
+    for (sfq = pldata->norm_head.next; sfq != NULL; sfq = sfq->next) {
+        if (pldata->msg_count[sfq->src_id] > max_usage) {
+            hog_index = sfq->src_id;
+            max_usage = pldata->msg_count[sfq->src_id];
+        }
+    }
+    return hog_index;
+}
+
+/* Schedules a stored message for garbage collection once it expires */
+static void Prio_Wheel_Insert(int32u src_id, Prio_Flood_Key *key, sp_time expire)
+{
+    Prio_Expire_Node *enode;
+    int64 tick;
+
+    if ((enode = (Prio_Expire_Node *) new(PRIO_FLOOD_EXPIRE_NODE)) == NULL) {
+        Alarm(EXIT, "Prio_Wheel_Insert: Cannot allocate expire node\r\n");
+    }
+
+    /* first tick that starts at or after the expiration time */
+    tick = ((int64) expire.sec * 1000000 + expire.usec + Prio_Wheel_Tick_Usec - 1) / 
+                Prio_Wheel_Tick_Usec;
+    if (tick <= Prio_Wheel_Now)
+        tick = Prio_Wheel_Now + 1;
+
+    enode->key = *key;
+    enode->src_id = src_id;
+    enode->tick = tick;
+    enode->next = Prio_Wheel[tick % PRIO_WHEEL_SLOTS];
+    Prio_Wheel[tick % PRIO_WHEEL_SLOTS] = enode;
+    Prio_Wheel_Count++;
+
+    if (!Prio_Wheel_Queued) {
+        E_queue(Priority_Garbage_Collect, 0, NULL, prio_garb_coll_timeout);
+        Prio_Wheel_Queued = 1;
+    }
+}
+
 int Fill_Packet_Header_Best_Effort_Flood( char* hdr )
 {
     prio_flood_header *f_hdr = (prio_flood_header*)hdr;
@@ -300,15 +546,14 @@ int Priority_Flood_Disseminate(Link *src_link, sys_scatter *scat, int mode)
     packet_header       *phdr;
     prio_flood_header   *f_hdr;
     int                 msg_size = 0, expected_size, ret = BUFF_OK, crypto_ret;
-    int32u              i, src_id, ngbr_iter = 0, max_usage, hog_index;
-    int16u              packets = 0;
+    int32u              i, src_id, ngbr_iter = 0, hog_index;
     int32u              last_hop_ip, last_hop_index = 0, temp_microsecs;
     stdit               ip_it, msg_it, it;
     sp_time             now, temp_time;
     Prio_Flood_Value    fbv, *fbv_ptr;
     Prio_Link_Data      *pldata;
     Prio_PQ_Node        *temp_pq_node;
-    Send_Fair_Queue     *temp_sfq;
+    Prio_Flood_Key      key;
     Node                *nd;
     unsigned int        sign_len;
     unsigned char       temp_ttl;
@@ -523,6 +768,7 @@ int Priority_Flood_Disseminate(Link *src_link, sys_scatter *scat, int mode)
             inc_ref_cnt(fbv.msg_scat->elements[i].buf);
         fbv.msg_len = msg_size;
         fbv.link_mode = mode;
+        fbv.packets = Calculate_Packets_In_Message(fbv.msg_scat, mode, NULL);
         
         fbv.ns = new(PRIO_FLOOD_NS_OBJ);
         if (fbv.ns == NULL) {
@@ -538,6 +784,10 @@ int Priority_Flood_Disseminate(Link *src_link, sys_scatter *scat, int mode)
         stdhash_find(&Belly[src_id], &msg_it, &f_hdr->incarnation);
         fbv_ptr = ((Prio_Flood_Value *)stdhash_it_val(&msg_it));
 
+        key.incarnation = f_hdr->incarnation;
+        key.seq_num = f_hdr->seq_num;
+        Prio_Wheel_Insert(src_id, &key, fbv.expire);
+
         /* num_unique++;
         if (num_unique % 1000 == 0) 
             printf("~~~ Stats after %d unique packets ~~~\n", num_unique); */
@@ -636,53 +886,20 @@ int Priority_Flood_Disseminate(Link *src_link, sys_scatter *scat, int mode)
                                     Prio_PQ_Node object\r\n");
                 }
 
-                /* fill in the pq node */
+                /* fill in the pq node and link it into the corresponding 
+                 * src's PQ at its priority level, increasing the msg_count 
+                 * for that source and total messages */
                 temp_pq_node->timestamp = fbv_ptr->expire;
                 temp_pq_node->entry = fbv_ptr;
-                temp_pq_node->next = NULL;
-                temp_pq_node->prev =
-                    pldata->pq[src_id].tail[f_hdr->priority];
-
-                /* link to the node in the corresponding src's PQ and correct
-                 * prior lvl */
-                pldata->pq[src_id].tail[f_hdr->priority]->next =
-                    temp_pq_node;
-                pldata->pq[src_id].tail[f_hdr->priority] = temp_pq_node;
+                Prio_PQ_Insert(pldata, src_id, temp_pq_node, f_hdr->priority,
+                                fbv_ptr->packets);
 
                 /* update the Ngbr status for both pointer to msg and flag */
                 fbv_ptr->ns[ngbr_iter].flag = NEED_MSG;
                 fbv_ptr->ns[ngbr_iter].ngbr = temp_pq_node;
 
                 /* possibly put this source into the send_queues */
-                if (pldata->in_send_queue[src_id] == 0) {
-                    if((temp_sfq = (Send_Fair_Queue *) new(SEND_QUEUE_NODE))
-                        == NULL)
-                    {
-                        Alarm(EXIT, "Priority_Flood_Disseminate: Cannot \
-                                     allocate send_queue objecti\r\n");
-                    }
-                    temp_sfq->next = NULL;
-                    temp_sfq->src_id = src_id;
-                    temp_sfq->penalty = 1;
-                    pldata->urgent_tail->next = temp_sfq;
-                    pldata->urgent_tail = temp_sfq;
-                    pldata->in_send_queue[src_id] = 1;
-                }
-
-                /* increase the msg_count for that source
-                 * and total messages */
-                packets = Calculate_Packets_In_Message(fbv_ptr->msg_scat, mode, NULL);
-                pldata->msg_count[src_id] += packets;
-                pldata->total_msg += packets;
-
-                /* Check if the max has now increased */
-                if (f_hdr->priority > pldata->max_pq[src_id]) {
-                    pldata->max_pq[src_id] = f_hdr->priority;
-                }
-                /* Check if the min has now decreased */
-                if (f_hdr->priority < pldata->min_pq[src_id]) {
-                    pldata->min_pq[src_id] = f_hdr->priority;
-                }
+                Prio_Activate_Source(pldata, src_id);
                
                 /* Find the node that corresponds to this neighbor */
                 stdhash_find(&All_Nodes, &it, &Neighbor_Addrs[My_ID][ngbr_iter]);
@@ -701,19 +918,11 @@ int Priority_Flood_Disseminate(Link *src_link, sys_scatter *scat, int mode)
                 if (pldata->total_msg > Conf_Prio.Max_Mess_Stored) {
                     
                     /* search for the sender_id w/ the maximum usage */
-                    hog_index = 0; max_usage = 0;
-                    for (i = 1; i <= MAX_NODES; i++) {
-                        if (pldata->msg_count[i] > 0 &&
-                                pldata->msg_count[i] > max_usage)
-                        {
-                            hog_index = i;
-                            max_usage = pldata->msg_count[i];
-                        }
-                    }
+                    hog_index = Prio_Find_Hog(pldata);
 
                     /* get the current hog's lowest priority, oldest message */
-                    temp_pq_node = pldata->pq[hog_index].
-                                        head[pldata->min_pq[hog_index]].next;
+                    temp_pq_node = pldata->pq[hog_index].head[
+                        Prio_Lowest_Level[pldata->pq[hog_index].levels]].next;
 
                     /* call cleanup function */
                     Cleanup_prio_flood_ds(ngbr_iter, hog_index,
@@ -834,67 +1043,22 @@ int Priority_Flood_Send_One( Node *next_hop, int mode )
 
     while (!sent_one) {
         
-        temp_sfq = NULL;
-
-        /* first, check the urgent sender fair queue */
-        if (pldata->urgent_head.next != NULL) {
-            temp_sfq = pldata->urgent_head.next;
-            temp_sfq->penalty--;
-            /* make sure that this source still has something to send */
-            if (temp_sfq->penalty > 0 || pldata->msg_count[temp_sfq->src_id] == 0) {
-                pldata->urgent_head.next = pldata->urgent_head.next->next;
-                if(pldata->urgent_tail == temp_sfq)
-                    pldata->urgent_tail = &pldata->urgent_head;
-                /* move to back of normal queue */
-                temp_sfq->next = NULL;
-                pldata->norm_tail->next = temp_sfq;
-                pldata->norm_tail = temp_sfq;
-                continue;
-            }
-        }
-        /* next, check normal_head if the urgent was empty */
-        else if (pldata->norm_head.next != NULL) {
-            temp_sfq = pldata->norm_head.next;
-            temp_sfq->penalty--;
-            if (temp_sfq->penalty > 0) {
-                pldata->norm_head.next = pldata->norm_head.next->next;
-                if (pldata->norm_head.next == NULL)
-                    pldata->norm_tail = &pldata->norm_head;
-                temp_sfq->next = NULL;
-                pldata->norm_tail->next = temp_sfq;
-                pldata->norm_tail = temp_sfq;
-                continue;
-            }
-            /* make sure that this source still has something to send */
-            else if (pldata->msg_count[temp_sfq->src_id] == 0) {
-                pldata->norm_head.next = pldata->norm_head.next->next;
-                if (pldata->norm_head.next == NULL)
-                    pldata->norm_tail = &pldata->norm_head;
-                pldata->in_send_queue[temp_sfq->src_id] = 0;
-                dispose(temp_sfq);
-                continue;
-            }
-        }
-        /* else no source (toward this link) has anything to send */
-        else {
+        /* pick the next source in the fair queue, and that sender's
+         * highest priority, oldest message */
+        temp_sfq = Prio_Next_Source(pldata, &temp_pq_node);
+
+        /* no source (toward this link) has anything to send */
+        if (temp_sfq == NULL)
             return 0;
-        }
-            
-        /* now, we must get this sender's highest priority, oldest message */
+
         sender_id = temp_sfq->src_id;
-        temp_pq_node =
-                pldata->pq[sender_id].head[pldata->max_pq[sender_id]].next;
-        assert(temp_pq_node != NULL);
-        
         now = E_get_time();
         fbv_ptr = temp_pq_node->entry;
         
-        /* check if this msg is expired */
+        /* check if this msg is expired, the source is not charged for it */
         if (E_compare_time(temp_pq_node->timestamp, now) <= 0) {
             Cleanup_prio_flood_ds(ngbr_index, sender_id, temp_pq_node->entry,
                                     EXPIRED_MSG);
-            /* Correcting the penalty because no message was sent this iteration */
-            temp_sfq->penalty = 1;
             continue;
         }
 
@@ -918,39 +1082,18 @@ int Priority_Flood_Send_One( Node *next_hop, int mode )
                                 Forward_Data\r\n");
                 Alarm(PRINT, "... Trying to SEND #%"PRIu64" TO "IPF"\n",
                     fbv_ptr->seq_num, IP(Neighbor_Addrs[My_ID][ngbr_index]));
-                /* Correcting the penalty because the message failed to send */
-                temp_sfq->penalty++;
+                /* The source is not charged since the message failed to send */
                 return 0;
                 break;
             default:
                 Alarm(PRINT, "Priority_Flood_Send_One(): got an invalid  \
                                 return from Forward_Data\r\n");
-                /* Correcting the penalty because the message failed to send */
-                temp_sfq->penalty++;
+                /* The source is not charged since the message failed to send */
                 return 0;
         } 
 
-        /* cleanup the send_fair_queue */
-        if (temp_sfq == pldata->urgent_head.next) {
-            pldata->urgent_head.next = pldata->urgent_head.next->next;
-            if(pldata->urgent_tail == temp_sfq)
-                pldata->urgent_tail = &pldata->urgent_head;
-        }
-        else if (temp_sfq == pldata->norm_head.next) {
-            pldata->norm_head.next = pldata->norm_head.next->next;
-            if(pldata->norm_tail == temp_sfq)
-                pldata->norm_tail = &pldata->norm_head;
-        } 
-        else { /* error */
-            Alarm(PRINT, "Priority_Flood_Send_One(): send_fair_queue \
-                            node not possible\r\n");
-        }
-
-        /* move to back of normal queue */
-        temp_sfq->penalty = Calculate_Packets_In_Message(fbv_ptr->msg_scat, mode, NULL);
-        temp_sfq->next = NULL;
-        pldata->norm_tail->next = temp_sfq;
-        pldata->norm_tail = temp_sfq;
+        /* charge the source in the send_fair_queue */
+        Prio_Charge_Source(pldata, temp_sfq, fbv_ptr->packets);
 
         Cleanup_prio_flood_ds(ngbr_index, sender_id, temp_pq_node->entry,
                                 ON_LINK_MSG);
@@ -993,9 +1136,7 @@ int Priority_Flood_Send_One( Node *next_hop, int mode )
 void Cleanup_prio_flood_ds(int ngbr_index, int src_id, 
                             Prio_Flood_Value *fbv_ptr, int ngbr_flag)
 {
-    int                 j, i, start = 1, end = Degree[My_ID];
-    int16u              packets = 0;
-    Prio_Link_Data      *pldata;
+    int                 i, start = 1, end = Degree[My_ID];
     Prio_PQ_Node        *pqnode;
 
     if (fbv_ptr->need_count == 0)
@@ -1005,47 +1146,16 @@ void Cleanup_prio_flood_ds(int ngbr_index, int src_id,
         start = end = ngbr_index;
     }
 
-    packets = Calculate_Packets_In_Message(fbv_ptr->msg_scat, 
-                        fbv_ptr->link_mode, NULL);
-
     for (i = start; i <= end && fbv_ptr->need_count > 0; i++) {
 
         /* If this neighbor has already cleaned up this message, skip */
         if ( fbv_ptr->ns[i].ngbr == NULL)
             continue;
 
-        pldata = &Edge_Data[i];
-        pldata->msg_count[src_id] -= packets;
-        pldata->total_msg -= packets;
+        /* Delete the pqnode, fixing pointers and counts around it */
         pqnode = fbv_ptr->ns[i].ngbr;
-
-        /* Delete the pqnode and fix pointers around it */
-        pqnode->prev->next = pqnode->next;
-        if (pqnode->next != NULL)
-            pqnode->next->prev = pqnode->prev;
-        else {
-            pldata->pq[src_id].tail[fbv_ptr->priority] = pqnode->prev;
-
-            /* have to update max/min prioirity where we have msgs */
-            if (pldata->msg_count[src_id] > 0) { /* still some msgs in PQ */
-                for (j = pldata->max_pq[src_id]; j >= 1 && 
-                        pldata->pq[src_id].head[j].next == NULL; j--)
-                {
-                    pldata->max_pq[src_id]--;
-                }
-                for (j = pldata->min_pq[src_id]; j <= MAX_PRIORITY &&
-                        pldata->pq[src_id].head[j].next == NULL; j++) 
-                {
-                    pldata->min_pq[src_id]++;
-                }
-            }
-            else if (pldata->msg_count[src_id] == 0) { /* PQ is empty */
-                pldata->max_pq[src_id] = 0;
-                pldata->min_pq[src_id] = MAX_PRIORITY + 1;
-            }
-            else
-                Alarm(EXIT, "Cleanup_flood_ds(): msg_count can't be < 0");
-        }
+        Prio_PQ_Remove(&Edge_Data[i], src_id, pqnode, fbv_ptr->priority,
+                        fbv_ptr->packets);
         dispose(pqnode);
 
         /* Update the NS array for with that status */
@@ -1067,7 +1177,9 @@ void Cleanup_prio_flood_ds(int ngbr_index, int src_id,
 /**************************************************************/
 /* void Priority_Garbage_Collect (int32 dummy1, void *dummy2) */
 /*                                                            */
-/* Event for deleting expired meta data of messages           */
+/* Event for deleting expired meta data of messages. Advances */
+/*   the expiration timer wheel to the current time, cleaning */
+/*   up only the messages whose slots have come due.          */
 /*                                                            */
 /*                                                            */
 /* Arguments                                                  */
@@ -1082,40 +1194,61 @@ void Cleanup_prio_flood_ds(int ngbr_index, int src_id,
 /**************************************************************/
 void Priority_Garbage_Collect (int dummy1, void* dummy2) 
 {
-    int32u i;
-    int32u gc_count, tot_count, tot_nnodes;
+    int32u gc_count, steps;
+    int64 tick, now_tick;
     stdit it;
     Prio_Flood_Value *fbv_ptr;
+    Prio_Expire_Node **prev, *enode;
     sp_time now;
 
     UNUSED(dummy1);
     UNUSED(dummy2);
 
     gc_count = 0;
-    tot_count = 0;
-    tot_nnodes = 0;
     now = E_get_time();
+    now_tick = ((int64) now.sec * 1000000 + now.usec) / Prio_Wheel_Tick_Usec;
+    Prio_Wheel_Queued = 0;
+
+    /* visit every slot between the last tick and now, at most once around */
+    if (now_tick - Prio_Wheel_Now > PRIO_WHEEL_SLOTS)
+        steps = PRIO_WHEEL_SLOTS;
+    else
+        steps = now_tick - Prio_Wheel_Now;
+
+    for (tick = Prio_Wheel_Now + 1; steps > 0; tick++, steps--) {
+        prev = &Prio_Wheel[tick % PRIO_WHEEL_SLOTS];
+        while (*prev != NULL) {
+            enode = *prev;
+
+            /* expires on a later trip around the wheel */
+            if (enode->tick > now_tick) {
+                prev = &enode->next;
+                continue;
+            }
 
-    for (i = 1; i <= MAX_NODES; i++) {
-        stdhash_begin(&Belly[i], &it);
-        tot_nnodes += stdhash_load_lvl(&Belly[i]);
-        while (!stdhash_is_end(&Belly[i], &it)) {
-            fbv_ptr = ((Prio_Flood_Value *)stdhash_it_val(&it));
-            tot_count++;
-            if (E_compare_time(fbv_ptr->expire, now) <= 0) {
-                Cleanup_prio_flood_ds(0, i, fbv_ptr, EXPIRED_MSG);
-                stdhash_erase(&Belly[i], &it);
+            stdhash_find(&Belly[enode->src_id], &it, &enode->key);
+            if (!stdhash_is_end(&Belly[enode->src_id], &it)) {
+                fbv_ptr = ((Prio_Flood_Value *)stdhash_it_val(&it));
+                Cleanup_prio_flood_ds(0, enode->src_id, fbv_ptr, EXPIRED_MSG);
+                stdhash_erase(&Belly[enode->src_id], &it);
                 gc_count++;
-                continue;
             }
-            stdhash_it_next(&it);
+
+            *prev = enode->next;
+            dispose(enode);
+            Prio_Wheel_Count--;
         }
     }
+    if (now_tick > Prio_Wheel_Now)
+        Prio_Wheel_Now = now_tick;
+
+    Alarm(DEBUG, "Priority Garbage Collect: Finished, erased %u items, "
+            "%u remain\n", gc_count, Prio_Wheel_Count);
 
-    Alarm(DEBUG, "Priority Garbage Collect: Finished, erased %u of %u items, "
-            "%u remain, sum hash load = %u\n", gc_count, tot_count, 
-            tot_count - gc_count, tot_nnodes);
-    E_queue(Priority_Garbage_Collect, 0, NULL, prio_garb_coll_timeout);
+    if (Prio_Wheel_Count > 0) {
+        E_queue(Priority_Garbage_Collect, 0, NULL, prio_garb_coll_timeout);
+        Prio_Wheel_Queued = 1;
+    }
 }
 
 void Priority_Print_Statistics (int dummy1, void* dummy2)
@@ -1177,3 +1310,128 @@ void Priority_Print_Statistics (int dummy1, void* dummy2)
     elapsed_for_stats = E_get_time();
     E_queue( Priority_Print_Statistics, 0, NULL, prio_print_stat_timeout);
 }
+
+/* Drives the per-link scheduler of a synthetic link with MAX_NODES sources 
+ * under overload: every send opportunity, two messages arrive, half of them 
+ * from a single heavy source and the rest spread across the other sources at 
+ * random priorities, so the link storage fills up and the heaviest source is 
+ * dropped from. Prints the average and worst enqueue and dequeue cost, the 
+ * Jain fairness index of the service given to the light sources, and how 
+ * much of the service went to the top priority. Run with the -pfb option */
+void Priority_Flood_Benchmark(int messages)
+{
+    Prio_Link_Data      *pldata;
+    Prio_Flood_Value    templates[MAX_PRIORITY + 1];
+    Prio_PQ_Node        *pqnode;
+    Send_Fair_Queue     *sfq;
+    int32u              src_id, priority, hog_index;
+    int32u              served[MAX_NODES + 1];
+    int64u              enq_count = 0, deq_count = 0, dropped = 0, top_served = 0;
+    double              usec, enq_usec = 0, deq_usec = 0, enq_max = 0, deq_max = 0;
+    double              sum = 0, sum_sq = 0;
+    sp_time             start, stop;
+    int                 i, j, light = 0;
+
+    Alarm(PRINT, "Priority_Flood_Benchmark: %d sources, %d messages, "
+            "%u packets stored per link\r\n", MAX_NODES, messages,
+            Conf_Prio.Max_Mess_Stored);
+    if (messages <= 0)
+        return;
+
+    pldata = (Prio_Link_Data *) Mem_alloc(sizeof(Prio_Link_Data));
+    Prio_Init_Link_Data(pldata);
+
+    /* the scheduler only looks at the priority and size of each message */
+    for (i = 0; i <= MAX_PRIORITY; i++) {
+        memset(&templates[i], 0, sizeof(Prio_Flood_Value));
+        templates[i].priority = i;
+        templates[i].packets = 1;
+    }
+    for (i = 0; i <= MAX_NODES; i++)
+        served[i] = 0;
+
+    for (i = 0; i < messages; i++) {
+
+        for (j = 0; j < 2; j++) {
+            if (rand() % 2 == 0) {
+                src_id = 1;
+                priority = 1;
+            }
+            else {
+                src_id = 2 + rand() % (MAX_NODES - 1);
+                priority = 1 + rand() % MAX_PRIORITY;
+            }
+
+            start = E_get_time();
+            if ((pqnode = (Prio_PQ_Node *) new(PRIO_FLOOD_PQ_NODE)) == NULL)
+                Alarm(EXIT, "Priority_Flood_Benchmark: cannot allocate pq node\r\n");
+            pqnode->entry = &templates[priority];
+            Prio_PQ_Insert(pldata, src_id, pqnode, priority, 1);
+            Prio_Activate_Source(pldata, src_id);
+
+            if (pldata->total_msg > Conf_Prio.Max_Mess_Stored) {
+                hog_index = Prio_Find_Hog(pldata);
+                pqnode = pldata->pq[hog_index].head[
+                    Prio_Lowest_Level[pldata->pq[hog_index].levels]].next;
+                Prio_PQ_Remove(pldata, hog_index, pqnode, 
+                                pqnode->entry->priority, 1);
+                dispose(pqnode);
+                dropped++;
+            }
+            stop = E_get_time();
+
+            usec = (stop.sec - start.sec) * 1.0e6 + (stop.usec - start.usec);
+            enq_usec += usec;
+            if (usec > enq_max)
+                enq_max = usec;
+            enq_count++;
+        }
+
+        start = E_get_time();
+        sfq = Prio_Next_Source(pldata, &pqnode);
+        if (sfq == NULL)
+            continue;
+        src_id = sfq->src_id;
+        priority = pqnode->entry->priority;
+        Prio_Charge_Source(pldata, sfq, 1);
+        Prio_PQ_Remove(pldata, src_id, pqnode, priority, 1);
+        dispose(pqnode);
+        stop = E_get_time();
+
+        usec = (stop.sec - start.sec) * 1.0e6 + (stop.usec - start.usec);
+        deq_usec += usec;
+        if (usec > deq_max)
+            deq_max = usec;
+        deq_count++;
+
+        served[src_id]++;
+        if (priority == MAX_PRIORITY)
+            top_served++;
+    }
+
+    /* drain the link, which also releases the send queue nodes */
+    while ((sfq = Prio_Next_Source(pldata, &pqnode)) != NULL) {
+        Prio_Charge_Source(pldata, sfq, 1);
+        Prio_PQ_Remove(pldata, sfq->src_id, pqnode, pqnode->entry->priority, 1);
+        dispose(pqnode);
+    }
+
+    for (i = 2; i <= MAX_NODES; i++) {
+        sum += served[i];
+        sum_sq += (double) served[i] * served[i];
+        light++;
+    }
+
+    Alarm(PRINT, "Priority_Flood_Benchmark: enqueue avg %.3f usec, max %.0f usec; "
+            "dequeue avg %.3f usec, max %.0f usec\r\n", 
+            enq_usec / enq_count, enq_max, 
+            deq_count > 0 ? deq_usec / deq_count : 0, deq_max);
+    Alarm(PRINT, "Priority_Flood_Benchmark: sent %"PRIu64", dropped %"PRIu64", "
+            "heavy source share %.3f, light source fairness %.3f, "
+            "top priority share %.3f\r\n", deq_count, dropped, 
+            deq_count > 0 ? (double) served[1] / deq_count : 0,
+            sum_sq > 0 ? (sum * sum) / (light * sum_sq) : 0,
+            deq_count > 0 ? (double) top_served / deq_count : 0);
+
+    dispose(pldata);
+}
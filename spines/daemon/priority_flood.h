@@ -75,6 +75,15 @@
 #define PRIO_DEFAULT_EXPIRE_USEC    0
 #define GARB_COLL_TO                60  /* 1 min */
 
+/* Deficit round robin across sources on each link: credit (in packets)
+ * granted to a source each time it goes around the send queue */
+#define PRIO_DRR_QUANTUM            1
+
+/* Expiration timer wheel. The wheel spans Garbage_Collection_Sec seconds,
+ * so each slot covers Garbage_Collection_Sec / PRIO_WHEEL_SLOTS */
+#define PRIO_WHEEL_SLOTS            4096
+#define PRIO_WHEEL_MIN_TICK_USEC    1000
+
 typedef struct CONF_PRIO_d {
     unsigned char Crypto;
     unsigned char Default_Priority;
@@ -117,13 +126,23 @@ typedef struct Prio_Flood_Value_d {
     sys_scatter *msg_scat;
     int32u msg_len;
     int link_mode; /* The mode of the link from which this message was recieved */
+    int16u packets;  /* Packets in msg_scat on link_mode, charged to each link */
     Prio_Neighbor_Status *ns;
 } Prio_Flood_Value;
 
+/* Entry in the expiration timer wheel, one per stored message */
+typedef struct Prio_Expire_Node_d {
+    Prio_Flood_Key key;
+    int32u src_id;
+    int64 tick;
+    struct Prio_Expire_Node_d *next;
+} Prio_Expire_Node;
+
 /* -------Per Neighbor/Link Data Structures-------- */
 typedef struct Send_Fair_Queue_d {
     int32u src_id;
-    int16u penalty;
+    int32 deficit;
+    unsigned char in_turn;
     struct Send_Fair_Queue_d *next;
 } Send_Fair_Queue;
 
@@ -135,6 +154,7 @@ typedef struct Prio_PQ_Node_d {
 } Prio_PQ_Node;
 
 typedef struct Prio_PQ_d {
+    int16u        levels;   /* bit p is set when priority p is non-empty */
     Prio_PQ_Node  head[MAX_PRIORITY + 1];
     Prio_PQ_Node *tail[MAX_PRIORITY + 1];
 } Prio_PQ;
@@ -143,8 +163,6 @@ typedef struct Prio_Link_Data_d {
     int32u              total_msg;
     int32u              msg_count[MAX_NODES + 1];
     unsigned char       in_send_queue[MAX_NODES + 1];
-    int32u              max_pq[MAX_NODES + 1];
-    int32u              min_pq[MAX_NODES + 1];
     Prio_PQ             pq[MAX_NODES + 1];
     Send_Fair_Queue     norm_head;
     Send_Fair_Queue     *norm_tail;
@@ -170,7 +188,7 @@ ext sp_time                  Time_Since_Checkpoint;
 ext int16u Prio_Signature_Len;
 ext CONF_PRIO Conf_Prio;
 
-/* this is how often we will do garbage collection */
+/* this is how often the expiration timer wheel advances */
 ext sp_time prio_garb_coll_timeout; 
 
 /* Configuration File Functions */
@@ -189,4 +207,7 @@ int Fill_Packet_Header_Best_Effort_Flood( char* hdr );
 int Priority_Flood_Disseminate(Link *src_link, sys_scatter *scat, int mode); 
 int Priority_Flood_Send_One(Node *next_hop, int mode);
 
+/* Benchmarking Functions */
+void Priority_Flood_Benchmark(int messages);
+
 #endif
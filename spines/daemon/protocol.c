@@ -65,6 +65,7 @@
 #include "state_flood.h"
 
 extern int16u Port;
+extern int    Fast_Detect;
 
 /* Statistics */
 
@@ -188,6 +189,11 @@ void Prot_process_scat(sys_scatter *scat, int total_bytes, Interface *local_inte
         Check_Link_Loss(leg, pack_hdr->seq_no, mode);
     }
 
+    /* Any packet from the other side shows the leg is alive */
+    if (Fast_Detect) {
+      Hello_Recv_Liveness(leg);
+    }
+
     switch (mode) {
 
     case CONTROL_LINK:
@@ -3446,11 +3446,11 @@ void Apply_Link_Status_Change( int16u ID1, int16u ID2, int16 cost)
     if (e->cost == cost)
         return;
 
+    /* Invalidate multipath cache entries that this change can affect */
+    MultiPath_Edge_Update(e, cost);
+
     e->cost = cost;
     Alarm(PRINT, "Apply_Link_Status_Change: [%u,%u] --> cost = %d\r\n", id1, id2, cost);
-   
-    /* Clear the multipath cache */
-    MultiPath_Clear_Cache();
 }
 
 /***********************************************************/
@@ -1322,20 +1322,36 @@ int Process_Session_Packet(Session *ses)
                     lkp.burst_rate = Flip_int32(lkp.burst_rate);
                 }
 
-                /* Delay is given in milliseconds */
+                /* Older clients do not send the jitter field */
+                if (cmd->len >= 5 * sizeof(int32)) {
+                    lkp.jitter.usec = *(int32*)(ses->data + 2 * sizeof(udp_header) + 5 * sizeof(int32));
+                    if(!Same_endian(ses->endianess_type)) {
+                        lkp.jitter.usec = Flip_int32(lkp.jitter.usec);
+                    }
+                }
+
+                /* Delay and jitter are given in milliseconds */
 
                 lkp.delay.usec   *= 1000;
 
                 lkp.delay.sec     = lkp.delay.usec / 1000000;
                 lkp.delay.usec    = lkp.delay.usec % 1000000;
 
+                if (lkp.jitter.usec < 0) {
+                    lkp.jitter.usec = 0;
+                }
+                lkp.jitter.usec  *= 1000;
+
+                lkp.jitter.sec    = lkp.jitter.usec / 1000000;
+                lkp.jitter.usec   = lkp.jitter.usec % 1000000;
+
                 lkp.was_loss      = 0;
 
                 lkp.bucket        = BWTH_BUCKET;
                 lkp.last_time_add = E_get_time();
 
-                Alarm(PRINT, "\nSetting leg params(" IPF " -> " IPF "): bandwidth: %d; latency: %d; loss: %d; burst: %d; was_loss %d\n\n",
-                      IP(cmd->source), IP(cmd->dest), lkp.bandwidth, lkp.delay.usec, lkp.loss_rate, lkp.burst_rate, lkp.was_loss);
+                Alarm(PRINT, "\nSetting leg params(" IPF " -> " IPF "): bandwidth: %d; latency: %d; jitter: %d; loss: %d; burst: %d; was_loss %d\n\n",
+                      IP(cmd->source), IP(cmd->dest), lkp.bandwidth, lkp.delay.usec, lkp.jitter.usec, lkp.loss_rate, lkp.burst_rate, lkp.was_loss);
 
                 memset(&lid, 0, sizeof(lid));
                 lid.src_interf_id = cmd->source;
@@ -1343,7 +1359,8 @@ int Process_Session_Packet(Session *ses)
 
                 stdhash_erase_key(&Monitor_Params, &lid);
 
-                if (lkp.bandwidth > 0 || lkp.delay.sec > 0 || lkp.delay.usec > 0 || lkp.loss_rate > 0) {
+                if (lkp.bandwidth > 0 || lkp.delay.sec > 0 || lkp.delay.usec > 0 || 
+                    lkp.jitter.sec > 0 || lkp.jitter.usec > 0 || lkp.loss_rate > 0) {
 
                   if (stdhash_insert(&Monitor_Params, &it, &lid, &lkp) != 0) {
                     Alarm(EXIT, "Couldn't insert into Monitor_Params!\r\n");
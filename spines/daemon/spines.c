@@ -82,6 +82,7 @@
 #include "route.h"
 #include "priority_flood.h"
 #include "reliable_flood.h"
+#include "multipath.h"
 #include "multicast.h"
 #include "kernel_routing.h"
 #include "configuration.h"
@@ -223,6 +224,9 @@ int      Fast_Retransmit;
 int      Stream_Fairness;
 int      TCP_Fairness;
 int      Print_Cost;
+int      Fast_Detect;
+int      MultiPath_Bench_Iters;
+int      Prio_Bench_Messages;
 int      Unicast_Only;
 int      Memory_Limit;
 int16    KR_Flags;
@@ -457,6 +461,18 @@ int main(int argc, char* argv[])
 
     Init_Network();
 
+    if (MultiPath_Bench_Iters > 0) {
+        MultiPath_Benchmark(MultiPath_Bench_Iters);
+        Session_Finish();
+        return(0);
+    }
+
+    if (Prio_Bench_Messages > 0) {
+        Priority_Flood_Benchmark(Prio_Bench_Messages);
+        Session_Finish();
+        return(0);
+    }
+
     if(Up_Down_Interval.sec != 0)
 	E_queue(Up_Down_Net, 0, NULL, Up_Down_Interval);
 
@@ -518,6 +534,7 @@ static void Init_Memory_Objects(int x)
   Mem_init_object_abort(PRIO_FLOOD_PQ_NODE, "Priority_Flood_PQ", sizeof(Prio_PQ_Node), (int)(30*x), 20);
   Mem_init_object_abort(PRIO_FLOOD_NS_OBJ, "Priority_Flood_NS", sizeof(Prio_Neighbor_Status) * (Degree[My_ID] + 1), (int)(30*x), 20);
   Mem_init_object_abort(SEND_QUEUE_NODE, "Send_Fairness_Queue", sizeof(Send_Fair_Queue), (int)(3*x), 1); 
+  Mem_init_object_abort(PRIO_FLOOD_EXPIRE_NODE, "Priority_Flood_Expire", sizeof(Prio_Expire_Node), (int)(30*x), 20);
   Mem_init_object_abort(FLOW_QUEUE_NODE, "Flow_Fairness_Queue", sizeof(Flow_Queue), (int)(3*x), 1); 
   Mem_init_object_abort(RF_SESSION_OBJ, "Reliable_Flood_Session", sizeof(Session_Obj), (int)(3*x), 1); 
   Mem_init_object_abort(DISSEM_QUEUE_NODE, "Dissemination_Queue", sizeof(Dissem_Fair_Queue), (int)(3*x), 1); 
@@ -684,6 +701,9 @@ static  void    Usage(int argc, char *argv[])
     Stream_Fairness = 0;
     TCP_Fairness = 0;
     Print_Cost = 0;
+    Fast_Detect = 0;
+    MultiPath_Bench_Iters = 0;
+    Prio_Bench_Messages = 0;
     Up_Down_Interval.sec  = 0;
     Up_Down_Interval.usec = 0;
     Time_until_Exit.sec  = 0;
@@ -716,6 +736,14 @@ static  void    Usage(int argc, char *argv[])
             TCP_Fairness = 1;
         }else if(!strncmp(*argv, "-pc", 4)) {
             Print_Cost = 1;
+        }else if(!strncmp(*argv, "-fd", 4)) {
+            Fast_Detect = 1;
+        }else if(!strncmp(*argv, "-mpb", 5)) {
+            sscanf(argv[1], "%d", &MultiPath_Bench_Iters);
+            argc--; argv++;
+        }else if(!strncmp(*argv, "-pfb", 5)) {
+            sscanf(argv[1], "%d", &Prio_Bench_Messages);
+            argc--; argv++;
         }else if(!strncmp(*argv, "-m", 3)) {
             Accept_Monitor = 1;
         }else if(!strncmp(*argv, "-U", 3)) {
@@ -973,6 +1001,12 @@ static  void    Usage(int argc, char *argv[])
               "\t[-lf <file>]                   : log file name\r\n"
               "\t[-ud <path>]                   : unix domain socket path prefix, default is %s<port>\r\n"
               "\t[-pc]                          : print cost statistics\r\n"
+              "\t[-fd]                          : fast link failure detection with per-link\n"
+              "\t                                 hello intervals from rtt and jitter\r\n"
+              "\t[-mpb <iterations>]            : benchmark K-paths bitmask computation for\n"
+              "\t                                 the configured topology and exit\r\n"
+              "\t[-pfb <messages>]              : benchmark the priority flooding link scheduler\n"
+              "\t                                 with many sources under overload and exit\r\n"
               "\t[-rl <rate (kbps)>]            : per-leg rate limit (default 500,000 kbps, -1 for no limit)\r\n"
               "\t[-c <file>]                    : configuration file name, default is spines.conf\r\n",
                                                 SPINES_UNIX_SOCKET_PATH);
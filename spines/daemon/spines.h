@@ -145,6 +145,9 @@ extern int      Fast_Retransmit;
 extern int      Stream_Fairness;
 extern int      TCP_Fairness;
 extern int      Print_Cost;
+extern int      Fast_Detect;
+extern int      MultiPath_Bench_Iters;
+extern int      Prio_Bench_Messages;
 extern int      Unicast_Only;
 extern int      Memory_Limit;
 extern int16    KR_Flags;
@@ -2231,9 +2231,10 @@ int  spines_accept(int s, struct sockaddr *addr, socklen_t *addrlen)
 
 
 /***********************************************************/
-/* int spines_setlink(int sk, const struct sockaddr *addr, */
-/*                    int bandwidth, int latency,          */
-/*                    float loss, float burst)             */ 
+/* int spines_setlink_jitter(int sk, int remote_interf_id,*/
+/*                    int local_interf_id, int bandwidth,  */
+/*                    int latency, int jitter,             */
+/*                    float loss, float burst)             */
 /*                                                         */
 /* Sets the loss rate on packets received on a network leg */
 /*                                                         */
@@ -2242,7 +2243,9 @@ int  spines_accept(int s, struct sockaddr *addr, socklen_t *addrlen)
 /* sk:               the Spines socket (SOCK_STREAM type)  */
 /* remote_interf_id: the remote src interface for the leg  */
 /* local_interf_id:  the local dst interface for the leg   */
-/* link:             link latency                          */
+/* latency:          link latency (ms)                     */
+/* jitter:           extra delay drawn uniformly from      */
+/*                   [0, jitter] for each packet (ms)      */
 /* loss:             loss rate                             */
 /* burst:            conditional probability of loss       */
 /*                                                         */
@@ -2253,13 +2256,13 @@ int  spines_accept(int s, struct sockaddr *addr, socklen_t *addrlen)
 /*                                                         */
 /***********************************************************/
 
-int spines_setlink(int sk, int remote_interf_id, int local_interf_id, 
-		   int bandwidth, int latency, float loss, float burst)
+int spines_setlink_jitter(int sk, int remote_interf_id, int local_interf_id, 
+			  int bandwidth, int latency, int jitter, float loss, float burst)
 {
     udp_header *u_hdr, *cmd;
     char pkt[MAX_PACKET_SIZE];
     int32 *total_len;
-    int32 *bandwidth_in, *latency_in, *loss_rate, *burst_rate;
+    int32 *bandwidth_in, *latency_in, *loss_rate, *burst_rate, *jitter_in;
     int32 *type;
     int ret;
 
@@ -2271,13 +2274,15 @@ int spines_setlink(int sk, int remote_interf_id, int local_interf_id,
     latency_in = (int32*)(pkt+sizeof(int32)+2*sizeof(udp_header)+2*sizeof(int32));
     loss_rate = (int32*)(pkt+sizeof(int32)+2*sizeof(udp_header)+3*sizeof(int32));
     burst_rate = (int32*)(pkt+sizeof(int32)+2*sizeof(udp_header)+4*sizeof(int32));
+    jitter_in = (int32*)(pkt+sizeof(int32)+2*sizeof(udp_header)+5*sizeof(int32));
 
     *bandwidth_in = bandwidth; 
     *latency_in = latency; 
     *loss_rate = (int32)(loss*10000);
     *burst_rate = (int32)(burst*10000);
+    *jitter_in = jitter;
     
-    *total_len = (int32)(2*sizeof(udp_header) + 5*sizeof(int32));   
+    *total_len = (int32)(2*sizeof(udp_header) + 6*sizeof(int32));   
     
     u_hdr->source = 0;
     u_hdr->dest   = 0;
@@ -2288,12 +2293,12 @@ int spines_setlink(int sk, int remote_interf_id, int local_interf_id,
     cmd->source    = remote_interf_id;
     cmd->dest      = local_interf_id;
     cmd->dest_port = 0;
-    cmd->len       = 4*sizeof(int32);
+    cmd->len       = 5*sizeof(int32);
 
     ret = send(sk, pkt, *total_len+sizeof(int32), 0);
     
-    if(ret != 2*sizeof(udp_header)+6*sizeof(int32)) {
-        Alarm(PRINT, "spines_setlink(): communications error with spines daemon\n");
+    if(ret != 2*sizeof(udp_header)+7*sizeof(int32)) {
+        Alarm(PRINT, "spines_setlink_jitter(): communications error with spines daemon\n");
         spines_set_errno(SP_ERROR_DAEMON_COMM_ERR);
         return(-1);
     }
@@ -2301,6 +2306,22 @@ int spines_setlink(int sk, int remote_interf_id, int local_interf_id,
     return(0);  
 }
 
+/***********************************************************/
+/* int spines_setlink(int sk, int remote_interf_id,        */
+/*                    int local_interf_id, int bandwidth,  */
+/*                    int latency, float loss, float burst)*/
+/*                                                         */
+/* Same as spines_setlink_jitter() with no jitter          */
+/*                                                         */
+/***********************************************************/
+
+int spines_setlink(int sk, int remote_interf_id, int local_interf_id, 
+		   int bandwidth, int latency, float loss, float burst)
+{
+    return spines_setlink_jitter(sk, remote_interf_id, local_interf_id,
+                                 bandwidth, latency, 0, loss, burst);
+}
+
 /***********************************************************/
 /* int spines_dissemination(int sk, int paths,             */
 /*                             int overwrite_ip)           */
@@ -214,6 +214,8 @@ int spines_recvfrom_internal(int s, void *buf, size_t len, int flags,
 
 int spines_setlink(int sk, int remote_interf_id, int local_interf_id,
                    int bandwidth, int latency, float loss, float burst);
+int spines_setlink_jitter(int sk, int remote_interf_id, int local_interf_id,
+                          int bandwidth, int latency, int jitter, float loss, float burst);
 int spines_setdissemination(int sk, int paths, int overwrite_ip);
 int spines_get_client(int sk);
 
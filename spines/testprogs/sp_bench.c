@@ -0,0 +1,543 @@
+/*
+ * Spines.
+ *
+ * The contents of this file are subject to the Spines Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spines.org/LICENSE.txt
+ *
+ * or in the file ``LICENSE.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * The Creators of Spines are:
+ *  Yair Amir, Claudiu Danilov, John Schultz, Daniel Obenshain,
+ *  Thomas Tantillo, and Amy Babay.
+ *
+ * Copyright (c) 2003-2025 The Johns Hopkins University.
+ * All rights reserved.
+ *
+ * Major Contributor(s):
+ * --------------------
+ *    John Lane
+ *    Raluca Musaloiu-Elefteri
+ *    Nilo Rivera
+ *
+ * Contributor(s):
+ * ----------------
+ *    Sahiti Bommareddy
+ *
+ */
+
+/* sp_bench: paced, timestamped traffic between two Spines clients.
+ *
+ * The sender paces Num_pkts messages of Num_bytes at Rate kbps. The
+ * receiver records the one-way latency of every message and, when the
+ * sender's end marker arrives (or the stream goes idle), prints a single
+ * JSON line with latency percentiles, loss, reordering and goodput.
+ * Sender and receiver must share a clock (e.g. run on the same host),
+ * which is how spines/testprogs/spines_bench.py uses it. */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <sys/un.h>
+#include <netdb.h>
+#include <errno.h>
+
+#include "spines_lib.h"
+#include "spu_events.h"
+#include "spu_alarm.h"
+
+#define SP_MAX_PKT_SIZE   100000
+#define BENCH_END_SEQ     0xffffffff
+#define BENCH_END_COPIES  5
+
+static int    Num_bytes;
+static int    Rate;
+static int    Num_pkts;
+static char   IP[80];
+static char   SP_IP[80];
+static char   Unix_domain_path[80];
+static char   Mode_name[32];
+static char   Label[80];
+static char   Report_file[256];
+static int    spinesPort;
+static int    sendPort;
+static int    recvPort;
+static int    Send_Flag;
+static int    Protocol;
+static int    Idle_timeout;
+static int16u Priority;
+static int16u KPaths;
+
+static void Usage(int argc, char *argv[]);
+
+typedef struct bench_pkt_d {
+    int32u seq_num;
+    int32u origin_sec;
+    int32u origin_usec;
+    int32u total_sent;   /* only valid on the end marker */
+} bench_pkt;
+
+static long long Usec_Diff(sp_time later, sp_time earlier)
+{
+    return (long long)(later.sec - earlier.sec) * 1000000 + (later.usec - earlier.usec);
+}
+
+static int Cmp_Latency(const void *a, const void *b)
+{
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile over a sorted array */
+static long long Percentile(long long *sorted, int count, double pct)
+{
+    int rank;
+
+    if (count == 0)
+        return 0;
+
+    rank = (int)(pct / 100.0 * count + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    if (rank > count)
+        rank = count;
+
+    return sorted[rank - 1];
+}
+
+static double Cpu_Seconds(void)
+{
+    struct rusage ru;
+
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+           (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000000.0;
+}
+
+static FILE *Open_Report(void)
+{
+    FILE *f;
+
+    if (Report_file[0] == '\0')
+        return stdout;
+
+    if ((f = fopen(Report_file, "a")) == NULL)
+        Alarm(EXIT, "sp_bench: could not open report file %s\n", Report_file);
+
+    return f;
+}
+
+static void Close_Report(FILE *f)
+{
+    fflush(f);
+    if (f != stdout)
+        fclose(f);
+}
+
+static void Run_Sender(int sk, struct sockaddr_in *host)
+{
+    char         buf[SP_MAX_PKT_SIZE];
+    bench_pkt   *b_pkt = (bench_pkt*)buf;
+    sp_time      start, now, next;
+    long long    interval_usec, ahead, elapsed;
+    spines_nettime expiration;
+    double       cpu_start;
+    int          i, ret, sent;
+    FILE        *f;
+
+    memset(buf, 0, sizeof(buf));
+
+    expiration.sec  = 300;
+    expiration.usec = 0;
+    if (spines_setsockopt(sk, 0, SPINES_SET_EXPIRATION, (void *)&expiration, sizeof(spines_nettime)) < 0)
+        Alarm(EXIT, "sp_bench: error setting expiration time via setsockopt\n");
+
+    if (spines_setsockopt(sk, 0, SPINES_SET_PRIORITY, (void *)&Priority, sizeof(int16u)) < 0)
+        Alarm(EXIT, "sp_bench: error setting priority via setsockopt\n");
+
+    if (spines_setsockopt(sk, 0, SPINES_DISJOINT_PATHS, (void *)&KPaths, sizeof(int16u)) < 0)
+        Alarm(EXIT, "sp_bench: error setting k-paths value via setsockopt\n");
+
+    /* Time between messages at the requested rate (kbps) */
+    interval_usec = 0;
+    if (Rate > 0)
+        interval_usec = (long long)Num_bytes * 8 * 1000 / Rate;
+
+    cpu_start = Cpu_Seconds();
+    start = E_get_time();
+    next  = start;
+    sent  = 0;
+
+    for (i = 1; i <= Num_pkts; i++) {
+        if (interval_usec > 0) {
+            now = E_get_time();
+            ahead = Usec_Diff(next, now);
+            if (ahead > 0)
+                usleep((useconds_t)ahead);
+            next.usec += interval_usec;
+            next.sec  += next.usec / 1000000;
+            next.usec %= 1000000;
+        }
+
+        now = E_get_time();
+        b_pkt->seq_num     = htonl(i);
+        b_pkt->origin_sec  = htonl(now.sec);
+        b_pkt->origin_usec = htonl(now.usec);
+        b_pkt->total_sent  = 0;
+
+        ret = spines_sendto(sk, buf, Num_bytes, 0, (struct sockaddr *)host, sizeof(struct sockaddr));
+        if (ret != Num_bytes)
+            Alarm(EXIT, "sp_bench: error in writing: %d\n", ret);
+        sent++;
+    }
+
+    now = E_get_time();
+    elapsed = Usec_Diff(now, start);
+
+    b_pkt->seq_num     = htonl(BENCH_END_SEQ);
+    b_pkt->origin_sec  = htonl(now.sec);
+    b_pkt->origin_usec = htonl(now.usec);
+    b_pkt->total_sent  = htonl(sent);
+    for (i = 0; i < BENCH_END_COPIES; i++) {
+        spines_sendto(sk, buf, Num_bytes, 0, (struct sockaddr *)host, sizeof(struct sockaddr));
+        usleep(10000);
+    }
+
+    f = Open_Report();
+    fprintf(f, "{\"role\": \"sender\", \"label\": \"%s\", \"mode\": \"%s\", \"protocol\": %d, "
+               "\"size\": %d, \"rate_kbps\": %d, \"sent\": %d, \"duration_usec\": %lld, "
+               "\"offered_kbps\": %.3f, \"cpu_sec\": %.3f}\n",
+            Label, Mode_name, Protocol, Num_bytes, Rate, sent, elapsed,
+            elapsed > 0 ? (double)sent * Num_bytes * 8 * 1000 / elapsed : 0.0,
+            Cpu_Seconds() - cpu_start);
+    Close_Report(f);
+
+    /* gives the daemon time to complete the sends before the session closes */
+    sleep(1);
+}
+
+static void Run_Receiver(int sk)
+{
+    char           buf[SP_MAX_PKT_SIZE];
+    bench_pkt     *b_pkt = (bench_pkt*)buf;
+    long long     *latency;
+    unsigned char *seen;
+    long long      sum, oneway, duration;
+    sp_time        first, last, now, sent_at;
+    fd_set         mask, tmp_mask;
+    struct timeval timeout;
+    double         cpu_start;
+    int32u         seq, last_seq;
+    int            ret, received, duplicates, out_of_order, total_sent, got_end;
+    FILE          *f;
+
+    latency = malloc(Num_pkts * sizeof(long long));
+    seen    = calloc(Num_pkts + 1, 1);
+    if (latency == NULL || seen == NULL)
+        Alarm(EXIT, "sp_bench: out of memory for %d messages\n", Num_pkts);
+
+    FD_ZERO(&mask);
+    FD_SET(sk, &mask);
+
+    received = duplicates = out_of_order = got_end = 0;
+    total_sent = Num_pkts;
+    last_seq = 0;
+    sum = 0;
+    cpu_start = 0;
+    first.sec = first.usec = 0;
+    last = first;
+
+    while (!got_end || received < total_sent) {
+        tmp_mask = mask;
+        timeout.tv_sec  = Idle_timeout;
+        timeout.tv_usec = 0;
+
+        /* Wait forever for the first message, then stop once the stream goes idle */
+        ret = select(FD_SETSIZE, &tmp_mask, NULL, NULL, received == 0 && !got_end ? NULL : &timeout);
+        if (ret == 0)
+            break;
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            Alarm(EXIT, "sp_bench: select error %d\n", errno);
+        }
+
+        ret = spines_recvfrom(sk, buf, sizeof(buf), 0, NULL, 0);
+        now = E_get_time();
+        if (ret <= 0)
+            Alarm(EXIT, "sp_bench: disconnected by spines\n");
+        if (ret < (int)sizeof(bench_pkt))
+            continue;
+
+        seq = ntohl(b_pkt->seq_num);
+        if (seq == BENCH_END_SEQ) {
+            got_end = 1;
+            total_sent = ntohl(b_pkt->total_sent);
+            continue;
+        }
+        if (seq == 0 || seq > (int32u)Num_pkts)
+            continue;
+
+        if (seen[seq]) {
+            duplicates++;
+            continue;
+        }
+        seen[seq] = 1;
+
+        if (received == 0) {
+            first = now;
+            cpu_start = Cpu_Seconds();
+        }
+        last = now;
+
+        if (seq < last_seq)
+            out_of_order++;
+        else
+            last_seq = seq;
+
+        sent_at.sec  = ntohl(b_pkt->origin_sec);
+        sent_at.usec = ntohl(b_pkt->origin_usec);
+        oneway = Usec_Diff(now, sent_at);
+        latency[received++] = oneway;
+        sum += oneway;
+    }
+
+    qsort(latency, received, sizeof(long long), Cmp_Latency);
+    duration = Usec_Diff(last, first);
+
+    f = Open_Report();
+    fprintf(f, "{\"role\": \"receiver\", \"label\": \"%s\", \"mode\": \"%s\", \"protocol\": %d, "
+               "\"size\": %d, \"sent\": %d, \"received\": %d, \"lost\": %d, \"duplicates\": %d, "
+               "\"out_of_order\": %d, \"end_marker\": %s, \"duration_usec\": %lld, \"goodput_kbps\": %.3f, "
+               "\"latency_usec\": {\"min\": %lld, \"mean\": %.1f, \"p50\": %lld, \"p90\": %lld, "
+               "\"p99\": %lld, \"p999\": %lld, \"max\": %lld}, \"cpu_sec\": %.3f}\n",
+            Label, Mode_name, Protocol, Num_bytes, total_sent, received,
+            total_sent > received ? total_sent - received : 0, duplicates, out_of_order,
+            got_end ? "true" : "false", duration,
+            duration > 0 ? (double)received * Num_bytes * 8 * 1000 / duration : 0.0,
+            received ? latency[0] : 0, received ? (double)sum / received : 0.0,
+            Percentile(latency, received, 50), Percentile(latency, received, 90),
+            Percentile(latency, received, 99), Percentile(latency, received, 99.9),
+            received ? latency[received - 1] : 0,
+            received ? Cpu_Seconds() - cpu_start : 0.0);
+    Close_Report(f);
+
+    free(latency);
+    free(seen);
+}
+
+int main(int argc, char *argv[])
+{
+    int                 sk;
+    struct sockaddr_in  host, serv_addr, name;
+    struct sockaddr_un  unix_addr;
+    struct sockaddr    *daemon_ptr = NULL;
+    struct hostent     *host_ptr;
+
+    /* reports are read through a pipe by spines_bench.py */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    Usage(argc, argv);
+
+    /* INET connections take precedence if specified */
+    if (strcmp(SP_IP, "") != 0) {
+        if ((host_ptr = gethostbyname(SP_IP)) == NULL)
+            Alarm(EXIT, "sp_bench: could not resolve %s\n", SP_IP);
+        memset(&serv_addr, 0, sizeof(serv_addr));
+        serv_addr.sin_family = AF_INET;
+        serv_addr.sin_port   = htons(spinesPort);
+        memcpy(&serv_addr.sin_addr, host_ptr->h_addr, sizeof(struct in_addr));
+        daemon_ptr = (struct sockaddr *)&serv_addr;
+    } else if (strcmp(Unix_domain_path, "") != 0) {
+        memset(&unix_addr, 0, sizeof(unix_addr));
+        unix_addr.sun_family = AF_UNIX;
+        strncpy(unix_addr.sun_path, Unix_domain_path, sizeof(unix_addr.sun_path) - 1);
+        daemon_ptr = (struct sockaddr *)&unix_addr;
+    } else if (spinesPort != DEFAULT_SPINES_PORT) {
+        memset(&unix_addr, 0, sizeof(unix_addr));
+        unix_addr.sun_family = AF_UNIX;
+        sprintf(unix_addr.sun_path, "%s%hu", SPINES_UNIX_SOCKET_PATH, (unsigned short) spinesPort);
+        daemon_ptr = (struct sockaddr *)&unix_addr;
+    }
+
+    if (spines_init(daemon_ptr) < 0)
+        Alarm(EXIT, "sp_bench: spines_init error\n");
+
+    sk = spines_socket(PF_SPINES, SOCK_DGRAM, Protocol, NULL);
+    if (sk < 0)
+        Alarm(EXIT, "sp_bench: socket error\n");
+
+    if (Send_Flag == 1) {
+        if ((host_ptr = gethostbyname(IP)) == NULL)
+            Alarm(EXIT, "sp_bench: could not resolve destination %s\n", IP);
+        memset(&host, 0, sizeof(host));
+        host.sin_family = AF_INET;
+        host.sin_port   = htons(sendPort);
+        memcpy(&host.sin_addr, host_ptr->h_addr, sizeof(struct in_addr));
+
+        Run_Sender(sk, &host);
+    } else {
+        memset(&name, 0, sizeof(name));
+        name.sin_family      = AF_INET;
+        name.sin_addr.s_addr = INADDR_ANY;
+        name.sin_port        = htons(recvPort);
+
+        if (spines_bind(sk, (struct sockaddr *)&name, sizeof(name)) < 0)
+            Alarm(EXIT, "sp_bench: bind error\n");
+
+        Run_Receiver(sk);
+    }
+
+    spines_close(sk);
+
+    return 0;
+}
+
+static int Parse_Mode(const char *mode)
+{
+    if (!strcmp(mode, "udp"))
+        return UDP_LINKS;
+    if (!strcmp(mode, "reliable-link"))
+        return RELIABLE_LINKS;
+    if (!strcmp(mode, "realtime"))
+        return SOFT_REALTIME_LINKS;
+    if (!strcmp(mode, "it"))
+        return INTRUSION_TOL_LINKS | MIN_WEIGHT_ROUTING;
+    if (!strcmp(mode, "priority"))
+        return INTRUSION_TOL_LINKS | IT_PRIORITY_ROUTING;
+    if (!strcmp(mode, "reliable"))
+        return INTRUSION_TOL_LINKS | IT_RELIABLE_ROUTING;
+    /* source-based routing only runs over UDP or realtime links */
+    if (!strcmp(mode, "source"))
+        return SOFT_REALTIME_LINKS | SOURCE_BASED_ROUTING;
+
+    Alarm(EXIT, "sp_bench: unknown mode %s\n", mode);
+    return -1;
+}
+
+static void Usage(int argc, char *argv[])
+{
+    int tmp;
+
+    /* Setting defaults */
+    Num_bytes     = 1000;
+    Rate          = 1000;
+    Num_pkts      = 10000;
+    spinesPort    = DEFAULT_SPINES_PORT;
+    sendPort      = 8400;
+    recvPort      = 8400;
+    Send_Flag     = 0;
+    Idle_timeout  = 5;
+    Priority      = 10;
+    KPaths        = 0;  /* This is Flooding */
+    strcpy(IP, "");
+    strcpy(SP_IP, "");
+    strcpy(Unix_domain_path, "");
+    strcpy(Label, "");
+    strcpy(Report_file, "");
+    strcpy(Mode_name, "priority");
+    Protocol = Parse_Mode(Mode_name);
+
+    while (--argc > 0) {
+        argv++;
+
+        if (!strncmp(*argv, "-ud", 4) && argc > 1) {
+            sscanf(argv[1], "%79s", Unix_domain_path);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-p", 3) && argc > 1) {
+            sscanf(argv[1], "%d", &spinesPort);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-o", 3) && argc > 1) {
+            sscanf(argv[1], "%79s", SP_IP);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-d", 3) && argc > 1) {
+            sscanf(argv[1], "%d", &sendPort);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-r", 3) && argc > 1) {
+            sscanf(argv[1], "%d", &recvPort);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-a", 3) && argc > 1) {
+            sscanf(argv[1], "%79s", IP);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-m", 3) && argc > 1) {
+            sscanf(argv[1], "%31s", Mode_name);
+            Protocol = Parse_Mode(Mode_name);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-k", 3) && argc > 1) {
+            sscanf(argv[1], "%hu", &KPaths);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-y", 3) && argc > 1) {
+            if (sscanf(argv[1], "%d", &tmp) < 1 || tmp < 1 || tmp > 10)
+                Alarm(EXIT, "sp_bench: priority must be between 1 and 10\n");
+            Priority = (int16u)tmp;
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-b", 3) && argc > 1) {
+            sscanf(argv[1], "%d", &Num_bytes);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-R", 3) && argc > 1) {
+            sscanf(argv[1], "%d", &Rate);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-n", 3) && argc > 1) {
+            sscanf(argv[1], "%d", &Num_pkts);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-w", 3) && argc > 1) {
+            sscanf(argv[1], "%d", &Idle_timeout);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-l", 3) && argc > 1) {
+            sscanf(argv[1], "%79s", Label);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-f", 3) && argc > 1) {
+            sscanf(argv[1], "%255s", Report_file);
+            argc--; argv++;
+        } else if (!strncmp(*argv, "-s", 3)) {
+            Send_Flag = 1;
+        } else {
+            printf("Usage: sp_bench\n"
+                   "\t[-o <address>    ] : address where spines runs, default localhost\n"
+                   "\t[-p <port number>] : port where spines runs, default is 8100\n"
+                   "\t[-ud <path>      ] : unix domain socket path to connect to, default is /tmp/spines<port>\n"
+                   "\t[-d <port number>] : to send packets on, default is 8400\n"
+                   "\t[-r <port number>] : to receive packets on, default is 8400\n"
+                   "\t[-a <address>    ] : address to send packets to\n"
+                   "\t[-m <mode>       ] : priority, reliable, it, realtime, source, udp or reliable-link,\n"
+                   "\t                     default is priority\n"
+                   "\t[-k <paths>      ] : number of node-disjoint paths (0 for flooding), default is 0\n"
+                   "\t[-y <priority>   ] : message priority (1-10) for priority mode, default is 10\n"
+                   "\t[-b <size>       ] : size of the packets (in bytes), default is 1000\n"
+                   "\t[-R <rate>       ] : sending rate (in 1000's of bits per sec, 0 for unpaced), default is 1000\n"
+                   "\t[-n <rounds>     ] : number of packets, default is 10000\n"
+                   "\t[-w <seconds>    ] : receiver idle timeout, default is 5\n"
+                   "\t[-l <label>      ] : label copied into the report\n"
+                   "\t[-f <filename>   ] : append the JSON report to this file instead of stdout\n"
+                   "\t[-s              ] : sender\n");
+            exit(0);
+        }
+    }
+
+    if (Num_bytes > SP_MAX_PKT_SIZE || Num_bytes < (int)sizeof(bench_pkt))
+        Alarm(EXIT, "sp_bench: packet size is not within range of %d -> %d\n",
+              (int)sizeof(bench_pkt), SP_MAX_PKT_SIZE);
+
+    if (Num_pkts <= 0)
+        Alarm(EXIT, "sp_bench: number of packets must be positive\n");
+
+    if (Send_Flag == 1 && strcmp(IP, "") == 0)
+        Alarm(EXIT, "sp_bench: the sender needs a destination (-a)\n");
+}
@@ -0,0 +1,398 @@
+#!/usr/bin/env python3
+#
+# Spines.
+#
+# The contents of this file are subject to the Spines Open-Source
+# License, Version 1.0 (the ``License''); you may not use
+# this file except in compliance with the License.  You may obtain a
+# copy of the License at:
+#
+# http://www.spines.org/LICENSE.txt
+#
+# or in the file ``LICENSE.txt'' found in this distribution.
+#
+# Software distributed under the License is distributed on an AS IS basis,
+# WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+# for the specific language governing rights and limitations under the
+# License.
+#
+# The Creators of Spines are:
+#  Yair Amir, Claudiu Danilov, John Schultz, Daniel Obenshain,
+#  Thomas Tantillo, and Amy Babay.
+#
+# Copyright (c) 2003-2025 The Johns Hopkins University.
+# All rights reserved.
+#
+
+"""Bring up an N-node Spines overlay on loopback and measure it.
+
+Every daemon gets its own loopback address (127.0.1.<id> by default), its
+own unix domain socket prefix and a configuration generated from
+daemon/example_spines.conf.  Link profiles are applied with
+controlprogs/setlink through the daemons' monitor interface (-m), and
+traffic is driven with testprogs/sp_bench for every combination of mode,
+rate and message size.  Results, including CPU time per daemon, are
+written as JSON (and a CSV summary) and can be compared against a
+previous report to flag regressions.
+
+Example:
+    ./spines_bench.py -n 4 --topology ring --profile wan \\
+        --modes priority,reliable --rates 1000,10000 --sizes 200,1000 \\
+        --out wan.json --baseline last_wan.json
+"""
+
+import argparse
+import csv
+import json
+import os
+import re
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+SPINES_TOP = os.path.dirname(HERE)
+
+# delay (ms), jitter (ms), loss (%), burst (%), bandwidth (kbps, 0 = unlimited)
+PROFILES = {
+    "none":      (0,   0,  0.0,  0.0, 0),
+    "lan":       (1,   0,  0.0,  0.0, 0),
+    "wan":       (20,  5,  0.1,  0.0, 0),
+    "lossy":     (10,  2,  2.0, 20.0, 0),
+    "jittery":   (15, 15,  0.0,  0.0, 0),
+    "congested": (10,  2,  0.5,  0.0, 10000),
+}
+
+MODES = ["priority", "reliable", "it", "realtime", "source", "udp", "reliable-link"]
+
+# Latency and goodput metrics compared against a baseline report
+REGRESSION_METRICS = [("p50", "lower"), ("p99", "lower"), ("goodput_kbps", "higher")]
+
+
+def parse_list(text, conv=str):
+    return [conv(x) for x in text.split(",") if x != ""]
+
+
+def build_edges(args):
+    n = args.nodes
+    if args.edges:
+        edges = []
+        for pair in parse_list(args.edges):
+            a, b = pair.split("-")
+            edges.append((int(a), int(b)))
+    elif args.topology == "line":
+        edges = [(i, i + 1) for i in range(1, n)]
+    elif args.topology == "ring":
+        edges = [(i, i + 1) for i in range(1, n)] + ([(n, 1)] if n > 2 else [])
+    elif args.topology == "star":
+        edges = [(1, i) for i in range(2, n + 1)]
+    elif args.topology == "full":
+        edges = [(i, j) for i in range(1, n + 1) for j in range(i + 1, n + 1)]
+    else:
+        sys.exit("unknown topology %s" % args.topology)
+
+    for a, b in edges:
+        if not (1 <= a <= n and 1 <= b <= n) or a == b:
+            sys.exit("bad edge %d-%d for %d nodes" % (a, b, n))
+    return edges
+
+
+def node_ip(args, node_id):
+    return "%s.%d" % (args.ip_base, node_id)
+
+
+def write_config(args, path, edges):
+    """Copy example_spines.conf, apply overrides and fill Hosts/Edges."""
+    with open(os.path.join(SPINES_TOP, "daemon", "example_spines.conf")) as f:
+        text = f.read()
+
+    overrides = {
+        # dissemination-graph based protocols need both directions listed
+        "Directed_Edges": "True",
+        # every daemon shares the data ports, so clients use unix sockets only
+        "Remote_Connections": "False",
+    }
+    for item in args.conf:
+        key, value = item.split("=", 1)
+        overrides[key.strip()] = value.strip()
+
+    for key, value in overrides.items():
+        text, count = re.subn(r"(?m)^%s\s*=.*$" % re.escape(key), "%s = %s" % (key, value), text)
+        if count == 0:
+            text = "%s = %s\n" % (key, value) + text
+
+    hosts = "".join("    %d %s\n" % (i, node_ip(args, i)) for i in range(1, args.nodes + 1))
+    edge_lines = "".join("    %d %d %d\n    %d %d %d\n" % (a, b, args.cost, b, a, args.cost)
+                         for a, b in edges)
+    text = re.sub(r"(?ms)^Hosts \{.*?^\}", "Hosts {\n" + hosts + "}", text)
+    text = re.sub(r"(?ms)^Edges \{.*?^\}", "Edges {\n" + edge_lines + "}", text)
+
+    with open(path, "w") as f:
+        f.write(text)
+
+
+def proc_cpu(pid):
+    """utime + stime of a process in seconds."""
+    with open("/proc/%d/stat" % pid) as f:
+        fields = f.read().rsplit(")", 1)[1].split()
+    return (int(fields[11]) + int(fields[12])) / float(os.sysconf("SC_CLK_TCK"))
+
+
+def proc_rss_kb(pid):
+    with open("/proc/%d/status" % pid) as f:
+        for line in f:
+            if line.startswith("VmHWM:"):
+                return int(line.split()[1])
+    return 0
+
+
+class Overlay:
+    def __init__(self, args, edges):
+        self.args = args
+        self.edges = edges
+        self.workdir = args.workdir or tempfile.mkdtemp(prefix="spbench.")
+        self.daemons = {}
+        os.makedirs(self.workdir, exist_ok=True)
+
+    def ud_path(self, node_id):
+        return os.path.join(self.workdir, "n%d" % node_id, "sp")
+
+    def start(self):
+        conf = os.path.join(self.workdir, "spines.conf")
+        write_config(self.args, conf, self.edges)
+        keys = os.path.join(SPINES_TOP, "daemon", "keys")
+
+        for i in range(1, self.args.nodes + 1):
+            ndir = os.path.join(self.workdir, "n%d" % i)
+            os.makedirs(ndir, exist_ok=True)
+            # keys/ is read relative to the working directory
+            if os.path.isdir(keys) and not os.path.exists(os.path.join(ndir, "keys")):
+                os.symlink(keys, os.path.join(ndir, "keys"))
+            log = open(os.path.join(ndir, "spines.log"), "w")
+            cmd = [self.args.spines, "-p", str(self.args.port), "-c", conf,
+                   "-I", node_ip(self.args, i), "-ud", self.ud_path(i), "-m"]
+            self.daemons[i] = subprocess.Popen(cmd, cwd=ndir, stdout=log, stderr=subprocess.STDOUT)
+
+        time.sleep(1)
+        for i, p in self.daemons.items():
+            if p.poll() is not None:
+                self.stop()
+                sys.exit("daemon %d exited at startup, see %s/n%d/spines.log" % (i, self.workdir, i))
+
+    def apply_profile(self):
+        """Emulate every directed edge at its receiving daemon."""
+        default = PROFILES[self.args.profile]
+        per_edge = {}
+        for item in self.args.edge_profile:
+            pair, name = item.split("=")
+            a, b = pair.split("-")
+            per_edge[(int(a), int(b))] = PROFILES[name]
+
+        profile = list(default)
+        for idx, value in enumerate([self.args.delay, self.args.jitter, self.args.loss,
+                                     self.args.burst, self.args.bandwidth]):
+            if value is not None:
+                profile[idx] = value
+
+        for a, b in self.edges:
+            for src, dst in ((a, b), (b, a)):
+                delay, jitter, loss, burst, bw = per_edge.get((src, dst), profile)
+                if delay == 0 and jitter == 0 and loss == 0 and bw == 0:
+                    continue
+                cmd = [self.args.setlink, str(bw), "%d:%d" % (delay, jitter), str(loss), str(burst),
+                       node_ip(self.args, src), node_ip(self.args, dst), self.ud_path(dst)]
+                subprocess.run(cmd, stdout=subprocess.DEVNULL, check=False)
+
+    def cpu(self):
+        return {i: proc_cpu(p.pid) for i, p in self.daemons.items() if p.poll() is None}
+
+    def stop(self):
+        for p in self.daemons.values():
+            if p.poll() is None:
+                p.send_signal(signal.SIGINT)
+        for p in self.daemons.values():
+            try:
+                p.wait(timeout=5)
+            except subprocess.TimeoutExpired:
+                p.kill()
+
+
+def run_one(args, overlay, mode, rate, size, port):
+    label = "%s/%d/%d" % (mode, rate, size)
+    common = ["-m", mode, "-b", str(size), "-n", str(args.count), "-k", str(args.kpaths), "-l", label]
+
+    cpu_before = overlay.cpu()
+    wall_start = time.time()
+
+    recv = subprocess.Popen([args.sp_bench, "-ud", overlay.ud_path(args.dst), "-r", str(port),
+                             "-w", str(args.idle)] + common,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+    time.sleep(0.5)
+    send = subprocess.Popen([args.sp_bench, "-s", "-ud", overlay.ud_path(args.src), "-d", str(port),
+                             "-a", node_ip(args, args.dst), "-R", str(rate)] + common,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+
+    limit = args.count * size * 8.0 / max(rate, 1) / 1000.0 + args.idle + 60
+    try:
+        send_out, _ = send.communicate(timeout=limit)
+        recv_out, _ = recv.communicate(timeout=args.idle + 30)
+    except subprocess.TimeoutExpired:
+        send.kill()
+        recv.kill()
+        send_out, recv_out = "", ""
+
+    wall = time.time() - wall_start
+    cpu_after = overlay.cpu()
+
+    def last_json(text):
+        for line in reversed(text.splitlines()):
+            if line.startswith("{"):
+                return json.loads(line)
+        return None
+
+    daemons = []
+    for i in sorted(overlay.daemons):
+        if i in cpu_before and i in cpu_after:
+            used = cpu_after[i] - cpu_before[i]
+            daemons.append({"id": i, "cpu_sec": round(used, 3), "cpu_pct": round(100.0 * used / wall, 1),
+                            "max_rss_kb": proc_rss_kb(overlay.daemons[i].pid)})
+        else:
+            daemons.append({"id": i, "exited": True})
+
+    return {"mode": mode, "rate_kbps": rate, "size": size, "wall_sec": round(wall, 3),
+            "sender": last_json(send_out), "receiver": last_json(recv_out), "daemons": daemons}
+
+
+def compare(results, baseline_path, tolerance):
+    """Return a list of human readable regressions against a previous report."""
+    with open(baseline_path) as f:
+        base = {(r["mode"], r["rate_kbps"], r["size"]): r for r in json.load(f)["results"]}
+
+    regressions = []
+    for r in results:
+        old = base.get((r["mode"], r["rate_kbps"], r["size"]))
+        if old is None or not r["receiver"] or not old["receiver"]:
+            continue
+        for metric, better in REGRESSION_METRICS:
+            if metric == "goodput_kbps":
+                new_v, old_v = r["receiver"][metric], old["receiver"][metric]
+            else:
+                new_v, old_v = r["receiver"]["latency_usec"][metric], old["receiver"]["latency_usec"][metric]
+            if old_v <= 0:
+                continue
+            change = (new_v - old_v) / float(old_v)
+            if (better == "lower" and change > tolerance) or (better == "higher" and -change > tolerance):
+                regressions.append("%s/%d/%d %s: %s -> %s (%+.1f%%)" % (
+                    r["mode"], r["rate_kbps"], r["size"], metric, old_v, new_v, 100 * change))
+    return regressions
+
+
+def write_csv(path, results):
+    with open(path, "w", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(["mode", "rate_kbps", "size", "sent", "received", "lost", "goodput_kbps",
+                    "p50_usec", "p90_usec", "p99_usec", "p999_usec", "max_usec", "daemon_cpu_sec"])
+        for r in results:
+            rc = r["receiver"] or {}
+            lat = rc.get("latency_usec", {})
+            w.writerow([r["mode"], r["rate_kbps"], r["size"], rc.get("sent"), rc.get("received"),
+                        rc.get("lost"), rc.get("goodput_kbps"), lat.get("p50"), lat.get("p90"),
+                        lat.get("p99"), lat.get("p999"), lat.get("max"),
+                        round(sum(d.get("cpu_sec", 0) for d in r["daemons"]), 3)])
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("-n", "--nodes", type=int, default=3, help="number of daemons (default 3)")
+    ap.add_argument("--topology", default="line", help="line, ring, star or full (default line)")
+    ap.add_argument("--edges", help="explicit edge list, e.g. 1-2,2-3,1-3")
+    ap.add_argument("--cost", type=int, default=10, help="cost of every edge (default 10)")
+    ap.add_argument("--src", type=int, default=1, help="sending node (default 1)")
+    ap.add_argument("--dst", type=int, help="receiving node (default: last node)")
+    ap.add_argument("--profile", default="none", choices=sorted(PROFILES), help="link profile for every edge")
+    ap.add_argument("--edge-profile", action="append", default=[], metavar="A-B=PROFILE",
+                    help="profile for the directed edge A->B, may be repeated")
+    ap.add_argument("--delay", type=int, help="override profile delay (ms)")
+    ap.add_argument("--jitter", type=int, help="override profile jitter (ms)")
+    ap.add_argument("--loss", type=float, help="override profile loss (%%)")
+    ap.add_argument("--burst", type=float, help="override profile burst loss (%%)")
+    ap.add_argument("--bandwidth", type=int, help="override profile bandwidth (kbps)")
+    ap.add_argument("--modes", default="priority,reliable,it,realtime,source",
+                    help="comma separated sp_bench modes (%s)" % ", ".join(MODES))
+    ap.add_argument("--rates", default="1000", help="comma separated rates in kbps, 0 for unpaced")
+    ap.add_argument("--sizes", default="1000", help="comma separated message sizes in bytes")
+    ap.add_argument("--count", type=int, default=2000, help="messages per run (default 2000)")
+    ap.add_argument("--kpaths", type=int, default=0, help="node-disjoint paths, 0 for flooding")
+    ap.add_argument("--idle", type=int, default=3, help="receiver idle timeout in seconds")
+    ap.add_argument("--settle", type=float, default=5, help="seconds to let the overlay converge")
+    ap.add_argument("--port", type=int, default=8100, help="spines port shared by all daemons")
+    ap.add_argument("--ip-base", default="127.0.1", help="first three octets of node addresses")
+    ap.add_argument("--conf", action="append", default=[], metavar="KEY=VALUE",
+                    help="override a spines.conf parameter, may be repeated")
+    ap.add_argument("--spines", default=os.path.join(SPINES_TOP, "daemon", "spines"))
+    ap.add_argument("--setlink", default=os.path.join(SPINES_TOP, "controlprogs", "setlink"))
+    ap.add_argument("--sp-bench", default=os.path.join(HERE, "sp_bench"))
+    ap.add_argument("--workdir", help="directory for configs, sockets and logs")
+    ap.add_argument("--out", default="spines_bench.json", help="JSON report (default spines_bench.json)")
+    ap.add_argument("--csv", help="also write a CSV summary")
+    ap.add_argument("--baseline", help="previous JSON report to compare against")
+    ap.add_argument("--tolerance", type=float, default=0.10,
+                    help="relative change counted as a regression (default 0.10)")
+    args = ap.parse_args()
+
+    if args.dst is None:
+        args.dst = args.nodes
+    for mode in parse_list(args.modes):
+        if mode not in MODES:
+            sys.exit("unknown mode %s" % mode)
+    for prog in (args.spines, args.setlink, args.sp_bench):
+        if not os.access(prog, os.X_OK):
+            sys.exit("%s is not built" % prog)
+
+    edges = build_edges(args)
+    overlay = Overlay(args, edges)
+    results = []
+    try:
+        overlay.start()
+        overlay.apply_profile()
+        time.sleep(args.settle)
+
+        port = 8400
+        for mode in parse_list(args.modes):
+            for rate in parse_list(args.rates, int):
+                for size in parse_list(args.sizes, int):
+                    r = run_one(args, overlay, mode, rate, size, port)
+                    port += 1
+                    rc = r["receiver"] or {}
+                    print("%-14s %8d kbps %6d B: recv %s/%s p50 %s p99 %s usec goodput %s kbps" % (
+                        mode, rate, size, rc.get("received"), rc.get("sent"),
+                        rc.get("latency_usec", {}).get("p50"), rc.get("latency_usec", {}).get("p99"),
+                        rc.get("goodput_kbps")))
+                    results.append(r)
+    finally:
+        overlay.stop()
+        if args.workdir is None:
+            shutil.rmtree(overlay.workdir, ignore_errors=True)
+
+    report = {"nodes": args.nodes, "edges": edges, "src": args.src, "dst": args.dst,
+              "profile": args.profile, "edge_profiles": args.edge_profile, "count": args.count,
+              "kpaths": args.kpaths, "conf": args.conf, "time": time.strftime("%Y-%m-%dT%H:%M:%S"),
+              "results": results}
+    with open(args.out, "w") as f:
+        json.dump(report, f, indent=2)
+    if args.csv:
+        write_csv(args.csv, results)
+
+    if args.baseline:
+        regressions = compare(results, args.baseline, args.tolerance)
+        for line in regressions:
+            print("REGRESSION " + line)
+        if regressions:
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()